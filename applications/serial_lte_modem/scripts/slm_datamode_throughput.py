@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""Measure the data mode throughput of the Serial LTE Modem through a TCP echo server"""
+
+import argparse
+import logging
+import os
+import sys
+import threading
+import time
+import serial
+
+QUIT_STR = b'+++'
+
+
+class SLMClient:
+    """Send AT commands and data mode traffic to SLM through serial port."""
+    def __init__(self, serial_path, baudrate, rtscts):
+        self.serial = serial.Serial(serial_path, baudrate, rtscts=rtscts, timeout=0.1)
+        self.serial.reset_input_buffer()
+
+    def at_cmd(self, at_str, timeout=10):
+        """Send AT command and return the response lines, or None on error."""
+        self.serial.write(at_str.encode() + b'\r\n')
+        logging.debug(at_str)
+        resp = []
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            line = self.serial.readline()
+            if len(line) == 0:
+                continue
+            line = line.decode(errors='replace').strip()
+            logging.debug(line)
+            if line == 'OK':
+                return resp
+            if 'ERROR' in line:
+                return None
+            if line:
+                resp.append(line)
+        return None
+
+    def wait_for(self, urc, timeout=10):
+        """Wait for an unsolicited result code."""
+        data = b''
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            data += self.serial.read(self.serial.in_waiting or 1)
+            if urc.encode() in data:
+                return True
+        return False
+
+
+def run(client, size, chunk):
+    """Stream size bytes in data mode and read the echo. Returns (uplink_s, round_trip_s)."""
+    payload = os.urandom(size)
+    # The terminator must not appear in the data.
+    payload = payload.replace(QUIT_STR, b'---')
+    received = bytearray()
+
+    def reader():
+        deadline = time.monotonic() + 60
+        while len(received) < size and time.monotonic() < deadline:
+            received.extend(client.serial.read(min(size - len(received), 4096)))
+
+    thread = threading.Thread(target=reader)
+    start = time.monotonic()
+    thread.start()
+    for i in range(0, size, chunk):
+        client.serial.write(payload[i:i + chunk])
+    client.serial.flush()
+    uplink = time.monotonic() - start
+    thread.join()
+    round_trip = time.monotonic() - start
+
+    if bytes(received) != payload:
+        logging.error("Echo mismatch: %d of %d bytes received", len(received), size)
+        return None
+    return uplink, round_trip
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('port', help="Serial port of SLM")
+    parser.add_argument('--baudrate', type=int, default=115200)
+    parser.add_argument('--no-rtscts', action='store_true',
+                        help="Disable hardware flow control")
+    parser.add_argument('--host', required=True, help="TCP echo server")
+    parser.add_argument('--port', dest='port_number', type=int, default=7,
+                        help="TCP echo server port")
+    parser.add_argument('--size', type=int, default=65536, help="Bytes to send")
+    parser.add_argument('--chunk', type=int, default=1024, help="Bytes per serial write")
+    parser.add_argument('-v', '--verbose', action='store_true')
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO)
+
+    client = SLMClient(args.port, args.baudrate, not args.no_rtscts)
+    if client.at_cmd(f'AT#XTCPCLI=1,"{args.host}",{args.port_number}', timeout=60) is None:
+        logging.error("Failed to connect to %s:%d", args.host, args.port_number)
+        return 1
+    if client.at_cmd('AT#XTCPSEND') is None:
+        logging.error("Failed to enter data mode")
+        client.at_cmd('AT#XTCPCLI=0')
+        return 1
+
+    result = run(client, args.size, args.chunk)
+
+    client.serial.write(QUIT_STR)
+    if not client.wait_for('#XDATAMODE: 0'):
+        logging.warning("No data mode exit notification")
+    client.at_cmd('AT#XTCPCLI=0')
+
+    if result is None:
+        return 1
+    uplink, round_trip = result
+    logging.info("Uplink: %d bytes in %.2f s, %.0f bytes/s", args.size, uplink,
+                 args.size / uplink)
+    logging.info("Round trip: %d bytes in %.2f s, %.0f bytes/s", args.size, round_trip,
+                 args.size / round_trip)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,310 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""Reference host implementation of the multiplexing mode of the Serial LTE Modem
+
+Measures the throughput of one or more sockets through a TCP echo server,
+to compare with the data mode, see slm_datamode_throughput.py.
+"""
+
+import argparse
+import logging
+import os
+import queue
+import struct
+import sys
+import threading
+import time
+import serial
+
+SOF = 0xF9
+HEADER = struct.Struct('<BBBH')
+TYPE_DATA = 0
+TYPE_OPEN = 1
+TYPE_CREDIT = 2
+TYPE_CLOSE = 3
+CHANNEL_AT = 0
+MTU = 1024
+CREDIT = 8192
+
+
+def crc8_ccitt(data, crc=0xFF):
+    """CRC-8-CCITT as in Zephyr crc8_ccitt()."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame_encode(channel, frame_type, payload=b''):
+    """Encode a frame."""
+    header = HEADER.pack(SOF, channel, frame_type, len(payload))
+    return header + payload + bytes([crc8_ccitt(header[1:] + payload)])
+
+
+class FrameDecoder:
+    """Decode frames from a byte stream, skipping anything outside of frames."""
+    def __init__(self, mtu=MTU):
+        self.mtu = mtu
+        self.buf = bytearray()
+        self.errors = 0
+
+    def decode(self, data):
+        """Return the complete frames as (channel, type, payload) tuples."""
+        self.buf.extend(data)
+        frames = []
+        while True:
+            start = self.buf.find(SOF)
+            if start < 0:
+                self.buf.clear()
+                break
+            del self.buf[:start]
+            if len(self.buf) < HEADER.size:
+                break
+            _, channel, frame_type, length = HEADER.unpack_from(self.buf)
+            if length > self.mtu:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+            end = HEADER.size + length
+            if len(self.buf) < end + 1:
+                break
+            payload = bytes(self.buf[HEADER.size:end])
+            if self.buf[end] == crc8_ccitt(self.buf[1:end]):
+                frames.append((channel, frame_type, payload))
+                del self.buf[:end + 1]
+            else:
+                self.errors += 1
+                del self.buf[:1]
+        return frames
+
+
+class Channel:
+    """Socket channel with credit based flow control."""
+    def __init__(self, mux, channel):
+        self.mux = mux
+        self.channel = channel
+        self.credit = 0
+        self.credit_cond = threading.Condition()
+        self.rx = queue.Queue()
+        self.closed = False
+
+    def send(self, data):
+        """Send data, waiting for credit from SLM."""
+        while data:
+            with self.credit_cond:
+                while self.credit == 0 and not self.closed:
+                    self.credit_cond.wait(1)
+                if self.closed:
+                    raise ConnectionError(f"Channel {self.channel} closed")
+                size = min(len(data), self.credit, self.mux.mtu)
+                self.credit -= size
+            self.mux.write(frame_encode(self.channel, TYPE_DATA, data[:size]))
+            data = data[size:]
+
+    def recv(self, timeout=None):
+        """Return received data and give the credit back to SLM."""
+        data = self.rx.get(timeout=timeout)
+        self.mux.write(frame_encode(self.channel, TYPE_CREDIT, struct.pack('<H', len(data))))
+        return data
+
+    def close(self):
+        """Detach the channel. The socket stays open."""
+        self.mux.write(frame_encode(self.channel, TYPE_CLOSE))
+
+
+class SLMMux:
+    """Serial LTE Modem in multiplexing mode."""
+    def __init__(self, serial_port, mtu=MTU):
+        self.serial = serial_port
+        self.mtu = mtu
+        self.decoder = FrameDecoder(mtu)
+        self.write_lock = threading.Lock()
+        self.at_lines = queue.Queue()
+        self.at_buf = b''
+        self.channels = {}
+        self.opened = {}
+        self.running = True
+        self.reader = threading.Thread(target=self._read, daemon=True)
+        self.reader.start()
+
+    def write(self, frame):
+        """Write a frame in one piece."""
+        with self.write_lock:
+            self.serial.write(frame)
+
+    def _read(self):
+        while self.running:
+            data = self.serial.read(self.serial.in_waiting or 1)
+            for channel, frame_type, payload in self.decoder.decode(data):
+                self._frame(channel, frame_type, payload)
+
+    def _frame(self, channel, frame_type, payload):
+        if channel == CHANNEL_AT:
+            if frame_type == TYPE_DATA:
+                self.at_buf += payload
+                *lines, self.at_buf = self.at_buf.split(b'\r\n')
+                for line in lines:
+                    if line:
+                        self.at_lines.put(line.decode(errors='replace'))
+            elif frame_type == TYPE_CLOSE:
+                self.running = False
+            return
+        chan = self.channels.get(channel)
+        if chan is None:
+            logging.warning("Frame for unknown channel %d", channel)
+        elif frame_type == TYPE_DATA:
+            chan.rx.put(payload)
+        elif frame_type in (TYPE_OPEN, TYPE_CREDIT):
+            with chan.credit_cond:
+                chan.credit += struct.unpack('<H', payload)[0]
+                chan.credit_cond.notify_all()
+            if frame_type == TYPE_OPEN:
+                self.opened[channel].set()
+        elif frame_type == TYPE_CLOSE:
+            with chan.credit_cond:
+                chan.closed = True
+                chan.credit_cond.notify_all()
+            self.opened[channel].set()
+
+    def at_cmd(self, at_str, timeout=10):
+        """Send AT command on the AT channel and return the response lines, or None on error."""
+        self.write(frame_encode(CHANNEL_AT, TYPE_DATA, at_str.encode() + b'\r\n'))
+        resp = []
+        deadline = time.monotonic() + timeout
+        while True:
+            try:
+                line = self.at_lines.get(timeout=max(deadline - time.monotonic(), 0.01))
+            except queue.Empty:
+                return None
+            logging.debug(line)
+            if line == 'OK':
+                return resp
+            if 'ERROR' in line:
+                return None
+            resp.append(line)
+
+    def open(self, fd, credit=CREDIT):
+        """Attach the socket with the given file descriptor to a channel."""
+        channel = fd + 1
+        chan = Channel(self, channel)
+        self.channels[channel] = chan
+        self.opened[channel] = threading.Event()
+        self.write(frame_encode(channel, TYPE_OPEN, struct.pack('<H', credit)))
+        if not self.opened[channel].wait(5) or chan.closed:
+            raise ConnectionError(f"Channel {channel} not opened")
+        return chan
+
+    def exit(self):
+        """Leave the multiplexing mode."""
+        self.write(frame_encode(CHANNEL_AT, TYPE_CLOSE))
+        self.reader.join(5)
+        self.running = False
+
+
+def at_cmd(port, at_str, timeout=10):
+    """Send AT command before the multiplexing mode."""
+    port.write(at_str.encode() + b'\r\n')
+    resp = []
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        line = port.readline().decode(errors='replace').strip()
+        if line == 'OK':
+            return resp
+        if 'ERROR' in line:
+            return None
+        if line:
+            resp.append(line)
+    return None
+
+
+def echo(chan, size, results, index):
+    """Send size bytes on a channel and read them back."""
+    payload = os.urandom(size)
+    received = bytearray()
+    start = time.monotonic()
+    sender = threading.Thread(target=chan.send, args=(payload,))
+    sender.start()
+    try:
+        while len(received) < size:
+            received.extend(chan.recv(timeout=30))
+    except queue.Empty:
+        pass
+    sender.join()
+    elapsed = time.monotonic() - start
+    results[index] = (bytes(received) == payload, elapsed)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('port', help="Serial port of SLM")
+    parser.add_argument('--baudrate', type=int, default=115200)
+    parser.add_argument('--host', required=True, help="TCP echo server")
+    parser.add_argument('--port', dest='port_number', type=int, default=7,
+                        help="TCP echo server port")
+    parser.add_argument('--sockets', type=int, default=2, help="Concurrent sockets")
+    parser.add_argument('--size', type=int, default=65536, help="Bytes to send per socket")
+    parser.add_argument('--mtu', type=int, default=MTU, help="CONFIG_SLM_MUX_MTU of SLM")
+    parser.add_argument('-v', '--verbose', action='store_true')
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO)
+
+    port = serial.Serial(args.port, args.baudrate, rtscts=True, timeout=0.1)
+    port.reset_input_buffer()
+
+    fds = []
+    for _ in range(args.sockets):
+        resp = at_cmd(port, 'AT#XSOCKET=1,1,0')
+        if not resp or at_cmd(port, f'AT#XCONNECT="{args.host}",{args.port_number}',
+                              timeout=60) is None:
+            logging.error("Failed to connect to %s:%d", args.host, args.port_number)
+            return 1
+        fds.append(int(resp[0].split(':')[1].split(',')[0]))
+
+    if at_cmd(port, 'AT#XMUX=1') is None:
+        logging.error("Failed to enter multiplexing mode")
+        return 1
+
+    mux = SLMMux(port, args.mtu)
+    channels = [mux.open(fd) for fd in fds]
+    results = [None] * len(channels)
+    threads = [threading.Thread(target=echo, args=(chan, args.size, results, i))
+               for i, chan in enumerate(channels)]
+    start = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+
+    for chan in channels:
+        chan.close()
+    # AT commands and responses share the link with the socket data.
+    for fd in fds:
+        mux.at_cmd(f'AT#XSOCKETSELECT={fd}')
+        mux.at_cmd('AT#XSOCKET=0')
+    mux.exit()
+
+    ok = True
+    for fd, (match, seconds) in zip(fds, results):
+        ok = ok and match
+        logging.info("Socket %d: %s, %d bytes in %.2f s, %.0f bytes/s", fd,
+                     "OK" if match else "echo mismatch", args.size, seconds,
+                     args.size / seconds)
+    total = args.size * len(fds)
+    logging.info("Total round trip: %d bytes in %.2f s, %.0f bytes/s", total, elapsed,
+                 total / elapsed)
+    logging.info("Frame errors: %d", mux.decoder.errors)
+    logging.info("Compare with: slm_datamode_throughput.py %s --host %s --port %d --size %d",
+                 args.port, args.host, args.port_number, total)
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/logging/log.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/posix/sys/eventfd.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/ring_buffer.h>
+#include "slm_util.h"
+#include "slm_at_host.h"
+#include "slm_at_socket.h"
+#include "slm_uart_handler.h"
+#include "slm_mux_frame.h"
+#include "slm_at_mux.h"
+
+LOG_MODULE_REGISTER(slm_mux, CONFIG_SLM_LOG_LEVEL);
+
+#define THREAD_STACK_SIZE	KB(2)
+#define THREAD_PRIORITY		K_LOWEST_APPLICATION_THREAD_PRIO
+
+/* Time to wait after a poll() error. */
+#define MUX_POLL_RETRY_MS	100
+/* Time to wait for the thread to terminate. */
+#define MUX_STOP_TIMEOUT	K_SECONDS(1)
+
+#define MUX_CHANNEL_COUNT	SLM_MAX_SOCKET_COUNT
+
+/**@brief Multiplexing operations. */
+enum slm_mux_operation {
+	SLM_MUX_OP_START = 1,
+};
+
+/* global variable defined in different files */
+extern struct at_param_list at_param_list;
+extern struct k_work_q slm_work_q;
+
+/* Socket channel */
+struct mux_channel {
+	int fd;			/* Attached socket, INVALID_SOCKET if free */
+	uint32_t dl_credit;	/* Bytes the host can still receive */
+	uint32_t ul_credit;	/* Bytes the host can still send */
+	struct ring_buf ul_buf;	/* Uplink data waiting to be sent to the socket */
+};
+
+static struct {
+	atomic_t active;
+	slm_uart_rx_callback_t at_rx;
+	struct slm_mux_decoder decoder;
+	struct mux_channel channels[MUX_CHANNEL_COUNT];
+	int wake_fd;		/* Wakes up the thread from poll() */
+} mux;
+
+static uint8_t frame_buf[CONFIG_SLM_MUX_MTU];
+static uint8_t recv_buf[CONFIG_SLM_MUX_MTU];
+/* The host cannot send more than its credit, so the uplink data always fits. */
+static uint8_t ul_bufs[MUX_CHANNEL_COUNT][CONFIG_SLM_MUX_CREDIT];
+
+K_MUTEX_DEFINE(mutex_channels); /* Protects the channels. */
+K_MUTEX_DEFINE(mutex_frame_tx); /* Keeps the parts of a frame together. */
+
+static struct k_thread mux_thread;
+static K_THREAD_STACK_DEFINE(mux_thread_stack, THREAD_STACK_SIZE);
+/* Waits for the thread to terminate, outside of the UART receive context. */
+static struct k_work mux_stop_work;
+
+static int frame_send(uint8_t channel, uint8_t type, const uint8_t *payload, uint16_t len)
+{
+	uint8_t header[SLM_MUX_HEADER_SIZE];
+	uint8_t fcs;
+	int err;
+
+	slm_mux_header_encode(header, channel, type, len);
+	fcs = slm_mux_fcs(header, payload, len);
+
+	k_mutex_lock(&mutex_frame_tx, K_FOREVER);
+	err = slm_uart_tx_write(header, sizeof(header));
+	if (err == 0 && len > 0) {
+		err = slm_uart_tx_write(payload, len);
+	}
+	if (err == 0) {
+		err = slm_uart_tx_write(&fcs, sizeof(fcs));
+	}
+	k_mutex_unlock(&mutex_frame_tx);
+
+	return err;
+}
+
+static int credit_send(uint8_t channel, uint8_t type, uint16_t credit)
+{
+	uint8_t payload[sizeof(uint16_t)];
+
+	sys_put_le16(credit, payload);
+
+	return frame_send(channel, type, payload, sizeof(payload));
+}
+
+/* Make the thread poll again, for example after a change in the credit. */
+static void mux_wake(void)
+{
+	(void)eventfd_write(mux.wake_fd, 1);
+}
+
+/* Lock mutex_channels, before calling. INVALID_SOCKET finds a free channel. */
+static struct mux_channel *channel_find(int fd)
+{
+	for (int i = 0; i < MUX_CHANNEL_COUNT; i++) {
+		if (mux.channels[i].fd == fd) {
+			return &mux.channels[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void channel_close(int fd, bool notify)
+{
+	struct mux_channel *ch;
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (ch) {
+		ch->fd = INVALID_SOCKET;
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	if (ch && notify) {
+		LOG_INF("Channel %d closed", SLM_MUX_CHANNEL_SOCKET(fd));
+		(void)frame_send(SLM_MUX_CHANNEL_SOCKET(fd), SLM_MUX_TYPE_CLOSE, NULL, 0);
+	}
+}
+
+static void channel_open(int fd, uint16_t credit)
+{
+	struct mux_channel *ch;
+
+	/* Only the sockets of the host can be attached, not the internal ones. */
+	if (!slm_at_socket_is_opened(fd)) {
+		LOG_WRN("Socket %d not opened", fd);
+		(void)frame_send(SLM_MUX_CHANNEL_SOCKET(fd), SLM_MUX_TYPE_CLOSE, NULL, 0);
+		return;
+	}
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (!ch) {
+		ch = channel_find(INVALID_SOCKET);
+	}
+	if (ch) {
+		ch->fd = fd;
+		ch->dl_credit = credit;
+		ch->ul_credit = CONFIG_SLM_MUX_CREDIT;
+		ring_buf_reset(&ch->ul_buf);
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	if (!ch) {
+		LOG_WRN("No free channel for socket %d", fd);
+		(void)frame_send(SLM_MUX_CHANNEL_SOCKET(fd), SLM_MUX_TYPE_CLOSE, NULL, 0);
+		return;
+	}
+
+	LOG_INF("Channel %d opened", SLM_MUX_CHANNEL_SOCKET(fd));
+	(void)credit_send(SLM_MUX_CHANNEL_SOCKET(fd), SLM_MUX_TYPE_OPEN, CONFIG_SLM_MUX_CREDIT);
+	mux_wake();
+}
+
+static void channel_credit(int fd, uint16_t credit)
+{
+	struct mux_channel *ch;
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (ch) {
+		ch->dl_credit += credit;
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	if (ch) {
+		mux_wake();
+	} else {
+		LOG_WRN("Credit for closed channel %d", SLM_MUX_CHANNEL_SOCKET(fd));
+	}
+}
+
+/* Queue uplink data, it is sent from the thread when the socket is writable. */
+static void channel_data(int fd, const uint8_t *data, uint16_t len)
+{
+	struct mux_channel *ch;
+	bool credit_ok = false;
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (ch && len <= ch->ul_credit) {
+		ch->ul_credit -= len;
+		(void)ring_buf_put(&ch->ul_buf, data, len);
+		credit_ok = true;
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	if (!ch) {
+		LOG_WRN("Channel %d not open, %d dropped", SLM_MUX_CHANNEL_SOCKET(fd), len);
+		return;
+	}
+	if (!credit_ok) {
+		LOG_WRN("Channel %d out of credit, %d dropped", SLM_MUX_CHANNEL_SOCKET(fd), len);
+		return;
+	}
+
+	mux_wake();
+}
+
+/* Make the thread exit. Return false, if it was not running. */
+static bool mux_stop(void)
+{
+	if (!atomic_cas(&mux.active, true, false)) {
+		return false;
+	}
+
+	mux_wake();
+
+	return true;
+}
+
+static void mux_join(void)
+{
+	if (k_thread_join(&mux_thread, MUX_STOP_TIMEOUT) != 0) {
+		LOG_WRN("Wait for thread terminate failed");
+	}
+
+	LOG_INF("Exit multiplexing mode");
+}
+
+static void mux_stop_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	mux_join();
+}
+
+static void at_frame_handler(const struct slm_mux_frame *frame)
+{
+	switch (frame->type) {
+	case SLM_MUX_TYPE_DATA:
+		mux.at_rx(frame->payload, frame->len);
+		break;
+	case SLM_MUX_TYPE_CLOSE:
+		/* Acknowledge, AT commands are not framed after this. */
+		(void)frame_send(SLM_MUX_CHANNEL_AT, SLM_MUX_TYPE_CLOSE, NULL, 0);
+		slm_mux_decoder_stop(&mux.decoder);
+		if (mux_stop()) {
+			k_work_submit_to_queue(&slm_work_q, &mux_stop_work);
+		}
+		break;
+	default:
+		LOG_WRN("Frame type %d not supported on AT channel", frame->type);
+		break;
+	}
+}
+
+static void frame_handler(const struct slm_mux_frame *frame, void *ctx)
+{
+	int fd = frame->channel - SLM_MUX_CHANNEL_SOCKET(0);
+
+	ARG_UNUSED(ctx);
+
+	if (frame->channel == SLM_MUX_CHANNEL_AT) {
+		at_frame_handler(frame);
+		return;
+	}
+
+	switch (frame->type) {
+	case SLM_MUX_TYPE_DATA:
+		channel_data(fd, frame->payload, frame->len);
+		break;
+	case SLM_MUX_TYPE_OPEN:
+	case SLM_MUX_TYPE_CREDIT:
+		if (frame->len != sizeof(uint16_t)) {
+			LOG_WRN("Invalid credit on channel %d", frame->channel);
+		} else if (frame->type == SLM_MUX_TYPE_OPEN) {
+			channel_open(fd, sys_get_le16(frame->payload));
+		} else {
+			channel_credit(fd, sys_get_le16(frame->payload));
+		}
+		break;
+	case SLM_MUX_TYPE_CLOSE:
+		channel_close(fd, true);
+		break;
+	default:
+		LOG_WRN("Unknown frame type %d", frame->type);
+		break;
+	}
+}
+
+static void socket_recv(int fd)
+{
+	struct mux_channel *ch;
+	size_t size = 0;
+	int ret;
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (ch) {
+		size = MIN(ch->dl_credit, sizeof(recv_buf));
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	if (size == 0) {
+		return;
+	}
+
+	ret = recv(fd, recv_buf, size, MSG_DONTWAIT);
+	if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return;
+	}
+	if (ret <= 0) {
+		LOG_WRN("recv() socket %d: %d", fd, ret < 0 ? -errno : 0);
+		channel_close(fd, true);
+		return;
+	}
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (ch) {
+		ch->dl_credit -= ret;
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	(void)frame_send(SLM_MUX_CHANNEL_SOCKET(fd), SLM_MUX_TYPE_DATA, recv_buf, ret);
+}
+
+/* Send queued uplink data, and return the credit for what was sent. */
+static void socket_send(int fd)
+{
+	struct mux_channel *ch;
+	uint8_t *data;
+	uint32_t size;
+	int ret = 0;
+
+	k_mutex_lock(&mutex_channels, K_FOREVER);
+	ch = channel_find(fd);
+	if (ch) {
+		size = ring_buf_get_claim(&ch->ul_buf, &data, ring_buf_capacity_get(&ch->ul_buf));
+		if (size > 0) {
+			ret = send(fd, data, size, MSG_DONTWAIT);
+			if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+				ret = 0;
+			} else if (ret < 0) {
+				ret = -errno;
+				LOG_ERR("send() failed: %d, %d dropped", ret,
+					ring_buf_size_get(&ch->ul_buf));
+			}
+		}
+		(void)ring_buf_get_finish(&ch->ul_buf, MAX(ret, 0));
+		if (ret > 0) {
+			ch->ul_credit += ret;
+		}
+	}
+	k_mutex_unlock(&mutex_channels);
+
+	if (ret < 0) {
+		channel_close(fd, true);
+	} else if (ret > 0) {
+		(void)credit_send(SLM_MUX_CHANNEL_SOCKET(fd), SLM_MUX_TYPE_CREDIT, ret);
+	}
+}
+
+static void mux_thread_func(void *p1, void *p2, void *p3)
+{
+	/* The wakeup eventfd and the channels. */
+	struct pollfd fds[1 + MUX_CHANNEL_COUNT];
+	struct mux_channel *ch;
+	eventfd_t value;
+	int nfds;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	fds[0].fd = mux.wake_fd;
+	fds[0].events = POLLIN;
+
+	while (atomic_get(&mux.active)) {
+		/* Only poll for what the channels can do: receive when the host has credit,
+		 * and send when there is uplink data.
+		 */
+		nfds = 1;
+		k_mutex_lock(&mutex_channels, K_FOREVER);
+		for (int i = 0; i < MUX_CHANNEL_COUNT; i++) {
+			ch = &mux.channels[i];
+			if (ch->fd == INVALID_SOCKET) {
+				continue;
+			}
+			fds[nfds].fd = ch->fd;
+			fds[nfds].events = (ch->dl_credit > 0 ? POLLIN : 0) |
+					   (!ring_buf_is_empty(&ch->ul_buf) ? POLLOUT : 0);
+			if (fds[nfds].events != 0) {
+				nfds++;
+			}
+		}
+		k_mutex_unlock(&mutex_channels);
+
+		ret = poll(fds, nfds, SYS_FOREVER_MS);
+		if (ret < 0) {
+			LOG_WRN("poll() error: %d", -errno);
+			k_sleep(K_MSEC(MUX_POLL_RETRY_MS));
+			continue;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			(void)eventfd_read(mux.wake_fd, &value);
+		}
+
+		for (int i = 1; i < nfds; i++) {
+			if (fds[i].revents & POLLOUT) {
+				socket_send(fds[i].fd);
+			}
+			if (fds[i].revents & POLLIN) {
+				socket_recv(fds[i].fd);
+			} else if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+				LOG_WRN("Socket %d events: 0x%x", fds[i].fd, fds[i].revents);
+				channel_close(fds[i].fd, true);
+			}
+		}
+	}
+}
+
+void slm_at_mux_start(void)
+{
+	eventfd_t value;
+
+	for (int i = 0; i < MUX_CHANNEL_COUNT; i++) {
+		mux.channels[i].fd = INVALID_SOCKET;
+		ring_buf_init(&mux.channels[i].ul_buf, sizeof(ul_bufs[i]), ul_bufs[i]);
+	}
+	slm_mux_decoder_init(&mux.decoder, frame_buf, sizeof(frame_buf), frame_handler, NULL);
+	(void)eventfd_read(mux.wake_fd, &value);
+
+	atomic_set(&mux.active, true);
+	k_thread_create(&mux_thread, mux_thread_stack,
+			K_THREAD_STACK_SIZEOF(mux_thread_stack),
+			mux_thread_func, NULL, NULL, NULL,
+			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+
+	LOG_INF("Enter multiplexing mode");
+}
+
+bool slm_at_mux_is_active(void)
+{
+	return atomic_get(&mux.active);
+}
+
+size_t slm_at_mux_rx(const uint8_t *data, size_t len)
+{
+	return slm_mux_decode(&mux.decoder, data, len);
+}
+
+int slm_at_mux_at_write(const uint8_t *data, size_t len)
+{
+	size_t size;
+	int err;
+
+	while (len > 0) {
+		size = MIN(len, CONFIG_SLM_MUX_MTU);
+		err = frame_send(SLM_MUX_CHANNEL_AT, SLM_MUX_TYPE_DATA, data, size);
+		if (err) {
+			return err;
+		}
+		data += size;
+		len -= size;
+	}
+
+	return 0;
+}
+
+/**@brief handle AT#XMUX commands
+ *  AT#XMUX=<op>
+ *  AT#XMUX?
+ *  AT#XMUX=?
+ */
+int handle_at_mux(enum at_cmd_type cmd_type)
+{
+	int err = -EINVAL;
+	uint16_t op;
+
+	switch (cmd_type) {
+	case AT_CMD_TYPE_SET_COMMAND:
+		err = at_params_unsigned_short_get(&at_param_list, 1, &op);
+		if (err) {
+			return err;
+		}
+		if (op != SLM_MUX_OP_START) {
+			LOG_ERR("Invalid op: %d", op);
+			return -EINVAL;
+		}
+		if (slm_at_mux_is_active()) {
+			return -EALREADY;
+		}
+		if (k_work_busy_get(&mux_stop_work) != 0) {
+			/* The thread of the previous multiplexing mode is still running. */
+			return -EBUSY;
+		}
+		enter_muxmode();
+		break;
+
+	case AT_CMD_TYPE_READ_COMMAND:
+		rsp_send("\r\n#XMUX: %d,%d\r\n", slm_at_mux_is_active(), CONFIG_SLM_MUX_MTU);
+		err = 0;
+		break;
+
+	case AT_CMD_TYPE_TEST_COMMAND:
+		rsp_send("\r\n#XMUX: (%d)\r\n", SLM_MUX_OP_START);
+		err = 0;
+		break;
+
+	default:
+		break;
+	}
+
+	return err;
+}
+
+int slm_at_mux_init(slm_uart_rx_callback_t at_rx)
+{
+	mux.at_rx = at_rx;
+	atomic_set(&mux.active, false);
+	k_work_init(&mux_stop_work, mux_stop_work_fn);
+
+	mux.wake_fd = eventfd(0, EFD_NONBLOCK);
+	if (mux.wake_fd < 0) {
+		LOG_ERR("eventfd() failed: %d", -errno);
+		return -errno;
+	}
+
+	return 0;
+}
+
+int slm_at_mux_uninit(void)
+{
+	struct k_work_sync sync;
+
+	if (mux_stop()) {
+		mux_join();
+	}
+	(void)k_work_flush(&mux_stop_work, &sync);
+
+	if (mux.wake_fd != INVALID_SOCKET) {
+		(void)close(mux.wake_fd);
+		mux.wake_fd = INVALID_SOCKET;
+	}
+
+	return 0;
+}
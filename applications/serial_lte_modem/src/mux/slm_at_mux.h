@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLM_AT_MUX_
+#define SLM_AT_MUX_
+
+/**@file slm_at_mux.h
+ *
+ * @brief Vendor-specific AT command for multiplexing mode.
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include "slm_uart_handler.h"
+
+/** Channel of AT commands, responses and notifications. */
+#define SLM_MUX_CHANNEL_AT 0
+
+/** Channel of the socket with the given file descriptor. */
+#define SLM_MUX_CHANNEL_SOCKET(fd) ((fd) + 1)
+
+/**
+ * @brief Initialize multiplexing.
+ *
+ * @param at_rx Callback for data received on the AT channel.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_at_mux_init(slm_uart_rx_callback_t at_rx);
+
+/**
+ * @brief Uninitialize multiplexing. Stops the multiplexing mode.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_at_mux_uninit(void);
+
+/**
+ * @brief Start the multiplexing mode.
+ */
+void slm_at_mux_start(void);
+
+/**
+ * @brief Check whether the multiplexing mode is active.
+ *
+ * @retval true if yes, false if no.
+ */
+bool slm_at_mux_is_active(void);
+
+/**
+ * @brief Decode data received from UART in multiplexing mode.
+ *
+ * Stops after the frame that exits the multiplexing mode.
+ *
+ * @param data Received data.
+ * @param len Length of the data.
+ *
+ * @return Number of bytes decoded. The rest of the data is not framed.
+ */
+size_t slm_at_mux_rx(const uint8_t *data, size_t len);
+
+/**
+ * @brief Send data on the AT channel.
+ *
+ * @param data Data to send.
+ * @param len Length of the data.
+ *
+ * @retval 0 If the data was successfully written to buffer.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_at_mux_at_write(const uint8_t *data, size_t len);
+
+/** @} */
+
+#endif /* SLM_AT_MUX_ */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+#include "slm_mux_frame.h"
+
+#define FCS_INIT 0xFF
+
+void slm_mux_header_encode(uint8_t header[SLM_MUX_HEADER_SIZE],
+			   uint8_t channel, uint8_t type, uint16_t len)
+{
+	header[0] = SLM_MUX_SOF;
+	header[1] = channel;
+	header[2] = type;
+	sys_put_le16(len, &header[3]);
+}
+
+uint8_t slm_mux_fcs(const uint8_t header[SLM_MUX_HEADER_SIZE], const uint8_t *payload,
+		    uint16_t len)
+{
+	/* The start of frame is not covered. */
+	uint8_t fcs = crc8_ccitt(FCS_INIT, &header[1], SLM_MUX_HEADER_SIZE - 1);
+
+	return crc8_ccitt(fcs, payload, len);
+}
+
+size_t slm_mux_frame_encode(uint8_t *buf, size_t size, uint8_t channel, uint8_t type,
+			    const uint8_t *payload, uint16_t len)
+{
+	if (size < SLM_MUX_FRAME_SIZE(len)) {
+		return 0;
+	}
+
+	slm_mux_header_encode(buf, channel, type, len);
+	if (len > 0) {
+		memcpy(&buf[SLM_MUX_HEADER_SIZE], payload, len);
+	}
+	buf[SLM_MUX_HEADER_SIZE + len] = slm_mux_fcs(buf, payload, len);
+
+	return SLM_MUX_FRAME_SIZE(len);
+}
+
+void slm_mux_decoder_init(struct slm_mux_decoder *decoder, uint8_t *buf, size_t buf_size,
+			  slm_mux_frame_handler_t handler, void *ctx)
+{
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->handler = handler;
+	decoder->ctx = ctx;
+	decoder->buf = buf;
+	decoder->buf_size = buf_size;
+}
+
+static void frame_end(struct slm_mux_decoder *decoder, uint8_t fcs)
+{
+	struct slm_mux_frame frame = {
+		.channel = decoder->header[1],
+		.type = decoder->header[2],
+		.len = decoder->len,
+		.payload = decoder->buf,
+	};
+
+	if (fcs == slm_mux_fcs(decoder->header, decoder->buf, decoder->len)) {
+		decoder->handler(&frame, decoder->ctx);
+	} else {
+		decoder->errors++;
+	}
+	decoder->pos = 0;
+}
+
+size_t slm_mux_decode(struct slm_mux_decoder *decoder, const uint8_t *data, size_t len)
+{
+	size_t i = 0;
+	size_t count;
+
+	while (i < len && !decoder->stopped) {
+		if (decoder->pos == 0) {
+			/* Hunt for the start of a frame. */
+			if (data[i++] == SLM_MUX_SOF) {
+				decoder->header[decoder->pos++] = SLM_MUX_SOF;
+			}
+		} else if (decoder->pos < SLM_MUX_HEADER_SIZE) {
+			decoder->header[decoder->pos++] = data[i++];
+			if (decoder->pos == SLM_MUX_HEADER_SIZE) {
+				decoder->len = sys_get_le16(&decoder->header[3]);
+				if (decoder->len > decoder->buf_size) {
+					decoder->errors++;
+					decoder->pos = 0;
+				}
+			}
+		} else if (decoder->pos < SLM_MUX_HEADER_SIZE + decoder->len) {
+			/* Copy as much of the payload as there is. */
+			count = MIN(len - i, SLM_MUX_HEADER_SIZE + decoder->len - decoder->pos);
+			memcpy(&decoder->buf[decoder->pos - SLM_MUX_HEADER_SIZE], &data[i], count);
+			decoder->pos += count;
+			i += count;
+		} else {
+			frame_end(decoder, data[i++]);
+		}
+	}
+
+	return i;
+}
+
+void slm_mux_decoder_stop(struct slm_mux_decoder *decoder)
+{
+	decoder->stopped = true;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLM_MUX_FRAME_
+#define SLM_MUX_FRAME_
+
+/**@file slm_mux_frame.h
+ *
+ * @brief Binary frames of the multiplexing mode of serial LTE modem
+ *
+ * A frame is encoded as follows, with the length in little endian:
+ *
+ *   | 0xF9 | channel | type | length (2) | payload (length) | FCS |
+ *
+ * The frame check sequence is the CRC-8-CCITT of the channel, type, length and payload.
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Start of a frame. */
+#define SLM_MUX_SOF 0xF9
+
+/** Size of the header, including the start of frame. */
+#define SLM_MUX_HEADER_SIZE 5
+
+/** Size of the frame check sequence. */
+#define SLM_MUX_FCS_SIZE 1
+
+/** Size of a frame with a payload of the given length. */
+#define SLM_MUX_FRAME_SIZE(len) (SLM_MUX_HEADER_SIZE + (len) + SLM_MUX_FCS_SIZE)
+
+/** @brief Frame types. */
+enum slm_mux_frame_type {
+	/** Data of the channel. */
+	SLM_MUX_TYPE_DATA,
+	/** Attach a channel. The payload is the credit of the sender, two bytes in little endian. */
+	SLM_MUX_TYPE_OPEN,
+	/** More credit for a channel, two bytes in little endian. */
+	SLM_MUX_TYPE_CREDIT,
+	/** Detach a channel. No payload. */
+	SLM_MUX_TYPE_CLOSE,
+};
+
+/** @brief Decoded frame. */
+struct slm_mux_frame {
+	uint8_t channel;
+	uint8_t type;
+	uint16_t len;
+	const uint8_t *payload;
+};
+
+/**@brief Handler of decoded frames.
+ *
+ * @param frame Decoded frame. The payload is valid only during the call.
+ * @param ctx Context given to @ref slm_mux_decoder_init.
+ */
+typedef void (*slm_mux_frame_handler_t)(const struct slm_mux_frame *frame, void *ctx);
+
+/** @brief Frame decoder state. */
+struct slm_mux_decoder {
+	slm_mux_frame_handler_t handler;
+	void *ctx;
+	uint8_t *buf;
+	size_t buf_size;
+	uint8_t header[SLM_MUX_HEADER_SIZE];
+	size_t pos;
+	uint16_t len;
+	/** Number of frames that were dropped because of a wrong FCS or length. */
+	uint32_t errors;
+	/** Set by @ref slm_mux_decoder_stop. */
+	bool stopped;
+};
+
+/**
+ * @brief Encode the header of a frame
+ *
+ * @param header Header to encode.
+ * @param channel Channel of the frame.
+ * @param type Type of the frame.
+ * @param len Length of the payload.
+ */
+void slm_mux_header_encode(uint8_t header[SLM_MUX_HEADER_SIZE],
+			   uint8_t channel, uint8_t type, uint16_t len);
+
+/**
+ * @brief Calculate the frame check sequence of a frame
+ *
+ * @param header Encoded header.
+ * @param payload Payload of the frame.
+ * @param len Length of the payload.
+ *
+ * @return Frame check sequence.
+ */
+uint8_t slm_mux_fcs(const uint8_t header[SLM_MUX_HEADER_SIZE], const uint8_t *payload,
+		    uint16_t len);
+
+/**
+ * @brief Encode a frame to a buffer
+ *
+ * @param buf Buffer for the frame.
+ * @param size Size of the buffer.
+ * @param channel Channel of the frame.
+ * @param type Type of the frame.
+ * @param payload Payload of the frame.
+ * @param len Length of the payload.
+ *
+ * @return Size of the encoded frame, or 0 if it does not fit to the buffer.
+ */
+size_t slm_mux_frame_encode(uint8_t *buf, size_t size, uint8_t channel, uint8_t type,
+			    const uint8_t *payload, uint16_t len);
+
+/**
+ * @brief Initialize a frame decoder
+ *
+ * @param decoder Decoder to initialize.
+ * @param buf Buffer for the payload of a frame.
+ * @param buf_size Size of the buffer. Longer frames are dropped.
+ * @param handler Handler of decoded frames.
+ * @param ctx Context passed to the handler.
+ */
+void slm_mux_decoder_init(struct slm_mux_decoder *decoder, uint8_t *buf, size_t buf_size,
+			  slm_mux_frame_handler_t handler, void *ctx);
+
+/**
+ * @brief Decode received data
+ *
+ * Calls the handler for each complete frame. Data outside of frames is skipped.
+ *
+ * @param decoder Decoder.
+ * @param data Received data.
+ * @param len Length of the data.
+ *
+ * @return Number of bytes decoded. Less than @p len if the decoder was stopped.
+ */
+size_t slm_mux_decode(struct slm_mux_decoder *decoder, const uint8_t *data, size_t len);
+
+/**
+ * @brief Stop a frame decoder
+ *
+ * Called from the handler, when the data after the frame is not framed.
+ * @ref slm_mux_decode returns after the frame, and decodes nothing after that.
+ *
+ * @param decoder Decoder.
+ */
+void slm_mux_decoder_stop(struct slm_mux_decoder *decoder);
+
+/** @} */
+
+#endif /* SLM_MUX_FRAME_ */
@@ -24,6 +24,8 @@
 #include "slm_util.h"
 #include "slm_settings.h"
 #include "slm_at_host.h"
+#include "slm_at_dispatch.h"
+#include "slm_proxy_poll.h"
 #include "slm_at_tcp_proxy.h"
 #include "slm_at_udp_proxy.h"
 #include "slm_at_socket.h"
@@ -70,9 +72,6 @@ enum sleep_modes {
 	SLEEP_MODE_IDLE
 };
 
-/** @brief AT command handler type. */
-typedef int (*slm_at_handler_t) (enum at_cmd_type);
-
 static struct slm_work_info {
 	struct k_work_delayable uart_work;
 	struct k_work_delayable sleep_work;
@@ -504,14 +503,15 @@ int handle_at_gpio_configure(enum at_cmd_type cmd_type);
 int handle_at_gpio_operate(enum at_cmd_type cmd_type);
 #endif
 
+#if defined(CONFIG_SLM_MUX)
+int handle_at_mux(enum at_cmd_type cmd_type);
+#endif
+
 #if defined(CONFIG_SLM_CARRIER)
 int handle_at_carrier(enum at_cmd_type cmd_type);
 #endif
 
-static struct slm_at_cmd {
-	char *string;
-	slm_at_handler_t handler;
-} slm_at_cmd_list[] = {
+static const struct slm_at_cmd slm_at_cmd_list[] = {
 	/* Generic commands */
 	{"AT#XSLMVER", handle_at_slmver},
 	{"AT#XSLEEP", handle_at_sleep},
@@ -618,12 +618,18 @@ static struct slm_at_cmd {
 	{"AT#XGPIO", handle_at_gpio_operate},
 #endif
 
+#if defined(CONFIG_SLM_MUX)
+	{"AT#XMUX", handle_at_mux},
+#endif
+
 #if defined(CONFIG_SLM_CARRIER)
 	{"AT#XCARRIER", handle_at_carrier},
 #endif
 
 };
 
+static struct slm_at_dispatch slm_at_dispatch;
+
 int handle_at_clac(enum at_cmd_type cmd_type)
 {
 	int ret = -EINVAL;
@@ -642,34 +648,47 @@ int handle_at_clac(enum at_cmd_type cmd_type)
 
 int slm_at_parse(const char *at_cmd)
 {
-	int ret = UNKNOWN_AT_COMMAND_RET;
-	int total = ARRAY_SIZE(slm_at_cmd_list);
+	int ret;
+	enum at_cmd_type type;
+	const struct slm_at_cmd *cmd = slm_at_dispatch_find(&slm_at_dispatch, at_cmd);
 
-	for (int i = 0; i < total; i++) {
-		if (slm_util_cmd_casecmp(at_cmd, slm_at_cmd_list[i].string)) {
-			enum at_cmd_type type = at_parser_cmd_type_get(at_cmd);
+	if (cmd == NULL) {
+		return UNKNOWN_AT_COMMAND_RET;
+	}
 
-			at_params_list_clear(&at_param_list);
-			ret = at_parser_params_from_str(at_cmd, NULL, &at_param_list);
-			if (ret) {
-				LOG_ERR("Failed to parse AT command %d", ret);
-				return -EINVAL;
-			}
-			ret = slm_at_cmd_list[i].handler(type);
-			break;
+	type = at_parser_cmd_type_get(at_cmd);
+
+	at_params_list_clear(&at_param_list);
+	/* Only set commands have parameters, don't spend time and heap parsing the others. */
+	if (type == AT_CMD_TYPE_SET_COMMAND) {
+		ret = at_parser_params_from_str(at_cmd, NULL, &at_param_list);
+		if (ret) {
+			LOG_ERR("Failed to parse AT command %d", ret);
+			return -EINVAL;
 		}
 	}
 
-	return ret;
+	return cmd->handler(type);
 }
 
 int slm_at_init(void)
 {
 	int err;
 
+	err = slm_at_dispatch_init(&slm_at_dispatch, slm_at_cmd_list, ARRAY_SIZE(slm_at_cmd_list));
+	if (err) {
+		LOG_ERR("AT command table could not be indexed: %d", err);
+		return -EFAULT;
+	}
+
 	k_work_init_delayable(&slm_work.uart_work, set_uart_wk);
 	k_work_init_delayable(&slm_work.sleep_work, go_sleep_wk);
 
+	err = slm_proxy_poll_init();
+	if (err) {
+		LOG_ERR("Proxy event loop could not be initialized: %d", err);
+		return -EFAULT;
+	}
 	err = slm_at_tcp_proxy_init();
 	if (err) {
 		LOG_ERR("TCP Server could not be initialized: %d", err);
@@ -781,6 +800,10 @@ void slm_at_uninit(void)
 	if (err) {
 		LOG_WRN("UDP Server could not be uninitialized: %d", err);
 	}
+	err = slm_proxy_poll_uninit();
+	if (err) {
+		LOG_WRN("Proxy event loop could not be uninitialized: %d", err);
+	}
 	err = slm_at_socket_uninit();
 	if (err) {
 		LOG_WRN("TCPIP could not be uninitialized: %d", err);
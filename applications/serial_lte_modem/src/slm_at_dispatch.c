@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include "slm_at_dispatch.h"
+
+BUILD_ASSERT(IS_POWER_OF_TWO(SLM_AT_DISPATCH_SLOTS));
+
+/* "AT" and the separator, that is, '+', '%' or '#'. */
+#define AT_CMD_PREFIX_LEN 3
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+/* Length of the command name, see slm_at_dispatch_find(). */
+static size_t cmd_name_len(const char *at_cmd)
+{
+	size_t len = 0;
+
+	while (len < AT_CMD_PREFIX_LEN && at_cmd[len] != '\0') {
+		len++;
+	}
+	while (isalnum((int)at_cmd[len])) {
+		len++;
+	}
+
+	return len;
+}
+
+/* FNV-1a hash of the command name in upper case. */
+static uint32_t cmd_name_hash(const char *name, size_t len)
+{
+	uint32_t hash = FNV_OFFSET_BASIS;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)toupper((int)name[i]);
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+static bool cmd_name_equal(const char *name, size_t len, const char *slm_cmd)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (toupper((int)name[i]) != toupper((int)slm_cmd[i])) {
+			/* Also stops at the end of slm_cmd. */
+			return false;
+		}
+	}
+
+	return slm_cmd[len] == '\0';
+}
+
+/* Returns the slot of the name, or the empty slot where it would be stored. */
+static size_t slot_find(const struct slm_at_dispatch *dispatch, const char *name, size_t len)
+{
+	size_t slot = cmd_name_hash(name, len) & (SLM_AT_DISPATCH_SLOTS - 1);
+	uint8_t index;
+
+	/* Linear probing. There is always an empty slot, so this terminates. */
+	while ((index = dispatch->slots[slot]) != 0) {
+		if (cmd_name_equal(name, len, dispatch->list[index - 1].string)) {
+			break;
+		}
+		slot = (slot + 1) & (SLM_AT_DISPATCH_SLOTS - 1);
+	}
+
+	return slot;
+}
+
+int slm_at_dispatch_init(struct slm_at_dispatch *dispatch,
+			 const struct slm_at_cmd *list, size_t count)
+{
+	size_t slot;
+
+	if (count >= MIN(SLM_AT_DISPATCH_SLOTS, UINT8_MAX)) {
+		return -ENOMEM;
+	}
+
+	memset(dispatch->slots, 0, sizeof(dispatch->slots));
+	dispatch->list = list;
+
+	for (size_t i = 0; i < count; i++) {
+		slot = slot_find(dispatch, list[i].string, strlen(list[i].string));
+		if (dispatch->slots[slot] != 0) {
+			return -EEXIST;
+		}
+		dispatch->slots[slot] = i + 1;
+	}
+
+	return 0;
+}
+
+const struct slm_at_cmd *slm_at_dispatch_find(const struct slm_at_dispatch *dispatch,
+					      const char *at_cmd)
+{
+	size_t len = cmd_name_len(at_cmd);
+	uint8_t index = dispatch->slots[slot_find(dispatch, at_cmd, len)];
+
+	return (index != 0) ? &dispatch->list[index - 1] : NULL;
+}
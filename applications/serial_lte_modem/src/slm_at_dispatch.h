@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLM_AT_DISPATCH_
+#define SLM_AT_DISPATCH_
+
+/**@file slm_at_dispatch.h
+ *
+ * @brief Lookup of proprietary AT commands by name for serial LTE modem
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <modem/at_cmd_parser.h>
+
+/** @brief AT command handler type. */
+typedef int (*slm_at_handler_t) (enum at_cmd_type);
+
+/** @brief AT command table entry. */
+struct slm_at_cmd {
+	const char *string;
+	slm_at_handler_t handler;
+};
+
+/** Number of hash slots. Must be a power of two and larger than the number of commands. */
+#define SLM_AT_DISPATCH_SLOTS 128
+
+/** @brief Hash index of an AT command table. */
+struct slm_at_dispatch {
+	const struct slm_at_cmd *list;
+	/* Index to the list plus one, zero for an empty slot. */
+	uint8_t slots[SLM_AT_DISPATCH_SLOTS];
+};
+
+/**
+ * @brief Build the hash index of an AT command table
+ *
+ * @param dispatch Index to build.
+ * @param list AT command table. Must stay valid as long as the index is used.
+ * @param count Number of entries in the table.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOMEM If the table has too many entries.
+ * @retval -EEXIST If a command name is in the table twice.
+ */
+int slm_at_dispatch_init(struct slm_at_dispatch *dispatch,
+			 const struct slm_at_cmd *list, size_t count);
+
+/**
+ * @brief Find the table entry of an AT command
+ *
+ * The command name is compared ignoring case. It ends at the first character after
+ * the "AT" prefix and the separator that is not alphanumeric.
+ *
+ * @param dispatch Index of the table.
+ * @param at_cmd Command string received from UART.
+ *
+ * @return Table entry, or NULL if the command is not in the table.
+ */
+const struct slm_at_cmd *slm_at_dispatch_find(const struct slm_at_dispatch *dispatch,
+					      const char *at_cmd);
+
+/** @} */
+
+#endif /* SLM_AT_DISPATCH_ */
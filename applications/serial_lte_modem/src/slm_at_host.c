@@ -14,6 +14,9 @@
 #include "slm_at_host.h"
 #include "slm_at_fota.h"
 #include "slm_uart_handler.h"
+#if defined(CONFIG_SLM_MUX)
+#include "slm_at_mux.h"
+#endif
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(slm_at_host, CONFIG_SLM_LOG_LEVEL);
@@ -38,6 +41,7 @@ enum slm_operation_mode {
 static enum slm_operation_mode slm_mode;
 static slm_datamode_handler_t datamode_handler;
 static int datamode_handler_result;
+static bool datamode_stream; /* Data is passed to the handler as soon as it is received. */
 uint16_t datamode_time_limit;	/* Send trigger by time in data mode */
 K_MUTEX_DEFINE(mutex_mode);  /* Protects the operation mode variables. */
 
@@ -51,6 +55,10 @@ K_MUTEX_DEFINE(mutex_data); /* Protects the data_rb and quit_str_partial_match.
 
 static struct k_work raw_send_scheduled_work;
 
+#if defined(CONFIG_SLM_MUX)
+static bool muxmode_pending; /* Enter multiplexing mode after the response is sent. */
+#endif
+
 /* global variable used across different files */
 struct at_param_list at_param_list;           /* For AT parser */
 
@@ -74,6 +82,17 @@ static enum slm_operation_mode get_slm_mode(void)
 	return mode;
 }
 
+/* Write to UART, or to the AT channel in multiplexing mode. */
+static int host_tx_write(const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_SLM_MUX)
+	if (slm_at_mux_is_active()) {
+		return slm_at_mux_at_write(data, len);
+	}
+#endif
+	return slm_uart_tx_write(data, len);
+}
+
 /* Lock mutex_mode, before calling. */
 static bool set_slm_mode(enum slm_operation_mode mode)
 {
@@ -114,6 +133,7 @@ static bool exit_datamode(void)
 			(void)datamode_handler(DATAMODE_EXIT, NULL, 0, SLM_DATAMODE_FLAGS_NONE);
 		}
 		datamode_handler = NULL;
+		datamode_stream = false;
 
 		k_mutex_lock(&mutex_data, K_FOREVER);
 		ring_buf_reset(&data_rb);
@@ -131,11 +151,45 @@ static bool exit_datamode(void)
 	return ret;
 }
 
+/* Pass data to the data mode handler. Returns the number of bytes that are done with,
+ * either sent or dropped.
+ */
+static size_t datamode_send(const uint8_t *data, size_t len, uint8_t flags)
+{
+	int size_sent;
+	size_t size_finish;
+
+	LOG_HEXDUMP_DBG(data, MIN(len, HEXDUMP_DATAMODE_MAX), "RX-DATA");
+
+	k_mutex_lock(&mutex_mode, K_FOREVER);
+	if (datamode_handler) {
+		size_sent = datamode_handler(DATAMODE_SEND, data, len, flags);
+		if (size_sent > 0) {
+			size_finish = size_sent;
+		} else if (size_sent == 0) {
+			size_finish = len;
+		} else {
+			LOG_WRN("Raw send failed, %zu dropped", len);
+			size_finish = len;
+		}
+	} else {
+		LOG_WRN("no handler, %zu dropped", len);
+		size_finish = len;
+	}
+	k_mutex_unlock(&mutex_mode);
+
+#if defined(CONFIG_SLM_DATAMODE_URC)
+	rsp_send("\r\n#XDATAMODE: %zu\r\n", size_finish);
+#endif
+
+	return size_finish;
+}
+
 /* Lock mutex_data, before calling. */
 static void raw_send(uint8_t flags)
 {
 	uint8_t *data = NULL;
-	int size_send, size_sent, size_all, size_finish;
+	int size_send, size_all;
 
 	/* NOTE ring_buf_get_claim() might not return full size */
 	do {
@@ -146,38 +200,24 @@ static void raw_send(uint8_t flags)
 		}
 		LOG_INF("Raw send: size_send: %d, data %p", size_send, (void *)data);
 		if (data != NULL && size_send > 0) {
-
 			/* Raw data sending */
-			size_finish = 0;
-
-			LOG_HEXDUMP_DBG(data, MIN(size_send, HEXDUMP_DATAMODE_MAX), "RX-DATA");
-			k_mutex_lock(&mutex_mode, K_FOREVER);
-			if (datamode_handler && size_send > 0) {
-				size_sent = datamode_handler(DATAMODE_SEND, data, size_send, flags);
-				if (size_sent > 0) {
-					size_finish += size_sent;
-				} else if (size_sent == 0) {
-					size_finish += size_send;
-				} else {
-					LOG_WRN("Raw send failed, %d dropped", size_send);
-					size_finish += size_send;
-				}
-				(void)ring_buf_get_finish(&data_rb, size_finish);
-			} else {
-				LOG_WRN("no handler, %d dropped", size_send);
-				(void)ring_buf_get_finish(&data_rb, size_send + size_finish);
-			}
-			k_mutex_unlock(&mutex_mode);
-
-#if defined(CONFIG_SLM_DATAMODE_URC)
-			rsp_send("\r\n#XDATAMODE: %d\r\n", size_finish);
-#endif
+			(void)ring_buf_get_finish(&data_rb, datamode_send(data, size_send, flags));
 		} else {
 			break;
 		}
 	} while (true);
 }
 
+/* Lock mutex_data, before calling. Sends data straight from the UART receive buffer. */
+static void stream_send(const uint8_t *buf, size_t len)
+{
+	size_t sent = 0;
+
+	while (sent < len) {
+		sent += datamode_send(buf + sent, len - sent, SLM_DATAMODE_FLAGS_NONE);
+	}
+}
+
 /* Lock mutex_data, before calling. */
 static void write_data_buf(const uint8_t *buf, size_t len)
 {
@@ -217,7 +257,7 @@ static void inactivity_timer_handler(struct k_timer *timer)
 	ARG_UNUSED(timer);
 
 	LOG_INF("time limit reached");
-	if (!ring_buf_is_empty(&data_rb)) {
+	if (!ring_buf_is_empty(&data_rb) || quit_str_partial_match > 0) {
 		k_work_submit(&raw_send_scheduled_work);
 	} else {
 		LOG_DBG("data buffer empty");
@@ -240,9 +280,7 @@ static size_t raw_rx_handler(const uint8_t *buf, const size_t len)
 	prev_quit_str_match_count = quit_str_partial_match;
 	quit_str_match = false;
 	quit_str_match_count = prev_quit_str_match_count;
-	if (prev_quit_str_match_count != 0) {
-		prev_quit_str_match = true;
-	}
+	prev_quit_str_match = (prev_quit_str_match_count != 0);
 
 	/* Find quit_str or partial match at the end of the buffer. */
 	for (processed = 0; processed < len && quit_str_match == false; processed++) {
@@ -262,8 +300,18 @@ static size_t raw_rx_handler(const uint8_t *buf, const size_t len)
 		/* Write data which was previously interpreted as a possible partial quit_str. */
 		write_data_buf(slm_quit_str, prev_quit_str_match_count);
 
-		/* Write data from buf until the start of the possible (partial) quit_str. */
-		write_data_buf(buf, processed - quit_str_match_count);
+		if (datamode_stream && ring_buf_is_empty(&data_rb)) {
+			/* Send data until the start of the possible (partial) quit_str without
+			 * copying it to the data mode buffer.
+			 */
+			stream_send(buf, processed - quit_str_match_count);
+		} else {
+			/* Write data from buf until the start of the possible (partial) quit_str. */
+			write_data_buf(buf, processed - quit_str_match_count);
+			if (datamode_stream) {
+				raw_send(SLM_DATAMODE_FLAGS_NONE);
+			}
+		}
 	} else {
 		/* Nothing to write this round.*/
 	}
@@ -456,6 +504,13 @@ static void cmd_send(uint8_t *buf, uint16_t cmd_length, uint16_t buf_size)
 	err = slm_at_parse((const char *)buf);
 	if (err == 0) {
 		rsp_send_ok();
+#if defined(CONFIG_SLM_MUX)
+		if (muxmode_pending) {
+			/* Everything after the OK response is framed. */
+			muxmode_pending = false;
+			slm_at_mux_start();
+		}
+#endif
 		return;
 	} else if (err != UNKNOWN_AT_COMMAND_RET) {
 		rsp_send_error();
@@ -478,7 +533,7 @@ static void cmd_send(uint8_t *buf, uint16_t cmd_length, uint16_t buf_size)
 	 */
 	if (strlen(buf) > strlen(CRLF_STR)) {
 		format_final_result(at_buf, strlen(at_buf), sizeof(at_buf));
-		err = slm_uart_tx_write(buf, strlen(buf));
+		err = host_tx_write(buf, strlen(buf));
 		if (err) {
 			LOG_ERR("AT command response failed: %d", err);
 		}
@@ -600,15 +655,36 @@ static size_t null_handler(const uint8_t *buf, const size_t len)
 	return processed;
 }
 
-static void rx_handler_callback(const uint8_t *buf, size_t len)
+/* Handle data received from UART, or from the AT channel if muxed is set. */
+static void host_rx(const uint8_t *buf, size_t len, bool muxed)
 {
 	enum slm_operation_mode mode;
 	size_t ret = 0;
 
+#if defined(CONFIG_SLM_MUX)
+	if (!muxed && slm_at_mux_is_active()) {
+		ret = slm_at_mux_rx(buf, len);
+		if (ret == len) {
+			return;
+		}
+		/* The host exited the multiplexing mode, the rest is not framed. */
+		buf += ret;
+		len -= ret;
+	}
+#endif
 	k_timer_stop(&inactivity_timer);
 
 	while (len > 0) {
 
+#if defined(CONFIG_SLM_MUX)
+		/* The rest of the data is framed, if the last command started multiplexing. */
+		if (!muxed && slm_at_mux_is_active()) {
+			ret = slm_at_mux_rx(buf, len);
+			buf += ret;
+			len -= ret;
+			continue;
+		}
+#endif
 		mode = get_slm_mode();
 
 		if (mode == SLM_AT_COMMAND_MODE) {
@@ -619,7 +695,7 @@ static void rx_handler_callback(const uint8_t *buf, size_t len)
 			ret = null_handler(buf, len);
 		} else {
 			LOG_ERR("Internal error: Unknown SLM mode.");
-			(void)slm_uart_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
+			(void)host_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
 			break;
 		}
 
@@ -628,7 +704,7 @@ static void rx_handler_callback(const uint8_t *buf, size_t len)
 			len -= ret;
 		} else {
 			LOG_ERR("Internal error: Command overflow.");
-			(void)slm_uart_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
+			(void)host_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
 			break;
 		}
 	}
@@ -639,24 +715,36 @@ static void rx_handler_callback(const uint8_t *buf, size_t len)
 	}
 }
 
+static void rx_handler_callback(const uint8_t *buf, size_t len)
+{
+	host_rx(buf, len, false);
+}
+
+#if defined(CONFIG_SLM_MUX)
+static void mux_at_rx(const uint8_t *buf, size_t len)
+{
+	host_rx(buf, len, true);
+}
+#endif
+
 AT_MONITOR(at_notify, ANY, notification_handler);
 
 static void notification_handler(const char *notification)
 {
 	if (get_slm_mode() == SLM_AT_COMMAND_MODE) {
-		(void)slm_uart_tx_write(CRLF_STR, strlen(CRLF_STR));
-		(void)slm_uart_tx_write(notification, strlen(notification));
+		(void)host_tx_write(CRLF_STR, strlen(CRLF_STR));
+		(void)host_tx_write(notification, strlen(notification));
 	}
 }
 
 void rsp_send_ok(void)
 {
-	(void)slm_uart_tx_write(OK_STR, sizeof(OK_STR) - 1);
+	(void)host_tx_write(OK_STR, sizeof(OK_STR) - 1);
 }
 
 void rsp_send_error(void)
 {
-	(void)slm_uart_tx_write(ERROR_STR, sizeof(ERROR_STR) - 1);
+	(void)host_tx_write(ERROR_STR, sizeof(ERROR_STR) - 1);
 }
 
 void rsp_send(const char *fmt, ...)
@@ -667,17 +755,17 @@ void rsp_send(const char *fmt, ...)
 	vsnprintf(rsp_buf, sizeof(rsp_buf), fmt, arg_ptr);
 	va_end(arg_ptr);
 
-	(void)slm_uart_tx_write(rsp_buf, strlen(rsp_buf));
+	(void)host_tx_write(rsp_buf, strlen(rsp_buf));
 }
 
 void data_send(const uint8_t *data, size_t len)
 {
 	LOG_HEXDUMP_DBG(data, MIN(len, HEXDUMP_DATAMODE_MAX), "TX-DATA");
-	(void)slm_uart_tx_write(data, len);
+	(void)host_tx_write(data, len);
 }
 
 
-int enter_datamode(slm_datamode_handler_t handler)
+static int datamode_enter(slm_datamode_handler_t handler, bool stream)
 {
 	k_mutex_lock(&mutex_mode, K_FOREVER);
 
@@ -692,6 +780,7 @@ int enter_datamode(slm_datamode_handler_t handler)
 	k_mutex_unlock(&mutex_data);
 
 	datamode_handler = handler;
+	datamode_stream = stream;
 	if (datamode_time_limit == 0) {
 		if (slm_uart.baudrate > 0) {
 			datamode_time_limit = CONFIG_SLM_UART_RX_BUF_SIZE * (8 + 1 + 1) * 1000 /
@@ -702,13 +791,30 @@ int enter_datamode(slm_datamode_handler_t handler)
 			datamode_time_limit = 1000;
 		}
 	}
-	LOG_INF("Enter datamode");
+	LOG_INF("Enter datamode%s", stream ? " (stream)" : "");
 
 	k_mutex_unlock(&mutex_mode);
 
 	return 0;
 }
 
+#if defined(CONFIG_SLM_MUX)
+void enter_muxmode(void)
+{
+	muxmode_pending = true;
+}
+#endif
+
+int enter_datamode(slm_datamode_handler_t handler)
+{
+	return datamode_enter(handler, false);
+}
+
+int enter_datamode_stream(slm_datamode_handler_t handler)
+{
+	return datamode_enter(handler, IS_ENABLED(CONFIG_SLM_DATAMODE_STREAM));
+}
+
 bool in_datamode(void)
 {
 	return (get_slm_mode() == SLM_DATA_MODE);
@@ -725,6 +831,7 @@ bool exit_datamode_handler(int result)
 			(void)datamode_handler(DATAMODE_EXIT, NULL, 0, SLM_DATAMODE_FLAGS_NONE);
 		}
 		datamode_handler = NULL;
+		datamode_stream = false;
 		datamode_handler_result = result;
 		ret = true;
 
@@ -786,6 +893,13 @@ int slm_at_host_init(void)
 
 	k_work_init(&raw_send_scheduled_work, raw_send_scheduled);
 
+#if defined(CONFIG_SLM_MUX)
+	err = slm_at_mux_init(mux_at_rx);
+	if (err) {
+		return err;
+	}
+#endif
+
 	err = slm_uart_handler_init(rx_handler_callback);
 	if (err) {
 		return err;
@@ -811,6 +925,10 @@ void slm_at_host_uninit(void)
 
 	slm_at_uninit();
 
+#if defined(CONFIG_SLM_MUX)
+	(void)slm_at_mux_uninit();
+#endif
+
 	/* Power off UART module */
 	slm_uart_handler_uninit();
 
@@ -91,6 +91,26 @@ void data_send(const uint8_t *data, size_t len);
  */
 int enter_datamode(slm_datamode_handler_t handler);
 
+/**
+ * @brief Request SLM AT host to enter data mode for a stream socket
+ *
+ * Same as @ref enter_datamode, but with CONFIG_SLM_DATAMODE_STREAM the received data is
+ * passed to the handler as soon as it is received, without buffering.
+ *
+ * @param handler Data mode handler provided by requesting module
+ *
+ * @retval 0 If the operation was successful.
+ *         Otherwise, a (negative) error code is returned.
+ */
+int enter_datamode_stream(slm_datamode_handler_t handler);
+
+/**
+ * @brief Request SLM AT host to enter multiplexing mode
+ *
+ * The multiplexing mode starts after the OK response of the current command.
+ */
+void enter_muxmode(void);
+
 /**
  * @brief Check whether SLM AT host is in data mode
  *
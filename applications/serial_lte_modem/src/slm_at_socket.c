@@ -1425,6 +1425,8 @@ int handle_at_send(enum at_cmd_type cmd_type)
 				return err;
 			}
 			err = do_send(data, size);
+		} else if (sock.type == SOCK_STREAM) {
+			err = enter_datamode_stream(socket_datamode_callback);
 		} else {
 			err = enter_datamode(socket_datamode_callback);
 		}
@@ -1688,3 +1690,8 @@ int slm_at_socket_uninit(void)
 
 	return 0;
 }
+
+bool slm_at_socket_is_opened(int fd)
+{
+	return is_opened_socket(fd) || (fd != INVALID_SOCKET && fd == sock.fd_peer);
+}
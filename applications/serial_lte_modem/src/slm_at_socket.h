@@ -13,6 +13,8 @@
  * @{
  */
 
+#include <stdbool.h>
+
 /**
  * @brief Initialize socket AT command parser.
  *
@@ -28,6 +30,15 @@ int slm_at_socket_init(void);
  *           Otherwise, a (negative) error code is returned.
  */
 int slm_at_socket_uninit(void);
+
+/**
+ * @brief Check whether a socket was opened with the socket AT commands.
+ *
+ * @param fd Socket handle. The peer socket accepted by a server also counts.
+ *
+ * @retval true If the socket is open.
+ */
+bool slm_at_socket_is_opened(int fd);
 /** @} */
 
 #endif /* SLM_AT_SOCKET_ */
@@ -11,16 +11,20 @@
 #include "slm_util.h"
 #include "slm_native_tls.h"
 #include "slm_at_host.h"
+#include "slm_proxy_poll.h"
 #include "slm_at_tcp_proxy.h"
 
 LOG_MODULE_REGISTER(slm_tcp, CONFIG_SLM_LOG_LEVEL);
 
-#define THREAD_STACK_SIZE	KB(4)
-#define THREAD_PRIORITY		K_LOWEST_APPLICATION_THREAD_PRIO
-
 /* Some features need future modem firmware support */
 #define SLM_TCP_PROXY_FUTURE_FEATURE	0
 
+#define TCP_PEERS	CONFIG_SLM_TCP_SERVER_CONNECTIONS
+
+/* The listening socket, the connections and a UDP socket. */
+BUILD_ASSERT(CONFIG_SLM_PROXY_POLL_SOCKETS >= TCP_PEERS + 2,
+	     "CONFIG_SLM_PROXY_POLL_SOCKETS too small for CONFIG_SLM_TCP_SERVER_CONNECTIONS");
+
 /**@brief Proxy operations. */
 enum slm_tcp_proxy_operation {
 	SERVER_STOP,
@@ -37,25 +41,37 @@ enum slm_tcp_role {
 	TCP_ROLE_SERVER
 };
 
-static struct k_thread tcp_thread;
-static K_THREAD_STACK_DEFINE(tcp_thread_stack, THREAD_STACK_SIZE);
-static bool server_stop_pending;
+/**@brief States of a connection accepted by the TCP server. */
+enum slm_tcp_peer_state {
+	TCP_PEER_FREE,		/* Not connected */
+	TCP_PEER_CONNECTED,	/* Received data is sent with #XTCPDATA */
+	TCP_PEER_DATAMODE,	/* Data is exchanged in data mode */
+	TCP_PEER_PAUSED		/* Not received while another connection is in data mode */
+};
+
+struct tcp_peer {
+	int sock;			/* Socket descriptor. */
+	enum slm_tcp_peer_state state;
+};
 
 static struct tcp_proxy {
 	int sock;		/* Socket descriptor. */
 	int family;		/* Socket address family */
 	sec_tag_t sec_tag;	/* Security tag of the credential */
-	int sock_peer;		/* Socket descriptor for peer. */
+	struct tcp_peer peers[TCP_PEERS];	/* Connections accepted by the server. */
+	struct tcp_peer *peer;	/* Connection that #XTCPSEND and data mode send to. */
 	enum slm_tcp_role role;	/* Client or Server proxy */
 } proxy;
 
 /* global variable defined in different files */
 extern struct at_param_list at_param_list;
 extern uint8_t data_buf[SLM_MAX_MESSAGE_SIZE];
+extern struct k_work_q slm_work_q;
 
-/** forward declaration of thread function **/
-static void tcpcli_thread_func(void *p1, void *p2, void *p3);
-static void tcpsvr_thread_func(void *p1, void *p2, void *p3);
+/** forward declaration of socket event handlers **/
+static void tcpcli_event_handler(int fd, short revents, void *ctx);
+static void tcpsvr_listen_handler(int fd, short revents, void *ctx);
+static void tcpsvr_peer_handler(int fd, short revents, void *ctx);
 
 static int do_tcp_server_start(uint16_t port)
 {
@@ -186,17 +202,17 @@ static int do_tcp_server_start(uint16_t port)
 	}
 
 	/* Enable listen */
-	ret = listen(proxy.sock, 1);
+	ret = listen(proxy.sock, TCP_PEERS);
 	if (ret < 0) {
 		LOG_ERR("listen() failed: %d", -errno);
 		ret = -EINVAL;
 		goto exit_svr;
 	}
 
-	k_thread_create(&tcp_thread, tcp_thread_stack,
-			K_THREAD_STACK_SIZEOF(tcp_thread_stack),
-			tcpsvr_thread_func, NULL, NULL, NULL,
-			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	ret = slm_proxy_poll_add(proxy.sock, POLLIN, tcpsvr_listen_handler, NULL);
+	if (ret) {
+		goto exit_svr;
+	}
 	proxy.role = TCP_ROLE_SERVER;
 	rsp_send("\r\n#XTCPSVR: %d,\"started\"\r\n", proxy.sock);
 
@@ -218,9 +234,109 @@ exit_svr:
 	return ret;
 }
 
-static int do_tcp_server_stop(void)
+static struct tcp_peer *tcpsvr_peer_find(int sock)
 {
-	int ret;
+	for (int i = 0; i < TCP_PEERS; i++) {
+		if (proxy.peers[i].state != TCP_PEER_FREE && proxy.peers[i].sock == sock) {
+			return &proxy.peers[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct tcp_peer *tcpsvr_peer_free_find(void)
+{
+	for (int i = 0; i < TCP_PEERS; i++) {
+		if (proxy.peers[i].state == TCP_PEER_FREE) {
+			return &proxy.peers[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Data is received from a connection unless another one is in data mode. */
+static short tcpsvr_peer_events(const struct tcp_peer *peer)
+{
+	return (peer->state == TCP_PEER_PAUSED) ? 0 : POLLIN;
+}
+
+static void tcpsvr_peer_state_set(struct tcp_peer *peer, enum slm_tcp_peer_state state)
+{
+	peer->state = state;
+	(void)slm_proxy_poll_events_set(peer->sock, tcpsvr_peer_events(peer));
+}
+
+/* Applies the states changed on data mode exit. The event loop cannot be updated from the
+ * data mode callback, which may be called from a socket handler of the loop.
+ */
+static void tcpsvr_events_update(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	for (int i = 0; i < TCP_PEERS; i++) {
+		if (proxy.peers[i].state != TCP_PEER_FREE) {
+			(void)slm_proxy_poll_events_set(proxy.peers[i].sock,
+							tcpsvr_peer_events(&proxy.peers[i]));
+		}
+	}
+}
+
+static K_WORK_DEFINE(events_work, tcpsvr_events_update);
+
+/* The current connection goes to data mode, the others are paused. */
+static void tcpsvr_datamode_enter(void)
+{
+	for (int i = 0; i < TCP_PEERS; i++) {
+		if (proxy.peers[i].state == TCP_PEER_CONNECTED) {
+			tcpsvr_peer_state_set(&proxy.peers[i], (&proxy.peers[i] == proxy.peer) ?
+					      TCP_PEER_DATAMODE : TCP_PEER_PAUSED);
+		}
+	}
+}
+
+static void tcpsvr_datamode_exit(void)
+{
+	for (int i = 0; i < TCP_PEERS; i++) {
+		if (proxy.peers[i].state != TCP_PEER_FREE) {
+			proxy.peers[i].state = TCP_PEER_CONNECTED;
+		}
+	}
+	k_work_submit_to_queue(&slm_work_q, &events_work);
+}
+
+/* Server-initiated disconnect */
+static void tcpsvr_terminate_connection(struct tcp_peer *peer, int cause)
+{
+	int sock = peer->sock;
+
+	if (peer->state == TCP_PEER_DATAMODE && in_datamode()) {
+		(void)exit_datamode_handler(cause);
+	}
+	(void)slm_proxy_poll_remove(sock);
+	close(sock);
+	peer->sock = INVALID_SOCKET;
+	peer->state = TCP_PEER_FREE;
+	if (proxy.peer == peer) {
+		/* Send to one of the remaining connections, if any. */
+		proxy.peer = NULL;
+		for (int i = 0; i < TCP_PEERS; i++) {
+			if (proxy.peers[i].state != TCP_PEER_FREE) {
+				proxy.peer = &proxy.peers[i];
+				break;
+			}
+		}
+	}
+	/* Not reported in the data of another connection. */
+	if (!in_datamode()) {
+		rsp_send("\r\n#XTCPSVR: %d,\"disconnected\",%d\r\n", cause, sock);
+	}
+}
+
+static int tcpsvr_stop(int cause)
+{
+	int ret = 0;
 
 	if (proxy.sock == INVALID_SOCKET) {
 		return 0;
@@ -231,24 +347,25 @@ static int do_tcp_server_stop(void)
 		proxy.sec_tag = INVALID_SEC_TAG;
 	}
 #endif
-	server_stop_pending = true;
-	if (proxy.sock_peer != INVALID_SOCKET) {
-		(void)close(proxy.sock_peer);
-		proxy.sock_peer = INVALID_SOCKET;
-		rsp_send("\r\n#XTCPSVR: 0,\"disconnected\"\r\n");
-	} else {
-		ret = close(proxy.sock);
-		if (ret < 0) {
-			LOG_WRN("close() failed: %d", -errno);
-			return ret;
+	for (int i = 0; i < TCP_PEERS; i++) {
+		if (proxy.peers[i].state != TCP_PEER_FREE) {
+			tcpsvr_terminate_connection(&proxy.peers[i], cause);
 		}
-		proxy.sock = INVALID_SOCKET;
 	}
-	if (k_thread_join(&tcp_thread, K_SECONDS(CONFIG_SLM_TCP_POLL_TIME + 1)) != 0) {
-		LOG_WRN("Wait for thread terminate failed");
+	(void)slm_proxy_poll_remove(proxy.sock);
+	if (close(proxy.sock) < 0) {
+		LOG_WRN("close() failed: %d", -errno);
+		ret = -errno;
 	}
+	proxy.sock = INVALID_SOCKET;
+	rsp_send("\r\n#XTCPSVR: %d,\"stopped\"\r\n", cause);
 
-	return 0;
+	return ret;
+}
+
+static int do_tcp_server_stop(void)
+{
+	return tcpsvr_stop(0);
 }
 
 static int do_tcp_client_connect(const char *url, uint16_t port)
@@ -304,10 +421,10 @@ static int do_tcp_client_connect(const char *url, uint16_t port)
 		goto exit_cli;
 	}
 
-	k_thread_create(&tcp_thread, tcp_thread_stack,
-			K_THREAD_STACK_SIZEOF(tcp_thread_stack),
-			tcpcli_thread_func, NULL, NULL, NULL,
-			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	ret = slm_proxy_poll_add(proxy.sock, POLLIN, tcpcli_event_handler, NULL);
+	if (ret) {
+		goto exit_cli;
+	}
 
 	proxy.role = TCP_ROLE_CLIENT;
 	rsp_send("\r\n#XTCPCLI: %d,\"connected\"\r\n", proxy.sock);
@@ -322,37 +439,47 @@ exit_cli:
 	return ret;
 }
 
-static int do_tcp_client_disconnect(void)
+static int tcpcli_disconnect(int cause)
 {
 	int ret = 0;
 
 	if (proxy.sock == INVALID_SOCKET) {
 		return 0;
 	}
-	ret = close(proxy.sock);
-	if (ret < 0) {
+	(void)slm_proxy_poll_remove(proxy.sock);
+	if (close(proxy.sock) < 0) {
 		LOG_WRN("close() failed: %d", -errno);
 		ret = -errno;
-	} else {
-		proxy.sock = INVALID_SOCKET;
 	}
-	if (ret == 0 &&
-	    k_thread_join(&tcp_thread, K_SECONDS(CONFIG_SLM_TCP_POLL_TIME * 2)) != 0) {
-		LOG_WRN("Wait for thread terminate failed");
-	}
-	rsp_send("\r\n#XTCPCLI: %d,\"disconnected\"\r\n", ret);
+	proxy.sock = INVALID_SOCKET;
+	rsp_send("\r\n#XTCPCLI: %d,\"disconnected\"\r\n", ret ? ret : cause);
 
 	return ret;
 }
 
+static int do_tcp_client_disconnect(void)
+{
+	return tcpcli_disconnect(0);
+}
+
+/* Socket to send to: the client, or the current connection of the server. */
+static int tcp_send_sock(void)
+{
+	if (proxy.role == TCP_ROLE_SERVER) {
+		return proxy.peer ? proxy.peer->sock : INVALID_SOCKET;
+	}
+
+	return proxy.sock;
+}
+
 static int do_tcp_send(const uint8_t *data, int datalen)
 {
 	int ret = 0;
 	uint32_t offset = 0;
-	int sock = proxy.sock;
+	int sock = tcp_send_sock();
 
-	if (proxy.role == TCP_ROLE_SERVER) {
-		sock = proxy.sock_peer;
+	if (sock == INVALID_SOCKET) {
+		return -ENOTCONN;
 	}
 
 	while (offset < datalen) {
@@ -378,11 +505,7 @@ static int do_tcp_send_datamode(const uint8_t *data, int datalen)
 {
 	int ret = 0;
 	uint32_t offset = 0;
-	int sock = proxy.sock;
-
-	if (proxy.role == TCP_ROLE_SERVER) {
-		sock = proxy.sock_peer;
-	}
+	int sock = tcp_send_sock();
 
 	while (offset < datalen) {
 		ret = send(sock, data + offset, datalen - offset, 0);
@@ -408,243 +531,158 @@ static int tcp_datamode_callback(uint8_t op, const uint8_t *data, int len, uint8
 		LOG_INF("datamode send: %d", ret);
 	} else if (op == DATAMODE_EXIT) {
 		LOG_DBG("datamode exit");
+		if (proxy.role == TCP_ROLE_SERVER) {
+			tcpsvr_datamode_exit();
+		}
 	}
 
 	return ret;
 }
 
-/* Server-initiated disconnect */
-static void tcpsvr_terminate_connection(int cause)
+/* Map the error events of a socket to a disconnect cause, 0 if none */
+static int tcp_event_error(short revents)
 {
-	if (in_datamode()) {
-		(void)exit_datamode_handler(cause);
+	if ((revents & POLLERR) == POLLERR) {
+		LOG_ERR("POLLERR");
+		return -EIO;
 	}
-	if (proxy.sock_peer != INVALID_SOCKET) {
-		close(proxy.sock_peer);
-		proxy.sock_peer = INVALID_SOCKET;
-		rsp_send("\r\n#XTCPSVR: %d,\"disconnected\"\r\n", cause);
+	if ((revents & POLLNVAL) == POLLNVAL) {
+		LOG_WRN("POLLNVAL");
+		return -ENETDOWN;
 	}
+	if ((revents & POLLHUP) == POLLHUP) {
+		/* disconnected by remote or lose LTE connection */
+		LOG_WRN("POLLHUP");
+		return -ECONNRESET;
+	}
+
+	return 0;
 }
 
-/* TCP server thread */
-static void tcpsvr_thread_func(void *p1, void *p2, void *p3)
+static void tcp_data_recv(int fd, bool server)
 {
 	int ret;
-	struct pollfd fds[2];
-
-	ARG_UNUSED(p1);
-	ARG_UNUSED(p2);
-	ARG_UNUSED(p3);
-
-	fds[0].fd = proxy.sock;
-	fds[0].events = POLLIN;
-	/** The field fd contains a file descriptor for an open file.  If this field is negative,
-	 * then the corresponding events field is ignored and the revents field returns zero.
-	 */
-	fds[1].fd = INVALID_SOCKET;
-	fds[1].events = POLLIN;
-	while (true) {
-		ret = poll(fds, 2, MSEC_PER_SEC * CONFIG_SLM_TCP_POLL_TIME);
-		if (server_stop_pending) {  /* server wait to stop */
-			ret = 0;
-			break;
-		}
-		if (ret < 0) { /* IO error */
-			LOG_WRN("poll() error: %d", -errno);
-			ret = -EIO;
-			break;
-		}
-		if (ret == 0) { /* timeout */
-			continue;
-		}
-		LOG_DBG("fds[0] events 0x%08x", fds[0].revents);
-		LOG_DBG("fds[1] events 0x%08x", fds[1].revents);
-		/* Listening socket events must be handled first*/
-		if (fds[0].revents) {
-			if ((fds[0].revents & POLLERR) == POLLERR) {
-				LOG_ERR("0: POLLERR");
-				ret = -EIO;
-				break;
-			}
-			if ((fds[0].revents & POLLHUP) == POLLHUP) {
-				LOG_WRN("0: POLLHUP");
-				ret = -ECONNRESET;
-				break;
-			}
-			if ((fds[0].revents & POLLNVAL) == POLLNVAL) {
-				/* server stopped by AT command */
-				LOG_WRN("0: POLLNVAL");
-				ret = -ENETDOWN;
-				break;
-			}
-			if ((fds[0].revents & POLLIN) != POLLIN) {
-				/* Ignore and check whether there are client events */
-				goto client_events;
-			}
 
-			/* Accept incoming connection */
-			char peer_addr[INET6_ADDRSTRLEN] = {0};
-			socklen_t len;
+	ret = recv(fd, (void *)data_buf, sizeof(data_buf), 0);
+	if (ret < 0) {
+		LOG_WRN("recv() error: %d", -errno);
+		return;
+	}
+	if (ret == 0) {
+		return;
+	}
+	if (in_datamode()) {
+		data_send(data_buf, ret);
+	} else if (server) {
+		rsp_send("\r\n#XTCPDATA: %d,%d\r\n", ret, fd);
+		data_send(data_buf, ret);
+	} else {
+		rsp_send("\r\n#XTCPDATA: %d\r\n", ret);
+		data_send(data_buf, ret);
+	}
+}
 
-			if (proxy.family == AF_INET) {
-				struct sockaddr_in client;
+/* TCP server listening socket events */
+static void tcpsvr_listen_handler(int fd, short revents, void *ctx)
+{
+	int ret;
+	char peer_addr[INET6_ADDRSTRLEN] = {0};
+	socklen_t len;
+	struct tcp_peer *peer;
+	bool paused;
 
-				len = sizeof(struct sockaddr_in);
-				ret = accept(proxy.sock, (struct sockaddr *)&client, &len);
-				if (ret == -1) {
-					LOG_WRN("accept(ipv4) error: %d", -errno);
-					goto client_events;
-				}
-				(void)inet_ntop(AF_INET, &client.sin_addr, peer_addr,
-					sizeof(peer_addr));
-			} else {
-				struct sockaddr_in6 client;
-
-				len = sizeof(struct sockaddr_in6);
-				ret = accept(proxy.sock, (struct sockaddr *)&client, &len);
-				if (ret == -1) {
-					LOG_WRN("accept(ipv6) error: %d", -errno);
-					goto client_events;
-				}
-				(void)inet_ntop(AF_INET6, &client.sin6_addr, peer_addr,
-					sizeof(peer_addr));
-			}
-			if (fds[1].fd >= 0) {
-				LOG_WRN("Full. Close connection.");
-				close(ret);
-				goto client_events;
-			}
-			proxy.sock_peer = ret;
-			fds[1].fd = proxy.sock_peer;
-			rsp_send("\r\n#XTCPSVR: \"%s\",\"connected\"\r\n", peer_addr);
-			LOG_DBG("New connection - %d", proxy.sock_peer);
+	ARG_UNUSED(ctx);
+
+	ret = tcp_event_error(revents);
+	if (ret) {
+		(void)tcpsvr_stop(ret);
+		return;
+	}
+	if ((revents & POLLIN) != POLLIN) {
+		return;
+	}
+
+	/* Accept incoming connection */
+	if (proxy.family == AF_INET) {
+		struct sockaddr_in client;
+
+		len = sizeof(struct sockaddr_in);
+		ret = accept(fd, (struct sockaddr *)&client, &len);
+		if (ret == -1) {
+			LOG_WRN("accept(ipv4) error: %d", -errno);
+			return;
 		}
-client_events:
-		/* Incoming socket events */
-		if (fds[1].revents) {
-			if ((fds[1].revents & POLLERR) == POLLERR) {
-				LOG_ERR("1: POLLERR");
-				tcpsvr_terminate_connection(-EIO);
-				fds[1].fd = INVALID_SOCKET;
-				continue;
-			}
-			if ((fds[1].revents & POLLHUP) == POLLHUP) {
-				LOG_ERR("1: POLLHUP");
-				tcpsvr_terminate_connection(-ECONNRESET);
-				fds[1].fd = INVALID_SOCKET;
-				continue;
-			}
-			if ((fds[1].revents & POLLNVAL) == POLLNVAL) {
-				LOG_WRN("1: POLLNVAL");
-				tcpsvr_terminate_connection(-ENETDOWN);
-				fds[1].fd = INVALID_SOCKET;
-				continue;
-			}
-			if ((fds[1].revents & POLLIN) != POLLIN) {
-				continue;
-			}
-			ret = recv(fds[1].fd, (void *)data_buf, sizeof(data_buf), 0);
-			if (ret < 0) {
-				LOG_WRN("recv() error: %d", -errno);
-				continue;
-			}
-			if (ret == 0) {
-				continue;
-			}
-			if (in_datamode()) {
-				data_send(data_buf, ret);
-			} else {
-				rsp_send("\r\n#XTCPDATA: %d\r\n", ret);
-				data_send(data_buf, ret);
-			}
+		(void)inet_ntop(AF_INET, &client.sin_addr, peer_addr, sizeof(peer_addr));
+	} else {
+		struct sockaddr_in6 client;
+
+		len = sizeof(struct sockaddr_in6);
+		ret = accept(fd, (struct sockaddr *)&client, &len);
+		if (ret == -1) {
+			LOG_WRN("accept(ipv6) error: %d", -errno);
+			return;
 		}
+		(void)inet_ntop(AF_INET6, &client.sin6_addr, peer_addr, sizeof(peer_addr));
+	}
+	peer = tcpsvr_peer_free_find();
+	if (peer == NULL) {
+		LOG_WRN("Full. Close connection.");
+		close(ret);
+		return;
+	}
+	/* A connection made in data mode is received after it. */
+	paused = (proxy.peer != NULL && proxy.peer->state == TCP_PEER_DATAMODE);
+	if (slm_proxy_poll_add(ret, paused ? 0 : POLLIN, tcpsvr_peer_handler, peer) != 0) {
+		close(ret);
+		return;
+	}
+	peer->sock = ret;
+	peer->state = paused ? TCP_PEER_PAUSED : TCP_PEER_CONNECTED;
+	if (!paused) {
+		proxy.peer = peer;
 	}
+	if (!in_datamode()) {
+		rsp_send("\r\n#XTCPSVR: \"%s\",\"connected\",%d\r\n", peer_addr, peer->sock);
+	}
+	LOG_DBG("New connection - %d", peer->sock);
+}
 
-#if defined(CONFIG_SLM_NATIVE_TLS)
-	if (proxy.sec_tag != INVALID_SEC_TAG) {
-		(void)slm_tls_unloadcrdl(proxy.sec_tag);
-		proxy.sec_tag = INVALID_SEC_TAG;
+/* TCP server connected socket events */
+static void tcpsvr_peer_handler(int fd, short revents, void *ctx)
+{
+	struct tcp_peer *peer = ctx;
+	int ret;
+
+	ret = tcp_event_error(revents);
+	if (ret) {
+		tcpsvr_terminate_connection(peer, ret);
+		return;
 	}
-#endif
-	tcpsvr_terminate_connection(ret);
-	if (proxy.sock != INVALID_SOCKET) {
-		(void)close(proxy.sock);
-		proxy.sock = INVALID_SOCKET;
+	if ((revents & POLLIN) == POLLIN && peer->state != TCP_PEER_PAUSED) {
+		/* Reply to the connection that sent data last. */
+		proxy.peer = peer;
+		tcp_data_recv(fd, true);
 	}
-	rsp_send("\r\n#XTCPSVR: %d,\"stopped\"\r\n", ret);
-	server_stop_pending = false;
-	LOG_INF("TCP server thread terminated");
 }
 
-/* TCP client thread */
-static void tcpcli_thread_func(void *p1, void *p2, void *p3)
+/* TCP client socket events */
+static void tcpcli_event_handler(int fd, short revents, void *ctx)
 {
 	int ret;
-	static struct pollfd fds;
-
-	ARG_UNUSED(p1);
-	ARG_UNUSED(p2);
-	ARG_UNUSED(p3);
-
-	fds.fd = proxy.sock;
-	fds.events = POLLIN;
-	while (true) {
-		ret = poll(&fds, 1, MSEC_PER_SEC * CONFIG_SLM_TCP_POLL_TIME);
-		if (ret < 0) {  /* IO error */
-			LOG_WRN("poll() error: %d", ret);
-			ret = -EIO;
-			break;
-		}
-		if (ret == 0) {  /* timeout */
-			continue;
-		}
-		LOG_DBG("Poll events 0x%08x", fds.revents);
-		if ((fds.revents & POLLERR) == POLLERR) {
-			LOG_ERR("POLLERR");
-			ret = -EIO;
-			break;
-		}
-		if ((fds.revents & POLLNVAL) == POLLNVAL) {
-			/* client disconnected locally by AT command */
-			LOG_WRN("POLLNVAL");
-			ret = -ENETDOWN;
-			break;
-		}
-		if ((fds.revents & POLLHUP) == POLLHUP) {
-			/* client disconnected by remote or lose LTE connection */
-			LOG_WRN("POLLHUP");
-			ret = -ECONNRESET;
-			break;
-		}
-		if ((fds.revents & POLLIN) != POLLIN) {
-			continue;
-		}
-		ret = recv(fds.fd, (void *)data_buf, sizeof(data_buf), 0);
-		if (ret < 0) {
-			LOG_WRN("recv() error: %d", -errno);
-			continue;
-		}
-		if (ret == 0) {
-			continue;
-		}
+
+	ARG_UNUSED(ctx);
+
+	ret = tcp_event_error(revents);
+	if (ret) {
 		if (in_datamode()) {
-			data_send(data_buf, ret);
-		} else {
-			rsp_send("\r\n#XTCPDATA: %d\r\n", ret);
-			data_send(data_buf, ret);
+			(void)exit_datamode_handler(ret);
 		}
+		(void)tcpcli_disconnect(ret);
+		return;
 	}
-
-	if (in_datamode()) {
-		(void)exit_datamode_handler(ret);
-	}
-	if (proxy.sock != INVALID_SOCKET) {
-		(void)close(proxy.sock);
-		proxy.sock = INVALID_SOCKET;
-		rsp_send("\r\n#XTCPCLI: %d,\"disconnected\"\r\n", ret);
+	if ((revents & POLLIN) == POLLIN) {
+		tcp_data_recv(fd, false);
 	}
-
-	LOG_INF("TCP client thread terminated");
 }
 
 /**@brief handle AT#XTCPSVR commands
@@ -689,7 +727,7 @@ int handle_at_tcp_server(enum at_cmd_type cmd_type)
 
 	case AT_CMD_TYPE_READ_COMMAND:
 		rsp_send("\r\n#XTCPSVR: %d,%d,%d\r\n",
-			proxy.sock, proxy.sock_peer, proxy.family);
+			proxy.sock, proxy.peer ? proxy.peer->sock : INVALID_SOCKET, proxy.family);
 		err = 0;
 		break;
 
@@ -772,7 +810,7 @@ int handle_at_tcp_client(enum at_cmd_type cmd_type)
 }
 
 /**@brief handle AT#XTCPSEND commands
- *  AT#XTCPSEND[=<data>]
+ *  AT#XTCPSEND[=<data>[,<handle>]]
  *  AT#XTCPSEND? READ command not supported
  *  AT#XTCPSEND=? TEST command not supported
  */
@@ -781,10 +819,25 @@ int handle_at_tcp_send(enum at_cmd_type cmd_type)
 	int err = -EINVAL;
 	char data[SLM_MAX_PAYLOAD_SIZE + 1] = {0};
 	int size;
+	int handle;
+	struct tcp_peer *peer;
+	int param_count = at_params_valid_count_get(&at_param_list);
 
 	switch (cmd_type) {
 	case AT_CMD_TYPE_SET_COMMAND:
-		if (at_params_valid_count_get(&at_param_list) > 1) {
+		if (param_count > 2) {
+			/* Select the connection of the server. */
+			err = at_params_int_get(&at_param_list, 2, &handle);
+			if (err) {
+				return err;
+			}
+			peer = tcpsvr_peer_find(handle);
+			if (proxy.role != TCP_ROLE_SERVER || peer == NULL) {
+				return -EINVAL;
+			}
+			proxy.peer = peer;
+		}
+		if (param_count > 1) {
 			size = sizeof(data);
 			err = util_string_get(&at_param_list, 1, data, &size);
 			if (err) {
@@ -792,7 +845,16 @@ int handle_at_tcp_send(enum at_cmd_type cmd_type)
 			}
 			err = do_tcp_send(data, size);
 		} else {
-			err = enter_datamode(tcp_datamode_callback);
+			if (tcp_send_sock() == INVALID_SOCKET) {
+				return -ENOTCONN;
+			}
+			if (proxy.role == TCP_ROLE_SERVER) {
+				tcpsvr_datamode_enter();
+			}
+			err = enter_datamode_stream(tcp_datamode_callback);
+			if (err && proxy.role == TCP_ROLE_SERVER) {
+				tcpsvr_datamode_exit();
+			}
 		}
 		break;
 
@@ -812,20 +874,22 @@ int handle_at_tcp_hangup(enum at_cmd_type cmd_type)
 {
 	int err = -EINVAL;
 	int handle;
+	struct tcp_peer *peer;
 
 	switch (cmd_type) {
 	case AT_CMD_TYPE_SET_COMMAND:
-		if (proxy.role != TCP_ROLE_SERVER || proxy.sock_peer == INVALID_SOCKET) {
+		if (proxy.role != TCP_ROLE_SERVER) {
 			return -EINVAL;
 		}
 		err = at_params_int_get(&at_param_list, 1, &handle);
 		if (err) {
 			return err;
 		}
-		if (handle != proxy.sock_peer) {
+		peer = tcpsvr_peer_find(handle);
+		if (peer == NULL) {
 			return -EINVAL;
 		}
-		tcpsvr_terminate_connection(-ECONNREFUSED);
+		tcpsvr_terminate_connection(peer, -ECONNREFUSED);
 		err = 0;
 		break;
 
@@ -847,9 +911,13 @@ int slm_at_tcp_proxy_init(void)
 {
 	proxy.sock      = INVALID_SOCKET;
 	proxy.family    = AF_UNSPEC;
-	proxy.sock_peer = INVALID_SOCKET;
+	proxy.peer      = NULL;
 	proxy.role      = INVALID_ROLE;
 	proxy.sec_tag   = INVALID_SEC_TAG;
+	for (int i = 0; i < TCP_PEERS; i++) {
+		proxy.peers[i].sock = INVALID_SOCKET;
+		proxy.peers[i].state = TCP_PEER_FREE;
+	}
 
 	return 0;
 }
@@ -11,13 +11,11 @@
 #include <zephyr/net/tls_credentials.h>
 #include "slm_util.h"
 #include "slm_at_host.h"
+#include "slm_proxy_poll.h"
 #include "slm_at_udp_proxy.h"
 
 LOG_MODULE_REGISTER(slm_udp, CONFIG_SLM_LOG_LEVEL);
 
-#define THREAD_STACK_SIZE	KB(4)
-#define THREAD_PRIORITY		K_LOWEST_APPLICATION_THREAD_PRIO
-
 /*
  * Known limitation in this version
  * - Multiple concurrent
@@ -33,10 +31,6 @@ enum slm_udp_proxy_operation {
 	CLIENT_CONNECT6 = SERVER_START6
 };
 
-static struct k_thread udp_thread;
-static K_THREAD_STACK_DEFINE(udp_thread_stack, THREAD_STACK_SIZE);
-static k_tid_t udp_thread_id;
-
 /**@brief Proxy roles. */
 enum slm_udp_role {
 	UDP_ROLE_CLIENT,
@@ -59,8 +53,8 @@ static struct udp_proxy {
 extern struct at_param_list at_param_list;
 extern uint8_t data_buf[SLM_MAX_MESSAGE_SIZE];
 
-/** forward declaration of thread function **/
-static void udp_thread_func(void *p1, void *p2, void *p3);
+/** forward declaration of socket event handler **/
+static void udp_event_handler(int fd, short revents, void *ctx);
 
 static int do_udp_server_start(uint16_t port)
 {
@@ -124,10 +118,12 @@ static int do_udp_server_start(uint16_t port)
 		return -errno;
 	}
 
-	udp_thread_id = k_thread_create(&udp_thread, udp_thread_stack,
-			K_THREAD_STACK_SIZEOF(udp_thread_stack),
-			udp_thread_func, NULL, NULL, NULL,
-			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	ret = slm_proxy_poll_add(proxy.sock, POLLIN, udp_event_handler, NULL);
+	if (ret) {
+		close(proxy.sock);
+		proxy.sock = INVALID_SOCKET;
+		return ret;
+	}
 
 	proxy.role = UDP_ROLE_SERVER;
 	rsp_send("\r\n#XUDPSVR: %d,\"started\"\r\n", proxy.sock);
@@ -142,6 +138,7 @@ static int do_udp_server_stop(void)
 	if (proxy.sock == INVALID_SOCKET) {
 		return 0;
 	}
+	(void)slm_proxy_poll_remove(proxy.sock);
 	ret = close(proxy.sock);
 	if (ret < 0) {
 		LOG_WRN("close() failed: %d", -errno);
@@ -155,10 +152,6 @@ static int do_udp_server_stop(void)
 		}
 		slm_at_udp_proxy_init();
 	}
-	if (ret == 0 &&
-	    k_thread_join(&udp_thread, K_SECONDS(CONFIG_SLM_UDP_POLL_TIME * 2)) != 0) {
-		LOG_WRN("Wait for thread terminate failed");
-	}
 	rsp_send("\r\n#XUDPSVR: %d,\"stopped\"\r\n", ret);
 
 	return ret;
@@ -257,10 +250,10 @@ static int do_udp_client_connect(const char *url, uint16_t port)
 		}
 	}
 
-	udp_thread_id = k_thread_create(&udp_thread, udp_thread_stack,
-			K_THREAD_STACK_SIZEOF(udp_thread_stack),
-			udp_thread_func, NULL, NULL, NULL,
-			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	ret = slm_proxy_poll_add(proxy.sock, POLLIN, udp_event_handler, NULL);
+	if (ret) {
+		goto cli_exit;
+	}
 
 	proxy.role = UDP_ROLE_CLIENT;
 	rsp_send("\r\n#XUDPCLI: %d,\"connected\"\r\n", proxy.sock);
@@ -282,6 +275,7 @@ static int do_udp_client_disconnect(void)
 	if (proxy.sock == INVALID_SOCKET) {
 		return 0;
 	}
+	(void)slm_proxy_poll_remove(proxy.sock);
 	ret = close(proxy.sock);
 	if (ret < 0) {
 		LOG_WRN("close() failed: %d", -errno);
@@ -289,10 +283,6 @@ static int do_udp_client_disconnect(void)
 	} else {
 		proxy.sock = INVALID_SOCKET;
 	}
-	if (ret == 0 &&
-	    k_thread_join(&udp_thread, K_SECONDS(CONFIG_SLM_UDP_POLL_TIME * 2)) != 0) {
-		LOG_WRN("Wait for thread terminate failed");
-	}
 	rsp_send("\r\n#XUDPCLI: %d,\"disconnected\"\r\n", ret);
 
 	return ret;
@@ -366,96 +356,77 @@ static int do_udp_send_datamode(const uint8_t *data, int datalen)
 	return (offset > 0) ? offset : -1;
 }
 
-static void udp_thread_func(void *p1, void *p2, void *p3)
+static void udp_event_handler(int fd, short revents, void *ctx)
 {
 	int ret;
-	struct pollfd fds;
 
-	ARG_UNUSED(p1);
-	ARG_UNUSED(p2);
-	ARG_UNUSED(p3);
-
-	fds.fd = proxy.sock;
-	fds.events = POLLIN;
-
-	do {
-		ret = poll(&fds, 1, MSEC_PER_SEC * CONFIG_SLM_UDP_POLL_TIME);
-		if (ret < 0) {  /* IO error */
-			LOG_WRN("poll() error: %d", ret);
-			continue;
-		}
-		if (ret == 0) {  /* timeout */
-			continue;
-		}
-		LOG_DBG("Poll events 0x%08x", fds.revents);
-		if ((fds.revents & POLLERR) == POLLERR) {
-			LOG_WRN("POLLERR");
-			ret = -EIO;
-			break;
-		}
-		if ((fds.revents & POLLNVAL) == POLLNVAL) {
-			/* UDP client or server closed */
-			LOG_WRN("POLLNVAL");
-			ret = -ENETDOWN;
-			break;
-		}
-		if ((fds.revents & POLLHUP) == POLLHUP) {
-			/* Lose LTE connection */
-			LOG_WRN("POLLHUP");
-			ret = -ECONNRESET;
-			break;
-		}
-		if ((fds.revents & POLLIN) != POLLIN) {
-			continue;
-		}
+	ARG_UNUSED(ctx);
 
-		if (proxy.role == UDP_ROLE_SERVER) {
-			/* remember remote from last recvfrom */
-			if (proxy.family == AF_INET) {
-				int size = sizeof(struct sockaddr_in);
+	if ((revents & POLLERR) == POLLERR) {
+		LOG_WRN("POLLERR");
+		ret = -EIO;
+		goto terminate;
+	}
+	if ((revents & POLLNVAL) == POLLNVAL) {
+		LOG_WRN("POLLNVAL");
+		ret = -ENETDOWN;
+		goto terminate;
+	}
+	if ((revents & POLLHUP) == POLLHUP) {
+		/* Lose LTE connection */
+		LOG_WRN("POLLHUP");
+		ret = -ECONNRESET;
+		goto terminate;
+	}
+	if ((revents & POLLIN) != POLLIN) {
+		return;
+	}
 
-				memset(&proxy.remote, 0, sizeof(struct sockaddr_in));
-				ret = recvfrom(proxy.sock, (void *)data_buf, sizeof(data_buf), 0,
-					(struct sockaddr *)&(proxy.remote), &size);
-			} else {
-				int size = sizeof(struct sockaddr_in6);
+	if (proxy.role == UDP_ROLE_SERVER) {
+		/* remember remote from last recvfrom */
+		if (proxy.family == AF_INET) {
+			int size = sizeof(struct sockaddr_in);
 
-				memset(&proxy.remote6, 0, sizeof(struct sockaddr_in6));
-				ret = recvfrom(proxy.sock, (void *)data_buf, sizeof(data_buf), 0,
-					(struct sockaddr *)&(proxy.remote6), &size);
-			}
-		} else {
-			ret = recv(proxy.sock, (void *)data_buf, sizeof(data_buf), 0);
-		}
-		if (ret < 0) {
-			LOG_WRN("recv() error: %d", -errno);
-			continue;
-		}
-		if (ret == 0) {
-			continue;
-		}
-		if (in_datamode()) {
-			data_send(data_buf, ret);
+			memset(&proxy.remote, 0, sizeof(struct sockaddr_in));
+			ret = recvfrom(fd, (void *)data_buf, sizeof(data_buf), 0,
+				(struct sockaddr *)&(proxy.remote), &size);
 		} else {
-			rsp_send("\r\n#XUDPDATA: %d\r\n", ret);
-			data_send(data_buf, ret);
+			int size = sizeof(struct sockaddr_in6);
+
+			memset(&proxy.remote6, 0, sizeof(struct sockaddr_in6));
+			ret = recvfrom(fd, (void *)data_buf, sizeof(data_buf), 0,
+				(struct sockaddr *)&(proxy.remote6), &size);
 		}
-	} while (true);
+	} else {
+		ret = recv(fd, (void *)data_buf, sizeof(data_buf), 0);
+	}
+	if (ret < 0) {
+		LOG_WRN("recv() error: %d", -errno);
+		return;
+	}
+	if (ret == 0) {
+		return;
+	}
+	if (in_datamode()) {
+		data_send(data_buf, ret);
+	} else {
+		rsp_send("\r\n#XUDPDATA: %d\r\n", ret);
+		data_send(data_buf, ret);
+	}
+	return;
 
+terminate:
 	if (in_datamode()) {
 		exit_datamode_handler(ret);
 	}
-	if (proxy.sock != INVALID_SOCKET) {
-		close(proxy.sock);
-		proxy.sock = INVALID_SOCKET;
-		if (proxy.role == UDP_ROLE_CLIENT) {
-			rsp_send("\r\n#XUDPCLI: %d,\"disconnected\"\r\n", ret);
-		} else {
-			rsp_send("\r\n#XUDPSVR: %d,\"stopped\"\r\n", ret);
-		}
+	(void)slm_proxy_poll_remove(fd);
+	close(fd);
+	proxy.sock = INVALID_SOCKET;
+	if (proxy.role == UDP_ROLE_CLIENT) {
+		rsp_send("\r\n#XUDPCLI: %d,\"disconnected\"\r\n", ret);
+	} else {
+		rsp_send("\r\n#XUDPSVR: %d,\"stopped\"\r\n", ret);
 	}
-
-	LOG_INF("UDP thread terminated");
 }
 
 static int udp_datamode_callback(uint8_t op, const uint8_t *data, int len, uint8_t flags)
@@ -663,7 +634,7 @@ int slm_at_udp_proxy_uninit(void)
 	int ret = 0;
 
 	if (proxy.sock != INVALID_SOCKET) {
-		k_thread_abort(udp_thread_id);
+		(void)slm_proxy_poll_remove(proxy.sock);
 		ret = close(proxy.sock);
 		if (ret < 0) {
 			LOG_WRN("close() failed: %d", -errno);
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/logging/log.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/posix/sys/eventfd.h>
+#include "slm_defines.h"
+#include "slm_proxy_poll.h"
+
+LOG_MODULE_REGISTER(slm_proxy_poll, CONFIG_SLM_LOG_LEVEL);
+
+#define THREAD_STACK_SIZE	KB(4)
+#define THREAD_PRIORITY		K_LOWEST_APPLICATION_THREAD_PRIO
+
+#define POLL_SOCKETS		CONFIG_SLM_PROXY_POLL_SOCKETS
+#define POLL_RETRY_MS		100
+#define POLL_STOP_TIMEOUT	K_SECONDS(1)
+
+/* Polled socket */
+struct poll_entry {
+	int fd;				/* Socket, INVALID_SOCKET if free */
+	short events;			/* Requested events */
+	uint16_t seq;			/* Changes when the entry is reused */
+	slm_proxy_poll_handler_t handler;
+	void *ctx;
+};
+
+static struct poll_entry entries[POLL_SOCKETS];
+static uint16_t entry_seq;
+static atomic_t running;
+/* Wakes up the thread from poll() to pick up the changed entries. */
+static int wake_fd = INVALID_SOCKET;
+
+/* Protects the entries. Held while calling the handlers, so that a removed socket
+ * is never handled. Handlers may add and remove sockets as the mutex is recursive.
+ */
+K_MUTEX_DEFINE(mutex_entries);
+
+static struct k_thread poll_thread;
+static K_THREAD_STACK_DEFINE(poll_thread_stack, THREAD_STACK_SIZE);
+
+static struct poll_entry *entry_find(int fd)
+{
+	for (int i = 0; i < POLL_SOCKETS; i++) {
+		if (entries[i].fd == fd) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void poll_wake(void)
+{
+	(void)eventfd_write(wake_fd, 1);
+}
+
+int slm_proxy_poll_add(int fd, short events, slm_proxy_poll_handler_t handler, void *ctx)
+{
+	struct poll_entry *entry;
+	int err = 0;
+
+	if (fd < 0 || handler == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&mutex_entries, K_FOREVER);
+	if (entry_find(fd)) {
+		err = -EEXIST;
+	} else {
+		entry = entry_find(INVALID_SOCKET);
+		if (entry) {
+			entry->fd = fd;
+			entry->events = events;
+			entry->seq = ++entry_seq;
+			entry->handler = handler;
+			entry->ctx = ctx;
+		} else {
+			LOG_ERR("No room for socket %d", fd);
+			err = -ENOMEM;
+		}
+	}
+	k_mutex_unlock(&mutex_entries);
+
+	if (err == 0) {
+		poll_wake();
+	}
+
+	return err;
+}
+
+int slm_proxy_poll_remove(int fd)
+{
+	struct poll_entry *entry;
+
+	if (fd < 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&mutex_entries, K_FOREVER);
+	entry = entry_find(fd);
+	if (entry) {
+		entry->fd = INVALID_SOCKET;
+	}
+	k_mutex_unlock(&mutex_entries);
+
+	if (entry == NULL) {
+		return -ENOENT;
+	}
+	/* Stop polling the socket before it is closed. */
+	poll_wake();
+
+	return 0;
+}
+
+int slm_proxy_poll_events_set(int fd, short events)
+{
+	struct poll_entry *entry;
+
+	if (fd < 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&mutex_entries, K_FOREVER);
+	entry = entry_find(fd);
+	if (entry) {
+		entry->events = events;
+	}
+	k_mutex_unlock(&mutex_entries);
+
+	if (entry == NULL) {
+		return -ENOENT;
+	}
+	poll_wake();
+
+	return 0;
+}
+
+static void poll_dispatch(const struct pollfd *fds, const uint16_t *seqs, int nfds)
+{
+	struct poll_entry *entry;
+	short revents;
+
+	k_mutex_lock(&mutex_entries, K_FOREVER);
+	for (int i = 1; i < nfds; i++) {
+		if (fds[i].revents == 0) {
+			continue;
+		}
+		/* Skip the sockets removed (and maybe reopened) while polling. */
+		entry = entry_find(fds[i].fd);
+		if (entry == NULL || entry->seq != seqs[i]) {
+			continue;
+		}
+		/* Nor report the events no longer requested. */
+		revents = fds[i].revents & (entry->events | POLLERR | POLLHUP | POLLNVAL);
+		if (revents == 0) {
+			continue;
+		}
+		LOG_DBG("Socket %d events 0x%x", fds[i].fd, revents);
+		entry->handler(fds[i].fd, revents, entry->ctx);
+	}
+	k_mutex_unlock(&mutex_entries);
+}
+
+static void poll_thread_func(void *p1, void *p2, void *p3)
+{
+	/* The wakeup eventfd and the sockets. */
+	struct pollfd fds[1 + POLL_SOCKETS];
+	uint16_t seqs[1 + POLL_SOCKETS];
+	eventfd_t value;
+	int nfds;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	fds[0].fd = wake_fd;
+	fds[0].events = POLLIN;
+
+	while (atomic_get(&running)) {
+		nfds = 1;
+		k_mutex_lock(&mutex_entries, K_FOREVER);
+		for (int i = 0; i < POLL_SOCKETS; i++) {
+			if (entries[i].fd != INVALID_SOCKET) {
+				fds[nfds].fd = entries[i].fd;
+				fds[nfds].events = entries[i].events;
+				fds[nfds].revents = 0;
+				seqs[nfds] = entries[i].seq;
+				nfds++;
+			}
+		}
+		k_mutex_unlock(&mutex_entries);
+
+		fds[0].revents = 0;
+		ret = poll(fds, nfds, SYS_FOREVER_MS);
+		if (ret < 0) {
+			LOG_WRN("poll() error: %d", -errno);
+			k_sleep(K_MSEC(POLL_RETRY_MS));
+			continue;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			(void)eventfd_read(wake_fd, &value);
+		}
+		poll_dispatch(fds, seqs, nfds);
+	}
+
+	LOG_DBG("Proxy poll thread terminated");
+}
+
+int slm_proxy_poll_init(void)
+{
+	for (int i = 0; i < POLL_SOCKETS; i++) {
+		entries[i].fd = INVALID_SOCKET;
+	}
+
+	wake_fd = eventfd(0, EFD_NONBLOCK);
+	if (wake_fd < 0) {
+		LOG_ERR("eventfd() failed: %d", -errno);
+		return -errno;
+	}
+
+	atomic_set(&running, true);
+	k_thread_create(&poll_thread, poll_thread_stack,
+			K_THREAD_STACK_SIZEOF(poll_thread_stack),
+			poll_thread_func, NULL, NULL, NULL,
+			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	k_thread_name_set(&poll_thread, "slm_proxy_poll");
+
+	return 0;
+}
+
+int slm_proxy_poll_uninit(void)
+{
+	if (wake_fd == INVALID_SOCKET) {
+		return 0;
+	}
+
+	atomic_set(&running, false);
+	poll_wake();
+	if (k_thread_join(&poll_thread, POLL_STOP_TIMEOUT) != 0) {
+		LOG_WRN("Wait for thread terminate failed");
+		k_thread_abort(&poll_thread);
+	}
+
+	(void)close(wake_fd);
+	wake_fd = INVALID_SOCKET;
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLM_PROXY_POLL_
+#define SLM_PROXY_POLL_
+
+/**@file slm_proxy_poll.h
+ *
+ * @brief Event loop of the proxy sockets for serial LTE modem
+ *
+ * One thread polls all the sockets of the TCP and UDP proxies and calls the handler of
+ * the socket when there are events.
+ * @{
+ */
+
+#include <zephyr/types.h>
+
+/**@brief Socket event handler type.
+ *
+ * Called from the event loop thread. The handler may add and remove sockets.
+ *
+ * @param fd Socket with events.
+ * @param revents Returned events, see poll().
+ * @param ctx Context given to @ref slm_proxy_poll_add.
+ */
+typedef void (*slm_proxy_poll_handler_t)(int fd, short revents, void *ctx);
+
+/**
+ * @brief Add a socket to the event loop
+ *
+ * @param fd Socket to poll.
+ * @param events Events to poll for, see poll(). POLLERR, POLLHUP and POLLNVAL are
+ *               always reported.
+ * @param handler Handler of the events.
+ * @param ctx Context passed to the handler.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the socket or the handler is invalid.
+ * @retval -EEXIST If the socket was already added.
+ * @retval -ENOMEM If all the CONFIG_SLM_PROXY_POLL_SOCKETS entries are in use.
+ */
+int slm_proxy_poll_add(int fd, short events, slm_proxy_poll_handler_t handler, void *ctx);
+
+/**
+ * @brief Remove a socket from the event loop
+ *
+ * The handler of the socket is not called after this returns, so the socket can be
+ * closed.
+ *
+ * @param fd Socket to remove.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the socket is invalid.
+ * @retval -ENOENT If the socket was not in the event loop.
+ */
+int slm_proxy_poll_remove(int fd);
+
+/**
+ * @brief Change the events to poll for a socket
+ *
+ * Used to stop receiving from a socket for a while, without removing it.
+ * The handler is not called for the events no longer polled after this returns.
+ *
+ * @param fd Socket in the event loop.
+ * @param events Events to poll for, see poll(). POLLERR, POLLHUP and POLLNVAL are
+ *               always reported.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the socket is invalid.
+ * @retval -ENOENT If the socket was not in the event loop.
+ */
+int slm_proxy_poll_events_set(int fd, short events);
+
+/**
+ * @brief Start the event loop
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_proxy_poll_init(void);
+
+/**
+ * @brief Stop the event loop
+ *
+ * All the sockets must have been removed.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_proxy_poll_uninit(void);
+
+/** @} */
+
+#endif /* SLM_PROXY_POLL_ */
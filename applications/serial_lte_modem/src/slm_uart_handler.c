@@ -118,6 +118,16 @@ static void rx_buf_unref(void *buf)
 	}
 }
 
+static void rx_pause_log(const char *reason)
+{
+	if (slm_uart.flow_ctrl == UART_CFG_FLOW_CTRL_RTS_CTS) {
+		/* RTS is deasserted, the host holds off until UART RX is enabled again. */
+		LOG_DBG("Disabling UART RX: %s", reason);
+	} else {
+		LOG_WRN("Disabling UART RX: %s Data may be lost without flow control.", reason);
+	}
+}
+
 static int rx_enable(void)
 {
 	struct rx_buf_t *buf;
@@ -260,12 +270,12 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 		break;
 	case UART_RX_BUF_REQUEST:
 		if (k_msgq_num_free_get(&rx_event_queue) < UART_RX_EVENT_COUNT_FOR_BUF) {
-			LOG_INF("Disabling UART RX: No event space.");
+			rx_pause_log("No event space.");
 			break;
 		}
 		buf = rx_buf_alloc();
 		if (!buf) {
-			LOG_INF("Disabling UART RX: No free buffers.");
+			rx_pause_log("No free buffers.");
 			break;
 		}
 		err = uart_rx_buf_rsp(uart_dev, buf->buf, sizeof(buf->buf));
@@ -43,6 +43,18 @@ struct bt_gatt_dm_attr {
 	uint8_t		perm;
 };
 
+/** @brief Size of an arena that can hold the data of a discovered service.
+ *
+ * Each attribute takes at most a service or characteristic value
+ * and two UUIDs.
+ *
+ * @param _attr_cnt Number of attributes in the service.
+ */
+#define BT_GATT_DM_ARENA_SIZE(_attr_cnt)                                     \
+	((_attr_cnt) * (MAX(sizeof(struct bt_gatt_service_val),             \
+			    sizeof(struct bt_gatt_chrc)) +                  \
+			2 * ROUND_UP(sizeof(struct bt_uuid_128), 4)))
+
 /** @brief Discovery callback structure.
  *
  *  This structure is used for tracking the result of a discovery.
@@ -317,6 +329,36 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context);
  */
 int bt_gatt_dm_data_release(struct bt_gatt_dm *dm);
 
+/** @brief Set the arena for the discovery data.
+ *
+ * By default, the discovery data is stored in blocks allocated from the
+ * heap. With an arena set, the data of each discovered service is placed
+ * in the given buffer instead, and no memory is allocated during
+ * the discovery. Use @ref BT_GATT_DM_ARENA_SIZE to size the buffer.
+ * If the buffer is too small for a service, the discovery fails with
+ * -ENOMEM.
+ *
+ * The arena is used until it is set again. Pass NULL to go back to
+ * the heap.
+ *
+ * @param[in] buf  Buffer aligned to 4 bytes, or NULL.
+ * @param[in] size Size of the buffer.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the buffer is not aligned.
+ * @retval -EBUSY If a discovery is in progress or its data is not
+ *                released.
+ */
+int bt_gatt_dm_arena_set(void *buf, size_t size);
+
+/** @brief Clear the discovery cache.
+ *
+ * @details Available with the @kconfig{CONFIG_BT_GATT_DM_CACHE} option.
+ *          Later discoveries are run against the peer again, until their
+ *          results are cached.
+ */
+void bt_gatt_dm_cache_clear(void);
+
 /** @brief Print service discovery data.
  *
  * This function prints GATT attributes that belong to the discovered service.
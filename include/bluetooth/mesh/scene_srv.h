@@ -27,6 +27,10 @@ extern "C" {
 #define CONFIG_BT_MESH_SCENES_MAX 0
 #endif
 
+#ifndef CONFIG_BT_MESH_SCENE_SRV_BASE_SIZE
+#define CONFIG_BT_MESH_SCENE_SRV_BASE_SIZE 0
+#endif
+
 /** @def BT_MESH_SCENE_ENTRY_SIG
  *
  *  @brief Scene entry type definition for SIG models
@@ -49,6 +53,20 @@ extern "C" {
 
 struct bt_mesh_scene_srv;
 
+/** Scene Server storage statistics. */
+struct bt_mesh_scene_srv_stats {
+	/** Number of scene data bytes written to persistent storage. */
+	uint32_t bytes_written;
+	/** Number of scene data records written to persistent storage. */
+	uint32_t records_written;
+	/** Duration of the last scene recall in microseconds, including
+	 *  reading the scene data from persistent storage.
+	 */
+	uint32_t recall_time_us;
+	/** Number of model states restored by the last scene recall. */
+	uint16_t recall_entries;
+};
+
 /** @def BT_MESH_MODEL_SCENE_SRV
  *
  *  @brief Scene Server model composition data entry.
@@ -85,6 +103,16 @@ struct bt_mesh_scene_srv {
 	uint8_t vndpages;
 	/** Largest number of pages used to store SIG model scene data. */
 	uint8_t sigpages;
+	/** Largest number of pages used to store scene data. */
+	uint8_t pages;
+
+	/** Length of the base state, or 0 if there is none. */
+	uint16_t base_len;
+	/** Base state that the scenes are stored as a difference from. */
+	uint8_t base[1 + CONFIG_BT_MESH_SCENE_SRV_BASE_SIZE];
+
+	/** Storage statistics. */
+	struct bt_mesh_scene_srv_stats stats;
 
 	/** Linked list node for Scene Server list */
 	sys_snode_t n;
@@ -235,6 +263,14 @@ bt_mesh_scene_srv_current_scene_get(const struct bt_mesh_scene_srv *srv);
 uint16_t
 bt_mesh_scene_srv_target_scene_get(const struct bt_mesh_scene_srv *srv);
 
+/** @brief Get the storage statistics of the Scene Server.
+ *
+ *  @param[in]  srv   Scene Server model.
+ *  @param[out] stats Storage statistics.
+ */
+void bt_mesh_scene_srv_stats_get(const struct bt_mesh_scene_srv *srv,
+				 struct bt_mesh_scene_srv_stats *stats);
+
 /** @cond INTERNAL_HIDDEN */
 extern const struct bt_mesh_model_cb _bt_mesh_scene_srv_cb;
 extern const struct bt_mesh_model_op _bt_mesh_scene_srv_op[];
@@ -562,6 +562,37 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr);
  */
 void bt_scan_blocklist_clear(void);
 
+/**@brief Duplicate filter statistics. */
+struct bt_scan_duplicate_filter_stats {
+	/** Number of reports suppressed as duplicates. */
+	uint32_t hits;
+
+	/** Number of reports passed on, because they were new, changed,
+	 *  or their previous report was older than the suppression window.
+	 */
+	uint32_t misses;
+};
+
+/**@brief Get the statistics of the duplicate filter.
+ *
+ * @details Available with the @kconfig{CONFIG_BT_SCAN_DUPLICATE_FILTER}
+ *          option.
+ *
+ * @param[out] stats Duplicate filter statistics.
+ *
+ * @retval 0 If the operation was successful. Otherwise, a (negative) error
+ *	     code is returned.
+ */
+int bt_scan_duplicate_filter_stats_get(struct bt_scan_duplicate_filter_stats *stats);
+
+/**@brief Clear the duplicate filter.
+ *
+ * @details Use this function to forget all reported devices, so that
+ *          the next report of each device is passed on. The statistics
+ *          are reset as well.
+ */
+void bt_scan_duplicate_filter_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,6 +60,7 @@ struct dfu_target {
 	int (*done)(bool successful);
 	int (*schedule_update)(int img_num);
 	int (*reset)();
+	int (*read)(size_t offset, void *buf, size_t len);
 };
 
 /**
@@ -121,6 +122,20 @@ int dfu_target_offset_get(size_t *offset);
  **/
 int dfu_target_write(const void *const buf, size_t len);
 
+/**
+ * @brief Read back data written to the initialized DFU target.
+ *
+ * Only data that has been passed to @ref dfu_target_write can be read.
+ *
+ * @param[in] offset Offset within the image to read from.
+ * @param[out] buf Buffer for the data.
+ * @param[in] len Number of bytes to read.
+ *
+ * @return 0 on success, -ENOTSUP if the target cannot be read back,
+ *	   or another negative error code indicating reason of failure.
+ **/
+int dfu_target_read(size_t offset, void *buf, size_t len);
+
 /**
  * @brief Release the resources that were needed for the current DFU
  *	  target.
@@ -156,6 +171,36 @@ int dfu_target_reset(void);
  **/
 int dfu_target_schedule_update(int img_num);
 
+/**
+ * @brief Set the expected SHA-256 hash of the image being written.
+ *
+ * The image is hashed while it is written, and verified when
+ * @ref dfu_target_done is called with @c successful set, without
+ * reading the image back from flash. @ref dfu_target_done returns -EACCES
+ * if the hash of the image is not available then.
+ * Requires @kconfig{CONFIG_DFU_TARGET_HASH}.
+ *
+ * @param[in] hash Expected SHA-256 hash, or NULL to skip the verification.
+ * @param[in] len Length of @p hash, 32 bytes.
+ *
+ * @return 0 on success or a negative error code indicating reason of failure.
+ **/
+int dfu_target_hash_set(const uint8_t *hash, size_t len);
+
+/**
+ * @brief Get the SHA-256 hash of the data written to the DFU target.
+ *
+ * Requires @kconfig{CONFIG_DFU_TARGET_HASH}.
+ *
+ * @param[out] hash Buffer for the hash.
+ * @param[in] len Size of @p hash, at least 32 bytes.
+ *
+ * @return 0 on success, -ENODATA if the hash is not available, for instance
+ *	   if an update was resumed without a saved hash state,
+ *	   or another negative error code indicating reason of failure.
+ **/
+int dfu_target_hash_get(uint8_t *hash, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -130,6 +130,17 @@ int dfu_target_full_modem_done(bool successful);
  **/
 int dfu_target_full_modem_schedule_update(int img_num);
 
+/**
+ * @brief Read back data written to the flash device.
+ *
+ * @param[in] offset Offset within the image to read from.
+ * @param[out] buf Buffer for the data.
+ * @param[in] len Number of bytes to read.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_full_modem_read(size_t offset, void *buf, size_t len);
+
 /**
  * @brief Release resources and erase the download area.
  *
@@ -88,6 +88,17 @@ int dfu_target_mcuboot_done(bool successful);
  **/
 int dfu_target_mcuboot_schedule_update(int img_num);
 
+/**
+ * @brief Read back data written to the secondary slot.
+ *
+ * @param[in] offset Offset within the image to read from.
+ * @param[out] buf Buffer for the data.
+ * @param[in] len Number of bytes to read.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_mcuboot_read(size_t offset, void *buf, size_t len);
+
 /**
  * @brief Release resources and erase the download area.
  *
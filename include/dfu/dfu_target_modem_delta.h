@@ -81,6 +81,15 @@ int dfu_target_modem_delta_done(bool successful);
  **/
 int dfu_target_modem_delta_schedule_update(int img_num);
 
+/**
+ * @brief Read back data written to the modem.
+ *
+ * The modem does not allow reading back the delta image.
+ *
+ * @return -ENOTSUP, always.
+ */
+int dfu_target_modem_delta_read(size_t offset, void *buf, size_t len);
+
 /**
  * @brief Release resources and erase the download area.
  *
@@ -89,6 +89,21 @@ int dfu_target_stream_offset_get(size_t *offset);
  */
 int dfu_target_stream_write(const uint8_t *buf, size_t len);
 
+/**
+ * @brief Read back firmware data written to the stream.
+ *
+ * Data which is still buffered, and not yet written to flash, is read
+ * from the buffer.
+ *
+ * @param[in] offset Offset within the payload to read from.
+ * @param[out] buf Buffer for the data.
+ * @param[in] len Number of bytes to read.
+ *
+ * @return 0 on success, -EINVAL if the range has not been written,
+ *	   or another negative errno.
+ */
+int dfu_target_stream_read(size_t offset, uint8_t *buf, size_t len);
+
 /**
  * @brief Release resources and finalize stream flash write if successful.
 
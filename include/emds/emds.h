@@ -35,6 +35,12 @@ struct emds_entry {
 	uint8_t *data;
 	/** Length of data that will be stored. */
 	size_t len;
+	/** Internal: Address of the entry in the emergency data storage. */
+	uint32_t ate_addr;
+	/** Internal: Checksum of the data at the last store. */
+	uint32_t crc;
+	/** Internal: State flags. */
+	uint8_t flags;
 };
 
 /**
@@ -60,7 +66,7 @@ struct emds_dynamic_entry {
  * This creates a variable _name prepended by emds_.
  */
 #define EMDS_STATIC_ENTRY_DEFINE(_name, _id, _data, _len)                      \
-	static const STRUCT_SECTION_ITERABLE(emds_entry, emds_##_name) = {     \
+	static STRUCT_SECTION_ITERABLE(emds_entry, emds_##_name) = {           \
 		.id = _id,                                                     \
 		.data = (uint8_t *)_data,                                      \
 		.len = _len,                                                   \
@@ -80,6 +86,22 @@ struct emds_dynamic_entry {
  */
 typedef void (*emds_store_cb_t)(void);
 
+/**
+ * @struct emds_store_stats
+ *
+ * Statistics of the last store operation.
+ */
+struct emds_store_stats {
+	/** Time spent storing, with interrupts locked (in microseconds). */
+	uint32_t time_us;
+	/** Number of bytes written to flash, including the allocation table. */
+	uint32_t bytes_written;
+	/** Number of entries written. */
+	uint16_t entries_written;
+	/** Number of entries skipped, as their data had not changed. */
+	uint16_t entries_skipped;
+};
+
 /**
  * @brief Initialize the emergency data storage.
  *
@@ -115,7 +137,11 @@ int emds_entry_add(struct emds_dynamic_entry *entry);
  *
  * Triggers the process of storing all data registered to be stored. All data
  * registered either through @ref emds_entry_add function or the
- * @ref EMDS_STATIC_ENTRY_DEFINE macro is stored. It locks all interrupts until
+ * @ref EMDS_STATIC_ENTRY_DEFINE macro is stored. Entries that have not changed
+ * since they were loaded are still in the storage, and are skipped. The store
+ * is only complete when all changed entries have been written. If it is
+ * interrupted, only the changed entries written so far are loaded on the next
+ * boot. It locks all interrupts until
  * the write is finished. Once the data storage is completed, the data should
  * not be changed, and the device should be halted. The device must not be
  * allowed to reboot when operating on a backup supply, since reboot will
@@ -164,9 +190,11 @@ int emds_clear(void);
  * This function prepares the flash area for the next emergency data storage. It
  * deletes the current entries if there is enough space for the next emergency
  * data storage, and clears the flash storage if there is not enough space for
- * the next storage. This has to be done after all the dynamic entries are
- * added. After this has been called emergency data storage should be ready to
- * store.
+ * the next storage. Entries with the same data as in RAM are kept, so that
+ * @ref emds_store can skip them if they have not changed, but they are not
+ * loaded again unless @ref emds_store completes. This has to be done after all
+ * the dynamic entries are added. After this has been called emergency data
+ * storage should be ready to store.
  *
  * @retval 0 Success
  * @retval -ERRNO errno code if error
@@ -177,8 +205,9 @@ int emds_prepare(void);
  * @brief Estimate the time needed to store the registered data.
  *
  * Estimate how much time it takes to store all dynamic and static data
- * registered in the entries. This value is dependent on the chip used, and
- * should be checked against the chip datasheet.
+ * registered in the entries, in the worst case where all entries have
+ * changed. This value is dependent on the chip used, and should be checked
+ * against the chip datasheet.
  *
  * @return Time needed to store all data (in microseconds).
  */
@@ -194,6 +223,13 @@ uint32_t emds_store_time_get(void);
  */
 uint32_t emds_store_size_get(void);
 
+/**
+ * @brief Get the statistics of the last store operation.
+ *
+ * @param stats Statistics of the last call to @ref emds_store.
+ */
+void emds_store_stats_get(struct emds_store_stats *stats);
+
 /**
  * @brief Check if the store operation can be run.
  *
@@ -191,6 +191,53 @@ struct location_data_cloud {
 #endif
 };
 
+/** Number of buckets in a time-to-fix histogram. */
+#define LOCATION_TTFF_HIST_BUCKETS 8
+
+/** Time-to-fix statistics of a location method. */
+struct location_ttff_method_stats {
+	/** Number of locations acquired. */
+	uint32_t fixes;
+	/** Shortest time to fix in milliseconds. */
+	uint32_t min_ms;
+	/** Longest time to fix in milliseconds. */
+	uint32_t max_ms;
+	/** Sum of the times to fix in milliseconds. */
+	uint64_t total_ms;
+	/**
+	 * Histogram of the times to fix. Bucket i counts the fixes that took less than
+	 * 2^i seconds and were not counted in an earlier bucket. The last bucket counts the rest.
+	 */
+	uint32_t hist[LOCATION_TTFF_HIST_BUCKETS];
+};
+
+/**
+ * Time-to-fix statistics. The time to fix is measured from the start of a method
+ * to the location reported by it.
+ */
+struct location_ttff_stats {
+	/** GNSS. */
+	struct location_ttff_method_stats gnss;
+	/** Cellular only. */
+	struct location_ttff_method_stats cellular;
+	/** Wi-Fi only. */
+	struct location_ttff_method_stats wifi;
+	/** Wi-Fi and cellular combined into a single cloud request. */
+	struct location_ttff_method_stats wifi_cellular;
+};
+
+/** GNSS assistance data statistics. */
+struct location_gnss_assistance_stats {
+	/** Assistance data requests made ahead of a periodic location request. */
+	uint32_t prefetches;
+	/** Assistance data requests made when GNSS was started. */
+	uint32_t on_demand;
+	/** Assistance data requests made while LTE was in RRC idle mode, waking up LTE. */
+	uint32_t lte_wakeups;
+	/** GNSS starts without an assistance data check, because the data was known to be valid. */
+	uint32_t warm_starts;
+};
+
 /** Location event data. */
 struct location_event_data {
 	/** Event ID. */
@@ -618,6 +665,33 @@ void location_cloud_location_ext_result_set(
 	enum location_ext_result result,
 	struct location_data *location);
 
+/**
+ * @brief Get the time-to-fix statistics.
+ *
+ * @param[out] stats Time-to-fix statistics.
+ *
+ * @return 0 on success, or negative error code on failure.
+ * @retval -EINVAL Given pointer is NULL.
+ * @retval -ENOTSUP CONFIG_LOCATION_TTFF_STATS is not set.
+ */
+int location_ttff_stats_get(struct location_ttff_stats *stats);
+
+/**
+ * @brief Reset the time-to-fix statistics.
+ */
+void location_ttff_stats_reset(void);
+
+/**
+ * @brief Get the GNSS assistance data statistics.
+ *
+ * @param[out] stats GNSS assistance data statistics.
+ *
+ * @return 0 on success, or negative error code on failure.
+ * @retval -EINVAL Given pointer is NULL.
+ * @retval -ENOTSUP CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH is not set.
+ */
+int location_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats);
+
 /** @} */
 
 #ifdef __cplusplus
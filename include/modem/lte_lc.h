@@ -884,6 +884,57 @@ struct lte_lc_cfun_cb {
 		.context = _context,                                                               \
 	};
 
+/** @brief Items of the modem state cached by the link controller. */
+enum lte_lc_state_item {
+	LTE_LC_STATE_FUNC_MODE,
+	LTE_LC_STATE_NW_REG_STATUS,
+	LTE_LC_STATE_CELL,
+	LTE_LC_STATE_LTE_MODE,
+	LTE_LC_STATE_PSM,
+	LTE_LC_STATE_EDRX,
+	LTE_LC_STATE_RRC_MODE,
+
+	LTE_LC_STATE_COUNT,
+};
+
+/** @brief Snapshot of the modem state cached by the link controller. */
+struct lte_lc_state {
+	/** Bitmask of valid items, BIT(enum lte_lc_state_item). */
+	uint32_t valid;
+
+	/** Functional mode. */
+	enum lte_lc_func_mode func_mode;
+
+	/** Network registration status. */
+	enum lte_lc_nw_reg_status nw_reg_status;
+
+	/** Current cell. Only the cell ID and tracking area code are set. */
+	struct lte_lc_cell cell;
+
+	/** Currently active LTE mode. */
+	enum lte_lc_lte_mode lte_mode;
+
+	/** PSM configuration given by the network. */
+	struct lte_lc_psm_cfg psm_cfg;
+
+	/** eDRX configuration given by the network. */
+	struct lte_lc_edrx_cfg edrx_cfg;
+
+	/** RRC mode. */
+	enum lte_lc_rrc_mode rrc_mode;
+};
+
+/** @brief Modem state cache statistics. */
+struct lte_lc_state_cache_stats {
+	/** Number of getter calls answered from the cache, that is, AT round-trips avoided. */
+	uint32_t hits;
+
+	/** Number of getter calls that queried the modem because the item was missing
+	 *  or older than CONFIG_LTE_LC_STATE_CACHE_MAX_AGE_MS.
+	 */
+	uint32_t misses;
+};
+
 struct lte_lc_evt {
 	enum lte_lc_evt_type type;
 	union {
@@ -1209,6 +1260,31 @@ int lte_lc_func_mode_get(enum lte_lc_func_mode *mode);
  */
 int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode);
 
+/** @brief Get a snapshot of the cached modem state.
+ *
+ * The snapshot is taken without querying the modem. Only the items flagged in
+ * @ref lte_lc_state.valid are known and younger than CONFIG_LTE_LC_STATE_CACHE_MAX_AGE_MS.
+ *
+ * @note Requires CONFIG_LTE_LC_STATE_CACHE.
+ *
+ * @param state Pointer to the snapshot.
+ *
+ * @retval 0 if successful.
+ * @retval -EINVAL if input argument was invalid.
+ */
+int lte_lc_state_get(struct lte_lc_state *state);
+
+/** @brief Get the modem state cache statistics.
+ *
+ * @note Requires CONFIG_LTE_LC_STATE_CACHE.
+ *
+ * @param stats Pointer to the statistics.
+ *
+ * @retval 0 if successful.
+ * @retval -EINVAL if input argument was invalid.
+ */
+int lte_lc_state_cache_stats_get(struct lte_lc_state_cache_stats *stats);
+
 /** @brief Initiate a neighbor cell measurement.
  *         The result of the measurement is reported back as an event of the type
  *         LTE_LC_EVT_NEIGHBOR_CELL_MEAS, meaning that an event handler must be
@@ -152,21 +152,59 @@ const char *nrf_modem_lib_fault_strerror(int fault);
 #endif
 
 #if defined(CONFIG_NRF_MODEM_LIB_MEM_DIAG) || defined(__DOXYGEN__)
+/** Number of buckets in the allocation size histogram. */
+#define NRF_MODEM_LIB_DIAG_SIZE_HIST_BUCKETS 8
+
+/** Number of size classes of each heap. */
+#define NRF_MODEM_LIB_DIAG_SLAB_CLASSES 3
+
+/** @brief Size class runtime statistics. */
+struct nrf_modem_lib_diag_slab_stats {
+	/** Block size, zero if the class is disabled. */
+	uint32_t block_size;
+	/** Number of blocks. */
+	uint32_t blocks;
+	/** Number of blocks in use. */
+	uint32_t used;
+	/** Highest number of blocks in use at once. */
+	uint32_t max_used;
+	/** Number of allocations that found the class exhausted. */
+	uint32_t fallbacks;
+};
+
+/** @brief Heap runtime statistics. */
+struct nrf_modem_lib_diag_heap_stats {
+	/** Heap statistics, including the memory reserved for size classes. */
+	struct sys_memory_stats heap;
+	/** Number of failed allocations. */
+	uint32_t failed_allocs;
+	/** Largest block that can currently be allocated from the heap. */
+	size_t largest_free_block;
+	/**
+	 * Allocation size histogram. Bucket n counts requests of up to 16 << n bytes,
+	 * the last bucket counts all larger requests.
+	 */
+	uint32_t size_hist[NRF_MODEM_LIB_DIAG_SIZE_HIST_BUCKETS];
+#if defined(CONFIG_NRF_MODEM_LIB_MEM_SLAB) || defined(__DOXYGEN__)
+	/** Size class statistics. */
+	struct nrf_modem_lib_diag_slab_stats slab[NRF_MODEM_LIB_DIAG_SLAB_CLASSES];
+#endif
+};
+
 struct nrf_modem_lib_diag_stats {
-	struct {
-		struct sys_memory_stats heap;
-		uint32_t failed_allocs;
-	} library;
-	struct {
-		struct sys_memory_stats heap;
-		uint32_t failed_allocs;
-	} shmem;
+	/** Library heap statistics. */
+	struct nrf_modem_lib_diag_heap_stats library;
+	/** Shared memory (TX region) heap statistics. */
+	struct nrf_modem_lib_diag_heap_stats shmem;
 };
 /**
  * @brief Retrieve heap runtime statistics.
  *
  * Retrieve runtime statistics for the shared memory and library heaps.
  *
+ * @note The largest free block is found by probing the heap with interrupts locked,
+ *       which takes a number of allocations logarithmic in the heap size.
+ *
  * @return int Zero on success, non-zero otherwise.
  */
 int nrf_modem_lib_diag_stats_get(struct nrf_modem_lib_diag_stats *stats);
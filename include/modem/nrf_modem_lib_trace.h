@@ -116,6 +116,28 @@ int nrf_modem_lib_trace_clear(void);
 uint32_t nrf_modem_lib_trace_backend_bitrate_get(void);
 #endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE) || defined(__DOXYGEN__) */
 
+/** @brief Trace backend statistics */
+struct nrf_modem_lib_trace_backend_stats {
+	/** Number of trace bytes received by the backend. */
+	uint64_t bytes_in;
+	/** Number of bytes output or stored by the backend, after compression if any. */
+	uint64_t bytes_out;
+};
+
+/**
+ * @brief Get the statistics of the trace backend.
+ *
+ * The compression ratio of the backend is @c bytes_in / @c bytes_out.
+ *
+ * @note This operation is only supported with some trace backends. If not supported, the function
+ *       returns -ENOTSUP.
+ *
+ * @param stats Statistics output.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int nrf_modem_lib_trace_backend_stats_get(struct nrf_modem_lib_trace_backend_stats *stats);
+
 /** @} */
 
 #ifdef __cplusplus
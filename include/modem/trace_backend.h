@@ -7,6 +7,9 @@
 #ifndef TRACE_BACKEND_H__
 #define TRACE_BACKEND_H__
 
+#include <stddef.h>
+#include <nrf_modem_trace.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,6 +26,8 @@ extern "C" {
  */
 typedef int (*trace_backend_processed_cb)(size_t len);
 
+struct nrf_modem_lib_trace_backend_stats;
+
 /**
  * @brief The trace backend interface, implemented by the trace backend.
  */
@@ -63,6 +68,25 @@ struct nrf_modem_lib_trace_backend {
 	 */
 	int (*write)(const void *data, size_t len);
 
+	/**
+	 * @brief Write a vector of trace fragments to the compile-time selected trace backend.
+	 *
+	 * Write all trace fragments received from the modem in one operation. When implemented,
+	 * this is used instead of @c write. The fragments are not copied by the trace module,
+	 * so the backend may keep referencing their data until it reports it as processed.
+	 *
+	 * @note Set to @c NULL if this operation is not supported by the trace backend.
+	 *
+	 * @param frags   Trace fragments.
+	 * @param n_frags Number of trace fragments.
+	 *
+	 * @returns Number of bytes written, counted from the start of the first fragment, if the
+	 *          operation was successful. This can be less than the total length of the
+	 *          fragments, in which case the remaining data is written in a new call.
+	 *          Otherwise, a (negative) error code is returned, as for @c write.
+	 */
+	int (*write_vec)(const struct nrf_modem_trace_data *frags, size_t n_frags);
+
 	/**
 	 * @brief Get the number of bytes stored in the compile-time selected trace backend.
 	 *
@@ -99,6 +123,17 @@ struct nrf_modem_lib_trace_backend {
 	 * @return 0 on success, negative errno on failure.
 	 */
 	int (*clear)(void);
+
+	/**
+	 * @brief Get the statistics of the compile-time selected trace backend.
+	 *
+	 * @note Set to @c NULL if this operation is not supported by the trace backend.
+	 *
+	 * @param stats Statistics output.
+	 *
+	 * @return 0 on success, negative errno on failure.
+	 */
+	int (*stats_get)(struct nrf_modem_lib_trace_backend_stats *stats);
 };
 
 /**@} */ /* defgroup trace_backend */
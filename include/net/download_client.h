@@ -174,8 +174,30 @@ struct download_client {
 		bool connection_close;
 		/** Is using ranged query. */
 		bool ranged;
+		/** Hash of the entity tag (ETag) of the resource, zero if none. */
+		uint32_t etag;
 	} http;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_PARALLEL)
+	struct {
+		/** Socket of each connection, -1 if not connected. */
+		int fd[CONFIG_DOWNLOAD_CLIENT_PARALLEL_CONN_MAX];
+		/** Start of the range in flight on each connection. */
+		size_t start[CONFIG_DOWNLOAD_CLIENT_PARALLEL_CONN_MAX];
+		/** Start of the next range to request. */
+		size_t next;
+		/** Number of ranges to keep in flight. */
+		uint8_t window;
+		/** Fragments received since the last throughput sample. */
+		uint8_t samples;
+		/** Uptime and progress at the last throughput sample. */
+		int64_t sample_time;
+		size_t sample_progress;
+		/** Last measured throughput, in bytes per second. */
+		uint32_t rate;
+	} parallel;
+#endif
+
 	struct {
 		/** CoAP block context. */
 		struct coap_block_context block_ctx;
@@ -286,6 +308,22 @@ int download_client_start(struct download_client *client, const char *file,
  */
 int download_client_file_size_get(struct download_client *client, size_t *size);
 
+/**
+ * @brief Retrieve a hash of the entity tag (ETag) of the file being downloaded.
+ *
+ * The entity tag identifies a version of the file on the HTTP server,
+ * and is only available after the download has begun.
+ * The download is stopped with an error if the entity tag changes
+ * in the middle of a download.
+ *
+ * @param[in]  client	Client instance.
+ * @param[out] etag	Hash of the entity tag.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ *	       -ENODATA if the server did not send an entity tag.
+ */
+int download_client_etag_get(struct download_client *client, uint32_t *etag);
+
 /**
  * @brief Initiate disconnection.
  *
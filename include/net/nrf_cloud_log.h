@@ -113,6 +113,41 @@ bool nrf_cloud_is_text_logging_enabled(void);
  */
 bool nrf_cloud_is_dict_logging_enabled(void);
 
+/** @brief Statistics of the nRF Cloud logging backend. */
+struct nrf_cloud_log_stats {
+	/** Total number of lines logged */
+	uint32_t lines_rendered;
+	/** Total number of bytes (before TLS) logged */
+	uint32_t bytes_rendered;
+	/** Total number of lines sent */
+	uint32_t lines_sent;
+	/** Total number of bytes (before TLS) sent */
+	uint32_t bytes_sent;
+	/** Total number of lines dropped by the logging system */
+	uint32_t lines_dropped;
+	/** Total number of repeated lines that were suppressed */
+	uint32_t lines_deduplicated;
+	/** Total number of lines dropped by the per-source rate limiter */
+	uint32_t lines_rate_limited;
+	/** Total number of dictionary log bytes before compression */
+	uint32_t bytes_uncompressed;
+	/** Total number of dictionary log bytes after compression */
+	uint32_t bytes_compressed;
+};
+
+/**
+ * @brief Get the statistics of the nRF Cloud logging backend.
+ *
+ * The compression ratio in percent is bytes_compressed * 100 / bytes_uncompressed.
+ *
+ * @param[out] stats Statistics.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL stats is NULL.
+ * @retval -ENOTSUP CONFIG_NRF_CLOUD_LOG_BACKEND is not enabled.
+ */
+int nrf_cloud_log_stats_get(struct nrf_cloud_log_stats *stats);
+
 #if defined(CONFIG_NRF_CLOUD_LOG_DIRECT)
 #if defined(CONFIG_NRF_CLOUD_MQTT) || defined(CONFIG_NRF_CLOUD_COAP)
 /**
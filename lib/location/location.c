@@ -16,6 +16,9 @@
 #endif
 
 #include "location_core.h"
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+#include "method_gnss.h"
+#endif
 
 LOG_MODULE_REGISTER(location, CONFIG_LOCATION_LOG_LEVEL);
 
@@ -346,3 +349,38 @@ void location_cloud_location_ext_result_set(
 	location_core_cloud_location_ext_result_set(result, location);
 #endif
 }
+
+int location_ttff_stats_get(struct location_ttff_stats *stats)
+{
+#if defined(CONFIG_LOCATION_TTFF_STATS)
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	location_core_ttff_stats_get(stats);
+
+	return 0;
+#endif
+	return -ENOTSUP;
+}
+
+void location_ttff_stats_reset(void)
+{
+#if defined(CONFIG_LOCATION_TTFF_STATS)
+	location_core_ttff_stats_reset();
+#endif
+}
+
+int location_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats)
+{
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	method_gnss_assistance_stats_get(stats);
+
+	return 0;
+#endif
+	return -ENOTSUP;
+}
@@ -69,6 +69,12 @@ K_WORK_DEFINE(location_event_cb_work, location_core_event_cb_fn);
 /** Semaphore protecting the use of location requests. */
 K_SEM_DEFINE(location_core_sem, 1, 1);
 
+#if defined(CONFIG_LOCATION_TTFF_STATS)
+/** Time-to-fix statistics and the lock protecting them. */
+static struct location_ttff_stats ttff_stats;
+static struct k_spinlock ttff_stats_lock;
+#endif
+
 /***** Location method configurations *****/
 
 #if defined(CONFIG_LOCATION_METHOD_GNSS)
@@ -158,6 +164,7 @@ static void location_core_current_event_data_init(enum location_method method)
 	memset(&loc_req_info.current_event_data, 0, sizeof(loc_req_info.current_event_data));
 
 	loc_req_info.current_method = method;
+	loc_req_info.method_start_uptime = k_uptime_get();
 }
 
 static void location_core_current_config_clear(void)
@@ -648,6 +655,75 @@ enum location_method location_core_event_method_resolve(enum location_method met
 #endif
 }
 
+#if defined(CONFIG_LOCATION_TTFF_STATS)
+static void location_core_ttff_record(enum location_method method, int64_t ttff_ms)
+{
+	struct location_ttff_method_stats *stats;
+	k_spinlock_key_t key;
+	uint32_t bucket;
+
+	switch (method) {
+	case LOCATION_METHOD_GNSS:
+		stats = &ttff_stats.gnss;
+		break;
+	case LOCATION_METHOD_CELLULAR:
+		stats = &ttff_stats.cellular;
+		break;
+	case LOCATION_METHOD_WIFI:
+		stats = &ttff_stats.wifi;
+		break;
+	case LOCATION_METHOD_INTERNAL_WIFI_CELLULAR:
+		stats = &ttff_stats.wifi_cellular;
+		break;
+	default:
+		return;
+	}
+
+	ttff_ms = CLAMP(ttff_ms, 0, UINT32_MAX);
+
+	/* Bucket i holds times below 2^i seconds. */
+	bucket = 0;
+	while (bucket < LOCATION_TTFF_HIST_BUCKETS - 1 && ttff_ms >= (MSEC_PER_SEC << bucket)) {
+		bucket++;
+	}
+
+	key = k_spin_lock(&ttff_stats_lock);
+
+	if (stats->fixes == 0 || ttff_ms < stats->min_ms) {
+		stats->min_ms = ttff_ms;
+	}
+	if (ttff_ms > stats->max_ms) {
+		stats->max_ms = ttff_ms;
+	}
+	stats->fixes++;
+	stats->total_ms += ttff_ms;
+	stats->hist[bucket]++;
+
+	k_spin_unlock(&ttff_stats_lock, key);
+
+	LOG_DBG("Time to fix with '%s': %lld ms",
+		(char *)location_method_api_get(method)->method_string, ttff_ms);
+}
+
+void location_core_ttff_stats_get(struct location_ttff_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&ttff_stats_lock);
+
+	*stats = ttff_stats;
+
+	k_spin_unlock(&ttff_stats_lock, key);
+}
+
+void location_core_ttff_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ttff_stats_lock);
+
+	memset(&ttff_stats, 0, sizeof(ttff_stats));
+
+	k_spin_unlock(&ttff_stats_lock, key);
+}
+#endif /* CONFIG_LOCATION_TTFF_STATS */
+
 static void location_core_event_cb_fn(struct k_work *work)
 {
 	char latitude_str[12];
@@ -668,6 +744,11 @@ static void location_core_event_cb_fn(struct k_work *work)
 		 * Caller sets loc_req_info.current_event_data.location
 		 */
 
+#if defined(CONFIG_LOCATION_TTFF_STATS)
+		location_core_ttff_record(loc_req_info.current_method,
+					  k_uptime_get() - loc_req_info.method_start_uptime);
+#endif
+
 		LOG_DBG("Location acquired successfully:");
 		LOG_DBG("  method: %s (%d)", (char *)location_method_api_get(
 			loc_req_info.current_event_data.method)->method_string,
@@ -763,6 +844,11 @@ static void location_core_event_cb_fn(struct k_work *work)
 			location_core_work_queue_get(),
 			&location_periodic_work,
 			K_SECONDS(loc_req_info.config.interval));
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+		if (loc_req_info.gnss != NULL) {
+			method_gnss_prefetch_schedule(loc_req_info.config.interval);
+		}
+#endif
 	} else {
 		location_core_current_config_clear();
 
@@ -856,6 +942,9 @@ int location_core_cancel(void)
 	k_work_cancel_delayable(&location_core_timeout_work);
 	k_work_cancel_delayable(&location_periodic_work);
 	k_work_cancel(&location_event_cb_work);
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	method_gnss_prefetch_cancel();
+#endif
 
 	/* Check if location has been requested using one of the methods */
 	if (current_method != 0) {
@@ -42,6 +42,9 @@ struct location_request_info {
 	 * This is used in cloud location method to calculate timeout for the cloud operation.
 	 */
 	int64_t timeout_uptime;
+
+	/** Device uptime when the currently used method was started. */
+	int64_t method_start_uptime;
 };
 
 struct location_method_api {
@@ -84,5 +87,9 @@ void location_core_config_log(const struct location_config *config);
 void location_core_timer_start(int32_t timeout);
 void location_core_timer_stop(void);
 struct k_work_q *location_core_work_queue_get(void);
+#if defined(CONFIG_LOCATION_TTFF_STATS)
+void location_core_ttff_stats_get(struct location_ttff_stats *stats);
+void location_core_ttff_stats_reset(void);
+#endif
 
 #endif /* LOCATION_CORE_H */
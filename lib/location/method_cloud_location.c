@@ -36,6 +36,28 @@ struct method_cloud_location_start_work_args {
 static struct method_cloud_location_start_work_args method_cloud_location_start_work;
 static bool running;
 
+#if CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS > 0
+static void method_cloud_location_scan_deadline_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	/* Wi-Fi scan completed a while ago, do not wait for the cell measurements any longer */
+	if (scan_cellular_cancel() == 0) {
+		LOG_INF("Cell measurements cancelled at the scan deadline");
+	}
+}
+
+/* Run in the system work queue, as the location work queue is blocked by the measurements */
+static K_WORK_DELAYABLE_DEFINE(method_cloud_location_scan_deadline_work,
+			       method_cloud_location_scan_deadline_work_fn);
+
+static void method_cloud_location_wifi_scan_done(void)
+{
+	k_work_schedule(&method_cloud_location_scan_deadline_work,
+			K_MSEC(CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS));
+}
+#endif
+
 static void method_cloud_location_positioning_work_fn(struct k_work *work)
 {
 	struct method_cloud_location_start_work_args *work_data =
@@ -48,6 +70,8 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 	int err = 0;
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 	struct k_sem wifi_scan_ready;
+	scan_wifi_done_cb_t wifi_scan_done_cb = NULL;
+	k_timeout_t wifi_scan_wait = K_FOREVER;
 
 	k_sem_init(&wifi_scan_ready, 0, 1);
 #endif
@@ -63,9 +87,18 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 
 	location_core_timer_start(used_timeout_ms);
 
+#if CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS > 0
+	/* Both scans run in parallel. Whichever completes first starts the deadline for
+	 * the other one.
+	 */
+	if (wifi_config != NULL && cell_config != NULL) {
+		wifi_scan_done_cb = method_cloud_location_wifi_scan_done;
+	}
+#endif
+
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 	if (wifi_config != NULL) {
-		err = scan_wifi_start(&wifi_scan_ready);
+		err = scan_wifi_start(&wifi_scan_ready, wifi_scan_done_cb);
 	}
 #endif
 
@@ -76,13 +109,36 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 	}
 #endif
 
+#if CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS > 0
+	if (wifi_scan_done_cb != NULL) {
+		(void)k_work_cancel_delayable(&method_cloud_location_scan_deadline_work);
+		wifi_scan_wait = K_MSEC(CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS);
+	}
+#endif
+
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 	if (wifi_config != NULL) {
-		k_sem_take(&wifi_scan_ready, K_FOREVER);
+		if (k_sem_take(&wifi_scan_ready, wifi_scan_wait) == -EAGAIN && running) {
+			/* Use the access points found so far */
+			LOG_INF("Wi-Fi scanning cancelled at the scan deadline");
+			scan_wifi_cancel();
+		}
 		scan_wifi_info = scan_wifi_results_get();
 	}
 #endif
 
+#if CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS > 0
+	if (wifi_scan_done_cb != NULL) {
+		struct k_work_sync sync;
+
+		/* Wi-Fi scan may have completed after the cell measurements. Make sure the
+		 * deadline cannot fire during the next request.
+		 */
+		(void)k_work_cancel_delayable_sync(&method_cloud_location_scan_deadline_work,
+						   &sync);
+	}
+#endif
+
 	if (!running) {
 		goto end;
 	}
@@ -169,6 +225,9 @@ end:
 int method_cloud_location_cancel(void)
 {
 	if (running) {
+#if CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS > 0
+		(void)k_work_cancel_delayable(&method_cloud_location_scan_deadline_work);
+#endif
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 		scan_wifi_cancel();
 #endif
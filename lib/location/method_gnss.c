@@ -76,6 +76,10 @@ BUILD_ASSERT(
 /* A-GPS minimum number of expired almanacs to request all almanacs. */
 #define AGPS_ALM_MIN_COUNT 3
 #endif
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+#define EXPIRY_MIN_COUNT_MAX \
+	MAX(PGPS_EPHE_MIN_COUNT, MAX(AGPS_EPHE_MIN_COUNT, AGPS_ALM_MIN_COUNT))
+#endif
 
 #define VISIBILITY_DETECTION_EXEC_TIME CONFIG_LOCATION_METHOD_GNSS_VISIBILITY_DETECTION_EXEC_TIME
 #define VISIBILITY_DETECTION_SAT_LIMIT CONFIG_LOCATION_METHOD_GNSS_VISIBILITY_DETECTION_SAT_LIMIT
@@ -151,6 +155,21 @@ static void method_gnss_pgps_ext_work_fn(struct k_work *item);
 static int insuf_timewin_count;
 static int fixes_remaining;
 
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+static struct k_work_delayable method_gnss_prefetch_work;
+/* Set when the prefetch window is open and the prefetch waits for LTE to become active. */
+static bool prefetch_pending;
+/* Set while assistance data is requested by the prefetch. */
+static bool prefetching;
+/* Time in seconds added to the expiry thresholds while prefetching. */
+static uint32_t expiry_lookahead;
+/* Uptime of the next periodic location request. */
+static int64_t next_request_uptime;
+/* Uptime until which the assistance data in GNSS is known to be valid, zero if unknown. */
+static int64_t assistance_valid_until;
+static struct location_gnss_assistance_stats assistance_stats;
+#endif
+
 #if defined(CONFIG_LOCATION_DATA_DETAILS)
 static struct location_data_details_gnss location_data_details_gnss;
 #endif
@@ -233,6 +252,13 @@ void method_gnss_lte_ind_handler(const struct lte_lc_evt *const evt)
 		if (evt->rrc_mode == LTE_LC_RRC_MODE_CONNECTED) {
 			/* Prevent GNSS from starting while RRC is in connected mode. */
 			k_sem_reset(&entered_rrc_idle);
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+			/* LTE is active anyway, fetch assistance data now if it is needed. */
+			if (prefetch_pending) {
+				k_work_reschedule_for_queue(location_core_work_queue_get(),
+							    &method_gnss_prefetch_work, K_NO_WAIT);
+			}
+#endif
 		} else if (evt->rrc_mode == LTE_LC_RRC_MODE_IDLE) {
 			/* Allow GNSS operation once RRC is in idle mode. */
 			k_sem_give(&entered_rrc_idle);
@@ -475,6 +501,20 @@ bool method_gnss_agps_required(struct nrf_modem_gnss_agps_data_frame *request)
  */
 static void method_gnss_assistance_request(void)
 {
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	assistance_valid_until = 0;
+
+	if (prefetching) {
+		assistance_stats.prefetches++;
+	} else {
+		assistance_stats.on_demand++;
+	}
+
+	if (k_sem_count_get(&entered_rrc_idle) != 0) {
+		assistance_stats.lte_wakeups++;
+	}
+#endif
+
 #if defined(CONFIG_NRF_CLOUD_PGPS)
 	/* Ephemerides come from P-GPS. */
 	pgps_agps_request.sv_mask_ephe = agps_request.sv_mask_ephe;
@@ -984,7 +1024,8 @@ static void method_gnss_positioning_work_fn(struct k_work *work)
  */
 static bool method_gnss_agps_expiry_process(const struct nrf_modem_gnss_agps_expiry *agps_expiry)
 {
-	uint16_t ephe_expiry_threshold;
+	uint32_t ephe_expiry_threshold;
+	uint32_t agps_expiry_threshold = AGPS_EXPIRY_THRESHOLD;
 	uint8_t expired_ephes_min_count;
 	uint8_t expired_ephes = 0;
 	uint8_t expired_alms = 0;
@@ -997,12 +1038,18 @@ static bool method_gnss_agps_expiry_process(const struct nrf_modem_gnss_agps_exp
 		ephe_expiry_threshold = AGPS_EXPIRY_THRESHOLD;
 	}
 
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	/* Also request the data which is going to expire before the next location request. */
+	ephe_expiry_threshold += expiry_lookahead;
+	agps_expiry_threshold += expiry_lookahead;
+#endif
+
 	for (int i = 0; i < NRF_MODEM_GNSS_NUM_GPS_SATELLITES; i++) {
 		if (agps_expiry->ephe_expiry[i] <= ephe_expiry_threshold) {
 			expired_ephes++;
 		}
 
-		if (agps_expiry->alm_expiry[i] <= AGPS_EXPIRY_THRESHOLD) {
+		if (agps_expiry->alm_expiry[i] <= agps_expiry_threshold) {
 			expired_alms++;
 		}
 	}
@@ -1021,15 +1068,15 @@ static bool method_gnss_agps_expiry_process(const struct nrf_modem_gnss_agps_exp
 		agps_request.sv_mask_alm = 0xffffffff;
 	}
 
-	if (agps_expiry->utc_expiry <= AGPS_EXPIRY_THRESHOLD) {
+	if (agps_expiry->utc_expiry <= agps_expiry_threshold) {
 		agps_request.data_flags |= NRF_MODEM_GNSS_AGPS_GPS_UTC_REQUEST;
 	}
 
-	if (agps_expiry->klob_expiry <= AGPS_EXPIRY_THRESHOLD) {
+	if (agps_expiry->klob_expiry <= agps_expiry_threshold) {
 		agps_request.data_flags |= NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST;
 	}
 
-	if (agps_expiry->neq_expiry <= AGPS_EXPIRY_THRESHOLD) {
+	if (agps_expiry->neq_expiry <= agps_expiry_threshold) {
 		agps_request.data_flags |= NRF_MODEM_GNSS_AGPS_NEQUICK_REQUEST;
 	}
 
@@ -1037,7 +1084,7 @@ static bool method_gnss_agps_expiry_process(const struct nrf_modem_gnss_agps_exp
 		agps_request.data_flags |= NRF_MODEM_GNSS_AGPS_SYS_TIME_AND_SV_TOW_REQUEST;
 	}
 
-	if (agps_expiry->integrity_expiry <= AGPS_EXPIRY_THRESHOLD) {
+	if (agps_expiry->integrity_expiry <= agps_expiry_threshold) {
 		agps_request.data_flags |= NRF_MODEM_GNSS_AGPS_INTEGRITY_REQUEST;
 	}
 
@@ -1064,6 +1111,70 @@ static bool method_gnss_agps_expiry_process(const struct nrf_modem_gnss_agps_exp
 	       agps_request.data_flags != 0x0;
 }
 
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+/* Returns the count'th smallest expiry time in seconds, reduced by the given threshold. */
+static uint32_t method_gnss_expiry_nth_smallest(const uint16_t *expiry, uint8_t count,
+						uint16_t threshold)
+{
+	uint16_t smallest[EXPIRY_MIN_COUNT_MAX];
+	uint8_t found = 0;
+	int j;
+
+	__ASSERT_NO_MSG(count > 0 && count <= EXPIRY_MIN_COUNT_MAX);
+
+	/* Insertion sort into a list of the smallest values. */
+	for (int i = 0; i < NRF_MODEM_GNSS_NUM_GPS_SATELLITES; i++) {
+		if (found == count && expiry[i] >= smallest[count - 1]) {
+			continue;
+		}
+
+		j = (found < count) ? found++ : count - 1;
+		while (j > 0 && smallest[j - 1] > expiry[i]) {
+			smallest[j] = smallest[j - 1];
+			j--;
+		}
+		smallest[j] = expiry[i];
+	}
+
+	return smallest[count - 1] > threshold ? smallest[count - 1] - threshold : 0;
+}
+
+/* Returns the time in seconds until method_gnss_agps_expiry_process() would request some
+ * assistance data. Must only be called when it did not request anything.
+ */
+static uint32_t method_gnss_agps_expiry_margin(const struct nrf_modem_gnss_agps_expiry *agps_expiry)
+{
+	uint32_t margin;
+
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS)) {
+		margin = method_gnss_expiry_nth_smallest(agps_expiry->ephe_expiry,
+							 PGPS_EPHE_MIN_COUNT,
+							 PGPS_EXPIRY_THRESHOLD);
+	} else {
+		margin = method_gnss_expiry_nth_smallest(agps_expiry->ephe_expiry,
+							 AGPS_EPHE_MIN_COUNT,
+							 AGPS_EXPIRY_THRESHOLD);
+	}
+
+	margin = MIN(margin, method_gnss_expiry_nth_smallest(agps_expiry->alm_expiry,
+							     AGPS_ALM_MIN_COUNT,
+							     AGPS_EXPIRY_THRESHOLD));
+
+	/* The expiry of the other assistance data is above the threshold at this point. */
+	margin = MIN(margin, agps_expiry->utc_expiry - AGPS_EXPIRY_THRESHOLD);
+	margin = MIN(margin, agps_expiry->klob_expiry - AGPS_EXPIRY_THRESHOLD);
+	margin = MIN(margin, agps_expiry->neq_expiry - AGPS_EXPIRY_THRESHOLD);
+	margin = MIN(margin, agps_expiry->integrity_expiry - AGPS_EXPIRY_THRESHOLD);
+
+	return margin;
+}
+
+static bool method_gnss_assistance_valid_at(int64_t uptime)
+{
+	return assistance_valid_until != 0 && uptime < assistance_valid_until;
+}
+#endif /* CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH */
+
 /* Queries assistance data need from GNSS.
  *
  * To maintain backward compatibility with older modem firmware versions, two different methods are
@@ -1099,9 +1210,73 @@ static void method_gnss_agps_req_work_fn(struct k_work *work)
 	if (method_gnss_agps_expiry_process(&agps_expiry)) {
 		method_gnss_assistance_request();
 	}
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	else {
+		assistance_valid_until = k_uptime_get() +
+			method_gnss_agps_expiry_margin(&agps_expiry) * MSEC_PER_SEC;
+		LOG_DBG("Assistance data valid for %lld seconds",
+			(assistance_valid_until - k_uptime_get()) / MSEC_PER_SEC);
+	}
+#endif
 }
 #endif
 
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+static void method_gnss_prefetch_work_fn(struct k_work *work)
+{
+	if (running) {
+		/* GNSS has already been started and checked the assistance data need. */
+		prefetch_pending = false;
+		return;
+	}
+
+	if (method_gnss_assistance_valid_at(next_request_uptime)) {
+		LOG_DBG("Assistance data is valid for the next location request");
+		prefetch_pending = false;
+		return;
+	}
+
+	if (k_sem_count_get(&entered_rrc_idle) != 0) {
+		/* Don't wake up LTE just for the prefetch, wait for an RRC connection instead. */
+		LOG_DBG("Assistance data prefetch waiting for LTE to become active");
+		prefetch_pending = true;
+		return;
+	}
+
+	LOG_DBG("Prefetching assistance data");
+	prefetch_pending = false;
+
+	expiry_lookahead = MAX(next_request_uptime - k_uptime_get(), 0) / MSEC_PER_SEC;
+	prefetching = true;
+
+	method_gnss_agps_req_work_fn(NULL);
+
+	prefetching = false;
+	expiry_lookahead = 0;
+}
+
+void method_gnss_prefetch_schedule(int32_t interval)
+{
+	int32_t delay = MAX(interval - CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH_LEAD_TIME, 0);
+
+	next_request_uptime = k_uptime_get() + (int64_t)interval * MSEC_PER_SEC;
+
+	k_work_reschedule_for_queue(location_core_work_queue_get(),
+				    &method_gnss_prefetch_work, K_SECONDS(delay));
+}
+
+void method_gnss_prefetch_cancel(void)
+{
+	prefetch_pending = false;
+	(void)k_work_cancel_delayable(&method_gnss_prefetch_work);
+}
+
+void method_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats)
+{
+	*stats = assistance_stats;
+}
+#endif /* CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH */
+
 int method_gnss_location_get(const struct location_request_info *request)
 {
 	int err;
@@ -1141,6 +1316,21 @@ int method_gnss_location_get(const struct location_request_info *request)
 		}
 	}
 #endif
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	/* The prefetch window closes when GNSS is started. */
+	method_gnss_prefetch_cancel();
+
+	if (method_gnss_assistance_valid_at(k_uptime_get())) {
+		LOG_DBG("Assistance data is valid, starting GNSS right away");
+		assistance_stats.warm_starts++;
+
+		k_work_submit_to_queue(location_core_work_queue_get(), &method_gnss_start_work);
+
+		running = true;
+
+		return 0;
+	}
+#endif
 #if defined(CONFIG_NRF_CLOUD_AGPS) || defined(CONFIG_NRF_CLOUD_PGPS)
 	k_work_submit_to_queue(location_core_work_queue_get(), &method_gnss_agps_req_work);
 	/* Sleep for a while before submitting the next work, otherwise A-GPS data may not be
@@ -1184,6 +1374,9 @@ int method_gnss_init(void)
 		    method_gnss_agps_req_event_handle_work_fn);
 	k_work_init(&method_gnss_agps_req_work, method_gnss_agps_req_work_fn);
 #endif
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	k_work_init_delayable(&method_gnss_prefetch_work, method_gnss_prefetch_work_fn);
+#endif
 
 #if defined(CONFIG_NRF_CLOUD_PGPS)
 #if defined(CONFIG_LOCATION_SERVICE_EXTERNAL)
@@ -14,5 +14,10 @@ int method_gnss_timeout(void);
 #if defined(CONFIG_LOCATION_DATA_DETAILS)
 void method_gnss_details_get(struct location_data_details *details);
 #endif
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+void method_gnss_prefetch_schedule(int32_t interval);
+void method_gnss_prefetch_cancel(void);
+void method_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats);
+#endif
 
 #endif /* METHOD_GNSS_H */
@@ -29,6 +29,12 @@ static struct k_sem scan_cellular_sem_ncellmeas_evt;
 /* Requested number of cells to be searched. */
 static int8_t scan_cellular_cell_count;
 
+#if CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS > 0
+/* Uptime and requested cell count of the last complete measurement, used for reusing it. */
+static int64_t scan_cellular_results_uptime;
+static uint8_t scan_cellular_results_cell_count;
+#endif
+
 struct lte_lc_cells_info *scan_cellular_results_get(void)
 {
 	if (scan_cellular_info.current_cell.id == LTE_LC_CELL_EUTRAN_ID_INVALID) {
@@ -93,6 +99,20 @@ int scan_cellular_start(uint8_t cell_count)
 	};
 	int err;
 
+#if CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS > 0
+	if (scan_cellular_info.current_cell.id != LTE_LC_CELL_EUTRAN_ID_INVALID &&
+	    scan_cellular_results_uptime != 0 &&
+	    scan_cellular_results_cell_count >= cell_count &&
+	    k_uptime_get() - scan_cellular_results_uptime <=
+		CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS) {
+		LOG_DBG("Reusing cell measurements from %lld ms ago",
+			k_uptime_get() - scan_cellular_results_uptime);
+		return 0;
+	}
+
+	scan_cellular_results_uptime = 0;
+#endif
+
 	running = true;
 	scan_cellular_cell_count = cell_count;
 	scan_cellular_info.current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
@@ -155,9 +175,19 @@ int scan_cellular_start(uint8_t cell_count)
 			err = 0;
 			goto end;
 		}
-		k_sem_take(&scan_cellular_sem_ncellmeas_evt, K_FOREVER);
+		err = k_sem_take(&scan_cellular_sem_ncellmeas_evt, K_FOREVER);
+		if (err) {
+			/* Cancelled during GCI search, neighbor cells are still valid */
+			err = 0;
+			goto end;
+		}
 	}
 
+#if CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS > 0
+	scan_cellular_results_uptime = k_uptime_get();
+	scan_cellular_results_cell_count = cell_count;
+#endif
+
 end:
 	running = false;
 	return err;
@@ -27,6 +27,12 @@ static struct wifi_scan_info scan_wifi_info = {
 	.ap_info = scan_results,
 };
 static struct k_sem *scan_wifi_ready;
+static scan_wifi_done_cb_t scan_wifi_done_cb;
+
+#if CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS > 0
+/* Uptime of the last complete scan, used for reusing its results. */
+static int64_t scan_wifi_results_uptime;
+#endif
 
 struct wifi_scan_info *scan_wifi_results_get(void)
 {
@@ -46,11 +52,41 @@ struct wifi_scan_info *scan_wifi_results_get(void)
 	return &scan_wifi_info;
 }
 
-int scan_wifi_start(struct k_sem *wifi_scan_ready)
+static void scan_wifi_done(void)
+{
+	struct k_sem *ready = scan_wifi_ready;
+	scan_wifi_done_cb_t done_cb = scan_wifi_done_cb;
+
+	scan_wifi_ready = NULL;
+	scan_wifi_done_cb = NULL;
+
+	/* The callback must not run after the waiter has been released, as the waiter
+	 * is then free to start the next request.
+	 */
+	if (done_cb != NULL) {
+		done_cb();
+	}
+	k_sem_give(ready);
+}
+
+int scan_wifi_start(struct k_sem *wifi_scan_ready, scan_wifi_done_cb_t done_cb)
 {
 	int ret;
 
 	scan_wifi_ready = wifi_scan_ready;
+	scan_wifi_done_cb = done_cb;
+
+#if CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS > 0
+	if (scan_wifi_results_uptime != 0 &&
+	    k_uptime_get() - scan_wifi_results_uptime <= CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS) {
+		LOG_DBG("Reusing Wi-Fi scanning results from %lld ms ago",
+			k_uptime_get() - scan_wifi_results_uptime);
+		scan_wifi_done();
+		return 0;
+	}
+
+	scan_wifi_results_uptime = 0;
+#endif
 
 	LOG_DBG("Triggering start of Wi-Fi scanning");
 
@@ -61,8 +97,9 @@ int scan_wifi_start(struct k_sem *wifi_scan_ready)
 	if (ret) {
 		LOG_ERR("Failed to initiate Wi-Fi scanning: %d", ret);
 		ret = -EFAULT;
-		k_sem_give(wifi_scan_ready);
-		wifi_scan_ready = NULL;
+		k_sem_give(scan_wifi_ready);
+		scan_wifi_ready = NULL;
+		scan_wifi_done_cb = NULL;
 	}
 	return ret;
 }
@@ -100,10 +137,12 @@ static void scan_wifi_done_handle(struct net_mgmt_event_callback *cb)
 		LOG_WRN("Wi-Fi scan request failed (%d)", status->status);
 	} else {
 		LOG_DBG("Scan request done with %d Wi-Fi APs", scan_wifi_info.cnt);
+#if CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS > 0
+		scan_wifi_results_uptime = k_uptime_get();
+#endif
 	}
 
-	k_sem_give(scan_wifi_ready);
-	scan_wifi_ready = NULL;
+	scan_wifi_done();
 }
 
 void scan_wifi_net_mgmt_event_handler(
@@ -132,6 +171,7 @@ int scan_wifi_cancel(void)
 	if (scan_wifi_ready != NULL) {
 		k_sem_reset(scan_wifi_ready);
 		scan_wifi_ready = NULL;
+		scan_wifi_done_cb = NULL;
 	}
 	return 0;
 }
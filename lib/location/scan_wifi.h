@@ -9,8 +9,14 @@
 
 #include <net/wifi_location_common.h>
 
+/* Called from the network management context when a started scan has completed, or
+ * synchronously from scan_wifi_start() when recent results are reused.
+ * Always called before the scan ready semaphore is given.
+ */
+typedef void (*scan_wifi_done_cb_t)(void);
+
 int scan_wifi_init(void);
-int scan_wifi_start(struct k_sem *wifi_scan_ready);
+int scan_wifi_start(struct k_sem *wifi_scan_ready, scan_wifi_done_cb_t done_cb);
 struct wifi_scan_info *scan_wifi_results_get(void);
 int scan_wifi_cancel(void);
 
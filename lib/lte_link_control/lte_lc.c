@@ -22,6 +22,7 @@
 #include <zephyr/logging/log.h>
 
 #include "lte_lc_helpers.h"
+#include "lte_lc_state.h"
 
 LOG_MODULE_REGISTER(lte_lc, CONFIG_LTE_LINK_CONTROL_LOG_LEVEL);
 
@@ -136,6 +137,8 @@ static bool is_cellid_valid(uint32_t cellid)
 	return true;
 }
 
+static int psm_get(int *tau, int *active_time);
+
 AT_MONITOR(ltelc_atmon_cereg, "+CEREG", at_handler_cereg);
 AT_MONITOR(ltelc_atmon_cscon, "+CSCON", at_handler_cscon);
 AT_MONITOR(ltelc_atmon_cedrxp, "+CEDRXP", at_handler_cedrxp);
@@ -210,6 +213,15 @@ static void at_handler_cereg(const char *response)
 		break;
 	}
 
+	lte_lc_state_update(LTE_LC_STATE_NW_REG_STATUS, &reg_status, true);
+	lte_lc_state_update(LTE_LC_STATE_CELL, &cell, true);
+	lte_lc_state_update(LTE_LC_STATE_LTE_MODE, &lte_mode, true);
+
+	/* The PSM configuration may change with any registration update, it is read
+	 * again below if there is someone to notify.
+	 */
+	lte_lc_state_clear(LTE_LC_STATE_PSM);
+
 	if (event_handler_list_is_empty()) {
 		return;
 	}
@@ -249,7 +261,7 @@ static void at_handler_cereg(const char *response)
 		return;
 	}
 
-	err = lte_lc_psm_get(&psm_cfg.tau, &psm_cfg.active_time);
+	err = psm_get(&psm_cfg.tau, &psm_cfg.active_time);
 	if (err) {
 		if (err != -EBADMSG) {
 			LOG_ERR("Failed to get PSM information");
@@ -257,6 +269,8 @@ static void at_handler_cereg(const char *response)
 		return;
 	}
 
+	lte_lc_state_update(LTE_LC_STATE_PSM, &psm_cfg, true);
+
 	/* PSM configuration update event */
 	if ((psm_cfg.tau != prev_psm_cfg.tau) ||
 	    (psm_cfg.active_time != prev_psm_cfg.active_time)) {
@@ -289,6 +303,8 @@ static void at_handler_cscon(const char *response)
 		LTE_LC_TRACE(LTE_LC_TRACE_RRC_CONNECTED);
 	}
 
+	lte_lc_state_update(LTE_LC_STATE_RRC_MODE, &evt.rrc_mode, true);
+
 	evt.type = LTE_LC_EVT_RRC_UPDATE;
 
 	event_handler_list_dispatch(&evt);
@@ -309,6 +325,8 @@ static void at_handler_cedrxp(const char *response)
 		return;
 	}
 
+	lte_lc_state_update(LTE_LC_STATE_EDRX, &evt.edrx_cfg, true);
+
 	evt.type = LTE_LC_EVT_EDRX_UPDATE;
 
 	event_handler_list_dispatch(&evt);
@@ -569,6 +587,8 @@ static int enable_notifications(void)
 		}
 	}
 
+	lte_lc_state_subscribed_set(true);
+
 	return 0;
 }
 
@@ -802,6 +822,8 @@ int lte_lc_init_and_connect_async(lte_lc_evt_handler_t handler)
 
 int lte_lc_deinit(void)
 {
+	lte_lc_state_invalidate();
+
 	if (is_initialized) {
 		is_initialized = false;
 
@@ -856,6 +878,8 @@ int lte_lc_psm_req(bool enable)
 {
 	int err;
 
+	lte_lc_state_clear(LTE_LC_STATE_PSM);
+
 	if (enable) {
 		if (strlen(psm_param_rptau) == 8 &&
 		    strlen(psm_param_rat) == 8) {
@@ -881,7 +905,7 @@ int lte_lc_psm_req(bool enable)
 	return 0;
 }
 
-int lte_lc_psm_get(int *tau, int *active_time)
+static int psm_get(int *tau, int *active_time)
 {
 	int err;
 	struct lte_lc_psm_cfg psm_cfg;
@@ -892,10 +916,6 @@ int lte_lc_psm_get(int *tau, int *active_time)
 	const char ch = ',';
 	char *comma_ptr;
 
-	if ((tau == NULL) || (active_time == NULL)) {
-		return -EINVAL;
-	}
-
 	/* Format of XMONITOR AT command response:
 	 * %XMONITOR: <reg_status>,[<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,<cell_id>,
 	 * <phys_cell_id>,<EARFCN>,<rsrp>,<snr>,<NW-provided_eDRX_value>,<Active-Time>,
@@ -973,6 +993,35 @@ int lte_lc_psm_get(int *tau, int *active_time)
 	return 0;
 }
 
+int lte_lc_psm_get(int *tau, int *active_time)
+{
+	int err;
+	struct lte_lc_psm_cfg psm_cfg;
+
+	if ((tau == NULL) || (active_time == NULL)) {
+		return -EINVAL;
+	}
+
+	if (lte_lc_state_lookup(LTE_LC_STATE_PSM, &psm_cfg)) {
+		*tau = psm_cfg.tau;
+		*active_time = psm_cfg.active_time;
+
+		return 0;
+	}
+
+	err = psm_get(&psm_cfg.tau, &psm_cfg.active_time);
+	if (err) {
+		return err;
+	}
+
+	lte_lc_state_update(LTE_LC_STATE_PSM, &psm_cfg, false);
+
+	*tau = psm_cfg.tau;
+	*active_time = psm_cfg.active_time;
+
+	return 0;
+}
+
 int lte_lc_edrx_param_set(enum lte_lc_lte_mode mode, const char *edrx)
 {
 	char *edrx_param;
@@ -1036,6 +1085,9 @@ int lte_lc_edrx_req(bool enable)
 	int err;
 	int actt[] = {AT_CEDRXS_ACTT_WB, AT_CEDRXS_ACTT_NB};
 
+	/* +CEDRXP notifications are only received while eDRX is requested. */
+	lte_lc_state_clear(LTE_LC_STATE_EDRX);
+
 	if (!enable) {
 		err = nrf_modem_at_printf(edrx_disable);
 		if (err) {
@@ -1144,6 +1196,10 @@ int lte_lc_nw_reg_status_get(enum lte_lc_nw_reg_status *status)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_lookup(LTE_LC_STATE_NW_REG_STATUS, status)) {
+		return 0;
+	}
+
 	/* Read network registration status */
 	err = nrf_modem_at_scanf("AT+CEREG?",
 		"+CEREG: "
@@ -1164,6 +1220,8 @@ int lte_lc_nw_reg_status_get(enum lte_lc_nw_reg_status *status)
 		*status = status_tmp;
 	}
 
+	lte_lc_state_update(LTE_LC_STATE_NW_REG_STATUS, status, false);
+
 	return 0;
 }
 
@@ -1321,6 +1379,10 @@ int lte_lc_func_mode_get(enum lte_lc_func_mode *mode)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_lookup(LTE_LC_STATE_FUNC_MODE, mode)) {
+		return 0;
+	}
+
 	/* Exactly one parameter is expected to match. */
 	err = nrf_modem_at_scanf(AT_CFUN_READ, "+CFUN: %hu", &mode_tmp);
 	if (err != 1) {
@@ -1330,6 +1392,8 @@ int lte_lc_func_mode_get(enum lte_lc_func_mode *mode)
 
 	*mode = mode_tmp;
 
+	lte_lc_state_update(LTE_LC_STATE_FUNC_MODE, mode, false);
+
 	return 0;
 }
 
@@ -1396,6 +1460,19 @@ int lte_lc_func_mode_set(enum lte_lc_func_mode mode)
 		return -EFAULT;
 	}
 
+	switch (mode) {
+	case LTE_LC_FUNC_MODE_POWER_OFF:
+	case LTE_LC_FUNC_MODE_NORMAL:
+	case LTE_LC_FUNC_MODE_RX_ONLY:
+	case LTE_LC_FUNC_MODE_OFFLINE:
+		lte_lc_state_update(LTE_LC_STATE_FUNC_MODE, &mode, false);
+		break;
+	default:
+		/* The modem reports the resulting mode, which depends on the previous one. */
+		lte_lc_state_clear(LTE_LC_STATE_FUNC_MODE);
+		break;
+	}
+
 	STRUCT_SECTION_FOREACH(lte_lc_cfun_cb, e) {
 		LOG_DBG("CFUN monitor callback: %p", e->callback);
 		e->callback(mode, e->context);
@@ -1413,6 +1490,10 @@ int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_lookup(LTE_LC_STATE_LTE_MODE, mode)) {
+		return 0;
+	}
+
 	err = nrf_modem_at_scanf(AT_CEREG_READ,
 		"+CEREG: "
 		"%*u,"		/* <n> */
@@ -1427,6 +1508,8 @@ int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode)
 		 */
 		*mode = LTE_LC_LTE_MODE_NONE;
 
+		lte_lc_state_update(LTE_LC_STATE_LTE_MODE, mode, false);
+
 		return 0;
 	} else if (err < 1) {
 		LOG_ERR("Could not get the LTE mode, error: %d", err);
@@ -1444,6 +1527,8 @@ int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode)
 		return -EBADMSG;
 	}
 
+	lte_lc_state_update(LTE_LC_STATE_LTE_MODE, mode, false);
+
 	return 0;
 }
 
@@ -9,6 +9,8 @@
 #include <modem/nrf_modem_lib.h>
 #include <zephyr/logging/log.h>
 
+#include "lte_lc_state.h"
+
 LOG_MODULE_DECLARE(lte_lc);
 
 NRF_MODEM_LIB_ON_INIT(lte_lc_init_hook, on_modem_init, NULL);
@@ -16,6 +18,9 @@ NRF_MODEM_LIB_ON_SHUTDOWN(lte_lc_shutdown_hook, on_modem_shutdown, NULL);
 
 static void on_modem_init(int err, void *ctx)
 {
+	/* The modem has restarted, nothing known about its state holds anymore. */
+	lte_lc_state_invalidate();
+
 	if (err) {
 		if (err == NRF_MODEM_DFU_RESULT_OK) {
 			LOG_DBG("Modem DFU, lte_lc not initialized");
@@ -79,5 +84,7 @@ static void on_modem_init(int err, void *ctx)
 
 static void on_modem_shutdown(void *ctx)
 {
+	lte_lc_state_invalidate();
+
 	(void)lte_lc_deinit();
 }
@@ -52,10 +52,54 @@ static int cmd_offline(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+#if defined(CONFIG_LTE_LC_STATE_CACHE)
+static int cmd_cache(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	struct lte_lc_state state;
+	struct lte_lc_state_cache_stats stats;
+
+	(void)lte_lc_state_get(&state);
+	(void)lte_lc_state_cache_stats_get(&stats);
+
+	shell_print(shell, "Valid items: 0x%02x", state.valid);
+
+	if (state.valid & BIT(LTE_LC_STATE_FUNC_MODE)) {
+		shell_print(shell, "Functional mode: %d", state.func_mode);
+	}
+	if (state.valid & BIT(LTE_LC_STATE_NW_REG_STATUS)) {
+		shell_print(shell, "Registration status: %d", state.nw_reg_status);
+	}
+	if (state.valid & BIT(LTE_LC_STATE_CELL)) {
+		shell_print(shell, "Cell ID: 0x%08x, TAC: 0x%04x", state.cell.id, state.cell.tac);
+	}
+	if (state.valid & BIT(LTE_LC_STATE_LTE_MODE)) {
+		shell_print(shell, "LTE mode: %d", state.lte_mode);
+	}
+	if (state.valid & BIT(LTE_LC_STATE_PSM)) {
+		shell_print(shell, "PSM TAU: %d s, active time: %d s",
+			    state.psm_cfg.tau, state.psm_cfg.active_time);
+	}
+	if (state.valid & BIT(LTE_LC_STATE_RRC_MODE)) {
+		shell_print(shell, "RRC mode: %d", state.rrc_mode);
+	}
+
+	shell_print(shell, "AT round-trips avoided: %u, modem queries: %u",
+		    stats.hits, stats.misses);
+
+	return 0;
+}
+#endif /* CONFIG_LTE_LC_STATE_CACHE */
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_lte,
 	SHELL_CMD(normal, NULL, "Send the modem to normal mode", cmd_normal),
 	SHELL_CMD(offline, NULL, "Send the modem to offline mode", cmd_offline),
 	SHELL_CMD(power_off, NULL, "Send the modem to power off mode", cmd_power_off),
+#if defined(CONFIG_LTE_LC_STATE_CACHE)
+	SHELL_CMD(cache, NULL, "Print the cached modem state", cmd_cache),
+#endif
 	SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <modem/lte_lc.h>
+
+#include "lte_lc_state.h"
+
+#define ITEM(_field, _notified)						\
+	{								\
+		.offset = offsetof(struct lte_lc_state, _field),	\
+		.size = sizeof(((struct lte_lc_state *)0)->_field),	\
+		.notified = _notified,					\
+	}
+
+static const struct {
+	size_t offset;
+	size_t size;
+	/* Kept up to date by +CEREG, +CSCON and +CEDRXP notifications. */
+	bool notified;
+} items[] = {
+	[LTE_LC_STATE_FUNC_MODE]	= ITEM(func_mode, false),
+	[LTE_LC_STATE_NW_REG_STATUS]	= ITEM(nw_reg_status, true),
+	[LTE_LC_STATE_CELL]		= ITEM(cell, true),
+	[LTE_LC_STATE_LTE_MODE]		= ITEM(lte_mode, true),
+	[LTE_LC_STATE_PSM]		= ITEM(psm_cfg, true),
+	[LTE_LC_STATE_EDRX]		= ITEM(edrx_cfg, true),
+	[LTE_LC_STATE_RRC_MODE]		= ITEM(rrc_mode, true),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(items) == LTE_LC_STATE_COUNT);
+
+static struct k_spinlock lock;
+static struct lte_lc_state state;
+static int64_t updated[LTE_LC_STATE_COUNT];
+static bool subscribed;
+static struct lte_lc_state_cache_stats stats;
+
+static bool item_is_fresh(enum lte_lc_state_item item)
+{
+	if (!(state.valid & BIT(item))) {
+		return false;
+	}
+
+	if (CONFIG_LTE_LC_STATE_CACHE_MAX_AGE_MS == 0) {
+		return true;
+	}
+
+	return (k_uptime_get() - updated[item]) <= CONFIG_LTE_LC_STATE_CACHE_MAX_AGE_MS;
+}
+
+void lte_lc_state_invalidate(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	state.valid = 0;
+	subscribed = false;
+
+	k_spin_unlock(&lock, key);
+}
+
+void lte_lc_state_subscribed_set(bool value)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	subscribed = value;
+
+	k_spin_unlock(&lock, key);
+}
+
+void lte_lc_state_update(enum lte_lc_state_item item, const void *value, bool from_notif)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(item < LTE_LC_STATE_COUNT);
+
+	key = k_spin_lock(&lock);
+
+	if (from_notif || !items[item].notified || subscribed) {
+		memcpy((uint8_t *)&state + items[item].offset, value, items[item].size);
+		updated[item] = k_uptime_get();
+		state.valid |= BIT(item);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+void lte_lc_state_clear(enum lte_lc_state_item item)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	state.valid &= ~BIT(item);
+
+	k_spin_unlock(&lock, key);
+}
+
+bool lte_lc_state_lookup(enum lte_lc_state_item item, void *value)
+{
+	bool fresh;
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(item < LTE_LC_STATE_COUNT);
+
+	key = k_spin_lock(&lock);
+
+	fresh = item_is_fresh(item);
+	if (fresh) {
+		memcpy(value, (uint8_t *)&state + items[item].offset, items[item].size);
+		stats.hits++;
+	} else {
+		stats.misses++;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return fresh;
+}
+
+int lte_lc_state_get(struct lte_lc_state *snapshot)
+{
+	k_spinlock_key_t key;
+
+	if (snapshot == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+
+	*snapshot = state;
+	snapshot->valid = 0;
+
+	for (size_t i = 0; i < LTE_LC_STATE_COUNT; i++) {
+		if (item_is_fresh(i)) {
+			snapshot->valid |= BIT(i);
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int lte_lc_state_cache_stats_get(struct lte_lc_state_cache_stats *out)
+{
+	k_spinlock_key_t key;
+
+	if (out == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	*out = stats;
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
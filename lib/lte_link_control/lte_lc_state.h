@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef LTE_LC_STATE_H__
+#define LTE_LC_STATE_H__
+
+#include <stdbool.h>
+#include <modem/lte_lc.h>
+
+#if defined(CONFIG_LTE_LC_STATE_CACHE)
+
+/* Invalidate the whole snapshot and forget the notification subscriptions. */
+void lte_lc_state_invalidate(void);
+
+/* Record whether the notifications that keep the snapshot up to date are subscribed. */
+void lte_lc_state_subscribed_set(bool subscribed);
+
+/* Store an item. Items kept up to date by notifications are only stored from
+ * AT command responses (from_notif == false) while the notifications are subscribed,
+ * otherwise a later change would go unnoticed.
+ */
+void lte_lc_state_update(enum lte_lc_state_item item, const void *value, bool from_notif);
+
+/* Invalidate a single item. */
+void lte_lc_state_clear(enum lte_lc_state_item item);
+
+/* Copy a valid and fresh item to value. Counts a hit if found, otherwise a miss. */
+bool lte_lc_state_lookup(enum lte_lc_state_item item, void *value);
+
+#else
+
+static inline void lte_lc_state_invalidate(void) {}
+
+static inline void lte_lc_state_subscribed_set(bool subscribed) {}
+
+static inline void lte_lc_state_update(enum lte_lc_state_item item, const void *value,
+				       bool from_notif) {}
+
+static inline void lte_lc_state_clear(enum lte_lc_state_item item) {}
+
+static inline bool lte_lc_state_lookup(enum lte_lc_state_item item, void *value)
+{
+	return false;
+}
+
+#endif /* CONFIG_LTE_LC_STATE_CACHE */
+
+#endif /* LTE_LC_STATE_H__ */
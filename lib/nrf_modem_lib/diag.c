@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/init.h>
 #include <zephyr/sys/sys_heap.h>
@@ -11,6 +12,8 @@
 #include <zephyr/logging/log.h>
 #include <modem/nrf_modem_lib.h>
 
+#include "slab_heap.h"
+
 LOG_MODULE_DECLARE(nrf_modem, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
 /* extern in nrf_modem_os.c */
@@ -20,11 +23,93 @@ uint32_t nrf_modem_lib_failed_allocs;		/* failed allocations on library heap */
 /* from nrf_modem_os.c */
 extern struct k_heap nrf_modem_lib_shmem_heap;
 extern struct k_heap nrf_modem_lib_heap;
+extern struct slab_heap nrf_modem_lib_shmem_slab_heap;
+extern struct slab_heap nrf_modem_lib_slab_heap;
+
+BUILD_ASSERT(SLAB_HEAP_HIST_BUCKETS == NRF_MODEM_LIB_DIAG_SIZE_HIST_BUCKETS);
+
+/* Set while the heaps are probed for their largest free block. */
+static bool probing;
+
+/* High-water marks of the heaps, kept across probing. */
+static size_t shmem_max_allocated;
+static size_t library_max_allocated;
 
 #if CONFIG_NRF_MODEM_LIB_MEM_DIAG_DUMP
 static struct k_work_delayable diag_work;
 #endif
 
+/* Find the largest block that can be allocated from the heap by a binary search.
+ * Interrupts are locked so that no allocation can fail because of the probes.
+ * Probing raises the runtime high-water mark of the heap, so the mark is kept in
+ * max_allocated and the heap's own mark is reset afterwards.
+ */
+static size_t heap_probe(struct k_heap *heap, struct sys_memory_stats *stats,
+			 size_t *max_allocated)
+{
+	size_t lo = 0;
+	size_t hi;
+	size_t mid;
+	void *mem;
+	uint32_t key = irq_lock();
+
+	sys_heap_runtime_stats_get(&heap->heap, stats);
+
+	*max_allocated = MAX(*max_allocated, stats->max_allocated_bytes);
+	stats->max_allocated_bytes = *max_allocated;
+
+	probing = true;
+
+	hi = stats->free_bytes;
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		mem = k_heap_alloc(heap, mid, K_NO_WAIT);
+		if (mem) {
+			k_heap_free(heap, mem);
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	probing = false;
+
+	(void)sys_heap_runtime_stats_reset_max(&heap->heap);
+
+	irq_unlock(key);
+
+	return lo;
+}
+
+static void heap_stats_get(struct slab_heap *sh, struct nrf_modem_lib_diag_heap_stats *stats,
+			   uint32_t failed_allocs, size_t *max_allocated)
+{
+	stats->failed_allocs = failed_allocs;
+	stats->largest_free_block = heap_probe(sh->heap, &stats->heap, max_allocated);
+
+	for (size_t i = 0; i < SLAB_HEAP_HIST_BUCKETS; i++) {
+		stats->size_hist[i] = atomic_get(&sh->size_hist[i]);
+	}
+
+#if CONFIG_NRF_MODEM_LIB_MEM_SLAB
+	memset(stats->slab, 0, sizeof(stats->slab));
+
+	for (size_t i = 0; i < MIN(sh->num_classes, ARRAY_SIZE(stats->slab)); i++) {
+		struct slab_heap_class *class = &sh->classes[i];
+
+		if (!class->buf) {
+			continue;
+		}
+
+		stats->slab[i].block_size = class->block_size;
+		stats->slab[i].blocks = class->num_blocks;
+		stats->slab[i].used = k_mem_slab_num_used_get(&class->slab);
+		stats->slab[i].max_used = class->max_used;
+		stats->slab[i].fallbacks = atomic_get(&class->fallbacks);
+	}
+#endif
+}
+
 int nrf_modem_lib_diag_stats_get(struct nrf_modem_lib_diag_stats *stats)
 {
 	/* Prevent runtime stats get of uninitialized heap which causes unresponsiveness. */
@@ -36,11 +121,10 @@ int nrf_modem_lib_diag_stats_get(struct nrf_modem_lib_diag_stats *stats)
 		return -EFAULT;
 	}
 
-	sys_heap_runtime_stats_get(&nrf_modem_lib_shmem_heap.heap, &stats->shmem.heap);
-	sys_heap_runtime_stats_get(&nrf_modem_lib_heap.heap, &stats->library.heap);
-
-	stats->shmem.failed_allocs = nrf_modem_lib_shmem_failed_allocs;
-	stats->library.failed_allocs = nrf_modem_lib_failed_allocs;
+	heap_stats_get(&nrf_modem_lib_shmem_slab_heap, &stats->shmem,
+		       nrf_modem_lib_shmem_failed_allocs, &shmem_max_allocated);
+	heap_stats_get(&nrf_modem_lib_slab_heap, &stats->library,
+		       nrf_modem_lib_failed_allocs, &library_max_allocated);
 
 	return 0;
 }
@@ -48,21 +132,37 @@ int nrf_modem_lib_diag_stats_get(struct nrf_modem_lib_diag_stats *stats)
 #if CONFIG_NRF_MODEM_LIB_MEM_DIAG_ALLOC
 static void on_heap_alloc(uintptr_t heap_id, void *mem, size_t bytes)
 {
+	if (probing) {
+		return;
+	}
+
 	LOG_INF("lib alloc %p, size %u", mem, bytes);
 }
 
 static void on_heap_free(uintptr_t heap_id, void *mem, size_t bytes)
 {
+	if (probing) {
+		return;
+	}
+
 	LOG_INF("lib free  %p, size %u", mem, bytes);
 }
 
 static void on_shmem_alloc(uintptr_t heap_id, void *mem, size_t bytes)
 {
+	if (probing) {
+		return;
+	}
+
 	LOG_INF("shm alloc %p, size %u", mem, bytes);
 }
 
 static void on_shmem_free(uintptr_t heap_id, void *mem, size_t bytes)
 {
+	if (probing) {
+		return;
+	}
+
 	LOG_INF("shm free  %p, size %u", mem, bytes);
 }
 #endif
@@ -74,12 +174,16 @@ static void diag_task(struct k_work *item)
 
 	(void)nrf_modem_lib_diag_stats_get(&stats);
 
-	LOG_INF("shm: free %.4u, allocated %.4u, max allocated %.4u, failed %u",
+	LOG_INF("shm: free %.4u, allocated %.4u, max allocated %.4u, largest free %.4u, "
+		"failed %u",
 		stats.shmem.heap.free_bytes, stats.shmem.heap.allocated_bytes,
-		stats.shmem.heap.max_allocated_bytes, nrf_modem_lib_shmem_failed_allocs);
-	LOG_INF("lib: free %.4u, allocated %.4u, max allocated %.4u, failed %u",
+		stats.shmem.heap.max_allocated_bytes, stats.shmem.largest_free_block,
+		nrf_modem_lib_shmem_failed_allocs);
+	LOG_INF("lib: free %.4u, allocated %.4u, max allocated %.4u, largest free %.4u, "
+		"failed %u",
 		stats.library.heap.free_bytes, stats.library.heap.allocated_bytes,
-		stats.library.heap.max_allocated_bytes, nrf_modem_lib_failed_allocs);
+		stats.library.heap.max_allocated_bytes, stats.library.largest_free_block,
+		nrf_modem_lib_failed_allocs);
 
 	k_work_reschedule(&diag_work, K_MSEC(CONFIG_NRF_MODEM_LIB_MEM_DIAG_DUMP_PERIOD_MS));
 }
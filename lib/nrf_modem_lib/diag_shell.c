@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <modem/nrf_modem_lib.h>
+
+static void heap_stats_print(const struct shell *shell, const char *name,
+			     const struct nrf_modem_lib_diag_heap_stats *stats)
+{
+	shell_print(shell, "%s: free %u, allocated %u, max allocated %u, largest free %u, "
+		    "failed %u",
+		    name, stats->heap.free_bytes, stats->heap.allocated_bytes,
+		    stats->heap.max_allocated_bytes, stats->largest_free_block,
+		    stats->failed_allocs);
+
+#if CONFIG_NRF_MODEM_LIB_MEM_SLAB
+	for (size_t i = 0; i < ARRAY_SIZE(stats->slab); i++) {
+		const struct nrf_modem_lib_diag_slab_stats *slab = &stats->slab[i];
+
+		if (slab->block_size == 0) {
+			continue;
+		}
+
+		shell_print(shell, "  class %u: %4u bytes, used %u/%u, max used %u, fallbacks %u",
+			    i, slab->block_size, slab->used, slab->blocks, slab->max_used,
+			    slab->fallbacks);
+	}
+#endif
+}
+
+static void heap_hist_print(const struct shell *shell, const char *name,
+			    const struct nrf_modem_lib_diag_heap_stats *stats)
+{
+	const size_t last = ARRAY_SIZE(stats->size_hist) - 1;
+
+	shell_print(shell, "%s:", name);
+
+	for (size_t i = 0; i < last; i++) {
+		shell_print(shell, "  <= %4u bytes: %u", 16 << i, stats->size_hist[i]);
+	}
+
+	shell_print(shell, "   > %4u bytes: %u", 16 << (last - 1), stats->size_hist[last]);
+}
+
+static int diag_stats_get(const struct shell *shell, struct nrf_modem_lib_diag_stats *stats)
+{
+	int err;
+
+	err = nrf_modem_lib_diag_stats_get(stats);
+	if (err) {
+		shell_error(shell, "Failed to get memory statistics, err %d", err);
+	}
+
+	return err;
+}
+
+static int cmd_modem_mem_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	struct nrf_modem_lib_diag_stats stats;
+	int err;
+
+	err = diag_stats_get(shell, &stats);
+	if (err) {
+		return err;
+	}
+
+	heap_stats_print(shell, "shm", &stats.shmem);
+	heap_stats_print(shell, "lib", &stats.library);
+
+	return 0;
+}
+
+static int cmd_modem_mem_hist(const struct shell *shell, size_t argc, char **argv)
+{
+	struct nrf_modem_lib_diag_stats stats;
+	int err;
+
+	err = diag_stats_get(shell, &stats);
+	if (err) {
+		return err;
+	}
+
+	heap_hist_print(shell, "shm", &stats.shmem);
+	heap_hist_print(shell, "lib", &stats.library);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_modem_mem,
+	SHELL_CMD(stats, NULL, "Print heap and size class statistics", cmd_modem_mem_stats),
+	SHELL_CMD(hist, NULL, "Print allocation size histograms", cmd_modem_mem_hist),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(modem_mem, &sub_modem_mem, "Modem library memory diagnostics", NULL);
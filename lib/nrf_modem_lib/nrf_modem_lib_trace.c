@@ -116,8 +116,17 @@ K_WORK_DELAYABLE_DEFINE(backend_bps_log_work, backend_bps_log);
 
 static void backend_bps_log(struct k_work *item)
 {
+	struct nrf_modem_lib_trace_backend_stats stats;
+
 	LOG_INF("Trace backend bitrate (bps): %u", backend_bps_avg);
 
+	if (nrf_modem_lib_trace_backend_stats_get(&stats) == 0 && stats.bytes_out) {
+		LOG_INF("Trace backend bytes in: %llu, out: %llu, ratio: %u.%02u",
+			(unsigned long long)stats.bytes_in, (unsigned long long)stats.bytes_out,
+			(uint32_t)(stats.bytes_in / stats.bytes_out),
+			(uint32_t)((stats.bytes_in % stats.bytes_out) * 100 / stats.bytes_out));
+	}
+
 	k_work_schedule(&backend_bps_log_work, BACKEND_BPS_LOG_PERIOD);
 }
 #endif
@@ -189,6 +198,87 @@ int nrf_modem_lib_trace_processing_done_wait(k_timeout_t timeout)
 	return 0;
 }
 
+/* Signal that the backend is full and wait for it to be cleared.
+ * Returns 0 if writing can be retried.
+ */
+static int trace_space_wait(void)
+{
+	nrf_modem_lib_trace_callback(NRF_MODEM_LIB_TRACE_EVT_FULL);
+
+	if (!trace_backend.clear) {
+		return -ENOSPC;
+	}
+
+	has_space = false;
+	k_sem_give(&trace_done_sem);
+	k_sem_take(&trace_clear_sem, K_FOREVER);
+
+	return 0;
+}
+
+/* Write all fragments with a single scatter/gather operation per call. */
+static int trace_fragments_write_vec(struct nrf_modem_trace_data *frags, size_t n_frags)
+{
+	int ret;
+	size_t i = 0;
+	size_t offset = 0;
+	size_t written;
+	struct nrf_modem_trace_data head;
+
+	while (i < n_frags) {
+		PERF_START();
+
+		if (offset) {
+			/* Resume a partially written fragment. The fragments belong to
+			 * the modem library, so adjust a copy.
+			 */
+			head.data = (const uint8_t *)frags[i].data + offset;
+			head.len = frags[i].len - offset;
+			ret = trace_backend.write_vec(&head, 1);
+		} else {
+			ret = trace_backend.write_vec(&frags[i], n_frags - i);
+		}
+
+		PERF_END(ret);
+
+		__ASSERT(ret != 0, "Trace backend wrote 0 bytes");
+
+		if (ret == -EAGAIN) {
+			/* We don't allow retrying if the modem is shut down as that can block
+			 * a new modem init.
+			 */
+			if (!nrf_modem_is_initialized()) {
+				return -ESHUTDOWN;
+			}
+			continue;
+		}
+
+		if (ret == -ENOSPC) {
+			ret = trace_space_wait();
+			if (ret) {
+				return ret;
+			}
+			continue;
+		}
+
+		if (ret < 0) {
+			LOG_ERR("trace_backend.write_vec failed with err: %d", ret);
+			return ret;
+		}
+
+		/* Advance past the written bytes. */
+		written = ret;
+		while (i < n_frags && written >= frags[i].len - offset) {
+			written -= frags[i].len - offset;
+			offset = 0;
+			i++;
+		}
+		offset += written;
+	}
+
+	return 0;
+}
+
 static int trace_fragment_write(struct nrf_modem_trace_data *frag)
 {
 	int ret;
@@ -260,21 +350,25 @@ trace_reset:
 			goto deinit;
 		}
 
+		if (trace_backend.write_vec) {
+			err = trace_fragments_write_vec(frags, n_frags);
+			if (err) {
+				/* Irrecoverable error */
+				goto deinit;
+			}
+			continue;
+		}
+
 		for (int i = 0; i < n_frags; i++) {
 			err = trace_fragment_write(&frags[i]);
 			switch (err) {
 			case 0:
 				break;
 			case -ENOSPC:
-				nrf_modem_lib_trace_callback(NRF_MODEM_LIB_TRACE_EVT_FULL);
-
-				if (!trace_backend.clear) {
+				if (trace_space_wait()) {
 					goto deinit;
 				}
 
-				has_space = false;
-				k_sem_give(&trace_done_sem);
-				k_sem_take(&trace_clear_sem, K_FOREVER);
 				/* Try the same fragment again */
 				i--;
 				continue;
@@ -427,6 +521,19 @@ int nrf_modem_lib_trace_read(uint8_t *buf, size_t len)
 	return read;
 }
 
+int nrf_modem_lib_trace_backend_stats_get(struct nrf_modem_lib_trace_backend_stats *stats)
+{
+	if (!trace_backend.stats_get) {
+		return -ENOTSUP;
+	}
+
+	if (!stats) {
+		return -EFAULT;
+	}
+
+	return trace_backend.stats_get(stats);
+}
+
 int nrf_modem_lib_trace_clear(void)
 {
 	int err;
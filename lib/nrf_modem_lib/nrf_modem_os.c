@@ -16,13 +16,22 @@
 #include <pm_config.h>
 #include <zephyr/logging/log.h>
 
+#include "slab_heap.h"
+
 #define UNUSED_FLAGS 0
-#define THREAD_MONITOR_ENTRIES 10
+
+/* Number of thread monitor entries, must be a power of two. */
+#define THREAD_MONITOR_ENTRIES 16
+/* Number of wait queues sleeping threads are hashed into, must be a power of two. */
+#define WAIT_QUEUE_BUCKETS 16
+
+BUILD_ASSERT((THREAD_MONITOR_ENTRIES & (THREAD_MONITOR_ENTRIES - 1)) == 0);
+BUILD_ASSERT((WAIT_QUEUE_BUCKETS & (WAIT_QUEUE_BUCKETS - 1)) == 0);
 
 LOG_MODULE_REGISTER(nrf_modem, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
 struct sleeping_thread {
-	sys_snode_t node;
+	sys_dnode_t node;
 	struct k_sem sem;
 	uint32_t context;
 };
@@ -35,31 +44,98 @@ struct k_heap nrf_modem_lib_shmem_heap;
 struct k_heap nrf_modem_lib_heap;
 static uint8_t library_heap_buf[CONFIG_NRF_MODEM_LIB_HEAP_SIZE];
 
-/* An array of thread ID and RPC counter pairs, used to avoid race conditions.
+#if defined(CONFIG_NRF_MODEM_LIB_MEM_SLAB)
+/* Size classes, sorted by block size. */
+static struct slab_heap_class library_heap_classes[] = {
+	SLAB_HEAP_CLASS(CONFIG_NRF_MODEM_LIB_HEAP_SLAB_0_SIZE,
+			CONFIG_NRF_MODEM_LIB_HEAP_SLAB_0_COUNT),
+	SLAB_HEAP_CLASS(CONFIG_NRF_MODEM_LIB_HEAP_SLAB_1_SIZE,
+			CONFIG_NRF_MODEM_LIB_HEAP_SLAB_1_COUNT),
+	SLAB_HEAP_CLASS(CONFIG_NRF_MODEM_LIB_HEAP_SLAB_2_SIZE,
+			CONFIG_NRF_MODEM_LIB_HEAP_SLAB_2_COUNT),
+};
+
+static struct slab_heap_class shmem_heap_classes[] = {
+	SLAB_HEAP_CLASS(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_0_SIZE,
+			CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_0_COUNT),
+	SLAB_HEAP_CLASS(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_1_SIZE,
+			CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_1_COUNT),
+	SLAB_HEAP_CLASS(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_2_SIZE,
+			CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_2_COUNT),
+};
+#endif
+
+/* Allocator front-ends of the heaps, extern in diag.c */
+
+struct slab_heap nrf_modem_lib_shmem_slab_heap = {
+	.heap = &nrf_modem_lib_shmem_heap,
+#if defined(CONFIG_NRF_MODEM_LIB_MEM_SLAB)
+	.classes = shmem_heap_classes,
+	.num_classes = ARRAY_SIZE(shmem_heap_classes),
+#endif
+};
+
+struct slab_heap nrf_modem_lib_slab_heap = {
+	.heap = &nrf_modem_lib_heap,
+#if defined(CONFIG_NRF_MODEM_LIB_MEM_SLAB)
+	.classes = library_heap_classes,
+	.num_classes = ARRAY_SIZE(library_heap_classes),
+#endif
+};
+
+/* A table of thread ID and RPC counter pairs, used to avoid race conditions.
  * It allows to identify whether it is safe to put the thread to sleep or not.
+ * Threads are looked up by a hash of their ID, with linear probing.
  */
 static struct thread_monitor_entry {
 	k_tid_t id; /* Thread ID. */
 	int cnt; /* Last RPC event count. */
+	uint32_t used; /* Lookup count at which the entry was last used. */
 } thread_event_monitor[THREAD_MONITOR_ENTRIES];
 
-/* A list of threads that are sleeping and should be woken up on next event. */
-static sys_slist_t sleeping_threads;
+/* Lookup counter, orders the thread monitor entries by last use. */
+static uint32_t thread_monitor_clock;
+
+/* Threads that are sleeping and should be woken up on next event, hashed by context
+ * so that waking a specific context does not require walking every sleeping thread.
+ */
+static sys_dlist_t sleeping_threads[WAIT_QUEUE_BUCKETS];
 
 /* RPC event counter, incremented on each RPC event. */
 static atomic_t rpc_event_cnt;
 
+/* Fibonacci hash of a 32-bit value into an index of a power-of-two table. */
+static inline size_t hash_index(uint32_t value, size_t size)
+{
+	return (size_t)((value * 0x9E3779B1u) >> 16) & (size - 1);
+}
+
+static sys_dlist_t *wait_queue_get(uint32_t context)
+{
+	return &sleeping_threads[hash_index(context, WAIT_QUEUE_BUCKETS)];
+}
+
 /* Get thread monitor structure assigned to a specific thread id, with a RPC
- * counter value at which nrf_modem_lib last checked the 'readiness' of a thread
+ * counter value at which nrf_modem_lib last checked the 'readiness' of a thread.
+ *
+ * Entries are never freed, so the probe stops at the first unused entry. The whole
+ * table is probed if needed, so threads only compete for entries when there are more
+ * of them than entries. In that case, the least recently used entry is reused. An
+ * evicted thread only has to re-verify its readiness once, so this never loses a wakeup.
  */
 static struct thread_monitor_entry *thread_monitor_entry_get(k_tid_t id)
 {
-	struct thread_monitor_entry *entry = thread_event_monitor;
-	struct thread_monitor_entry *new_entry = thread_event_monitor;
-	int entry_age, oldest_entry_age = 0;
+	size_t idx = hash_index((uint32_t)(uintptr_t)id, THREAD_MONITOR_ENTRIES);
+	struct thread_monitor_entry *entry;
+	struct thread_monitor_entry *new_entry = NULL;
+
+	thread_monitor_clock++;
+
+	for (size_t i = 0; i < THREAD_MONITOR_ENTRIES; i++) {
+		entry = &thread_event_monitor[(idx + i) & (THREAD_MONITOR_ENTRIES - 1)];
 
-	for ( ; PART_OF_ARRAY(thread_event_monitor, entry); entry++) {
 		if (entry->id == id) {
+			entry->used = thread_monitor_clock;
 			return entry;
 		} else if (entry->id == 0) {
 			/* Uninitialized field. */
@@ -67,16 +143,15 @@ static struct thread_monitor_entry *thread_monitor_entry_get(k_tid_t id)
 			break;
 		}
 
-		/* Identify oldest entry. */
-		entry_age = rpc_event_cnt - entry->cnt;
-		if (entry_age > oldest_entry_age) {
-			oldest_entry_age = entry_age;
+		/* Identify least recently used entry. */
+		if (!new_entry || (int32_t)(entry->used - new_entry->used) < 0) {
 			new_entry = entry;
 		}
 	}
 
 	new_entry->id = id;
 	new_entry->cnt = rpc_event_cnt - 1;
+	new_entry->used = thread_monitor_clock;
 
 	return new_entry;
 }
@@ -124,7 +199,7 @@ static bool sleeping_thread_add(struct sleeping_thread *thread)
 
 	if (can_thread_sleep(entry)) {
 		allow_to_sleep = true;
-		sys_slist_append(&sleeping_threads, &thread->node);
+		sys_dlist_append(wait_queue_get(thread->context), &thread->node);
 	}
 
 	irq_unlock(key);
@@ -139,7 +214,7 @@ static void sleeping_thread_remove(struct sleeping_thread *thread)
 
 	uint32_t key = irq_lock();
 
-	sys_slist_find_and_remove(&sleeping_threads, &thread->node);
+	sys_dlist_remove(&thread->node);
 
 	entry = thread_monitor_entry_get(k_current_get());
 	thread_monitor_entry_update(entry);
@@ -279,22 +354,36 @@ unsigned int nrf_modem_os_sem_count_get(void *sem)
 
 void nrf_modem_os_event_notify(uint32_t context)
 {
+	struct sleeping_thread *thread;
+	uint32_t key;
+
 	atomic_inc(&rpc_event_cnt);
 
-	struct sleeping_thread *thread;
+	key = irq_lock();
 
-	/* Wake up all sleeping threads. */
-	SYS_SLIST_FOR_EACH_CONTAINER(&sleeping_threads, thread, node) {
-		if ((thread->context == context) || (context == 0)) {
-			k_sem_give(&thread->sem);
+	if (context == 0) {
+		/* Wake up all sleeping threads. */
+		for (size_t i = 0; i < WAIT_QUEUE_BUCKETS; i++) {
+			SYS_DLIST_FOR_EACH_CONTAINER(&sleeping_threads[i], thread, node) {
+				k_sem_give(&thread->sem);
+			}
+		}
+	} else {
+		/* Wake up the threads sleeping on this context only. */
+		SYS_DLIST_FOR_EACH_CONTAINER(wait_queue_get(context), thread, node) {
+			if (thread->context == context) {
+				k_sem_give(&thread->sem);
+			}
 		}
 	}
+
+	irq_unlock(key);
 }
 
 void *nrf_modem_os_alloc(size_t bytes)
 {
 	extern uint32_t nrf_modem_lib_failed_allocs;
-	void * const addr = k_heap_alloc(&nrf_modem_lib_heap, bytes, K_NO_WAIT);
+	void * const addr = slab_heap_alloc(&nrf_modem_lib_slab_heap, bytes);
 
 	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB_MEM_DIAG_ALLOC) && !addr) {
 		nrf_modem_lib_failed_allocs++;
@@ -305,13 +394,13 @@ void *nrf_modem_os_alloc(size_t bytes)
 
 void nrf_modem_os_free(void *mem)
 {
-	k_heap_free(&nrf_modem_lib_heap, mem);
+	slab_heap_free(&nrf_modem_lib_slab_heap, mem);
 }
 
 void *nrf_modem_os_shm_tx_alloc(size_t bytes)
 {
 	extern uint32_t nrf_modem_lib_shmem_failed_allocs;
-	void * const addr = k_heap_alloc(&nrf_modem_lib_shmem_heap, bytes, K_NO_WAIT);
+	void * const addr = slab_heap_alloc(&nrf_modem_lib_shmem_slab_heap, bytes);
 
 	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB_MEM_DIAG_ALLOC) && !addr) {
 		nrf_modem_lib_shmem_failed_allocs++;
@@ -322,7 +411,7 @@ void *nrf_modem_os_shm_tx_alloc(size_t bytes)
 
 void nrf_modem_os_shm_tx_free(void *mem)
 {
-	k_heap_free(&nrf_modem_lib_shmem_heap, mem);
+	slab_heap_free(&nrf_modem_lib_shmem_slab_heap, mem);
 }
 
 #if defined(CONFIG_LOG)
@@ -410,7 +499,9 @@ static int on_init(void)
 	 * initialization. This is because we want to keep the list intact regardless of modem
 	 * reinitialization to wake sleeping threads on modem initialization.
 	 */
-	sys_slist_init(&sleeping_threads);
+	for (size_t i = 0; i < WAIT_QUEUE_BUCKETS; i++) {
+		sys_dlist_init(&sleeping_threads[i]);
+	}
 	atomic_clear(&rpc_event_cnt);
 
 	return 0;
@@ -425,16 +516,25 @@ void nrf_modem_os_init(void)
 	k_heap_init(&nrf_modem_lib_heap, library_heap_buf, sizeof(library_heap_buf));
 	k_heap_init(&nrf_modem_lib_shmem_heap, (void *)PM_NRF_MODEM_LIB_TX_ADDRESS,
 		    CONFIG_NRF_MODEM_LIB_SHMEM_TX_SIZE);
+
+	/* Reserve the size classes, if any */
+	slab_heap_init(&nrf_modem_lib_slab_heap);
+	slab_heap_init(&nrf_modem_lib_shmem_slab_heap);
 }
 
 void nrf_modem_os_shutdown(void)
 {
 	struct sleeping_thread *thread;
+	uint32_t key = irq_lock();
 
 	/* Wake up all sleeping threads. */
-	SYS_SLIST_FOR_EACH_CONTAINER(&sleeping_threads, thread, node) {
-		k_sem_give(&thread->sem);
+	for (size_t i = 0; i < WAIT_QUEUE_BUCKETS; i++) {
+		SYS_DLIST_FOR_EACH_CONTAINER(&sleeping_threads[i], thread, node) {
+			k_sem_give(&thread->sem);
+		}
 	}
+
+	irq_unlock(key);
 }
 
 SYS_INIT(on_init, POST_KERNEL, 0);
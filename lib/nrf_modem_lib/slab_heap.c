@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+#include "slab_heap.h"
+
+LOG_MODULE_DECLARE(nrf_modem, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
+
+static bool class_owns(const struct slab_heap_class *class, const void *mem)
+{
+	const char *p = mem;
+
+	return class->buf && p >= class->buf &&
+	       p < class->buf + class->block_size * class->num_blocks;
+}
+
+static void size_hist_record(struct slab_heap *sh, size_t bytes)
+{
+	size_t bucket = 0;
+
+	while (bucket < SLAB_HEAP_HIST_BUCKETS - 1 && bytes > (16 << bucket)) {
+		bucket++;
+	}
+
+	atomic_inc(&sh->size_hist[bucket]);
+}
+
+void slab_heap_init(struct slab_heap *sh)
+{
+	struct slab_heap_class *class;
+	int err;
+
+	for (size_t i = 0; i < sh->num_classes; i++) {
+		class = &sh->classes[i];
+		class->buf = NULL;
+
+		if (class->num_blocks == 0) {
+			continue;
+		}
+
+		/* The slab is carved out of the heap, so that blocks in the shared memory
+		 * heap remain accessible to the modem.
+		 */
+		class->buf = k_heap_aligned_alloc(sh->heap, SLAB_HEAP_ALIGN,
+						  class->block_size * class->num_blocks,
+						  K_NO_WAIT);
+		if (!class->buf) {
+			LOG_WRN("Not enough heap for %u blocks of %u bytes",
+				class->num_blocks, class->block_size);
+			continue;
+		}
+
+		err = k_mem_slab_init(&class->slab, class->buf, class->block_size,
+				      class->num_blocks);
+		if (err) {
+			LOG_ERR("Failed to initialize slab of %u bytes, err %d",
+				class->block_size, err);
+			k_heap_free(sh->heap, class->buf);
+			class->buf = NULL;
+		}
+	}
+}
+
+void *slab_heap_alloc(struct slab_heap *sh, size_t bytes)
+{
+	struct slab_heap_class *class;
+	uint32_t used;
+	void *mem;
+
+	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB_MEM_DIAG)) {
+		size_hist_record(sh, bytes);
+	}
+
+	/* Classes are sorted by block size. */
+	for (size_t i = 0; i < sh->num_classes; i++) {
+		class = &sh->classes[i];
+
+		if (!class->buf || class->block_size < bytes) {
+			continue;
+		}
+
+		if (k_mem_slab_alloc(&class->slab, &mem, K_NO_WAIT) == 0) {
+			used = k_mem_slab_num_used_get(&class->slab);
+			if (used > class->max_used) {
+				class->max_used = used;
+			}
+			return mem;
+		}
+
+		atomic_inc(&class->fallbacks);
+	}
+
+	return k_heap_alloc(sh->heap, bytes, K_NO_WAIT);
+}
+
+void slab_heap_free(struct slab_heap *sh, void *mem)
+{
+	struct slab_heap_class *class;
+
+	for (size_t i = 0; i < sh->num_classes; i++) {
+		class = &sh->classes[i];
+
+		if (class_owns(class, mem)) {
+			k_mem_slab_free(&class->slab, &mem);
+			return;
+		}
+	}
+
+	k_heap_free(sh->heap, mem);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLAB_HEAP_H__
+#define SLAB_HEAP_H__
+
+#include <zephyr/kernel.h>
+
+/* Number of buckets in the allocation size histogram.
+ * Bucket n counts requests of up to 16 << n bytes, the last bucket counts the rest.
+ */
+#define SLAB_HEAP_HIST_BUCKETS 8
+
+/* Alignment of slab blocks, matching the alignment of k_heap allocations. */
+#define SLAB_HEAP_ALIGN 8
+
+/* A size class, serving fixed size blocks from a slab reserved in the backing heap. */
+struct slab_heap_class {
+	/* Block size, a multiple of SLAB_HEAP_ALIGN. */
+	size_t block_size;
+	/* Number of blocks reserved. */
+	uint32_t num_blocks;
+	/* Slab, valid if buf is not NULL. */
+	struct k_mem_slab slab;
+	/* Slab storage, reserved from the backing heap. */
+	char *buf;
+	/* Highest number of blocks used at once. */
+	uint32_t max_used;
+	/* Number of requests that found this class exhausted. */
+	atomic_t fallbacks;
+};
+
+/* A size-class allocator front-end for a k_heap.
+ * Requests are served from the smallest class that fits and has a free block,
+ * falling back to the backing heap for larger requests and when all fitting
+ * classes are exhausted.
+ */
+struct slab_heap {
+	struct k_heap *heap;
+	struct slab_heap_class *classes;
+	size_t num_classes;
+	atomic_t size_hist[SLAB_HEAP_HIST_BUCKETS];
+};
+
+#define SLAB_HEAP_CLASS(_size, _count)					\
+	{								\
+		.block_size = ROUND_UP(_size, SLAB_HEAP_ALIGN),		\
+		.num_blocks = (_count),					\
+	}
+
+/* Reserve the slabs from the backing heap. Must be called after the heap is initialized.
+ * Classes that can't be reserved are disabled.
+ */
+void slab_heap_init(struct slab_heap *sh);
+
+void *slab_heap_alloc(struct slab_heap *sh, size_t bytes);
+
+void slab_heap_free(struct slab_heap *sh, void *mem);
+
+#endif /* SLAB_HEAP_H__ */
@@ -15,6 +15,9 @@
 #include <zephyr/logging/log.h>
 
 #include <modem/trace_backend.h>
+#include <modem/nrf_modem_lib_trace.h>
+
+#include "trace_lz4.h"
 
 LOG_MODULE_REGISTER(modem_trace_backend, CONFIG_MODEM_TRACE_BACKEND_LOG_LEVEL);
 
@@ -26,6 +29,8 @@ LOG_MODULE_REGISTER(modem_trace_backend, CONFIG_MODEM_TRACE_BACKEND_LOG_LEVEL);
 
 #define TRACE_MAGIC_INITIALIZED 0x152ac523
 
+#define COMPRESSION IS_ENABLED(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_COMPRESSION)
+
 static trace_backend_processed_cb trace_processed_callback;
 
 static const struct flash_area *modem_trace_area;
@@ -46,6 +51,17 @@ static size_t trace_bytes_unread;
 static size_t flash_buf_written;
 static uint8_t flash_buf[BUF_SIZE];
 
+/* Trace bytes received and bytes stored, after compression. */
+static uint64_t stats_bytes_in;
+static uint64_t stats_bytes_out;
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_COMPRESSION
+BUILD_ASSERT(BUF_SIZE <= TRACE_LZ4_INPUT_MAX);
+
+/* Each flushed buffer is stored as one LZ4 frame. */
+static uint8_t compress_buf[TRACE_LZ4_FRAME_BOUND(BUF_SIZE)];
+#endif
+
 static bool is_initialized;
 
 static int trace_backend_clear(void);
@@ -59,7 +75,12 @@ static size_t buffer_append(const void *data, size_t len)
 	memcpy(&flash_buf[flash_buf_written], data, append_len);
 
 	flash_buf_written += append_len;
-	trace_bytes_unread += append_len;
+	stats_bytes_in += append_len;
+
+	/* With compression, the stored size is only known when the buffer is flushed. */
+	if (!COMPRESSION) {
+		trace_bytes_unread += append_len;
+	}
 
 	return append_len;
 }
@@ -78,6 +99,8 @@ static int buffer_flush_to_flash(void)
 {
 	int err;
 	struct fcb_entry loc_flush;
+	const uint8_t *data = flash_buf;
+	size_t len = flash_buf_written;
 
 	if (!is_initialized) {
 		return -EPERM;
@@ -87,7 +110,12 @@ static int buffer_flush_to_flash(void)
 		return -ENODATA;
 	}
 
-	err = fcb_append(&trace_fcb, flash_buf_written, &loc_flush);
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_COMPRESSION
+	data = compress_buf;
+	len = trace_lz4_frame_compress(flash_buf, flash_buf_written, compress_buf);
+#endif
+
+	err = fcb_append(&trace_fcb, len, &loc_flush);
 	if (err) {
 		if (IS_ENABLED(CONFIG_NRF_MODEM_TRACE_FLASH_NOSPACE_ERASE_OLDEST)) {
 			/* Find the number of trace bytes in oldest sector (that is not read). */
@@ -110,7 +138,7 @@ static int buffer_flush_to_flash(void)
 				LOG_ERR("fcb_rotate failed, err %d", err);
 				return err;
 			}
-			err = fcb_append(&trace_fcb, flash_buf_written, &loc_flush);
+			err = fcb_append(&trace_fcb, len, &loc_flush);
 		}
 
 		if (err) {
@@ -119,8 +147,7 @@ static int buffer_flush_to_flash(void)
 		}
 	}
 
-	err = flash_area_write(
-		trace_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc_flush), flash_buf, flash_buf_written);
+	err = flash_area_write(trace_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc_flush), data, len);
 	if (err) {
 		LOG_ERR("flash_area_write failed, err %d", err);
 		return err;
@@ -133,6 +160,11 @@ static int buffer_flush_to_flash(void)
 	}
 
 	flash_buf_written = 0;
+	stats_bytes_out += len;
+
+	if (COMPRESSION) {
+		trace_bytes_unread += len;
+	}
 
 	return 0;
 }
@@ -234,6 +266,11 @@ int trace_backend_init(trace_backend_processed_cb trace_processed_cb)
 
 size_t trace_backend_data_size(void)
 {
+	if (COMPRESSION) {
+		/* Buffered data is not compressed yet, its size is an upper bound. */
+		return trace_bytes_unread + flash_buf_written;
+	}
+
 	return trace_bytes_unread;
 }
 
@@ -288,6 +325,16 @@ int trace_backend_read(void *buf, size_t len)
 	}
 
 	err = fcb_getnext(&trace_fcb, &loc);
+	if (COMPRESSION && err == -ENOTSUP && flash_buf_written) {
+		/* Compress and store the buffered data, so that only whole frames are read. */
+		err = buffer_flush_to_flash();
+		if (err) {
+			return err;
+		}
+
+		err = fcb_getnext(&trace_fcb, &loc);
+	}
+
 	if (err == -ENOTSUP && !flash_buf_written) {
 		/* Nothing to read */
 		loc.fe_sector = 0;
@@ -323,6 +370,10 @@ int trace_backend_read(void *buf, size_t len)
 	return read_from_offset(buf, len);
 }
 
+/* Append data to the buffer, flushing it to flash when full.
+ * Returns the number of bytes appended, which is less than len only on error,
+ * or a negative error code if no bytes were appended.
+ */
 static int stream_write(const void *buf, size_t len)
 {
 	int ret;
@@ -336,28 +387,23 @@ static int stream_write(const void *buf, size_t len)
 
 	while (bytes_left) {
 		written = buffer_append(&bytes[len - bytes_left], bytes_left);
-		if (written != bytes_left) {
+		bytes_left -= written;
+
+		if (bytes_left) {
 			ret = buffer_flush_to_flash();
 			if (ret) {
 				LOG_ERR("buffer_flush_to_flash error %d", ret);
-				return ret;
-			}
-		}
-		if (written > 0) {
-			bytes_left -= written;
-			ret = trace_processed_callback(written);
-			if (ret < 0) {
-				LOG_ERR("trace_processed_callback failed: %d", ret);
-				return ret;
+				return (bytes_left == len) ? ret : (int)(len - bytes_left);
 			}
 		}
 	}
 
-	return 0;
+	return len;
 }
 
 int trace_backend_write(const void *data, size_t len)
 {
+	int err;
 	int write_ret = stream_write(data, len);
 
 	if (write_ret < 0) {
@@ -365,7 +411,57 @@ int trace_backend_write(const void *data, size_t len)
 		return write_ret;
 	}
 
-	return (int)len;
+	err = trace_processed_callback(write_ret);
+	if (err < 0) {
+		LOG_ERR("trace_processed_callback failed: %d", err);
+		return err;
+	}
+
+	return write_ret;
+}
+
+int trace_backend_write_vec(const struct nrf_modem_trace_data *frags, size_t n_frags)
+{
+	int err;
+	int ret = 0;
+	size_t written = 0;
+
+	for (size_t i = 0; i < n_frags; i++) {
+		ret = stream_write(frags[i].data, frags[i].len);
+		if (ret < 0) {
+			break;
+		}
+
+		written += ret;
+
+		if (ret != frags[i].len) {
+			break;
+		}
+	}
+
+	if (written == 0) {
+		if (ret < 0) {
+			LOG_ERR("write failed: %d", ret);
+		}
+		return ret;
+	}
+
+	/* Release all copied fragments at once. */
+	err = trace_processed_callback(written);
+	if (err < 0) {
+		LOG_ERR("trace_processed_callback failed: %d", err);
+		return err;
+	}
+
+	return written;
+}
+
+int trace_backend_stats_get(struct nrf_modem_lib_trace_backend_stats *stats)
+{
+	stats->bytes_in = stats_bytes_in;
+	stats->bytes_out = stats_bytes_out;
+
+	return 0;
 }
 
 int trace_backend_clear(void)
@@ -399,7 +495,9 @@ struct nrf_modem_lib_trace_backend trace_backend = {
 	.init = trace_backend_init,
 	.deinit = trace_backend_deinit,
 	.write = trace_backend_write,
+	.write_vec = trace_backend_write_vec,
 	.data_size = trace_backend_data_size,
 	.read = trace_backend_read,
 	.clear = trace_backend_clear,
+	.stats_get = trace_backend_stats_get,
 };
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <lz4.h>
+
+#include "trace_lz4.h"
+
+/* Frame descriptor: version 1, independent blocks, 64 KB maximum block size,
+ * followed by its header checksum, (XXH32(descriptor) >> 8) & 0xFF.
+ */
+static const uint8_t frame_header[] = { 0x04, 0x22, 0x4D, 0x18, 0x60, 0x40, 0x82 };
+
+#define BLOCK_UNCOMPRESSED BIT(31)
+
+/* Only the trace thread compresses frames, one at a time, so a single state is enough. */
+static LZ4_stream_t lz4_state;
+
+size_t trace_lz4_frame_compress(const uint8_t *src, size_t len, uint8_t *dst)
+{
+	uint8_t *op = dst;
+	int block_len = 0;
+
+	memcpy(op, frame_header, sizeof(frame_header));
+	op += sizeof(frame_header);
+
+	/* Only keep the compressed block if it is smaller than the input. */
+	if (len > 1) {
+		block_len = LZ4_compress_fast_extState(&lz4_state, (const char *)src,
+						       (char *)op + 4, len, len - 1, 1);
+	}
+
+	if (block_len > 0) {
+		sys_put_le32(block_len, op);
+		op += 4 + block_len;
+	} else {
+		sys_put_le32(len | BLOCK_UNCOMPRESSED, op);
+		memcpy(op + 4, src, len);
+		op += 4 + len;
+	}
+
+	/* End mark */
+	sys_put_le32(0, op);
+	op += 4;
+
+	return op - dst;
+}
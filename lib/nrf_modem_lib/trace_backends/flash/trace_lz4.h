@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TRACE_LZ4_H__
+#define TRACE_LZ4_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of a frame header, block header and end mark. */
+#define TRACE_LZ4_FRAME_OVERHEAD (7 + 4 + 4)
+
+/* Largest input size of a single frame. */
+#define TRACE_LZ4_INPUT_MAX 0xFFFF
+
+/* Worst case frame size for an input of the given length. */
+#define TRACE_LZ4_FRAME_BOUND(len) ((len) + TRACE_LZ4_FRAME_OVERHEAD)
+
+/* Compress src into a single LZ4 frame (https://github.com/lz4/lz4/blob/dev/doc/),
+ * holding one independent block. Incompressible input is stored uncompressed.
+ * A sequence of frames is a valid LZ4 stream and can be decompressed by the lz4 tool.
+ *
+ * @param src Input, at most TRACE_LZ4_INPUT_MAX bytes.
+ * @param len Input length.
+ * @param dst Output, at least TRACE_LZ4_FRAME_BOUND(len) bytes.
+ *
+ * @return Frame length.
+ */
+size_t trace_lz4_frame_compress(const uint8_t *src, size_t len, uint8_t *dst);
+
+#endif /* TRACE_LZ4_H__ */
@@ -67,8 +67,41 @@ int trace_backend_write(const void *data, size_t len)
 	return (int)len;
 }
 
+int trace_backend_write_vec(const struct nrf_modem_trace_data *frags, size_t n_frags)
+{
+	size_t written = 0;
+	int err;
+
+	/* The data is copied into the RTT buffer, so all fragments can be
+	 * reported as processed at once.
+	 */
+	for (size_t i = 0; i < n_frags; i++) {
+		const uint8_t *buf = frags[i].data;
+		size_t remaining_bytes = frags[i].len;
+
+		while (remaining_bytes) {
+			uint16_t transfer_len = MIN(remaining_bytes,
+				CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RTT_BUF_SIZE);
+
+			transfer_len = SEGGER_RTT_WriteNoLock(trace_rtt_channel,
+				&buf[frags[i].len - remaining_bytes], transfer_len);
+
+			remaining_bytes -= transfer_len;
+			written += transfer_len;
+		}
+	}
+
+	err = trace_processed_callback(written);
+	if (err) {
+		return err;
+	}
+
+	return (int)written;
+}
+
 struct nrf_modem_lib_trace_backend trace_backend = {
 	.init = trace_backend_init,
 	.deinit = trace_backend_deinit,
 	.write = trace_backend_write,
+	.write_vec = trace_backend_write_vec,
 };
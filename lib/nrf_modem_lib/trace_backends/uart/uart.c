@@ -30,6 +30,130 @@ static int tx_bytes;
 /* Callback to notify the trace library when trace data is processed. */
 static trace_backend_processed_cb trace_processed_callback;
 
+#define MAX_BUF_LEN ((1 << UARTE1_EASYDMA_MAXCNT_SIZE) - 1)
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION
+/* A trace chunk waiting to be transferred. The data belongs to the modem library and
+ * is valid until it is reported as processed, so it is transferred without copying.
+ */
+struct tx_chunk {
+	const uint8_t *data;
+	size_t len;
+};
+
+K_MSGQ_DEFINE(tx_queue, sizeof(struct tx_chunk),
+	      CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_QUEUE_SIZE, 4);
+
+/* Chunk being transferred. */
+static struct tx_chunk tx_current;
+static int tx_retries;
+/* Set while a transfer is in progress. */
+static atomic_t tx_active;
+/* Bytes transferred but not yet reported as processed. */
+static atomic_t tx_processed;
+
+static void processed_work_fn(struct k_work *work)
+{
+	size_t len = atomic_clear(&tx_processed);
+	int err;
+
+	if (len) {
+		err = trace_processed_callback(len);
+		if (err) {
+			LOG_ERR("trace_processed_callback failed: %d", err);
+		}
+	}
+}
+
+static K_WORK_DEFINE(processed_work, processed_work_fn);
+
+static void tx_current_done(size_t len)
+{
+	/* The processed callback must not be called from the UART interrupt. */
+	atomic_add(&tx_processed, len);
+	k_work_submit(&processed_work);
+}
+
+/* Start transferring the current chunk. Returns false if nothing was started. */
+static bool tx_current_start(void)
+{
+	int err;
+
+	err = uart_tx(uart_dev, tx_current.data, tx_current.len,
+		      UART_TX_WAIT_TIME_MS * USEC_PER_MSEC);
+	if (err) {
+		LOG_ERR("uart error: %d", err);
+		/* Drop the chunk so that the modem can release the memory. */
+		tx_current_done(tx_current.len);
+		return false;
+	}
+
+	return true;
+}
+
+/* Start the next queued transfer, unless one is in progress. Called both from the
+ * trace thread and the UART interrupt.
+ */
+static void tx_kick(void)
+{
+	while (k_msgq_num_used_get(&tx_queue) && atomic_cas(&tx_active, 0, 1)) {
+		if (k_msgq_get(&tx_queue, &tx_current, K_NO_WAIT) == 0) {
+			tx_retries = 0;
+			if (tx_current_start()) {
+				return;
+			}
+		}
+
+		atomic_clear(&tx_active);
+	}
+}
+
+static void tx_done(size_t len)
+{
+	tx_current.data += len;
+	tx_current.len -= len;
+	tx_current_done(len);
+
+	if (tx_current.len) {
+		/* Aborted, transfer the rest. */
+		if (len == 0 && ++tx_retries >= UART_TX_RETRIES) {
+			/* Give up, report the rest as processed. */
+			tx_current_done(tx_current.len);
+		} else if (tx_current_start()) {
+			return;
+		}
+	}
+
+	atomic_clear(&tx_active);
+	tx_kick();
+}
+
+static int tx_enqueue(const uint8_t *data, size_t len)
+{
+	struct tx_chunk chunk;
+	int err;
+
+	/* Split into smaller chunks to be transferred using DMA. */
+	while (len) {
+		chunk.data = data;
+		chunk.len = MIN(len, MAX_BUF_LEN);
+
+		/* Blocks while the queue is full, until transfers complete. */
+		err = k_msgq_put(&tx_queue, &chunk, K_FOREVER);
+		if (err) {
+			return err;
+		}
+
+		tx_kick();
+
+		data += chunk.len;
+		len -= chunk.len;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION */
+
 static void uart_callback(const struct device *dev, struct uart_event *evt, void *user_data)
 {
 	ARG_UNUSED(dev);
@@ -38,8 +162,12 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 	switch (evt->type) {
 	case UART_TX_DONE:
 	case UART_TX_ABORTED:
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION
+		tx_done(evt->data.tx.len);
+#else
 		tx_bytes = evt->data.tx.len;
 		k_sem_give(&tx_done_sem);
+#endif
 		break;
 	default:
 		LOG_DBG("Unhandled UART event: %d", evt->type);
@@ -94,9 +222,52 @@ int trace_backend_init(trace_backend_processed_cb trace_processed_cb)
 
 int trace_backend_deinit(void)
 {
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION
+	/* Let the queued transfers complete, so that all trace data is processed. */
+	for (int i = 0; i < UART_TX_WAIT_TIME_MS; i++) {
+		if (!k_msgq_num_used_get(&tx_queue) && !atomic_get(&tx_active)) {
+			break;
+		}
+		k_sleep(K_MSEC(1));
+	}
+
+	k_work_submit(&processed_work);
+#endif
+
 	return 0;
 }
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION
+int trace_backend_write(const void *data, size_t len)
+{
+	int err;
+
+	/* Return as soon as the data is queued, it is reported as processed on completion. */
+	err = tx_enqueue(data, len);
+	if (err) {
+		return err;
+	}
+
+	return len;
+}
+
+int trace_backend_write_vec(const struct nrf_modem_trace_data *frags, size_t n_frags)
+{
+	size_t written = 0;
+	int err;
+
+	for (size_t i = 0; i < n_frags; i++) {
+		err = tx_enqueue(frags[i].data, frags[i].len);
+		if (err) {
+			return written ? written : err;
+		}
+
+		written += frags[i].len;
+	}
+
+	return written;
+}
+#else
 /* Returns the number of bytes written, or negative error. */
 static int uart_send(const uint8_t *data, size_t len)
 {
@@ -127,7 +298,6 @@ int trace_backend_write(const void *data, size_t len)
 
 	/* Split RAM buffer into smaller chunks to be transferred using DMA. */
 	uint8_t *buf = (uint8_t *)data;
-	const size_t MAX_BUF_LEN = (1 << UARTE1_EASYDMA_MAXCNT_SIZE) - 1;
 	size_t remaining_bytes = len;
 
 	k_sem_take(&tx_sem, K_FOREVER);
@@ -165,9 +335,13 @@ out:
 
 	return ret;
 }
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION */
 
 struct nrf_modem_lib_trace_backend trace_backend = {
 	.init = trace_backend_init,
 	.deinit = trace_backend_deinit,
 	.write = trace_backend_write,
+#if CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART_ASYNC_COMPLETION
+	.write_vec = trace_backend_write_vec,
+#endif
 };
@@ -7,6 +7,8 @@
 #include <inttypes.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/net/buf.h>
+#include <zephyr/sys/byteorder.h>
 
 #include <bluetooth/gatt_dm.h>
 
@@ -63,14 +65,30 @@ struct bt_gatt_dm {
 
 	/* Single-linked list of allocated chunks for user data */
 	sys_slist_t chunk_list;
-	/* The used length of the current chunk */
+	/* The used length of the current chunk, or of the arena */
 	size_t cur_chunk_len;
+	/* User data storage set by the application, used instead of chunks */
+	uint8_t *arena;
+	size_t arena_size;
 
 	/* The pointer to callback structure */
 	const struct bt_gatt_dm_cb *callback;
 
 	/* Indicates that services should be searched by the UUID. */
 	bool search_svc_by_uuid;
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	/* Local identity and identity address of the bonded peer */
+	uint8_t id;
+	bt_addr_le_t peer;
+	/* The parameters used to read the Database Hash */
+	struct bt_gatt_read_params read_params;
+	/* Database Hash of the peer, if it has one */
+	uint8_t db_hash[16];
+	bool db_hash_valid;
+	/* The first handle of the current service search */
+	uint16_t search_start;
+#endif
 };
 
 /* Currently only one instance is supported */
@@ -88,6 +106,17 @@ static void *user_data_alloc(struct bt_gatt_dm *dm,
 	 */
 	len = ROUND_UP(len, DATA_ALIGN);
 
+	if (dm->arena) {
+		if (dm->cur_chunk_len + len > dm->arena_size) {
+			return NULL;
+		}
+
+		user_data_loc = &dm->arena[dm->cur_chunk_len];
+		dm->cur_chunk_len += len;
+
+		return user_data_loc;
+	}
+
 	__ASSERT_NO_MSG(len <= CHUNK_DATA_SIZE);
 
 	if (sys_slist_is_empty(&dm->chunk_list) ||
@@ -247,9 +276,283 @@ static struct bt_gatt_dm_attr *attr_find_by_handle(
 	return NULL;
 }
 
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+
+/* Local identity, peer identity address, Database Hash, first handle of the
+ * search and the searched service UUID
+ */
+#define CACHE_KEY_MAX (1 + sizeof(bt_addr_le_t) + 16 + sizeof(uint16_t) + 1 + \
+		       BT_UUID_SIZE_128)
+
+/* Cached services, one record after another, the oldest first. A record
+ * holds its length, the key, and the attributes of the found service. There
+ * are no attributes if no service was found.
+ */
+static K_MUTEX_DEFINE(cache_lock);
+static uint8_t cache_buf[CONFIG_BT_GATT_DM_CACHE_SIZE];
+static size_t cache_len;
+
+/* Reports the services taken from the cache. */
+static void cache_work_handler(struct k_work *work);
+static K_WORK_DEFINE(cache_work, cache_work_handler);
+
+static size_t cache_uuid_len(const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return BT_UUID_SIZE_16;
+	case BT_UUID_TYPE_32:
+		return BT_UUID_SIZE_32;
+	default:
+		return BT_UUID_SIZE_128;
+	}
+}
+
+static void cache_uuid_add(struct net_buf_simple *buf,
+			   const struct bt_uuid *uuid)
+{
+	net_buf_simple_add_u8(buf, cache_uuid_len(uuid));
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		net_buf_simple_add_le16(buf, BT_UUID_16(uuid)->val);
+		break;
+	case BT_UUID_TYPE_32:
+		net_buf_simple_add_le32(buf, BT_UUID_32(uuid)->val);
+		break;
+	default:
+		net_buf_simple_add_mem(buf, BT_UUID_128(uuid)->val,
+				       BT_UUID_SIZE_128);
+		break;
+	}
+}
+
+static bool cache_uuid_pull(struct net_buf_simple *buf,
+			    struct bt_uuid_128 *uuid)
+{
+	uint8_t len = net_buf_simple_pull_u8(buf);
+
+	return bt_uuid_create(&uuid->uuid, net_buf_simple_pull_mem(buf, len),
+			      len);
+}
+
+static void cache_key_add(const struct bt_gatt_dm *dm,
+			  struct net_buf_simple *buf)
+{
+	net_buf_simple_add_u8(buf, dm->id);
+	net_buf_simple_add_mem(buf, &dm->peer, sizeof(dm->peer));
+	net_buf_simple_add_mem(buf, dm->db_hash, sizeof(dm->db_hash));
+	net_buf_simple_add_le16(buf, dm->search_start);
+
+	if (dm->search_svc_by_uuid) {
+		cache_uuid_add(buf, &dm->svc_uuid.uuid);
+	} else {
+		net_buf_simple_add_u8(buf, 0);
+	}
+}
+
+/* Length of the stored attribute, see cache_attr_add. */
+static size_t cache_attr_len(const struct bt_gatt_dm_attr *attr)
+{
+	const struct bt_gatt_service_val *service_val =
+		bt_gatt_dm_attr_service_val(attr);
+	const struct bt_gatt_chrc *chrc = bt_gatt_dm_attr_chrc_val(attr);
+	size_t len = sizeof(uint16_t) + 2 + cache_uuid_len(attr->uuid);
+
+	if (service_val) {
+		len += sizeof(uint16_t) + 1 + cache_uuid_len(service_val->uuid);
+	} else if (chrc) {
+		len += sizeof(uint16_t) + 2 + cache_uuid_len(chrc->uuid);
+	}
+
+	return len;
+}
+
+static void cache_attr_add(struct net_buf_simple *buf,
+			   const struct bt_gatt_dm_attr *attr)
+{
+	const struct bt_gatt_service_val *service_val =
+		bt_gatt_dm_attr_service_val(attr);
+	const struct bt_gatt_chrc *chrc = bt_gatt_dm_attr_chrc_val(attr);
+
+	net_buf_simple_add_le16(buf, attr->handle);
+	net_buf_simple_add_u8(buf, attr->perm);
+	cache_uuid_add(buf, attr->uuid);
+
+	if (service_val) {
+		net_buf_simple_add_le16(buf, service_val->end_handle);
+		cache_uuid_add(buf, service_val->uuid);
+	} else if (chrc) {
+		net_buf_simple_add_le16(buf, chrc->value_handle);
+		net_buf_simple_add_u8(buf, chrc->properties);
+		cache_uuid_add(buf, chrc->uuid);
+	}
+}
+
+/* Must be called with cache_lock held. */
+static uint8_t *cache_find(const struct net_buf_simple *key)
+{
+	uint16_t len;
+
+	for (size_t off = 0; off < cache_len; off += len) {
+		len = sys_get_le16(&cache_buf[off]);
+
+		if (len >= sizeof(uint16_t) + key->len &&
+		    !memcmp(&cache_buf[off + sizeof(uint16_t)], key->data,
+			    key->len)) {
+			return &cache_buf[off];
+		}
+	}
+
+	return NULL;
+}
+
+static bool cache_contains(const struct bt_gatt_dm *dm)
+{
+	NET_BUF_SIMPLE_DEFINE(key, CACHE_KEY_MAX);
+	bool found;
+
+	cache_key_add(dm, &key);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	found = (cache_find(&key) != NULL);
+	k_mutex_unlock(&cache_lock);
+
+	return found;
+}
+
+static void cache_store(const struct bt_gatt_dm *dm)
+{
+	NET_BUF_SIMPLE_DEFINE(key, CACHE_KEY_MAX);
+	struct net_buf_simple buf;
+	size_t len;
+
+	if (!dm->db_hash_valid) {
+		return;
+	}
+
+	cache_key_add(dm, &key);
+
+	len = sizeof(uint16_t) + key.len + sizeof(uint16_t);
+	for (size_t i = 0; i < dm->cur_attr_id; i++) {
+		len += cache_attr_len(&dm->attrs[i]);
+	}
+
+	if (len > sizeof(cache_buf)) {
+		LOG_WRN("Service too large for the cache: %zu", len);
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* Already there if the service was taken from the cache. */
+	if (!cache_find(&key)) {
+		while (cache_len + len > sizeof(cache_buf)) {
+			uint16_t oldest = sys_get_le16(cache_buf);
+
+			cache_len -= oldest;
+			memmove(cache_buf, &cache_buf[oldest], cache_len);
+		}
+
+		net_buf_simple_init_with_data(&buf, &cache_buf[cache_len], len);
+		net_buf_simple_reset(&buf);
+
+		net_buf_simple_add_le16(&buf, len);
+		net_buf_simple_add_mem(&buf, key.data, key.len);
+		net_buf_simple_add_le16(&buf, dm->cur_attr_id);
+		for (size_t i = 0; i < dm->cur_attr_id; i++) {
+			cache_attr_add(&buf, &dm->attrs[i]);
+		}
+
+		__ASSERT_NO_MSG(buf.len == len);
+		cache_len += len;
+
+		LOG_DBG("Service cached, start handle: %u, attributes: %zu",
+			dm->search_start, dm->cur_attr_id);
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+/* Stores the attributes of a cached service as the discovery would.
+ * Must be called with cache_lock held.
+ */
+static int cache_restore(struct bt_gatt_dm *dm, uint8_t *record)
+{
+	struct net_buf_simple buf;
+	struct bt_uuid_128 type;
+	struct bt_uuid_128 uuid;
+	uint16_t cnt;
+
+	net_buf_simple_init_with_data(&buf, record, sys_get_le16(record));
+
+	/* Skip the length and the key. */
+	net_buf_simple_pull(&buf, sizeof(uint16_t) + sizeof(dm->id) + sizeof(dm->peer) +
+			    sizeof(dm->db_hash) + sizeof(uint16_t));
+	(void)cache_uuid_pull(&buf, &uuid);
+
+	cnt = net_buf_simple_pull_le16(&buf);
+
+	for (uint16_t i = 0; i < cnt; i++) {
+		struct bt_gatt_attr attr = {
+			.uuid = &type.uuid,
+		};
+		struct bt_gatt_dm_attr *cur_attr;
+		struct bt_gatt_service_val *service_val;
+		struct bt_gatt_chrc *chrc;
+
+		attr.handle = net_buf_simple_pull_le16(&buf);
+		attr.perm = net_buf_simple_pull_u8(&buf);
+		(void)cache_uuid_pull(&buf, &type);
+
+		if (!bt_uuid_cmp(attr.uuid, BT_UUID_GATT_PRIMARY) ||
+		    !bt_uuid_cmp(attr.uuid, BT_UUID_GATT_SECONDARY)) {
+			cur_attr = attr_store(dm, &attr, sizeof(*service_val));
+			if (!cur_attr) {
+				return -ENOMEM;
+			}
+
+			service_val = bt_gatt_dm_attr_service_val(cur_attr);
+			service_val->end_handle = net_buf_simple_pull_le16(&buf);
+			(void)cache_uuid_pull(&buf, &uuid);
+			service_val->uuid = uuid_store(dm, &uuid.uuid);
+			if (!service_val->uuid) {
+				return -ENOMEM;
+			}
+		} else if (!bt_uuid_cmp(attr.uuid, BT_UUID_GATT_CHRC)) {
+			cur_attr = attr_store(dm, &attr, sizeof(*chrc));
+			if (!cur_attr) {
+				return -ENOMEM;
+			}
+
+			chrc = bt_gatt_dm_attr_chrc_val(cur_attr);
+			chrc->value_handle = net_buf_simple_pull_le16(&buf);
+			chrc->properties = net_buf_simple_pull_u8(&buf);
+			(void)cache_uuid_pull(&buf, &uuid);
+			chrc->uuid = uuid_store(dm, &uuid.uuid);
+			if (!chrc->uuid) {
+				return -ENOMEM;
+			}
+		} else if (!attr_store(dm, &attr, 0)) {
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+#else
+
+static void cache_store(const struct bt_gatt_dm *dm)
+{
+}
+
+#endif /* defined(CONFIG_BT_GATT_DM_CACHE) */
+
 static void discovery_complete(struct bt_gatt_dm *dm)
 {
 	LOG_DBG("Discovery complete.");
+	cache_store(dm);
 	atomic_set_bit(dm->state_flags, STATE_ATTRS_RELEASE_PENDING);
 	if (dm->callback->completed) {
 		dm->callback->completed(dm, dm->context);
@@ -284,6 +587,8 @@ static uint8_t discovery_process_service(struct bt_gatt_dm *dm,
 	int err;
 
 	if (!attr) {
+		/* Cached, so that the search does not need to be repeated. */
+		cache_store(dm);
 		discovery_complete_not_found(dm);
 		return BT_GATT_ITER_STOP;
 	}
@@ -377,9 +682,11 @@ static uint8_t discovery_process_attribute(struct bt_gatt_dm *dm,
 
 	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CHRC) == 0) {
 		cur_attr = attr_store(dm, attr, sizeof(struct bt_gatt_chrc));
-		struct bt_gatt_chrc *cur_gatt_chrc = bt_gatt_dm_attr_chrc_val(cur_attr);
+		if (cur_attr) {
+			struct bt_gatt_chrc *cur_gatt_chrc = bt_gatt_dm_attr_chrc_val(cur_attr);
 
-		cur_gatt_chrc->uuid = cur_attr->uuid;
+			cur_gatt_chrc->uuid = cur_attr->uuid;
+		}
 	} else {
 		cur_attr = attr_store(dm, attr, 0);
 	}
@@ -472,6 +779,127 @@ static uint8_t discovery_callback(struct bt_conn *conn,
 	return BT_GATT_ITER_STOP;
 }
 
+/* Searches for the next service, in the cache if it is there. */
+static int service_discover(struct bt_gatt_dm *dm)
+{
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->search_start = dm->discover_params.start_handle;
+
+	if (dm->db_hash_valid && cache_contains(dm)) {
+		LOG_DBG("Service found in the cache");
+		k_work_submit(&cache_work);
+		return 0;
+	}
+#endif
+
+	return bt_gatt_discover(dm->conn, &dm->discover_params);
+}
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+
+static void cache_work_handler(struct k_work *work)
+{
+	struct bt_gatt_dm *dm = &bt_gatt_dm_inst;
+	NET_BUF_SIMPLE_DEFINE(key, CACHE_KEY_MAX);
+	struct bt_gatt_service_val *service_val;
+	uint8_t *record;
+	int err;
+
+	cache_key_add(dm, &key);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	record = cache_find(&key);
+	err = record ? cache_restore(dm, record) : -ENOENT;
+	k_mutex_unlock(&cache_lock);
+
+	if (err == -ENOENT) {
+		/* The cache was cleared in the meantime. */
+		err = bt_gatt_discover(dm->conn, &dm->discover_params);
+		if (!err) {
+			return;
+		}
+	}
+
+	if (err) {
+		LOG_ERR("Restoring cached service failed, error: %d.", err);
+		discovery_complete_error(dm, err);
+		return;
+	}
+
+	if (!dm->cur_attr_id) {
+		discovery_complete_not_found(dm);
+		return;
+	}
+
+	/* The parameters are left as a discovery of the service would. */
+	service_val = bt_gatt_dm_attr_service_val(&dm->attrs[0]);
+	dm->discover_params.end_handle = service_val->end_handle;
+	if (dm->attrs[0].handle != service_val->end_handle) {
+		dm->discover_params.uuid = NULL;
+	}
+
+	discovery_complete(dm);
+}
+
+static uint8_t db_hash_read_callback(struct bt_conn *conn, uint8_t err,
+				     struct bt_gatt_read_params *params,
+				     const void *data, uint16_t length)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm,
+					     read_params);
+	int ret;
+
+	if (!err && data && length == sizeof(dm->db_hash)) {
+		memcpy(dm->db_hash, data, sizeof(dm->db_hash));
+		dm->db_hash_valid = true;
+	} else {
+		LOG_DBG("No Database Hash, error: %u", err);
+	}
+
+	ret = service_discover(dm);
+	if (ret) {
+		LOG_ERR("Discover failed, error: %d.", ret);
+		discovery_complete_error(dm, ret);
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+/* Only the services of bonded peers are cached, others may change their
+ * database without the client noticing.
+ */
+static bool cache_peer_get(struct bt_gatt_dm *dm)
+{
+	struct bt_conn_info info;
+
+	if (bt_conn_get_info(dm->conn, &info) || (info.type != BT_CONN_TYPE_LE)) {
+		return false;
+	}
+
+	if (!bt_addr_le_is_bonded(info.id, info.le.dst)) {
+		return false;
+	}
+
+	dm->id = info.id;
+	bt_addr_le_copy(&dm->peer, info.le.dst);
+
+	return true;
+}
+
+/* Reads the Database Hash of the peer before the discovery is started. */
+static int db_hash_read(struct bt_gatt_dm *dm)
+{
+	dm->read_params.func = db_hash_read_callback;
+	dm->read_params.handle_count = 0;
+	dm->read_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+	dm->read_params.by_uuid.start_handle = 0x0001;
+	dm->read_params.by_uuid.end_handle = 0xffff;
+
+	return bt_gatt_read(dm->conn, &dm->read_params);
+}
+
+#endif /* defined(CONFIG_BT_GATT_DM_CACHE) */
+
 struct bt_gatt_service_val *bt_gatt_dm_attr_service_val(
 	const struct bt_gatt_dm_attr *attr)
 {
@@ -646,7 +1074,20 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->discover_params.end_handle = 0xffff;
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 
-	err = bt_gatt_discover(conn, &dm->discover_params);
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->db_hash_valid = false;
+
+	/* The services of a bonded peer are searched for once the hash is read.
+	 * Otherwise, they are discovered without the cache.
+	 */
+	err = cache_peer_get(dm) ? db_hash_read(dm) : -ENOENT;
+	if (err) {
+		LOG_DBG("Discovering without the cache, error: %d", err);
+		err = service_discover(dm);
+	}
+#else
+	err = service_discover(dm);
+#endif
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -689,7 +1130,7 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context)
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 	dm->discover_params.uuid = dm->search_svc_by_uuid ? &dm->svc_uuid.uuid : NULL;
 
-	err = bt_gatt_discover(dm->conn, &dm->discover_params);
+	err = service_discover(dm);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -712,6 +1153,33 @@ int bt_gatt_dm_data_release(struct bt_gatt_dm *dm)
 	return 0;
 }
 
+int bt_gatt_dm_arena_set(void *buf, size_t size)
+{
+	struct bt_gatt_dm *dm = &bt_gatt_dm_inst;
+
+	if ((uintptr_t)buf % DATA_ALIGN) {
+		return -EINVAL;
+	}
+
+	if (atomic_test_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
+		return -EBUSY;
+	}
+
+	dm->arena = buf;
+	dm->arena_size = buf ? size : 0;
+
+	return 0;
+}
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+void bt_gatt_dm_cache_clear(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	cache_len = 0;
+	k_mutex_unlock(&cache_lock);
+}
+#endif /* defined(CONFIG_BT_GATT_DM_CACHE) */
+
 #if CONFIG_BT_GATT_DM_DATA_PRINT
 
 #define UUID_STR_LEN 37
@@ -8,6 +8,7 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <zephyr/bluetooth/mesh.h>
 
 #define LOG_LEVEL CONFIG_BT_MESH_RPL_LOG_LEVEL
@@ -18,13 +19,167 @@ LOG_MODULE_REGISTER(bt_mesh_rpl);
 #include <mesh/rpl.h>
 #include <emds/emds.h>
 
+/* Entries are kept at the start of the list, in no particular order. The list is
+ * stored as is, so the index below is only kept in RAM and rebuilt when needed.
+ */
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
 EMDS_STATIC_ENTRY_DEFINE(rpl_store, CONFIG_BT_MESH_RPL_INDEX, replay_list, sizeof(replay_list));
 
+/* Open addressing hash of the entries by source address, with linear probing. Each
+ * element is the replay_list index + 1, or 0 if unused. Twice as many elements as
+ * entries keep the probe sequences short.
+ */
+#define RPL_HASH_SIZE (2 * CONFIG_BT_MESH_CRPL)
+
+BUILD_ASSERT(CONFIG_BT_MESH_CRPL < UINT16_MAX);
+
+static uint16_t rpl_hash[RPL_HASH_SIZE];
+static uint16_t rpl_count;
+static bool rpl_indexed;
+/* Set when an entry of the previous IV index was replaced, until the next IV update. */
+static bool rpl_old_iv_replaced;
+
+static size_t rpl_hash_home(uint16_t src)
+{
+	/* Unicast addresses are mostly assigned in sequence, so they spread evenly. */
+	return src % RPL_HASH_SIZE;
+}
+
+/* Returns the position of the source address in the hash, or of the unused element
+ * where it would be added.
+ */
+static size_t rpl_hash_find(uint16_t src)
+{
+	size_t pos = rpl_hash_home(src);
+
+	while (rpl_hash[pos] && replay_list[rpl_hash[pos] - 1].src != src) {
+		pos = (pos + 1) % RPL_HASH_SIZE;
+	}
+
+	return pos;
+}
+
+static void rpl_hash_remove(size_t pos)
+{
+	size_t next = pos;
+	size_t home;
+
+	rpl_hash[pos] = 0;
+
+	/* Move back the next elements of the probe sequence into the hole, unless their
+	 * home position is cyclically between the hole and themselves.
+	 */
+	while (true) {
+		next = (next + 1) % RPL_HASH_SIZE;
+		if (!rpl_hash[next]) {
+			return;
+		}
+
+		home = rpl_hash_home(replay_list[rpl_hash[next] - 1].src);
+		if ((next > pos) ? (home <= pos || home > next) : (home <= pos && home > next)) {
+			rpl_hash[pos] = rpl_hash[next];
+			rpl_hash[next] = 0;
+			pos = next;
+		}
+	}
+}
+
+/* Moves the entries to the start of the list and indexes them. Called after the list
+ * was loaded from the storage or changed as a whole.
+ */
+static void rpl_index_build(void)
+{
+	(void)memset(rpl_hash, 0, sizeof(rpl_hash));
+	rpl_count = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		if (!replay_list[i].src) {
+			continue;
+		}
+
+		if (i != rpl_count) {
+			replay_list[rpl_count] = replay_list[i];
+			(void)memset(&replay_list[i], 0, sizeof(replay_list[i]));
+		}
+
+		rpl_hash[rpl_hash_find(replay_list[rpl_count].src)] = rpl_count + 1;
+		rpl_count++;
+	}
+
+	rpl_indexed = true;
+}
+
+/* Returns the entry to use for a new source address: the first unused one, or if the
+ * list is full, an entry of the previous IV index. Those entries only protect against
+ * replays of messages sent with the previous IV index, which are rejected from unknown
+ * sources once one of them is replaced.
+ */
+static struct bt_mesh_rpl *rpl_free_find(void)
+{
+	if (rpl_count < ARRAY_SIZE(replay_list)) {
+		return &replay_list[rpl_count];
+	}
+
+	for (uint16_t i = 0; i < rpl_count; i++) {
+		if (replay_list[i].old_iv) {
+			return &replay_list[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Adds an entry for a new source address. Returns NULL if the list is full. */
+static struct bt_mesh_rpl *rpl_add(uint16_t src)
+{
+	struct bt_mesh_rpl *rpl = rpl_free_find();
+
+	if (!rpl) {
+		return NULL;
+	}
+
+	if (rpl->src) {
+		LOG_WRN("RPL is full, replacing 0x%04x of the previous IV index", rpl->src);
+		rpl_hash_remove(rpl_hash_find(rpl->src));
+		rpl_old_iv_replaced = true;
+	} else {
+		rpl_count++;
+	}
+
+	(void)memset(rpl, 0, sizeof(*rpl));
+	rpl->src = src;
+	rpl_hash[rpl_hash_find(src)] = (rpl - replay_list) + 1;
+
+	return rpl;
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
+	size_t pos;
+
+	/* The entry of a new source address is only taken now, so that it is not held
+	 * while a segmented message is received.
+	 */
+	if (rpl->src != rx->ctx.addr) {
+		if (!rpl_indexed) {
+			rpl_index_build();
+		}
+
+		pos = rpl_hash_find(rx->ctx.addr);
+		if (rpl_hash[pos]) {
+			/* Added since the check */
+			rpl = &replay_list[rpl_hash[pos] - 1];
+		} else {
+			rpl = rpl_add(rx->ctx.addr);
+			if (!rpl) {
+				LOG_ERR("RPL is full!");
+				return;
+			}
+		}
+	}
+
 	/* If this is the first message on the new IV index, we should reset it
 	 * to zero to avoid invalid combinations of IV index and seg.
 	 */
@@ -45,7 +200,8 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
+	size_t pos;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -57,55 +213,64 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	if (!rpl_indexed) {
+		rpl_index_build();
+	}
 
-		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
+	pos = rpl_hash_find(rx->ctx.addr);
 
-			return false;
+	/* New source address */
+	if (!rpl_hash[pos]) {
+		/* It may be the source of a replaced entry. */
+		if (rx->old_iv && rpl_old_iv_replaced) {
+			return true;
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		rpl = rpl_free_find();
+		if (!rpl) {
+			LOG_ERR("RPL is full!");
+			return true;
+		}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
+		}
 
-				return false;
-			} else {
-				return true;
-			}
+		return false;
+	}
+
+	/* Existing slot for given address */
+	rpl = &replay_list[rpl_hash[pos] - 1];
+
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
+
+	if ((!rx->old_iv && rpl->old_iv) ||
+	    rpl->seq < rx->seq) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
+
+		return false;
 	}
 
-	LOG_ERR("RPL is full!");
 	return true;
 }
 
 void bt_mesh_rpl_clear(void)
 {
 	(void)memset(replay_list, 0, sizeof(replay_list));
+	rpl_indexed = false;
+	rpl_old_iv_replaced = false;
 }
 
 void bt_mesh_rpl_reset(void)
 {
-	int shift = 0;
-	int last = 0;
-
 	/* Discard "old" IV Index entries from RPL and flag
 	 * any other ones (which are valid) as old.
 	 */
@@ -115,21 +280,14 @@ void bt_mesh_rpl_reset(void)
 		if (rpl->src) {
 			if (rpl->old_iv) {
 				(void)memset(rpl, 0, sizeof(*rpl));
-
-				shift++;
 			} else {
 				rpl->old_iv = true;
-
-				if (shift > 0) {
-					replay_list[i - shift] = *rpl;
-				}
 			}
-
-			last = i;
 		}
 	}
 
-	(void) memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+	rpl_old_iv_replaced = false;
+	rpl_index_build();
 }
 
 void bt_mesh_rpl_pending_store(uint16_t addr)
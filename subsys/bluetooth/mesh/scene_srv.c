@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/bluetooth/mesh/access.h>
 #include <bluetooth/mesh/models.h>
 #include <zephyr/sys/byteorder.h>
@@ -22,7 +23,16 @@ LOG_MODULE_REGISTER(bt_mesh_scene_srv);
 #define SCENE_PAGE_SIZE SETTINGS_MAX_VAL_LEN
 /* Account for company ID in data: */
 #define VND_MODEL_SCENE_DATA_OVERHEAD sizeof(uint16_t)
+/* Scenes are stored as a difference from the base state, which is stored as
+ * a scene that can't be used:
+ */
+#define SCENE_BASE BT_MESH_SCENE_NONE
+/* First byte of every scene data page: */
+#define SCENE_PAGE_FORMAT 2
 
+/* Scene data stored by earlier versions, in separate pages for SIG and vendor
+ * models.
+ */
 struct __packed scene_data {
 	uint8_t len;
 	uint8_t elem_idx;
@@ -30,11 +40,36 @@ struct __packed scene_data {
 	uint8_t data[];
 };
 
+/* Scene data of a single model. The items are stored in composition data
+ * order, and the model is found by its index in the element. The model ID is
+ * stored as well, so that the data isn't recalled to another model if the
+ * composition data changes.
+ */
+struct __packed scene_item {
+	uint8_t len;
+	uint8_t elem_idx;
+	uint8_t mod_idx;
+	uint8_t flags;
+	uint16_t id;
+	/** Company ID of vendor models, 0 for SIG models. */
+	uint16_t company;
+	uint8_t data[];
+};
+
+enum {
+	/** Vendor model. */
+	SCENE_ITEM_VND = BIT(0),
+	/** The model has no data in the scene, even if it has in the base state. */
+	SCENE_ITEM_ABSENT = BIT(1),
+	/** Base state item that the recalled scene overrides. Only used in RAM. */
+	SCENE_ITEM_OVERRIDDEN = BIT(7),
+};
+
 static sys_slist_t scene_servers;
 
-static char *scene_path(char *buf, uint16_t scene, bool vnd, uint8_t page)
+static char *scene_path(char *buf, uint16_t scene, char type, uint8_t page)
 {
-	sprintf(buf, "%x/%c%x", scene, vnd ? 'v' : 's', page);
+	sprintf(buf, "%x/%c%x", scene, type, page);
 	return buf;
 }
 
@@ -332,6 +367,7 @@ static void entry_recover(struct bt_mesh_scene_srv *srv, bool vnd,
 
 	entry->recall(mod, &data->data[overhead], data->len - overhead,
 		      &srv->transition);
+	srv->stats.recall_entries++;
 }
 
 static void page_recover(struct bt_mesh_scene_srv *srv, bool vnd,
@@ -344,65 +380,189 @@ static void page_recover(struct bt_mesh_scene_srv *srv, bool vnd,
 	}
 }
 
-static ssize_t entry_store(struct bt_mesh_model *mod,
-			   const struct bt_mesh_scene_entry *entry, bool vnd,
-			   uint8_t buf[])
+static int item_cmp(const struct scene_item *a, const struct scene_item *b)
 {
-	struct scene_data *data = (struct scene_data *)buf;
-	ssize_t size;
+	if (a->elem_idx != b->elem_idx) {
+		return a->elem_idx - b->elem_idx;
+	}
+
+	if ((a->flags & SCENE_ITEM_VND) != (b->flags & SCENE_ITEM_VND)) {
+		return (a->flags & SCENE_ITEM_VND) ? 1 : -1;
+	}
 
-	data->elem_idx = mod->elem_idx;
+	return a->mod_idx - b->mod_idx;
+}
 
+static bool item_equal(const struct scene_item *a, const struct scene_item *b)
+{
+	return a->id == b->id && a->company == b->company && a->len == b->len &&
+	       !memcmp(a->data, b->data, a->len);
+}
+
+static bool item_mod_match(const struct scene_item *item,
+			   const struct bt_mesh_model *mod, bool vnd)
+{
 	if (vnd) {
-		data->id = mod->vnd.id;
-		sys_put_le16(mod->vnd.company, data->data);
-		size = entry->store(mod,
-				    &data->data[VND_MODEL_SCENE_DATA_OVERHEAD]);
-		data->len = size + VND_MODEL_SCENE_DATA_OVERHEAD;
-	} else {
-		data->id = mod->id;
-		size = entry->store(mod, &data->data[0]);
-		data->len = size;
+		return item->id == mod->vnd.id &&
+		       item->company == mod->vnd.company;
 	}
 
-	if (size > entry->maxlen) {
-		LOG_ERR("Entry %s:%u:%u: data too large (%u bytes)",
-		       vnd ? "vnd" : "sig", mod->elem_idx, mod->mod_idx, size);
-		return -EINVAL;
+	return item->id == mod->id && item->company == 0;
+}
+
+static struct scene_item *page_item_next(uint8_t buf[], size_t len,
+					 size_t *off)
+{
+	struct scene_item *item;
+
+	if (*off + sizeof(*item) > len) {
+		return NULL;
+	}
+
+	item = (struct scene_item *)&buf[*off];
+	if (*off + sizeof(*item) + item->len > len) {
+		LOG_WRN("Truncated scene data @%u", *off);
+		return NULL;
+	}
+
+	*off += sizeof(*item) + item->len;
+	return item;
+}
+
+/** @brief Find the base state item of a model.
+ *
+ *  The search starts at @c off, and leaves it after the last item that is
+ *  before the given one in composition data order. Searching for items in
+ *  that order takes a single pass over the base state.
+ */
+static struct scene_item *base_item_find(struct bt_mesh_scene_srv *srv,
+					 const struct scene_item *item,
+					 size_t *off)
+{
+	struct scene_item *base;
+	size_t next = *off;
+
+	while ((base = page_item_next(srv->base, srv->base_len, &next))) {
+		int cmp = item_cmp(base, item);
+
+		if (cmp > 0) {
+			return NULL;
+		}
+
+		*off = next;
+
+		if (cmp == 0) {
+			return base;
+		}
 	}
 
+	return NULL;
+}
+
+static void item_recall(struct bt_mesh_scene_srv *srv,
+			const struct scene_item *item)
+{
+	const struct bt_mesh_comp *comp = bt_mesh_comp_get();
+	bool vnd = item->flags & SCENE_ITEM_VND;
+	const struct bt_mesh_scene_entry *entry;
+	const struct bt_mesh_elem *elem;
+	struct bt_mesh_model *mod;
+
+	if (item->elem_idx >= comp->elem_count) {
+		LOG_WRN("No element %u", item->elem_idx);
+		return;
+	}
+
+	elem = &comp->elem[item->elem_idx];
+	if (item->mod_idx >=
+	    (vnd ? elem->vnd_model_count : elem->model_count)) {
+		LOG_WRN("No model %s:%u:%u", vnd ? "vnd" : "sig",
+			item->elem_idx, item->mod_idx);
+		return;
+	}
+
+	mod = vnd ? &elem->vnd_models[item->mod_idx] :
+		    &elem->models[item->mod_idx];
+
+	if (!item_mod_match(item, mod, vnd)) {
+		LOG_WRN("Model %s:%u:%u changed from 0x%04x:0x%04x",
+			vnd ? "vnd" : "sig", item->elem_idx, item->mod_idx,
+			item->company, item->id);
+		return;
+	}
+
+	/* MeshMDL1.0.1, section 5.1.3.1.1:
+	 * If a model is extending another model, the extending model shall determine
+	 * the Stored with Scene behavior of that model.
+	 */
+	if (bt_mesh_model_is_extended(mod)) {
+		return;
+	}
+
+	entry = entry_find(mod, vnd);
+	if (!entry) {
+		LOG_WRN("No scene entry for %s:%u:%u", vnd ? "vnd" : "sig",
+			item->elem_idx, item->mod_idx);
+		return;
+	}
+
+	entry->recall(mod, item->data, item->len, &srv->transition);
+	srv->stats.recall_entries++;
+}
+
+static ssize_t item_store(struct bt_mesh_model *mod,
+			  const struct bt_mesh_scene_entry *entry, bool vnd,
+			  struct scene_item *item)
+{
+	ssize_t size;
+
+	item->len = 0;
+	item->elem_idx = mod->elem_idx;
+	item->mod_idx = mod->mod_idx;
+	item->flags = vnd ? SCENE_ITEM_VND : 0;
+	item->id = vnd ? mod->vnd.id : mod->id;
+	item->company = vnd ? mod->vnd.company : 0;
+
+	size = entry->store(mod, item->data);
 	if (size < 0) {
 		LOG_WRN("Failed storing %s:%u:%u (%d)", vnd ? "vnd" : "sig",
 			mod->elem_idx, mod->mod_idx, size);
 		return size;
 	}
 
-	if (size == 0) {
-		/* Silently ignore this entry */
-		return 0;
+	if (size > entry->maxlen) {
+		LOG_ERR("Entry %s:%u:%u: data too large (%u bytes)",
+		       vnd ? "vnd" : "sig", mod->elem_idx, mod->mod_idx, size);
+		return -EINVAL;
 	}
 
-	return sizeof(struct scene_data) + data->len;
+	item->len = size;
+	return size;
 }
 
 /** Store a single page of the Scene.
  *
  *  To accommodate large scene data, each scene is stored in pages of up to 256
- *  bytes.
+ *  bytes. SIG and vendor models share the pages.
  */
-static void page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
-		       uint8_t page, bool vnd, uint8_t buf[], size_t len)
+static int page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
+		      uint8_t page, const uint8_t buf[], size_t len)
 {
 	char path[9];
 	int err;
 
-	scene_path(path, scene, vnd, page);
-	update_page_count(srv, vnd, page);
+	scene_path(path, scene, 'd', page);
+	srv->pages = MAX(page + 1, srv->pages);
 
 	err = bt_mesh_model_data_store(srv->model, false, path, buf, len);
 	if (err) {
 		LOG_ERR("Failed storing %s: %d", path, err);
+		return err;
 	}
+
+	srv->stats.bytes_written += len;
+	srv->stats.records_written++;
+	return 0;
 }
 
 /** @brief Get the end of the Scene server's controlled elements.
@@ -478,57 +638,193 @@ static void scene_recall_complete(struct bt_mesh_scene_srv *srv)
 	}
 }
 
-static void scene_store_mod(struct bt_mesh_scene_srv *srv, uint16_t scene,
-			    bool vnd)
+typedef void (*scene_mod_cb_t)(struct bt_mesh_scene_srv *srv,
+			       struct bt_mesh_model *mod,
+			       const struct bt_mesh_scene_entry *entry,
+			       bool vnd, void *user_data);
+
+/** @brief Call @c cb for every model with scene data, in composition data
+ *         order.
+ */
+static void scene_mods_foreach(struct bt_mesh_scene_srv *srv,
+			       scene_mod_cb_t cb, void *user_data)
 {
-	const size_t data_overhead = sizeof(struct scene_data) + (vnd ? 2 : 0);
 	const struct bt_mesh_comp *comp = bt_mesh_comp_get();
 	uint16_t elem_end = srv_elem_end(srv);
-	uint8_t buf[SCENE_PAGE_SIZE];
-	uint8_t page = 0;
-	size_t len = 0;
 
 	for (int i = srv->model->elem_idx; i < elem_end; i++) {
 		const struct bt_mesh_elem *elem = &comp->elem[i];
-		struct bt_mesh_model *models = vnd ? elem->vnd_models : elem->models;
-		int model_count = vnd ? elem->vnd_model_count : elem->model_count;
 
-		for (int j = 0; j < model_count; j++) {
-			const struct bt_mesh_scene_entry *entry;
-			struct bt_mesh_model *mod = &models[j];
-			ssize_t size;
-
-			if (mod == srv->model) {
-				continue;
+		for (int vnd = 0; vnd <= 1; vnd++) {
+			struct bt_mesh_model *models =
+				vnd ? elem->vnd_models : elem->models;
+			int model_count =
+				vnd ? elem->vnd_model_count : elem->model_count;
+
+			for (int j = 0; j < model_count; j++) {
+				const struct bt_mesh_scene_entry *entry;
+				struct bt_mesh_model *mod = &models[j];
+
+				if (mod == srv->model) {
+					continue;
+				}
+
+				/* MeshMDL1.0.1, section 5.1.3.1.1:
+				 * If a model is extending another model, the
+				 * extending model shall determine the Stored
+				 * with Scene behavior of that model.
+				 */
+				if (bt_mesh_model_is_extended(mod)) {
+					continue;
+				}
+
+				entry = entry_find(mod, vnd);
+				if (!entry) {
+					continue;
+				}
+
+				cb(srv, mod, entry, vnd, user_data);
 			}
+		}
+	}
+}
 
-			/* MeshMDL1.0.1, section 5.1.3.1.1:
-			 * If a model is extending another model, the extending
-			 * model shall determine the Stored with Scene behavior
-			 * of that model.
-			 */
-			if (bt_mesh_model_is_extended(mod)) {
-				continue;
-			}
+static void base_item_add(struct bt_mesh_scene_srv *srv,
+			  struct bt_mesh_model *mod,
+			  const struct bt_mesh_scene_entry *entry, bool vnd,
+			  void *user_data)
+{
+	size_t *len = user_data;
+	struct scene_item *item = (struct scene_item *)&srv->base[*len];
 
-			entry = entry_find(mod, vnd);
-			if (!entry) {
-				continue;
-			}
+	/* Models that don't fit are stored in full in every scene. */
+	if (*len + sizeof(*item) + entry->maxlen > sizeof(srv->base)) {
+		return;
+	}
 
-			if (len + data_overhead + entry->maxlen >= SCENE_PAGE_SIZE) {
-				page_store(srv, scene, page++, vnd, buf, len);
-				len = 0;
-			}
+	if (item_store(mod, entry, vnd, item) > 0) {
+		*len += sizeof(*item) + item->len;
+	}
+}
+
+/** Make the current state the base state that scenes are stored against. */
+static void base_create(struct bt_mesh_scene_srv *srv)
+{
+	size_t len = 1;
+
+	srv->base[0] = SCENE_PAGE_FORMAT;
+	scene_mods_foreach(srv, base_item_add, &len);
+
+	if (!page_store(srv, SCENE_BASE, 0, srv->base, len)) {
+		srv->base_len = len;
+	}
+}
+
+static void base_delete(struct bt_mesh_scene_srv *srv)
+{
+	char path[9];
+
+	if (!srv->base_len) {
+		return;
+	}
+
+	scene_path(path, SCENE_BASE, 'd', 0);
+	(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
+	srv->base_len = 0;
+}
+
+struct scene_writer {
+	uint16_t scene;
+	uint8_t page;
+	size_t len;
+	/* Base state search position */
+	size_t base_off;
+	uint8_t buf[SCENE_PAGE_SIZE];
+};
+
+static void scene_item_add(struct bt_mesh_scene_srv *srv,
+			   struct bt_mesh_model *mod,
+			   const struct bt_mesh_scene_entry *entry, bool vnd,
+			   void *user_data)
+{
+	struct scene_writer *writer = user_data;
+	struct scene_item *item;
+	struct scene_item *base;
+	ssize_t size;
+
+	if (writer->len + sizeof(*item) + entry->maxlen > sizeof(writer->buf)) {
+		(void)page_store(srv, writer->scene, writer->page++, writer->buf,
+				 writer->len);
+		writer->len = 1;
+	}
+
+	item = (struct scene_item *)&writer->buf[writer->len];
+	size = item_store(mod, entry, vnd, item);
+	base = base_item_find(srv, item, &writer->base_off);
 
-			size = entry_store(mod, entry, vnd, &buf[len]);
-			len += MAX(0, size);
+	if (base && size > 0 && item_equal(base, item)) {
+		/* Recalled from the base state. */
+		return;
+	}
+
+	if (size <= 0) {
+		if (!base) {
+			return;
 		}
+
+		/* Keep the base state from being recalled for the model: */
+		item->flags |= SCENE_ITEM_ABSENT;
 	}
 
-	if (len) {
-		page_store(srv, scene, page, vnd, buf, len);
+	writer->len += sizeof(*item) + item->len;
+}
+
+static void scene_pages_delete(struct bt_mesh_scene_srv *srv, uint16_t scene,
+			       uint8_t first)
+{
+	char path[9];
+
+	for (int i = first; i < srv->pages; i++) {
+		scene_path(path, scene, 'd', i);
+		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
+	}
+
+	for (int i = 0; i < srv->sigpages; i++) {
+		scene_path(path, scene, 's', i);
+		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
 	}
+
+	for (int i = 0; i < srv->vndpages; i++) {
+		scene_path(path, scene, 'v', i);
+		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
+	}
+}
+
+/** @brief Store the models that differ from the base state.
+ *
+ *  The items are written in as few pages as they fit in, which is usually a
+ *  single page. Pages left over from an earlier store of the scene are
+ *  deleted.
+ */
+static void scene_data_store(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	struct scene_writer writer = {
+		.scene = scene,
+		.len = 1,
+		.base_off = 1,
+	};
+
+	if (CONFIG_BT_MESH_SCENE_SRV_BASE_SIZE && !srv->base_len) {
+		base_create(srv);
+	}
+
+	writer.buf[0] = SCENE_PAGE_FORMAT;
+	scene_mods_foreach(srv, scene_item_add, &writer);
+
+	/* Stored even if it's empty, so that the scene is found on boot. */
+	(void)page_store(srv, scene, writer.page++, writer.buf, writer.len);
+
+	scene_pages_delete(srv, scene, writer.page);
 }
 
 static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
@@ -545,8 +841,7 @@ static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
 		srv->all[srv->count++] = scene;
 	}
 
-	scene_store_mod(srv, scene, false);
-	scene_store_mod(srv, scene, true);
+	scene_data_store(srv, scene);
 
 	srv->prev = scene;
 	srv->next = BT_MESH_SCENE_NONE;
@@ -558,19 +853,9 @@ static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
 
 static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
 {
-	uint8_t path[9];
-
 	LOG_DBG("0x%x", *scene);
 
-	for (int i = 0; i < srv->sigpages; i++) {
-		scene_path(path, *scene, false, i);
-		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
-	}
-
-	for (int i = 0; i < srv->vndpages; i++) {
-		scene_path(path, *scene, true, i);
-		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
-	}
+	scene_pages_delete(srv, *scene, 0);
 
 	uint16_t target = target_scene(srv);
 	uint16_t current = current_scene(srv);
@@ -587,6 +872,10 @@ static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
 	}
 
 	*scene = srv->all[--srv->count];
+
+	if (!srv->count) {
+		base_delete(srv);
+	}
 }
 
 static int handle_store(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
@@ -730,67 +1019,82 @@ static int scene_srv_init(struct bt_mesh_model *model)
 	return 0;
 }
 
+static int base_load(struct bt_mesh_scene_srv *srv, size_t len_rd,
+		     settings_read_cb read_cb, void *cb_arg)
+{
+	ssize_t size;
+
+	if (len_rd > sizeof(srv->base)) {
+		LOG_ERR("Base state too large (%u bytes)", len_rd);
+		return -EINVAL;
+	}
+
+	size = read_cb(cb_arg, srv->base, sizeof(srv->base));
+	if (size < 1 || srv->base[0] != SCENE_PAGE_FORMAT) {
+		LOG_ERR("Failed loading base state");
+		return -EINVAL;
+	}
+
+	srv->base_len = size;
+	return 0;
+}
+
 static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 			 size_t len_rd, settings_read_cb read_cb, void *cb_arg)
 {
 	struct bt_mesh_scene_srv *srv = model->user_data;
-	uint8_t buf[SCENE_PAGE_SIZE];
+	const char *next;
 	uint16_t scene;
-	ssize_t size;
 	uint8_t page;
-	bool vnd;
 
 	LOG_DBG("path: %s", path);
 
-	/* The entire model data tree is loaded in this callback. Depending on
-	 * the path and whether we have started the mesh, we'll handle the data
-	 * differently:
+	/* The entire model data tree is loaded in this callback:
+	 *
+	 * - Path "0/d0": Base state, stored as scene number
+	 *   BT_MESH_SCENE_NONE (0x0000), which is never used by a scene
+	 * - Path "XXXX/dYY": Scene XXXX page YY
+	 * - Path "XXXX/vYY": Scene XXXX vendor model page YY, from earlier versions
+	 * - Path "XXXX/sYY": Scene XXXX sig model page YY, from earlier versions
 	 *
-	 * - Path "XXXX/vYY": Scene XXXX vendor model page YY
-	 * - Path "XXXX/sYY": Scene XXXX sig model page YY
+	 * Only the base state is read here, the scene data isn't read until
+	 * the scene is recalled.
 	 */
 	scene = strtol(path, NULL, 16);
-	if (scene == BT_MESH_SCENE_NONE) {
-		LOG_ERR("Unknown data %s", path);
-		return 0;
-	}
 
-	settings_name_next(path, &path);
-	if (!path) {
+	settings_name_next(path, &next);
+	if (!next) {
 		return 0;
 	}
 
-	vnd = path[0] == 'v';
-	page = strtol(&path[1], NULL, 16);
-	update_page_count(srv, vnd, page);
+	page = strtol(&next[1], NULL, 16);
 
-	/* Before starting the mesh, we'll just register that the scene exists:
-	 * Once the mesh starts, we'll load the current scene, and end up in
-	 * this callback again, but bt_mesh_is_provisioned() will be true.
-	 */
-	if (!bt_mesh_is_provisioned()) {
-		if (scene_find(srv, scene)) {
+	if (scene == SCENE_BASE) {
+		if (next[0] != 'd' || page != 0) {
+			LOG_ERR("Unknown data %s", path);
 			return 0;
 		}
 
-		if (srv->count == ARRAY_SIZE(srv->all)) {
-			LOG_WRN("No room for scene 0x%x", scene);
-			return 0;
-		}
+		return base_load(srv, len_rd, read_cb, cb_arg);
+	}
 
-		LOG_DBG("Recovered scene 0x%x", scene);
-		srv->all[srv->count++] = scene;
+	if (next[0] == 'd') {
+		srv->pages = MAX(page + 1, srv->pages);
+	} else {
+		update_page_count(srv, next[0] == 'v', page);
+	}
+
+	if (scene_find(srv, scene)) {
 		return 0;
 	}
 
-	size = read_cb(cb_arg, &buf, sizeof(buf));
-	if (size < 0) {
-		LOG_ERR("Failed loading scene 0x%x", scene);
-		return -EINVAL;
+	if (srv->count == ARRAY_SIZE(srv->all)) {
+		LOG_WRN("No room for scene 0x%x", scene);
+		return 0;
 	}
 
-	LOG_DBG("0x%x: %s", scene, bt_hex(buf, size));
-	page_recover(srv, vnd, buf, size);
+	LOG_DBG("Recovered scene 0x%x", scene);
+	srv->all[srv->count++] = scene;
 	return 0;
 }
 
@@ -809,6 +1113,8 @@ static void scene_srv_reset(struct bt_mesh_model *model)
 	(void)k_work_cancel_delayable(&srv->work);
 	srv->sigpages = 0;
 	srv->vndpages = 0;
+	srv->pages = 0;
+	base_delete(srv);
 }
 
 const struct bt_mesh_model_cb _bt_mesh_scene_srv_cb = {
@@ -864,12 +1170,109 @@ void bt_mesh_scene_invalidate(struct bt_mesh_model *mod)
 	srv->next = BT_MESH_SCENE_NONE;
 }
 
+struct scene_loader {
+	struct bt_mesh_scene_srv *srv;
+	/* The scene is stored as a difference from the base state. */
+	bool diff;
+};
+
+static int scene_page_load(const char *key, size_t len_rd,
+			   settings_read_cb read_cb, void *cb_arg, void *param)
+{
+	struct scene_loader *loader = param;
+	struct bt_mesh_scene_srv *srv = loader->srv;
+	uint8_t buf[SCENE_PAGE_SIZE];
+	struct scene_item *item;
+	struct scene_item *base;
+	size_t off = 1;
+	ssize_t size;
+
+	if (!key) {
+		return 0;
+	}
+
+	size = read_cb(cb_arg, &buf, sizeof(buf));
+	if (size < 0) {
+		LOG_ERR("Failed loading scene page %s", key);
+		return -EINVAL;
+	}
+
+	LOG_DBG("%s: %s", key, bt_hex(buf, size));
+
+	if (key[0] == 's' || key[0] == 'v') {
+		page_recover(srv, key[0] == 'v', buf, size);
+		return 0;
+	}
+
+	if (key[0] != 'd' || size < 1 || buf[0] != SCENE_PAGE_FORMAT) {
+		LOG_WRN("Unknown scene data %s", key);
+		return 0;
+	}
+
+	loader->diff = true;
+
+	/* The pages may be loaded in any order, so the base state is searched
+	 * from the start for every item.
+	 */
+	while ((item = page_item_next(buf, size, &off))) {
+		size_t base_off = 1;
+
+		base = base_item_find(srv, item, &base_off);
+		if (base) {
+			base->flags |= SCENE_ITEM_OVERRIDDEN;
+		}
+
+		if (!(item->flags & SCENE_ITEM_ABSENT)) {
+			item_recall(srv, item);
+		}
+	}
+
+	return 0;
+}
+
+/** @brief Recall the scene data.
+ *
+ *  The scene data is only read from persistent storage when it's recalled.
+ *  Models that the scene doesn't override are recalled from the base state in
+ *  RAM.
+ */
+static int scene_data_recall(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	struct scene_loader loader = { .srv = srv };
+	uint32_t start = k_cycle_get_32();
+	struct scene_item *item;
+	size_t off = 1;
+	char path[25];
+	int err;
+
+	sprintf(path, "bt/mesh/s/%x/data/%x",
+		(srv->model->elem_idx << 8) | srv->model->mod_idx, scene);
+
+	LOG_DBG("Loading %s", path);
+
+	srv->stats.recall_entries = 0;
+
+	err = settings_load_subtree_direct(path, scene_page_load, &loader);
+
+	while ((item = page_item_next(srv->base, srv->base_len, &off))) {
+		if (!err && loader.diff &&
+		    !(item->flags & SCENE_ITEM_OVERRIDDEN)) {
+			item_recall(srv, item);
+		}
+
+		item->flags &= ~SCENE_ITEM_OVERRIDDEN;
+	}
+
+	srv->stats.recall_time_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	return err;
+}
+
 int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 			  struct bt_mesh_model_transition *transition)
 {
 	int32_t transition_time;
 	uint16_t curr;
-	char path[25];
 	int err;
 
 	if (scene == BT_MESH_SCENE_NONE ||
@@ -908,12 +1311,7 @@ int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 		(void)k_work_cancel_delayable(&srv->work);
 	}
 
-	sprintf(path, "bt/mesh/s/%x/data/%x",
-		(srv->model->elem_idx << 8) | srv->model->mod_idx, scene);
-
-	LOG_DBG("Loading %s", path);
-
-	err = settings_load_subtree(path);
+	err = scene_data_recall(srv, scene);
 	if (!err) {
 		scene_recall_complete(srv);
 	}
@@ -940,3 +1338,9 @@ uint16_t bt_mesh_scene_srv_target_scene_get(const struct bt_mesh_scene_srv *srv)
 {
 	return target_scene(srv);
 }
+
+void bt_mesh_scene_srv_stats_get(const struct bt_mesh_scene_srv *srv,
+				 struct bt_mesh_scene_srv_stats *stats)
+{
+	*stats = srv->stats;
+}
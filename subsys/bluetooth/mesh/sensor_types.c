@@ -439,18 +439,170 @@ static int exp_1_1_decode(const struct bt_mesh_sensor_format *format,
 	return 0;
 }
 
+/* IEEE-754 32-bit floating point values are converted with integer arithmetic,
+ * so that encoding and decoding doesn't use the FPU. The results are the same as
+ * the single precision operations that are noted for each step, rounding to
+ * nearest, ties to even.
+ */
+#define F32_MANT_BITS 23
+#define F32_EXP_BIAS 127
+#define F32_EXP_MAX 0xff
+
+/* Value of mant * 2^exp. */
+struct f32 {
+	bool neg;
+	uint32_t mant;
+	int exp;
+};
+
+/* Round mant * 2^exp to a 24-bit mantissa. Sticky is set if mant was already
+ * rounded down, so that ties are rounded up.
+ */
+static struct f32 f32_round(bool neg, uint64_t mant, int exp, bool sticky)
+{
+	struct f32 f = { .neg = neg };
+	uint64_t rest;
+	int shift;
+
+	if (!mant) {
+		return f;
+	}
+
+	shift = __builtin_clzll(mant);
+	mant <<= shift;
+	exp -= shift;
+
+	f.mant = mant >> (63 - F32_MANT_BITS);
+	f.exp = exp + (63 - F32_MANT_BITS);
+	rest = mant & BIT64_MASK(63 - F32_MANT_BITS);
+
+	if (rest > BIT64(62 - F32_MANT_BITS) ||
+	    (rest == BIT64(62 - F32_MANT_BITS) && (sticky || (f.mant & 1)))) {
+		f.mant++;
+		if (f.mant == BIT(F32_MANT_BITS + 1)) {
+			f.mant >>= 1;
+			f.exp++;
+		}
+	}
+
+	return f;
+}
+
+/* (float)val */
+static struct f32 f32_from_int(int32_t val)
+{
+	return f32_round(val < 0, val < 0 ? -(int64_t)val : val, 0, false);
+}
+
+/* a / 1000000.0f */
+static struct f32 f32_div_million(struct f32 a)
+{
+	/* Keeps enough quotient bits for rounding: */
+	uint64_t num = (uint64_t)a.mant << 39;
+
+	return f32_round(a.neg, num / 1000000, a.exp - 39, num % 1000000);
+}
+
+/* a + b */
+static struct f32 f32_add(struct f32 a, struct f32 b)
+{
+	struct f32 hi = (b.exp > a.exp) ? b : a;
+	struct f32 lo = (b.exp > a.exp) ? a : b;
+	uint64_t hi_mant, lo_mant;
+	int diff = hi.exp - lo.exp;
+
+	if (!a.mant) {
+		return b;
+	}
+
+	if (!b.mant) {
+		return a;
+	}
+
+	/* Align the mantissas with room for a carry. Bits shifted out of the
+	 * smaller one are kept as a sticky bit, far below the rounding point.
+	 */
+	hi_mant = (uint64_t)hi.mant << 38;
+	lo_mant = (uint64_t)lo.mant << 38;
+	if (diff >= 64) {
+		lo_mant = 1;
+	} else if (diff) {
+		lo_mant = (lo_mant >> diff) | !!(lo_mant & BIT64_MASK(diff));
+	}
+
+	if (hi.neg == lo.neg) {
+		return f32_round(hi.neg, hi_mant + lo_mant, hi.exp - 38, false);
+	}
+
+	if (hi_mant >= lo_mant) {
+		return f32_round(hi.neg, hi_mant - lo_mant, hi.exp - 38, false);
+	}
+
+	return f32_round(lo.neg, lo_mant - hi_mant, hi.exp - 38, false);
+}
+
+/* (int64_t)a, saturating like the FPU conversion does. */
+static int64_t f32_to_int(struct f32 a, int64_t max)
+{
+	uint64_t val;
+
+	if (a.exp >= 0) {
+		val = (a.exp + F32_MANT_BITS + 1 > 63) ? UINT64_MAX :
+							  (uint64_t)a.mant << a.exp;
+	} else {
+		val = (a.exp <= -32) ? 0 : a.mant >> -a.exp;
+	}
+
+	if (a.neg) {
+		return (val > (uint64_t)max) ? -max - 1 : -(int64_t)val;
+	}
+
+	return (val > (uint64_t)max) ? max : val;
+}
+
+static uint32_t f32_pack(struct f32 a)
+{
+	if (!a.mant) {
+		return 0;
+	}
+
+	return ((uint32_t)a.neg << 31) |
+	       ((uint32_t)(a.exp + F32_MANT_BITS + F32_EXP_BIAS) << F32_MANT_BITS) |
+	       (a.mant & BIT_MASK(F32_MANT_BITS));
+}
+
+static struct f32 f32_unpack(uint32_t bits)
+{
+	uint32_t exp = (bits >> F32_MANT_BITS) & F32_EXP_MAX;
+	struct f32 f = {
+		.neg = bits >> 31,
+		.mant = bits & BIT_MASK(F32_MANT_BITS),
+		.exp = (int)exp - F32_EXP_BIAS - F32_MANT_BITS,
+	};
+
+	if (exp) {
+		f.mant |= BIT(F32_MANT_BITS);
+	} else {
+		/* Subnormal numbers are all far below 1 / 1000000. */
+		f.mant = 0;
+	}
+
+	return f;
+}
+
 static int float32_encode(const struct bt_mesh_sensor_format *format,
 			  const struct sensor_value *val,
 			  struct net_buf_simple *buf)
 {
-	if (net_buf_simple_tailroom(buf) < sizeof(float)) {
+	if (net_buf_simple_tailroom(buf) < sizeof(uint32_t)) {
 		return -ENOMEM;
 	}
 
-	/* IEEE-754 32-bit floating point */
-	float fvalue = (float)val->val1 + (float)val->val2 / 1000000L;
+	/* (float)val->val1 + (float)val->val2 / 1000000L */
+	struct f32 fvalue = f32_add(f32_from_int(val->val1),
+				    f32_div_million(f32_from_int(val->val2)));
 
-	net_buf_simple_add_mem(buf, &fvalue, sizeof(float));
+	net_buf_simple_add_le32(buf, f32_pack(fvalue));
 
 	return 0;
 }
@@ -458,17 +610,27 @@ static int float32_encode(const struct bt_mesh_sensor_format *format,
 static int float32_decode(const struct bt_mesh_sensor_format *format,
 			  struct net_buf_simple *buf, struct sensor_value *val)
 {
-	if (buf->len < sizeof(float)) {
+	if (buf->len < sizeof(uint32_t)) {
 		return -ENOMEM;
 	}
 
-	float fvalue;
+	uint32_t bits = net_buf_simple_pull_le32(buf);
+	struct f32 fvalue = f32_unpack(bits);
 
-	memcpy(&fvalue, net_buf_simple_pull_mem(buf, sizeof(float)),
-	       sizeof(float));
+	if (((bits >> F32_MANT_BITS) & F32_EXP_MAX) == F32_EXP_MAX) {
+		/* Infinity saturates, NaN is 0. */
+		if (bits & BIT_MASK(F32_MANT_BITS)) {
+			fvalue.mant = 0;
+		} else {
+			fvalue.exp = INT16_MAX;
+		}
+	}
 
-	val->val1 = (int32_t)fvalue;
-	val->val2 = ((int64_t)(fvalue * 1000000.0f)) % 1000000L;
+	/* (int32_t)fvalue */
+	val->val1 = f32_to_int(fvalue, INT32_MAX);
+	/* ((int64_t)(fvalue * 1000000.0f)) % 1000000L */
+	fvalue = f32_round(fvalue.neg, (uint64_t)fvalue.mant * 1000000, fvalue.exp, false);
+	val->val2 = f32_to_int(fvalue, INT64_MAX) % 1000000L;
 	return 0;
 }
 
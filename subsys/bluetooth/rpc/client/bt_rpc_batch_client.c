@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Batched calls of bluetooth API over nRF RPC. The calls are encoded one after another
+ * into a single command, which the host executes in order.
+ */
+
+#include <zephyr/kernel.h>
+
+#include <bt_rpc.h>
+
+#include "bt_rpc_common.h"
+#include "bt_rpc_batch_client.h"
+#include "serialize.h"
+#include "nrf_rpc_cbor.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
+
+/* Call ID of each batched call and the null terminating the batch. */
+#define ITEM_OVERHEAD 1
+#define END_OVERHEAD 1
+
+struct batch_error {
+	uint32_t index;
+	int err;
+};
+
+struct batch_errors {
+	uint32_t base;		/* Index of the first call in the message */
+	uint32_t count;
+	struct batch_error list[BT_RPC_BATCH_ERRORS_MAX];
+};
+
+static K_MUTEX_DEFINE(batch_mutex);
+
+static struct nrf_rpc_cbor_ctx batch_ctx;
+/* Thread that started the batch. Calls made by other threads are not batched. */
+static k_tid_t batch_thread;
+/* Calls encoded in batch_ctx. The buffer is allocated with the first one. */
+static uint32_t batch_items;
+/* Index of the first call in batch_ctx since the batch was started. */
+static uint32_t batch_index;
+static int batch_err;
+
+static struct batch_errors batch_errors;
+static bt_rpc_batch_error_cb_t batch_error_cb;
+
+static void batch_rsp_decode(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx,
+			     void *handler_data)
+{
+	struct batch_errors *errors = handler_data;
+	uint32_t failed;
+	uint32_t count;
+
+	failed = ser_decode_uint(ctx);
+	count = MIN(failed, BT_RPC_BATCH_ERRORS_MAX);
+
+	for (uint32_t i = 0; i < count; i++) {
+		errors->list[i].index = errors->base + ser_decode_uint(ctx);
+		errors->list[i].err = ser_decode_int(ctx);
+	}
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		LOG_ERR("Invalid response of batched calls");
+		errors->count = 0;
+		return;
+	}
+
+	errors->count = count;
+
+	if (failed > count) {
+		LOG_WRN("%u batched calls failed, %u not reported", failed, failed - count);
+	}
+}
+
+/* Called with batch_mutex held. */
+static void batch_flush(void)
+{
+	struct batch_errors rsp = { .base = batch_index };
+	int err;
+
+	if (batch_items == 0) {
+		return;
+	}
+
+	ser_encode_null(&batch_ctx);
+
+	/* A command, not an event, so that the batch is executed before any later call. */
+	err = nrf_rpc_cbor_cmd(&bt_rpc_grp, BT_RPC_BATCH_RPC_CMD, &batch_ctx,
+			       batch_rsp_decode, &rsp);
+	if (err) {
+		LOG_ERR("Sending %u batched calls failed: %d", batch_items, err);
+		batch_err = err;
+		rsp.count = 0;
+	}
+
+	/* Kept until reported, in case another batch was flushed meanwhile. */
+	for (uint32_t i = 0; i < rsp.count && batch_errors.count < BT_RPC_BATCH_ERRORS_MAX; i++) {
+		batch_errors.list[batch_errors.count++] = rsp.list[i];
+	}
+
+	batch_index += batch_items;
+	batch_items = 0;
+}
+
+/* Called without batch_mutex, so the callback can make batched calls. */
+static void batch_errors_report(void)
+{
+	struct batch_errors errors;
+	bt_rpc_batch_error_cb_t cb;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+	errors = batch_errors;
+	batch_errors.count = 0;
+	cb = batch_error_cb;
+	k_mutex_unlock(&batch_mutex);
+
+	for (uint32_t i = 0; cb && i < errors.count; i++) {
+		cb(errors.list[i].index, errors.list[i].err);
+	}
+}
+
+bool bt_rpc_batch_item_begin(uint8_t item, size_t size, struct nrf_rpc_cbor_ctx **ctx)
+{
+	size_t remaining;
+
+	size += ITEM_OVERHEAD;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (batch_thread != k_current_get()) {
+		k_mutex_unlock(&batch_mutex);
+		return false;
+	}
+
+	if (batch_items > 0) {
+		remaining = batch_ctx.zs->payload_end - batch_ctx.zs->payload;
+		if (size + END_OVERHEAD > remaining) {
+			batch_flush();
+		}
+	}
+
+	if (size + END_OVERHEAD > CONFIG_BT_RPC_BATCH_SIZE) {
+		/* Sent on its own, after the calls batched so far. */
+		k_mutex_unlock(&batch_mutex);
+		batch_errors_report();
+		return false;
+	}
+
+	if (batch_items == 0) {
+		NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, batch_ctx, CONFIG_BT_RPC_BATCH_SIZE);
+	}
+
+	ser_encode_uint(&batch_ctx, item);
+	batch_items++;
+
+	*ctx = &batch_ctx;
+
+	return true;
+}
+
+void bt_rpc_batch_item_end(void)
+{
+	k_mutex_unlock(&batch_mutex);
+	batch_errors_report();
+}
+
+int bt_rpc_batch_begin(void)
+{
+	int err = 0;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (batch_thread == k_current_get()) {
+		err = -EALREADY;
+	} else if (batch_thread) {
+		err = -EBUSY;
+	} else {
+		batch_thread = k_current_get();
+		batch_index = 0;
+		batch_err = 0;
+	}
+
+	k_mutex_unlock(&batch_mutex);
+
+	return err;
+}
+
+int bt_rpc_batch_end(void)
+{
+	int err;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (batch_thread != k_current_get()) {
+		k_mutex_unlock(&batch_mutex);
+		return -EALREADY;
+	}
+
+	batch_flush();
+	batch_thread = NULL;
+	err = batch_err;
+
+	k_mutex_unlock(&batch_mutex);
+
+	batch_errors_report();
+
+	return err;
+}
+
+void bt_rpc_batch_error_cb_set(bt_rpc_batch_error_cb_t cb)
+{
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+	batch_error_cb = cb;
+	k_mutex_unlock(&batch_mutex);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_RPC_BATCH_CLIENT_H_
+#define BT_RPC_BATCH_CLIENT_H_
+
+/**
+ * @file
+ * @defgroup bt_rpc_batch_client RPC batched calls client API
+ * @{
+ * @brief Internal API for encoding calls into the current batch.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nrf_rpc_cbor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_BT_RPC_BATCH)
+
+/** @brief Start encoding a call into the current batch.
+ *
+ * If the calling thread started a batch, the batch buffer is flushed first when the call does not fit
+ * in it. The call ID is encoded and the batch stays locked until
+ * @ref bt_rpc_batch_item_end is called.
+ *
+ * @param item Call ID, see @ref bt_rpc_batch_item.
+ * @param size Maximum size of the encoded call arguments.
+ * @param ctx  Returns the context to encode the call arguments into.
+ *
+ * @retval true If the call arguments must be encoded into @p ctx.
+ * @retval false If the calling thread has not started a batch or the call is too large for the batch buffer.
+ *               The call must be sent on its own.
+ */
+bool bt_rpc_batch_item_begin(uint8_t item, size_t size, struct nrf_rpc_cbor_ctx **ctx);
+
+/** @brief Finish encoding a call started with @ref bt_rpc_batch_item_begin. */
+void bt_rpc_batch_item_end(void);
+
+#else
+
+static inline bool bt_rpc_batch_item_begin(uint8_t item, size_t size,
+					   struct nrf_rpc_cbor_ctx **ctx)
+{
+	return false;
+}
+
+static inline void bt_rpc_batch_item_end(void) {}
+
+#endif /* defined(CONFIG_BT_RPC_BATCH) */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_RPC_BATCH_CLIENT_H_ */
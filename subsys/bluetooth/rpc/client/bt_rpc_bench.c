@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Measures the cost of a serialized Bluetooth API call, from encoding on the client to the
+ * response from the host, using GATT notifications as a typical call.
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+
+#include <bt_rpc.h>
+
+#define BENCH_COUNT_DEFAULT 1000
+#define BENCH_LEN_DEFAULT 20
+#define BENCH_LEN_MAX 244
+
+#define BT_UUID_BENCH_SVC_VAL \
+	BT_UUID_128_ENCODE(0x8e7f1a23, 0x4b2c, 0x11ee, 0xbe56, 0x0242ac120002)
+#define BT_UUID_BENCH_CHRC_VAL \
+	BT_UUID_128_ENCODE(0x8e7f1a24, 0x4b2c, 0x11ee, 0xbe56, 0x0242ac120002)
+
+static struct bt_uuid_128 bench_svc_uuid = BT_UUID_INIT_128(BT_UUID_BENCH_SVC_VAL);
+static struct bt_uuid_128 bench_chrc_uuid = BT_UUID_INIT_128(BT_UUID_BENCH_CHRC_VAL);
+
+static uint8_t bench_data[BENCH_LEN_MAX];
+
+BT_GATT_SERVICE_DEFINE(bench_svc,
+	BT_GATT_PRIMARY_SERVICE(&bench_svc_uuid),
+	BT_GATT_CHARACTERISTIC(&bench_chrc_uuid.uuid, BT_GATT_CHRC_NOTIFY,
+			       BT_GATT_PERM_NONE, NULL, NULL, NULL),
+	BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+);
+
+static int bench_args_parse(const struct shell *shell, size_t argc, char **argv,
+			    uint32_t *count, uint16_t *len)
+{
+	*count = BENCH_COUNT_DEFAULT;
+	*len = BENCH_LEN_DEFAULT;
+
+	if (argc > 1) {
+		*count = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		*len = MIN(strtoul(argv[2], NULL, 0), BENCH_LEN_MAX);
+	}
+	if (*count == 0) {
+		shell_error(shell, "Invalid count");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int cmd_bench_notify(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count;
+	uint16_t len;
+	uint64_t total_us = 0;
+	uint32_t min_us = UINT32_MAX;
+	uint32_t max_us = 0;
+	uint32_t failed = 0;
+	uint32_t start;
+	uint32_t us;
+	int err;
+
+	err = bench_args_parse(shell, argc, argv, &count, &len);
+	if (err) {
+		return err;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		bench_data[0] = (uint8_t)i;
+
+		start = k_cycle_get_32();
+		/* Notifies all subscribed peers, if any. The round trip to the host is the
+		 * same either way.
+		 */
+		err = bt_gatt_notify(NULL, &bench_svc.attrs[1], bench_data, len);
+		us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		if (err && err != -ENOTCONN) {
+			failed++;
+		}
+		total_us += us;
+		min_us = MIN(min_us, us);
+		max_us = MAX(max_us, us);
+	}
+
+	shell_print(shell, "%u notifications of %u bytes, %u failed", count, len, failed);
+	shell_print(shell, "Round trip: min %u us, avg %u us, max %u us",
+		    min_us, (uint32_t)(total_us / count), max_us);
+	shell_print(shell, "Calls per second: %u",
+		    (uint32_t)((uint64_t)count * USEC_PER_SEC / MAX(total_us, 1)));
+
+	return 0;
+}
+
+#if defined(CONFIG_BT_RPC_BATCH)
+static uint32_t batch_failed;
+
+static void bench_batch_error(uint32_t index, int err)
+{
+	if (err != -ENOTCONN) {
+		batch_failed++;
+	}
+}
+
+static int cmd_bench_notify_batch(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count;
+	uint16_t len;
+	uint32_t start;
+	uint32_t us;
+	int err;
+
+	err = bench_args_parse(shell, argc, argv, &count, &len);
+	if (err) {
+		return err;
+	}
+
+	batch_failed = 0;
+	bt_rpc_batch_error_cb_set(bench_batch_error);
+
+	start = k_cycle_get_32();
+
+	err = bt_rpc_batch_begin();
+	if (err) {
+		shell_error(shell, "Batch not started: %d", err);
+		return err;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		bench_data[0] = (uint8_t)i;
+		(void)bt_gatt_notify(NULL, &bench_svc.attrs[1], bench_data, len);
+	}
+
+	/* Batched calls return right away, so measure until the host executed all of them. */
+	err = bt_rpc_batch_end();
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	bt_rpc_batch_error_cb_set(NULL);
+
+	if (err) {
+		shell_error(shell, "Batch failed: %d", err);
+		return err;
+	}
+
+	shell_print(shell, "%u batched notifications of %u bytes, %u failed", count, len,
+		    batch_failed);
+	shell_print(shell, "Total: %u us, avg %u us", us, us / count);
+	shell_print(shell, "Calls per second: %u",
+		    (uint32_t)((uint64_t)count * USEC_PER_SEC / MAX(us, 1)));
+
+	return 0;
+}
+#endif /* defined(CONFIG_BT_RPC_BATCH) */
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmd_bt_rpc_bench,
+	SHELL_CMD_ARG(notify, NULL, "Call bt_gatt_notify [count] [length]",
+		      cmd_bench_notify, 1, 2),
+#if defined(CONFIG_BT_RPC_BATCH)
+	SHELL_CMD_ARG(notify_batch, NULL, "Call bt_gatt_notify in a batch [count] [length]",
+		      cmd_bench_notify_batch, 1, 2),
+#endif
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(bt_rpc_bench, &sub_cmd_bt_rpc_bench, "Bluetooth over RPC benchmark", NULL);
@@ -9,6 +9,7 @@
 #include <zephyr/bluetooth/conn.h>
 
 #include "bt_rpc_common.h"
+#include "bt_rpc_batch_client.h"
 #include "serialize.h"
 #include "cbkproxy.h"
 #include <nrf_rpc_cbor.h>
@@ -1201,6 +1202,42 @@ void bt_le_oob_set_sc_flag(bool enable)
 				&ctx, ser_rsp_decode_void, NULL);
 }
 
+/* The asynchronous variants are sent as events, or added to the current batch. */
+static void bool_evt_send(uint8_t evt_id, uint8_t batch_item, bool enable)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct nrf_rpc_cbor_ctx *batch;
+	size_t buffer_size_max = 1;
+
+	if (bt_rpc_batch_item_begin(batch_item, buffer_size_max, &batch)) {
+		ser_encode_bool(batch, enable);
+		bt_rpc_batch_item_end();
+		return;
+	}
+
+	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
+
+	ser_encode_bool(&ctx, enable);
+
+	nrf_rpc_cbor_evt_no_err(&bt_rpc_grp, evt_id, &ctx);
+}
+
+void bt_rpc_set_bondable_async(bool enable)
+{
+	bool_evt_send(BT_SET_BONDABLE_RPC_EVT, BT_RPC_BATCH_SET_BONDABLE, enable);
+}
+
+void bt_rpc_le_oob_set_legacy_flag_async(bool enable)
+{
+	bool_evt_send(BT_LE_OOB_SET_LEGACY_FLAG_RPC_EVT, BT_RPC_BATCH_LE_OOB_SET_LEGACY_FLAG,
+		      enable);
+}
+
+void bt_rpc_le_oob_set_sc_flag_async(bool enable)
+{
+	bool_evt_send(BT_LE_OOB_SET_SC_FLAG_RPC_EVT, BT_RPC_BATCH_LE_OOB_SET_SC_FLAG, enable);
+}
+
 #if !defined(CONFIG_BT_SMP_SC_PAIR_ONLY)
 int bt_le_oob_set_legacy_tk(struct bt_conn *conn, const uint8_t *tk)
 {
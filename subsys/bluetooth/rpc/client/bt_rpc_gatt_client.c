@@ -15,6 +15,7 @@
 
 #include "bt_rpc_common.h"
 #include "bt_rpc_gatt_common.h"
+#include "bt_rpc_batch_client.h"
 #include "serialize.h"
 #include "cbkproxy.h"
 #include "nrf_rpc_cbor.h"
@@ -758,6 +759,7 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 		      struct bt_gatt_notify_params *params)
 {
 	struct nrf_rpc_cbor_ctx ctx;
+	struct nrf_rpc_cbor_ctx *batch;
 	int result;
 	size_t scratchpad_size = 0;
 	size_t buffer_size_max = 8;
@@ -766,6 +768,16 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 
 	scratchpad_size += bt_gatt_notify_params_sp_size(params);
 
+	if (bt_rpc_batch_item_begin(BT_RPC_BATCH_GATT_NOTIFY_CB, buffer_size_max, &batch)) {
+		ser_encode_uint(batch, scratchpad_size);
+		bt_rpc_encode_bt_conn(batch, conn);
+		bt_gatt_notify_params_enc(batch, params);
+		bt_rpc_batch_item_end();
+
+		/* The result is reported by the batch error callback. */
+		return 0;
+	}
+
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 	ser_encode_uint(&ctx, scratchpad_size);
 
@@ -144,8 +144,35 @@ enum bt_rpc_cmd_from_cli_to_host {
 	/* internal.h API */
 	BT_ADDR_LE_IS_BONDED_CMD,
 	BT_HCI_CMD_SEND_SYNC_RPC_CMD,
+	/* bt_rpc.h API */
+	BT_RPC_BATCH_RPC_CMD,
 };
 
+/** @brief Client events IDs used in bluetooth API serialization.
+ *         Those events are sent from the client to the host.
+ */
+enum bt_rpc_evt_from_cli_to_host {
+	/* conn.h API */
+	BT_SET_BONDABLE_RPC_EVT,
+	BT_LE_OOB_SET_LEGACY_FLAG_RPC_EVT,
+	BT_LE_OOB_SET_SC_FLAG_RPC_EVT,
+};
+
+/** @brief Call IDs used inside of the @ref BT_RPC_BATCH_RPC_CMD command.
+ *         Each batched call starts with one of them, followed by the call arguments.
+ */
+enum bt_rpc_batch_item {
+	BT_RPC_BATCH_GATT_NOTIFY_CB,
+	BT_RPC_BATCH_SET_BONDABLE,
+	BT_RPC_BATCH_LE_OOB_SET_LEGACY_FLAG,
+	BT_RPC_BATCH_LE_OOB_SET_SC_FLAG,
+};
+
+/** @brief Maximum number of failed batched calls reported individually in the response
+ *         of a @ref BT_RPC_BATCH_RPC_CMD command.
+ */
+#define BT_RPC_BATCH_ERRORS_MAX 8
+
 /** @brief Host commands IDs used in bluetooth API serialization.
  *         Those commands are sent from the host to the client.
  */
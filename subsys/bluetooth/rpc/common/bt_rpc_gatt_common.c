@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 
 #include <zephyr/bluetooth/gatt.h>
 
@@ -21,14 +22,67 @@ LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
 
 static struct bt_gatt_svc_cache {
 	const struct bt_gatt_service *services[CONFIG_BT_RPC_GATT_SRV_MAX];
+	/* Service indexes sorted by the address of the service attributes, so that
+	 * the service of an attribute is found with a binary search.
+	 */
+	uint8_t sorted[CONFIG_BT_RPC_GATT_SRV_MAX];
 	size_t count;
 } svc_cache = {
 	.count = 0,
 };
 
+BUILD_ASSERT(CONFIG_BT_RPC_GATT_SRV_MAX <= UINT8_MAX + 1);
+
+static uintptr_t sorted_attrs(size_t pos)
+{
+	return (uintptr_t)svc_cache.services[svc_cache.sorted[pos]]->attrs;
+}
+
+/* Returns the last position in the sorted indexes of a service with attributes at or
+ * below the given address, or -1 if there is none.
+ */
+static int sorted_find(const struct bt_gatt_attr *attr)
+{
+	int low = 0;
+	int high = (int)svc_cache.count - 1;
+	int found = -1;
+	int mid;
+
+	while (low <= high) {
+		mid = (low + high) / 2;
+
+		if (sorted_attrs(mid) <= (uintptr_t)attr) {
+			found = mid;
+			low = mid + 1;
+		} else {
+			high = mid - 1;
+		}
+	}
+
+	return found;
+}
+
+/* Returns the position of the service in the sorted indexes, or -1 if not found. */
+static int sorted_find_service(const struct bt_gatt_service *svc)
+{
+	int pos = sorted_find(svc->attrs);
+
+	/* Services without attributes may share the address. */
+	while ((pos >= 0) && (sorted_attrs(pos) == (uintptr_t)svc->attrs)) {
+		if (svc_cache.services[svc_cache.sorted[pos]] == svc) {
+			return pos;
+		}
+
+		pos--;
+	}
+
+	return -1;
+}
+
 int bt_rpc_gatt_add_service(const struct bt_gatt_service *svc, uint32_t *svc_index)
 {
 	uint32_t index;
+	int pos;
 
 	if (svc_cache.count >= CONFIG_BT_RPC_GATT_SRV_MAX) {
 		LOG_ERR("Too many GATT services used by BT_RPC. %s",
@@ -36,9 +90,15 @@ int bt_rpc_gatt_add_service(const struct bt_gatt_service *svc, uint32_t *svc_ind
 		return -ENOMEM;
 	}
 
+	pos = sorted_find(svc->attrs) + 1;
+
 	index = svc_cache.count;
 	svc_cache.services[index] = svc;
 
+	memmove(&svc_cache.sorted[pos + 1], &svc_cache.sorted[pos],
+		sizeof(svc_cache.sorted[0]) * (svc_cache.count - pos));
+	svc_cache.sorted[pos] = index;
+
 	svc_cache.count++;
 
 	*svc_index = index;
@@ -50,25 +110,32 @@ int bt_rpc_gatt_attr_to_index(const struct bt_gatt_attr *attr, uint32_t *index)
 {
 	const struct bt_gatt_service *service;
 	uint32_t attr_index;
-	uint32_t service_index = 0;
+	uint32_t service_index;
+	int pos;
 
 	if (!attr) {
 		return -EINVAL;
 	}
 
-	do {
-		if (service_index >= svc_cache.count) {
-			return -EINVAL;
-		}
+	pos = sorted_find(attr);
 
-		service = svc_cache.services[service_index];
+	/* Services without attributes may share the address of the next service. */
+	while ((pos >= 0) &&
+	       (svc_cache.services[svc_cache.sorted[pos]]->attr_count == 0) &&
+	       (sorted_attrs(pos) == (uintptr_t)attr)) {
+		pos--;
+	}
 
-		if ((attr >= service->attrs) && (attr < &service->attrs[service->attr_count])) {
-			break;
-		}
+	if (pos < 0) {
+		return -EINVAL;
+	}
 
-		service_index++;
-	} while (true);
+	service_index = svc_cache.sorted[pos];
+	service = svc_cache.services[service_index];
+
+	if (attr >= &service->attrs[service->attr_count]) {
+		return -EINVAL;
+	}
 
 	attr_index = attr - service->attrs;
 
@@ -101,41 +168,49 @@ const struct bt_gatt_service *bt_rpc_gatt_get_service_by_index(uint16_t svc_inde
 
 int bt_rpc_gatt_service_to_index(const struct bt_gatt_service *svc, uint16_t *svc_index)
 {
-	int err = -EFAULT;
+	int pos;
 
 	if (!svc_index || !svc) {
 		return -EINVAL;
 	}
 
-	for (size_t i = 0; i < svc_cache.count; i++) {
-		if (svc == svc_cache.services[i]) {
-			*svc_index = i;
-			err = 0;
-			break;
-		}
+	pos = sorted_find_service(svc);
+	if (pos < 0) {
+		return -EFAULT;
 	}
 
-	return err;
+	*svc_index = svc_cache.sorted[pos];
+
+	return 0;
 }
 
 int bt_rpc_gatt_remove_service(const struct bt_gatt_service *svc)
 {
+	uint8_t index;
+	int pos;
+
 	if (!svc) {
 		return -EINVAL;
 	}
 
-	for (size_t i = 0; i < svc_cache.count; i++) {
-		if (svc == svc_cache.services[i]) {
-			if (i == ARRAY_SIZE(svc_cache.services)) {
-				svc_cache.services[i - 1] = NULL;
-			} else {
-				memmove(&svc_cache.services[i], &svc_cache.services[i + 1],
-					(sizeof(svc_cache.services[i]) * (svc_cache.count - i)));
-			}
+	pos = sorted_find_service(svc);
+	if (pos < 0) {
+		return 0;
+	}
+
+	index = svc_cache.sorted[pos];
 
-			svc_cache.count--;
+	/* The indexes of the next services shift down, as on the remote side. */
+	memmove(&svc_cache.services[index], &svc_cache.services[index + 1],
+		sizeof(svc_cache.services[0]) * (svc_cache.count - index - 1));
+	memmove(&svc_cache.sorted[pos], &svc_cache.sorted[pos + 1],
+		sizeof(svc_cache.sorted[0]) * (svc_cache.count - pos - 1));
 
-			break;
+	svc_cache.count--;
+
+	for (size_t i = 0; i < svc_cache.count; i++) {
+		if (svc_cache.sorted[i] > index) {
+			svc_cache.sorted[i]--;
 		}
 	}
 
@@ -1012,6 +1012,74 @@ NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_le_oob_set_sc_flag, BT_LE_OOB_SET_SC_FLA
 			 bt_le_oob_set_sc_flag_rpc_handler, NULL);
 
 
+/* Fire-and-forget variants, sent as events by the client. */
+static void bt_set_bondable_async_rpc_handler(const struct nrf_rpc_group *group,
+					struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	bool enable;
+
+	enable = ser_decode_bool(ctx);
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	bt_set_bondable(enable);
+
+	return;
+decoding_error:
+	report_decoding_error(BT_SET_BONDABLE_RPC_EVT, handler_data);
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bt_rpc_grp, bt_set_bondable_async, BT_SET_BONDABLE_RPC_EVT,
+			 bt_set_bondable_async_rpc_handler, NULL);
+
+
+static void bt_le_oob_set_legacy_flag_async_rpc_handler(const struct nrf_rpc_group *group,
+					     struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	bool enable;
+
+	enable = ser_decode_bool(ctx);
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	bt_le_oob_set_legacy_flag(enable);
+
+	return;
+decoding_error:
+	report_decoding_error(BT_LE_OOB_SET_LEGACY_FLAG_RPC_EVT, handler_data);
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bt_rpc_grp, bt_le_oob_set_legacy_flag_async,
+			 BT_LE_OOB_SET_LEGACY_FLAG_RPC_EVT,
+			 bt_le_oob_set_legacy_flag_async_rpc_handler, NULL);
+
+
+static void bt_le_oob_set_sc_flag_async_rpc_handler(const struct nrf_rpc_group *group,
+					     struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	bool enable;
+
+	enable = ser_decode_bool(ctx);
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	bt_le_oob_set_sc_flag(enable);
+
+	return;
+decoding_error:
+	report_decoding_error(BT_LE_OOB_SET_SC_FLAG_RPC_EVT, handler_data);
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bt_rpc_grp, bt_le_oob_set_sc_flag_async, BT_LE_OOB_SET_SC_FLAG_RPC_EVT,
+			 bt_le_oob_set_sc_flag_async_rpc_handler, NULL);
+
+
 #if !defined(CONFIG_BT_SMP_SC_PAIR_ONLY)
 static void bt_le_oob_set_legacy_tk_rpc_handler(const struct nrf_rpc_group *group,
 						struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
@@ -798,6 +798,79 @@ void bt_gatt_notify_params_dec(struct ser_scratchpad *scratchpad,
 
 }
 
+/* Batched call, decoded before the calls of the batch are executed. */
+struct bt_rpc_batch_call {
+	uint8_t item;
+	/* Negative error, if the call failed already when decoded. */
+	int err;
+	union {
+		struct {
+			struct bt_conn *conn;
+			struct bt_gatt_notify_params params;
+		} notify;
+		bool enable;
+	};
+};
+
+/* Copy a decoded buffer out of the scratchpad, it is released before the call. */
+static const void *bt_rpc_batch_data_copy(struct ser_scratchpad *data, const void *buf,
+					  size_t len)
+{
+	void *copy;
+
+	if (buf == NULL) {
+		return NULL;
+	}
+
+	if (net_buf_simple_tailroom(&data->buf) < SCRATCHPAD_ALIGN(len)) {
+		return NULL;
+	}
+
+	copy = ser_scratchpad_add(data, len);
+	memcpy(copy, buf, len);
+
+	return copy;
+}
+
+static size_t bt_uuid_size(const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return sizeof(struct bt_uuid_16);
+	case BT_UUID_TYPE_32:
+		return sizeof(struct bt_uuid_32);
+	default:
+		return sizeof(struct bt_uuid_128);
+	}
+}
+
+static int bt_gatt_notify_cb_batch_dec(struct nrf_rpc_cbor_ctx *ctx,
+				       struct bt_rpc_batch_call *call, struct ser_scratchpad *data)
+{
+	struct bt_gatt_notify_params *params = &call->notify.params;
+	const void *uuid;
+	struct ser_scratchpad scratchpad;
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, ctx);
+
+	call->notify.conn = bt_rpc_decode_bt_conn(ctx);
+	bt_gatt_notify_params_dec(&scratchpad, params);
+
+	if (!ser_decode_valid(ctx)) {
+		return -EBADMSG;
+	}
+
+	uuid = params->uuid;
+	params->data = bt_rpc_batch_data_copy(data, params->data, params->len);
+	params->uuid = bt_rpc_batch_data_copy(data, uuid, uuid ? bt_uuid_size(uuid) : 0);
+
+	if ((params->len > 0 && params->data == NULL) || (uuid != NULL && params->uuid == NULL)) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
 static void bt_gatt_notify_cb_rpc_handler(const struct nrf_rpc_group *group,
 					  struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
 {
@@ -828,6 +901,139 @@ decoding_error:
 NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_gatt_notify_cb, BT_GATT_NOTIFY_CB_RPC_CMD,
 	bt_gatt_notify_cb_rpc_handler, NULL);
 
+/* Decode a batched call. A negative error fails the call, without ending the batch. */
+static int bt_rpc_batch_item_dec(struct nrf_rpc_cbor_ctx *ctx, struct bt_rpc_batch_call *call,
+				 struct ser_scratchpad *data)
+{
+	call->item = ser_decode_uint(ctx);
+
+	switch (call->item) {
+	case BT_RPC_BATCH_GATT_NOTIFY_CB:
+		return bt_gatt_notify_cb_batch_dec(ctx, call, data);
+#if defined(CONFIG_BT_SMP)
+	case BT_RPC_BATCH_SET_BONDABLE:
+	case BT_RPC_BATCH_LE_OOB_SET_LEGACY_FLAG:
+	case BT_RPC_BATCH_LE_OOB_SET_SC_FLAG:
+		call->enable = ser_decode_bool(ctx);
+		return 0;
+#endif /* defined(CONFIG_BT_SMP) */
+	default:
+		ser_decoder_invalid(ctx, ZCBOR_ERR_WRONG_VALUE);
+		return -ENOTSUP;
+	}
+}
+
+static int bt_rpc_batch_item_call(const struct bt_rpc_batch_call *call)
+{
+	switch (call->item) {
+	case BT_RPC_BATCH_GATT_NOTIFY_CB:
+		return bt_gatt_notify_cb(call->notify.conn, &call->notify.params);
+#if defined(CONFIG_BT_SMP)
+	case BT_RPC_BATCH_SET_BONDABLE:
+		bt_set_bondable(call->enable);
+		return 0;
+	case BT_RPC_BATCH_LE_OOB_SET_LEGACY_FLAG:
+		bt_le_oob_set_legacy_flag(call->enable);
+		return 0;
+	case BT_RPC_BATCH_LE_OOB_SET_SC_FLAG:
+		bt_le_oob_set_sc_flag(call->enable);
+		return 0;
+#endif /* defined(CONFIG_BT_SMP) */
+	default:
+		return -ENOTSUP;
+	}
+}
+
+static void bt_rpc_batch_error_add(uint32_t *failed, uint32_t *index, int32_t *err,
+				   uint32_t i, int result)
+{
+	if (*failed < BT_RPC_BATCH_ERRORS_MAX) {
+		index[*failed] = i;
+		err[*failed] = result;
+	}
+	(*failed)++;
+}
+
+static void bt_rpc_batch_rsp_send(const struct nrf_rpc_group *group, uint32_t failed,
+				  const uint32_t *index, const int32_t *err)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	uint32_t count = MIN(failed, BT_RPC_BATCH_ERRORS_MAX);
+	size_t buffer_size_max = 5 + count * 10;
+
+	NRF_RPC_CBOR_ALLOC(group, ctx, buffer_size_max);
+
+	ser_encode_uint(&ctx, failed);
+	for (uint32_t i = 0; i < count; i++) {
+		ser_encode_uint(&ctx, index[i]);
+		ser_encode_int(&ctx, err[i]);
+	}
+
+	nrf_rpc_cbor_rsp_no_err(group, &ctx);
+}
+
+static void bt_rpc_batch_rpc_handler(const struct nrf_rpc_group *group,
+				     struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	struct bt_rpc_batch_call calls[CONFIG_BT_RPC_BATCH_HOST_CALLS];
+	uint32_t data_buf[SCRATCHPAD_ALIGN(CONFIG_BT_RPC_BATCH_HOST_DATA_SIZE) / sizeof(uint32_t)];
+	struct ser_scratchpad data;
+	uint32_t index[BT_RPC_BATCH_ERRORS_MAX];
+	int32_t err[BT_RPC_BATCH_ERRORS_MAX];
+	uint32_t failed = 0;
+	uint32_t count = 0;
+	uint32_t i;
+	int result;
+
+	data.ctx = ctx;
+	net_buf_simple_init_with_data(&data.buf, data_buf, sizeof(data_buf));
+	net_buf_simple_reset(&data.buf);
+
+	/* The whole batch is decoded before the calls are executed, so that the nRF RPC
+	 * transport can reuse the received message while the calls run. A null ends the batch.
+	 */
+	while (!ser_decode_is_null(ctx) && ser_decode_valid(ctx)) {
+		struct bt_rpc_batch_call unused;
+		struct bt_rpc_batch_call *call = count < ARRAY_SIZE(calls) ? &calls[count] : &unused;
+
+		call->err = bt_rpc_batch_item_dec(ctx, call, &data);
+
+		if (!ser_decode_valid(ctx)) {
+			break;
+		}
+
+		/* The calls that do not fit are decoded only to reach the end of the batch. */
+		count++;
+	}
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (i >= ARRAY_SIZE(calls)) {
+			result = -ENOMEM;
+		} else if (calls[i].err < 0) {
+			result = calls[i].err;
+		} else {
+			result = bt_rpc_batch_item_call(&calls[i]);
+		}
+
+		if (result < 0) {
+			bt_rpc_batch_error_add(&failed, index, err, i, result);
+		}
+	}
+
+	bt_rpc_batch_rsp_send(group, failed, index, err);
+
+	return;
+decoding_error:
+	report_decoding_error(BT_RPC_BATCH_RPC_CMD, handler_data);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_rpc_batch, BT_RPC_BATCH_RPC_CMD,
+	bt_rpc_batch_rpc_handler, NULL);
+
 void bt_gatt_indicate_params_dec(struct ser_scratchpad *scratchpad,
 				 struct bt_gatt_indicate_params *data)
 {
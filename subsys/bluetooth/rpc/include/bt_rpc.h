@@ -58,6 +58,90 @@ int bt_rpc_gatt_subscribe_flag_clear(struct bt_gatt_subscribe_params *params, ui
  */
 int bt_rpc_gatt_subscribe_flag_get(struct bt_gatt_subscribe_params *params, uint32_t flags_bit);
 
+/** @brief Enable or disable bonding, without waiting for the host.
+ *
+ * Same as @ref bt_set_bondable, but the call is sent as an event, or batched if the
+ * calling thread started a batch. The host executes it in order with the calls sent
+ * before it.
+ *
+ * Requires CONFIG_BT_SMP.
+ *
+ * @param enable Value allowing/disallowing to be bondable.
+ */
+void bt_rpc_set_bondable_async(bool enable);
+
+/** @brief Set OOB data flag for legacy pairing, without waiting for the host.
+ *
+ * Same as @ref bt_le_oob_set_legacy_flag, but the call is sent as an event, or batched
+ * if the calling thread started a batch.
+ *
+ * Requires CONFIG_BT_SMP.
+ *
+ * @param enable Value allowing/disallowing controller to use legacy OOB data.
+ */
+void bt_rpc_le_oob_set_legacy_flag_async(bool enable);
+
+/** @brief Set OOB data flag for LE Secure Connections pairing, without waiting for the host.
+ *
+ * Same as @ref bt_le_oob_set_sc_flag, but the call is sent as an event, or batched if
+ * the calling thread started a batch.
+ *
+ * Requires CONFIG_BT_SMP.
+ *
+ * @param enable Value allowing/disallowing controller to use LE SC OOB data.
+ */
+void bt_rpc_le_oob_set_sc_flag_async(bool enable);
+
+/** @brief Callback type for reporting failed batched calls.
+ *
+ * @param index Index of the failed call, counted from 0 since @ref bt_rpc_batch_begin.
+ * @param err   Error code returned by the call on the host.
+ */
+typedef void (*bt_rpc_batch_error_cb_t)(uint32_t index, int err);
+
+/** @brief Start batching calls.
+ *
+ * Until @ref bt_rpc_batch_end is called, the calls that the calling thread makes to
+ * @ref bt_gatt_notify_cb (and the functions based on it), @ref bt_rpc_set_bondable_async,
+ * @ref bt_rpc_le_oob_set_legacy_flag_async and @ref bt_rpc_le_oob_set_sc_flag_async are
+ * encoded into one buffer of CONFIG_BT_RPC_BATCH_SIZE bytes instead of being sent one
+ * by one. The buffer is sent to the host as one message when it is full or when the
+ * batch ends. Only one thread can batch calls at a time, the calls of other threads
+ * are sent immediately.
+ *
+ * The batched calls return right away, @ref bt_gatt_notify_cb returns 0. The host
+ * executes them in order and the calls that fail are reported to the callback set
+ * with @ref bt_rpc_batch_error_cb_set. Other calls are sent immediately, so they may
+ * be executed before the batched calls that precede them.
+ *
+ * Requires CONFIG_BT_RPC_BATCH.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EALREADY If the calling thread already started a batch.
+ * @retval -EBUSY If another thread started a batch.
+ */
+int bt_rpc_batch_begin(void);
+
+/** @brief Send the batched calls and stop batching.
+ *
+ * Returns once the host has executed all the batched calls.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EALREADY If the calling thread has not started a batch.
+ *           Otherwise, a (negative) error code of the transport is returned.
+ */
+int bt_rpc_batch_end(void);
+
+/** @brief Set the callback reporting failed batched calls.
+ *
+ * The callback is called from the thread that sent the batch to the host.
+ * Only the first eight failures of each message sent to the host are reported, the
+ * others are logged.
+ *
+ * @param cb Callback, or NULL to not report the failures.
+ */
+void bt_rpc_batch_error_cb_set(bt_rpc_batch_error_cb_t cb);
+
 #ifdef __cplusplus
 }
 #endif
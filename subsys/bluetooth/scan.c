@@ -12,12 +12,16 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 
-#define BT_SCAN_UUID_128_SIZE 16
-
 #define MODE_CHECK (BT_SCAN_NAME_FILTER | BT_SCAN_ADDR_FILTER | \
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
+/* Hash tables of the address and UUID filters have twice as many slots
+ * as filters, so that a lookup ends on an empty slot after a few probes.
+ */
+#define ADDR_HASH_SIZE (2 * CONFIG_BT_SCAN_ADDRESS_CNT)
+#define UUID_HASH_SIZE (2 * CONFIG_BT_SCAN_UUID_CNT)
+
 /* Scan filter mutex. */
 K_MUTEX_DEFINE(scan_mutex);
 
@@ -25,14 +29,14 @@ K_MUTEX_DEFINE(scan_mutex);
  * compare matching filters, their mode and event generation.
  */
 struct bt_scan_control {
-	/* Number of active filters. */
-	uint8_t filter_cnt;
+	/* Types of the active filters, as BT_SCAN_*_FILTER bits. */
+	uint8_t filter_enabled;
 
-	/* Number of matched filters. */
-	uint8_t filter_match_cnt;
+	/* Types of the matched filters. */
+	uint8_t filter_matched;
 
-	/* Indicates whether at least one filter has been fitted. */
-	bool filter_match;
+	/* UUID filters found in the advertising data, by filter index. */
+	uint32_t uuid_found;
 
 	/* Indicates in which mode filters operate. */
 	bool all_mode;
@@ -55,6 +59,12 @@ struct bt_scan_name_filter {
 	 */
 	char target_name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
 
+	/* Length of the names. */
+	uint8_t len[CONFIG_BT_SCAN_NAME_CNT];
+
+	/* Name indexes sorted by name. */
+	uint8_t order[CONFIG_BT_SCAN_NAME_CNT];
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -74,8 +84,14 @@ struct bt_scan_short_name_filter {
 
 		/* Minimum length of the short name. */
 		uint8_t min_len;
+
+		/* Length of the short name. */
+		uint8_t len;
 	} name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
+	/* Short name indexes sorted by name. */
+	uint8_t order[CONFIG_BT_SCAN_SHORT_NAME_CNT];
+
 	/* Short name filter counter. */
 	uint8_t cnt;
 
@@ -89,6 +105,9 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+	/* Address indexes plus one by address hash, 0 for an empty slot. */
+	uint8_t hash[ADDR_HASH_SIZE];
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +139,9 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+	/* UUID indexes plus one by UUID hash, 0 for an empty slot. */
+	uint8_t hash[UUID_HASH_SIZE];
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -155,6 +177,9 @@ struct bt_scan_manufacturer_data_filter {
 		uint8_t data_len;
 	} manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
 
+	/* Manufacturer data indexes sorted by data. */
+	uint8_t order[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -230,6 +255,53 @@ struct conn_blocklist {
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DUPLICATE_FILTER
+/* Last report passed on for a device and report type. */
+struct duplicate_entry {
+	/* Node in the list of entries, by the time they were last received. */
+	sys_dnode_t node;
+
+	/* Hash of the device address and the report type. */
+	uint32_t hash;
+
+	/* Hash of the advertising data of the last report passed on. */
+	uint32_t data_hash;
+
+	/* Uptime of the last report passed on, in milliseconds. */
+	uint32_t time;
+
+	/* Next entry index plus one in the hash bucket, 0 for none. */
+	uint8_t next;
+
+	/* Advertising type of the report. */
+	uint8_t adv_type;
+
+	/* Set for scan response data. */
+	bool scan_rsp;
+
+	/* Device address. */
+	bt_addr_le_t addr;
+};
+
+/* Duplicate report filter. */
+struct duplicate_filter {
+	/* Array of the entries. */
+	struct duplicate_entry entry[CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN];
+
+	/* First entry index plus one by hash, 0 for none. */
+	uint8_t bucket[CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN];
+
+	/* Entries in the least recently used order. */
+	sys_dlist_t lru;
+
+	/* Count of the entries in use. */
+	uint8_t count;
+
+	/* Filter statistics. */
+	struct bt_scan_duplicate_filter_stats stats;
+};
+#endif /* CONFIG_BT_SCAN_DUPLICATE_FILTER */
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -266,6 +338,11 @@ static struct bt_scan {
 	struct conn_blocklist blocklist;
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DUPLICATE_FILTER
+	/* Duplicate report filter. */
+	struct duplicate_filter duplicate_filter;
+#endif /* CONFIG_BT_SCAN_DUPLICATE_FILTER */
+
 } bt_scan;
 
 static sys_slist_t callback_list;
@@ -506,22 +583,77 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 }
 #endif /* CONFIG_BT_CENTRAL */
 
-static bool adv_addr_compare(const bt_addr_le_t *target_addr,
-			     struct bt_scan_control *control)
+static uint32_t hash_update(uint32_t hash, const uint8_t *data, size_t len)
 {
-	const bt_addr_le_t *addr =
-			bt_scan.scan_filters.addr.target_addr;
-	uint8_t counter = bt_scan.scan_filters.addr.cnt;
+	/* FNV-1a */
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
 
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
-			control->filter_status.addr.addr = &addr[i];
+	return hash;
+}
 
-			return true;
+static uint32_t hash_bytes(const uint8_t *data, size_t len)
+{
+	return hash_update(2166136261U, data, len);
+}
+
+/* Maps the hash to a slot of the table without a division. */
+static size_t hash_slot(uint32_t hash, size_t size)
+{
+	return ((uint64_t)hash * size) >> 32;
+}
+
+static size_t hash_next(size_t slot, size_t size)
+{
+	return (slot + 1 < size) ? (slot + 1) : 0;
+}
+
+static void hash_insert(uint8_t *table, size_t size, uint32_t hash,
+			uint8_t idx)
+{
+	size_t slot = hash_slot(hash, size);
+
+	while (table[slot]) {
+		slot = hash_next(slot, size);
+	}
+
+	table[slot] = idx + 1;
+}
+
+static int addr_filter_find(const bt_addr_le_t *target_addr)
+{
+	const struct bt_scan_addr_filter *addr_filter =
+			&bt_scan.scan_filters.addr;
+	uint32_t hash = hash_bytes((const uint8_t *)target_addr,
+				   sizeof(*target_addr));
+
+	for (size_t slot = hash_slot(hash, ADDR_HASH_SIZE);
+	     addr_filter->hash[slot];
+	     slot = hash_next(slot, ADDR_HASH_SIZE)) {
+		uint8_t i = addr_filter->hash[slot] - 1;
+
+		if (bt_addr_le_cmp(target_addr, &addr_filter->target_addr[i]) == 0) {
+			return i;
 		}
 	}
 
-	return false;
+	return -ENOENT;
+}
+
+static bool adv_addr_compare(const bt_addr_le_t *target_addr,
+			     struct bt_scan_control *control)
+{
+	int i = addr_filter_find(target_addr);
+
+	if (i < 0) {
+		return false;
+	}
+
+	control->filter_status.addr.addr =
+			&bt_scan.scan_filters.addr.target_addr[i];
+
+	return true;
 }
 
 static bool is_addr_filter_enabled(void)
@@ -534,11 +666,9 @@ static void check_addr(struct bt_scan_control *control,
 {
 	if (is_addr_filter_enabled()) {
 		if (adv_addr_compare(addr, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.addr.match = true;
-			control->filter_match = true;
+			control->filter_matched |= BT_SCAN_ADDR_FILTER;
 		}
 	}
 }
@@ -556,14 +686,15 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	}
 
 	/* Check for duplicated filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr_filter[i]) == 0) {
-			return 0;
-		}
+	if (addr_filter_find(target_addr) >= 0) {
+		return 0;
 	}
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	hash_insert(bt_scan.scan_filters.addr.hash, ADDR_HASH_SIZE,
+		    hash_bytes((const uint8_t *)target_addr, sizeof(*target_addr)),
+		    counter);
 
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
@@ -578,11 +709,165 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	return 0;
 }
 
-static bool adv_name_cmp(const uint8_t *data,
-			 uint8_t data_len,
-			 const char *target_name)
+/* Filters that match the beginning of the advertising data: names and
+ * manufacturer data. The filters are kept sorted by value, so that the ones
+ * that start with the same bytes are next to each other, and matching narrows
+ * down their range one byte at a time, as when walking a trie. A filter is
+ * sorted before the longer filters that it is a prefix of.
+ */
+struct prefix_filters {
+	/* Value and length of the first filter, and the distances to the
+	 * value and length of the next filter.
+	 */
+	const uint8_t *value;
+	size_t value_stride;
+	const uint8_t *len;
+	size_t len_stride;
+
+	/* Filter indexes in sorted order. */
+	uint8_t *order;
+
+	/* Number of filters. */
+	uint8_t cnt;
+};
+
+static const uint8_t *prefix_value(const struct prefix_filters *filters,
+				   uint8_t pos)
+{
+	return &filters->value[filters->order[pos] * filters->value_stride];
+}
+
+static uint8_t prefix_len(const struct prefix_filters *filters, uint8_t pos)
+{
+	return filters->len[filters->order[pos] * filters->len_stride];
+}
+
+/* First position in [lo, hi) of a filter that is longer than depth, with a
+ * byte at depth that is not below c, or above c if upper is set. The filters
+ * in the range start with the same depth bytes.
+ */
+static uint8_t prefix_bound(const struct prefix_filters *filters,
+			    uint8_t lo, uint8_t hi, uint8_t depth,
+			    uint8_t c, bool upper)
+{
+	while (lo < hi) {
+		uint8_t mid = lo + (hi - lo) / 2;
+		bool below = (prefix_len(filters, mid) <= depth) ||
+			     (prefix_value(filters, mid)[depth] < c) ||
+			     (upper && (prefix_value(filters, mid)[depth] == c));
+
+		if (below) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/* Filters in [lo, hi) that are depth bytes long. These are the first ones. */
+static uint32_t prefix_ended(const struct prefix_filters *filters,
+			     uint8_t lo, uint8_t hi, uint8_t depth)
+{
+	uint32_t mask = 0;
+
+	for (; (lo < hi) && (prefix_len(filters, lo) == depth); lo++) {
+		mask |= BIT(filters->order[lo]);
+	}
+
+	return mask;
+}
+
+static uint32_t prefix_range(const struct prefix_filters *filters,
+			     uint8_t lo, uint8_t hi)
+{
+	uint32_t mask = 0;
+
+	for (; lo < hi; lo++) {
+		mask |= BIT(filters->order[lo]);
+	}
+
+	return mask;
+}
+
+/* Narrows [*lo, *hi) down to the filters that start with the data. The filters
+ * shorter than the data, that the data starts with, are added to ended if it
+ * is not NULL. Returns false if no filter starts with the data.
+ */
+static bool prefix_walk(const struct prefix_filters *filters,
+			const uint8_t *data, uint8_t data_len,
+			uint8_t *lo, uint8_t *hi, uint32_t *ended)
 {
-	return strncmp(target_name, data, data_len) == 0;
+	for (uint8_t depth = 0; (depth < data_len) && (*lo < *hi); depth++) {
+		if (ended) {
+			*ended |= prefix_ended(filters, *lo, *hi, depth);
+		}
+
+		*lo = prefix_bound(filters, *lo, *hi, depth, data[depth], false);
+		*hi = prefix_bound(filters, *lo, *hi, depth, data[depth], true);
+	}
+
+	return *lo < *hi;
+}
+
+/* Inserts a new filter at its sorted position. */
+static void prefix_insert(struct prefix_filters *filters, uint8_t idx)
+{
+	const uint8_t *value = &filters->value[idx * filters->value_stride];
+	uint8_t len = filters->len[idx * filters->len_stride];
+	uint8_t pos;
+
+	for (pos = 0; pos < filters->cnt; pos++) {
+		uint8_t pos_len = prefix_len(filters, pos);
+		int cmp = memcmp(prefix_value(filters, pos), value,
+				 MIN(pos_len, len));
+
+		if ((cmp > 0) || ((cmp == 0) && (pos_len > len))) {
+			break;
+		}
+	}
+
+	memmove(&filters->order[pos + 1], &filters->order[pos],
+		filters->cnt - pos);
+	filters->order[pos] = idx;
+	filters->cnt++;
+}
+
+/* Names matched as strncmp(target_name, data, data_len) does: the name in the
+ * data is the start of the target name, or the target name itself if the
+ * data ends with a null character.
+ */
+static uint32_t prefix_name_match(const struct prefix_filters *filters,
+				  const struct bt_data *data)
+{
+	uint8_t name_len = strnlen((const char *)data->data, data->data_len);
+	uint8_t lo = 0;
+	uint8_t hi = filters->cnt;
+
+	if (!prefix_walk(filters, data->data, name_len, &lo, &hi, NULL)) {
+		return 0;
+	}
+
+	if (name_len < data->data_len) {
+		return prefix_ended(filters, lo, hi, name_len);
+	}
+
+	return prefix_range(filters, lo, hi);
+}
+
+static struct prefix_filters name_prefix_filters(void)
+{
+	struct bt_scan_name_filter *name_filter = &bt_scan.scan_filters.name;
+
+	return (struct prefix_filters) {
+		.value = (const uint8_t *)name_filter->target_name,
+		.value_stride = sizeof(name_filter->target_name[0]),
+		.len = name_filter->len,
+		.len_stride = sizeof(name_filter->len[0]),
+		.order = name_filter->order,
+		.cnt = name_filter->cnt,
+	};
 }
 
 static bool adv_name_compare(const struct bt_data *data,
@@ -590,24 +875,21 @@ static bool adv_name_compare(const struct bt_data *data,
 {
 	struct bt_scan_name_filter const *name_filter =
 			&bt_scan.scan_filters.name;
-	uint8_t counter = bt_scan.scan_filters.name.cnt;
-	uint8_t data_len = data->data_len;
+	struct prefix_filters filters = name_prefix_filters();
+	uint32_t match = prefix_name_match(&filters, data);
+	uint8_t i;
 
-	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_name_cmp(data->data,
-				 data_len,
-				 name_filter->target_name[i])) {
+	if (!match) {
+		return false;
+	}
 
-			control->filter_status.name.name =
-				name_filter->target_name[i];
-			control->filter_status.name.len = data_len;
+	/* The first name added is reported. */
+	i = u32_count_trailing_zeros(match);
 
-			return true;
-		}
-	}
+	control->filter_status.name.name = name_filter->target_name[i];
+	control->filter_status.name.len = data->data_len;
 
-	return false;
+	return true;
 }
 
 static inline bool is_name_filter_enabled(void)
@@ -620,17 +902,16 @@ static void name_check(struct bt_scan_control *control,
 {
 	if (is_name_filter_enabled()) {
 		if (adv_name_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.name.match = true;
-			control->filter_match = true;
+			control->filter_matched |= BT_SCAN_NAME_FILTER;
 		}
 	}
 }
 
 static int scan_name_filter_add(const char *name)
 {
+	struct prefix_filters filters = name_prefix_filters();
 	uint8_t counter = bt_scan.scan_filters.name.cnt;
 	size_t name_len;
 
@@ -656,6 +937,8 @@ static int scan_name_filter_add(const char *name)
 	/* Add name to filter. */
 	memcpy(bt_scan.scan_filters.name.target_name[counter],
 	       name, name_len);
+	bt_scan.scan_filters.name.len[counter] = name_len;
+	prefix_insert(&filters, counter);
 
 	bt_scan.scan_filters.name.cnt++;
 
@@ -664,17 +947,19 @@ static int scan_name_filter_add(const char *name)
 	return 0;
 }
 
-static bool adv_short_name_cmp(const uint8_t *data,
-			       uint8_t data_len,
-			       const char *target_name,
-			       uint8_t short_name_min_len)
+static struct prefix_filters short_name_prefix_filters(void)
 {
-	if ((data_len >= short_name_min_len) &&
-	    (strncmp(target_name, data, data_len) == 0)) {
-		return true;
-	}
+	struct bt_scan_short_name_filter *name_filter =
+			&bt_scan.scan_filters.short_name;
 
-	return false;
+	return (struct prefix_filters) {
+		.value = (const uint8_t *)name_filter->name[0].target_name,
+		.value_stride = sizeof(name_filter->name[0]),
+		.len = &name_filter->name[0].len,
+		.len_stride = sizeof(name_filter->name[0]),
+		.order = name_filter->order,
+		.cnt = name_filter->cnt,
+	};
 }
 
 static bool adv_short_name_compare(const struct bt_data *data,
@@ -682,19 +967,17 @@ static bool adv_short_name_compare(const struct bt_data *data,
 {
 	const struct bt_scan_short_name_filter *name_filter =
 			&bt_scan.scan_filters.short_name;
-	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
-	uint8_t data_len = data->data_len;
+	struct prefix_filters filters = short_name_prefix_filters();
+	uint32_t match = prefix_name_match(&filters, data);
 
-	/* Compare the name found with the name filters. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_short_name_cmp(data->data,
-				       data_len,
-				       name_filter->name[i].target_name,
-				       name_filter->name[i].min_len)) {
+	/* The first name added that the advertised name is long enough for. */
+	for (; match; match &= match - 1) {
+		uint8_t i = u32_count_trailing_zeros(match);
 
+		if (data->data_len >= name_filter->name[i].min_len) {
 			control->filter_status.short_name.name =
 				name_filter->name[i].target_name;
-			control->filter_status.short_name.len = data_len;
+			control->filter_status.short_name.len = data->data_len;
 
 			return true;
 		}
@@ -713,11 +996,9 @@ static void short_name_check(struct bt_scan_control *control,
 {
 	if (is_short_name_filter_enabled()) {
 		if (adv_short_name_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.short_name.match = true;
-			control->filter_match = true;
+			control->filter_matched |= BT_SCAN_SHORT_NAME_FILTER;
 		}
 	}
 }
@@ -728,6 +1009,7 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 		bt_scan.scan_filters.short_name.cnt;
 	struct bt_scan_short_name_filter *short_name_filter =
 		    &bt_scan.scan_filters.short_name;
+	struct prefix_filters filters = short_name_prefix_filters();
 	uint8_t name_len;
 
 	/* If no memory for filter. */
@@ -753,9 +1035,11 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 
 	/* Add name to the filter. */
 	short_name_filter->name[counter].min_len = short_name->min_len;
+	short_name_filter->name[counter].len = name_len;
 	memcpy(short_name_filter->name[counter].target_name,
 	       short_name->name,
 	       name_len);
+	prefix_insert(&filters, counter);
 
 	bt_scan.scan_filters.short_name.cnt++;
 
@@ -764,87 +1048,56 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+/* Hash of the UUID in its 128-bit form, so that it is the same for all
+ * encodings of a UUID that bt_uuid_cmp finds equal.
+ */
+static uint32_t uuid_hash(const struct bt_uuid *uuid)
 {
-	uint8_t uuid_len;
+	static const uint8_t base_uuid[] = {
+		BT_UUID_128_ENCODE(0x00000000, 0x0000, 0x1000, 0x8000, 0x00805F9B34FB)
+	};
+	const uint8_t *val_128;
+	uint8_t val[sizeof(uint32_t)];
 
-	switch (uuid_type) {
+	switch (uuid->type) {
 	case BT_UUID_TYPE_16:
-		uuid_len = sizeof(uint16_t);
+		sys_put_le32(BT_UUID_16(uuid)->val, val);
 		break;
 
 	case BT_UUID_TYPE_32:
-		uuid_len = sizeof(uint32_t);
-		break;
-
-	case BT_UUID_TYPE_128:
-		uuid_len = BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
+		sys_put_le32(BT_UUID_32(uuid)->val, val);
 		break;
 
 	default:
-		return false;
-	}
-
-	for (size_t i = 0; i < data_len; i += uuid_len) {
-		struct bt_uuid_128 uuid;
-
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
-			return false;
+		/* The 16-bit and 32-bit UUIDs are the last bytes of the base UUID. */
+		val_128 = BT_UUID_128(uuid)->val;
+		if (memcmp(val_128, base_uuid, sizeof(base_uuid) - sizeof(val))) {
+			return hash_bytes(val_128, sizeof(base_uuid));
 		}
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
-		}
+		memcpy(val, &val_128[sizeof(base_uuid) - sizeof(val)], sizeof(val));
+		break;
 	}
 
-	return false;
+	return hash_bytes(val, sizeof(val));
 }
 
-static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
-			     struct bt_scan_control *control)
+static int uuid_filter_find(const struct bt_uuid *uuid)
 {
 	const struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
-	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
-	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
-
-	for (size_t i = 0; i < counter; i++) {
-
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
-			control->filter_status.uuid.uuid[uuid_match_cnt] =
-				uuid_filter->uuid[i].uuid;
 
-			uuid_match_cnt++;
+	for (size_t slot = hash_slot(uuid_hash(uuid), UUID_HASH_SIZE);
+	     uuid_filter->hash[slot];
+	     slot = hash_next(slot, UUID_HASH_SIZE)) {
+		uint8_t i = uuid_filter->hash[slot] - 1;
 
-			/* In the normal filter mode,
-			 * only one UUID is needed to match.
-			 */
-			if (!all_filters_mode) {
-				break;
-			}
-
-		} else if (all_filters_mode) {
-			break;
+		if (bt_uuid_cmp(uuid, uuid_filter->uuid[i].uuid) == 0) {
+			return i;
 		}
 	}
 
-	control->filter_status.uuid.count = uuid_match_cnt;
-
-	/* In the multifilter mode, all UUIDs must be found in
-	 * the advertisement packets.
-	 */
-	if ((all_filters_mode && (uuid_match_cnt == counter)) ||
-	    ((!all_filters_mode) && (uuid_match_cnt > 0))) {
-		return true;
-	}
-
-	return false;
+	return -ENOENT;
 }
 
 static bool is_uuid_filter_enabled(void)
@@ -854,19 +1107,64 @@ static bool is_uuid_filter_enabled(void)
 
 static void uuid_check(struct bt_scan_control *control,
 		       const struct bt_data *data,
-		       uint8_t type)
+		       uint8_t uuid_len)
 {
-	if (is_uuid_filter_enabled()) {
-		if (adv_uuid_compare(data, type, control)) {
-			control->filter_match_cnt++;
+	if (!is_uuid_filter_enabled()) {
+		return;
+	}
 
-			/* Information about the filters matched. */
-			control->filter_status.uuid.match = true;
-			control->filter_match = true;
+	for (size_t i = 0; i + uuid_len <= data->data_len; i += uuid_len) {
+		struct bt_uuid_128 uuid;
+		int idx;
+
+		if (!bt_uuid_create(&uuid.uuid, &data->data[i], uuid_len)) {
+			return;
+		}
+
+		idx = uuid_filter_find(&uuid.uuid);
+		if (idx >= 0) {
+			control->uuid_found |= BIT(idx);
 		}
 	}
 }
 
+/* Called when all UUIDs of the advertising data are found. */
+static void uuid_match_check(struct bt_scan_control *control)
+{
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	struct bt_scan_uuid_filter_status *status =
+			&control->filter_status.uuid;
+	uint32_t found = control->uuid_found;
+
+	if (!found) {
+		return;
+	}
+
+	if (control->all_mode) {
+		/* In the multifilter mode, all UUIDs must be found in
+		 * the advertisement packets.
+		 */
+		if (found != (uint32_t)BIT64_MASK(uuid_filter->cnt)) {
+			return;
+		}
+	} else {
+		/* In the normal filter mode, only one UUID is needed
+		 * to match. The first UUID added is reported.
+		 */
+		found &= ~(found - 1);
+	}
+
+	for (; found; found &= found - 1) {
+		status->uuid[status->count++] =
+			uuid_filter->uuid[u32_count_trailing_zeros(found)].uuid;
+	}
+
+	/* Information about the filters matched. */
+	status->match = true;
+	control->filter_matched |= BT_SCAN_UUID_FILTER;
+}
+
 static int scan_uuid_filter_add(struct bt_uuid *uuid)
 {
 	struct bt_scan_uuid *uuid_filter = bt_scan.scan_filters.uuid.uuid;
@@ -881,10 +1179,8 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 	}
 
 	/* Check for duplicated filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_uuid_cmp(uuid_filter[i].uuid, uuid) == 0) {
-			return 0;
-		}
+	if (uuid_filter_find(uuid) >= 0) {
+		return 0;
 	}
 
 	/* Add UUID to the filter. */
@@ -917,6 +1213,9 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		return -EINVAL;
 	}
 
+	hash_insert(bt_scan.scan_filters.uuid.hash, UUID_HASH_SIZE,
+		    uuid_hash(uuid), counter);
+
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -978,11 +1277,9 @@ static void appearance_check(struct bt_scan_control *control,
 {
 	if (is_appearance_filter_enabled()) {
 		if (adv_appearance_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.appearance.match = true;
-			control->filter_match = true;
+			control->filter_matched |= BT_SCAN_APPEARANCE_FILTER;
 		}
 	}
 }
@@ -1029,31 +1326,52 @@ static bool adv_manufacturer_data_cmp(const uint8_t *data,
 	return true;
 }
 
+static struct prefix_filters manufacturer_data_prefix_filters(void)
+{
+	struct bt_scan_manufacturer_data_filter *md_filter =
+		&bt_scan.scan_filters.manufacturer_data;
+
+	return (struct prefix_filters) {
+		.value = md_filter->manufacturer_data[0].data,
+		.value_stride = sizeof(md_filter->manufacturer_data[0]),
+		.len = &md_filter->manufacturer_data[0].data_len,
+		.len_stride = sizeof(md_filter->manufacturer_data[0]),
+		.order = md_filter->order,
+		.cnt = md_filter->cnt,
+	};
+}
+
 static bool adv_manufacturer_data_compare(const struct bt_data *data,
 					  struct bt_scan_control *control)
 {
 	const struct bt_scan_manufacturer_data_filter *md_filter =
 		&bt_scan.scan_filters.manufacturer_data;
-	uint8_t counter = bt_scan.scan_filters.manufacturer_data.cnt;
-
-	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_manufacturer_data_cmp(data->data,
-				data->data_len,
-				md_filter->manufacturer_data[i].data,
-				md_filter->manufacturer_data[i].data_len)) {
+	struct prefix_filters filters = manufacturer_data_prefix_filters();
+	uint32_t match = 0;
+	uint8_t lo = 0;
+	uint8_t hi = filters.cnt;
+	uint8_t i;
 
-			control->filter_status.manufacturer_data.data =
-				md_filter->manufacturer_data[i].data;
-			control->filter_status.manufacturer_data.len =
-				md_filter->manufacturer_data[i].data_len;
+	/* All filters that the data starts with. */
+	if (prefix_walk(&filters, data->data, data->data_len, &lo, &hi, &match)) {
+		match |= prefix_ended(&filters, lo, hi, data->data_len);
+	}
 
-			return true;
-		}
+	if (!match) {
+		return false;
 	}
 
-	return false;
+	/* The first manufacturer data added is reported. */
+	i = u32_count_trailing_zeros(match);
+
+	control->filter_status.manufacturer_data.data =
+		md_filter->manufacturer_data[i].data;
+	control->filter_status.manufacturer_data.len =
+		md_filter->manufacturer_data[i].data_len;
+
+	return true;
 }
+
 static inline bool is_manufacturer_data_filter_enabled(void)
 {
 	return CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT &&
@@ -1065,11 +1383,9 @@ static void manufacturer_data_check(struct bt_scan_control *control,
 {
 	if (is_manufacturer_data_filter_enabled()) {
 		if (adv_manufacturer_data_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.manufacturer_data.match = true;
-			control->filter_match = true;
+			control->filter_matched |= BT_SCAN_MANUFACTURER_DATA_FILTER;
 		}
 	}
 }
@@ -1078,6 +1394,7 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 {
 	struct bt_scan_manufacturer_data_filter *md_filter =
 		&bt_scan.scan_filters.manufacturer_data;
+	struct prefix_filters filters = manufacturer_data_prefix_filters();
 	uint8_t counter = bt_scan.scan_filters.manufacturer_data.cnt;
 
 	/* If no memory for filter. */
@@ -1107,6 +1424,7 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 			manufacturer_data->data, manufacturer_data->data_len);
 	md_filter->manufacturer_data[counter].data_len =
 		manufacturer_data->data_len;
+	prefix_insert(&filters, counter);
 
 	bt_scan.scan_filters.manufacturer_data.cnt++;
 
@@ -1229,10 +1547,12 @@ void bt_scan_filter_remove_all(void)
 	struct bt_scan_addr_filter *addr_filter =
 			&bt_scan.scan_filters.addr;
 	addr_filter->cnt = 0;
+	memset(addr_filter->hash, 0, sizeof(addr_filter->hash));
 
 	struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
 	uuid_filter->cnt = 0;
+	memset(uuid_filter->hash, 0, sizeof(uuid_filter->hash));
 
 	struct bt_scan_appearance_filter *appearance_filter =
 			&bt_scan.scan_filters.appearance;
@@ -1372,6 +1692,10 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 	bt_conn_cb_register(&conn_callbacks);
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DUPLICATE_FILTER
+	bt_scan_duplicate_filter_clear();
+#endif /* CONFIG_BT_SCAN_DUPLICATE_FILTER */
 }
 
 void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
@@ -1381,30 +1705,30 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 
 static void check_enabled_filters(struct bt_scan_control *control)
 {
-	control->filter_cnt = 0;
+	control->filter_enabled = 0;
 
 	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
+		control->filter_enabled |= BT_SCAN_ADDR_FILTER;
 	}
 
 	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
+		control->filter_enabled |= BT_SCAN_NAME_FILTER;
 	}
 
 	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
+		control->filter_enabled |= BT_SCAN_SHORT_NAME_FILTER;
 	}
 
 	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
+		control->filter_enabled |= BT_SCAN_UUID_FILTER;
 	}
 
 	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
+		control->filter_enabled |= BT_SCAN_APPEARANCE_FILTER;
 	}
 
 	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
+		control->filter_enabled |= BT_SCAN_MANUFACTURER_DATA_FILTER;
 	}
 }
 
@@ -1432,18 +1756,18 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 	case BT_DATA_UUID16_SOME:
 	case BT_DATA_UUID16_ALL:
 		/* Check the UUID filter. */
-		uuid_check(scan_control, data, BT_UUID_TYPE_16);
+		uuid_check(scan_control, data, BT_UUID_SIZE_16);
 		break;
 
 	case BT_DATA_UUID32_SOME:
 	case BT_DATA_UUID32_ALL:
-		uuid_check(scan_control, data, BT_UUID_TYPE_32);
+		uuid_check(scan_control, data, BT_UUID_SIZE_32);
 		break;
 
 	case BT_DATA_UUID128_SOME:
 	case BT_DATA_UUID128_ALL:
 		/* Check the UUID filter. */
-		uuid_check(scan_control, data, BT_UUID_TYPE_128);
+		uuid_check(scan_control, data, BT_UUID_SIZE_128);
 		break;
 
 	case BT_DATA_MANUFACTURER_DATA:
@@ -1461,12 +1785,8 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 static void filter_state_check(struct bt_scan_control *control,
 			       const bt_addr_le_t *addr)
 {
-	if (!scan_device_filter_check(addr)) {
-		return;
-	}
-
 	if (control->all_mode &&
-	    (control->filter_match_cnt == control->filter_cnt)) {
+	    (control->filter_matched == control->filter_enabled)) {
 		notify_filter_matched(&control->device_info,
 				      &control->filter_status,
 				      control->connectable);
@@ -1478,7 +1798,7 @@ static void filter_state_check(struct bt_scan_control *control,
 	/* In the normal filter mode, only one filter match is
 	 * needed to generate the notification to the main application.
 	 */
-	else if ((!control->all_mode) && control->filter_match) {
+	else if ((!control->all_mode) && control->filter_matched) {
 		notify_filter_matched(&control->device_info,
 				      &control->filter_status,
 				      control->connectable);
@@ -1491,12 +1811,109 @@ static void filter_state_check(struct bt_scan_control *control,
 	}
 }
 
+#if CONFIG_BT_SCAN_DUPLICATE_FILTER
+static void duplicate_entry_unlink(struct duplicate_filter *filter,
+				   struct duplicate_entry *entry)
+{
+	uint8_t idx = (entry - filter->entry) + 1;
+	uint8_t *link = &filter->bucket[hash_slot(entry->hash,
+						  ARRAY_SIZE(filter->bucket))];
+
+	while (*link != idx) {
+		link = &filter->entry[*link - 1].next;
+	}
+
+	*link = entry->next;
+	sys_dlist_remove(&entry->node);
+}
+
+/* Checks if the last report of the same device and type that was passed on
+ * had the same advertising data, within the window. Remembers the report
+ * otherwise.
+ */
+static bool duplicate_report_check(const struct bt_le_scan_recv_info *info,
+				   const struct net_buf_simple *ad)
+{
+	struct duplicate_filter *filter = &bt_scan.duplicate_filter;
+	const bt_addr_le_t *addr = info->addr;
+	bool scan_rsp = (info->adv_props & BT_GAP_ADV_PROP_SCAN_RESPONSE) != 0;
+	uint8_t type[] = { info->adv_type, scan_rsp };
+	uint32_t hash = hash_update(hash_bytes((const uint8_t *)addr, sizeof(*addr)),
+				    type, sizeof(type));
+	uint32_t data_hash = hash_bytes(ad->data, ad->len);
+	uint8_t *bucket = &filter->bucket[hash_slot(hash, ARRAY_SIZE(filter->bucket))];
+	uint32_t now = k_uptime_get_32();
+	struct duplicate_entry *entry = NULL;
+	bool duplicate = false;
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	for (uint8_t idx = *bucket; idx; idx = filter->entry[idx - 1].next) {
+		struct duplicate_entry *e = &filter->entry[idx - 1];
+
+		if ((e->hash == hash) && (e->adv_type == info->adv_type) &&
+		    (e->scan_rsp == scan_rsp) && (bt_addr_le_cmp(&e->addr, addr) == 0)) {
+			entry = e;
+			break;
+		}
+	}
+
+	if (entry) {
+		duplicate = (entry->data_hash == data_hash) &&
+			    ((now - entry->time) < CONFIG_BT_SCAN_DUPLICATE_FILTER_WINDOW);
+		sys_dlist_remove(&entry->node);
+	} else {
+		if (filter->count < ARRAY_SIZE(filter->entry)) {
+			entry = &filter->entry[filter->count++];
+		} else {
+			/* Forget the least recently received device. */
+			entry = CONTAINER_OF(sys_dlist_peek_head(&filter->lru),
+					     struct duplicate_entry, node);
+			duplicate_entry_unlink(filter, entry);
+		}
+
+		entry->hash = hash;
+		entry->adv_type = info->adv_type;
+		entry->scan_rsp = scan_rsp;
+		bt_addr_le_copy(&entry->addr, addr);
+		entry->next = *bucket;
+		*bucket = (entry - filter->entry) + 1;
+	}
+
+	sys_dlist_append(&filter->lru, &entry->node);
+
+	if (duplicate) {
+		filter->stats.hits++;
+	} else {
+		entry->data_hash = data_hash;
+		entry->time = now;
+		filter->stats.misses++;
+	}
+
+	k_mutex_unlock(&scan_mutex);
+
+	return duplicate;
+}
+#endif /* CONFIG_BT_SCAN_DUPLICATE_FILTER */
+
 static void scan_recv(const struct bt_le_scan_recv_info *info,
 		      struct net_buf_simple *ad)
 {
 	struct bt_scan_control scan_control;
 	struct net_buf_simple_state state;
 
+	/* No events are generated for the filtered devices. */
+	if (!scan_device_filter_check(info->addr)) {
+		return;
+	}
+
+#if CONFIG_BT_SCAN_DUPLICATE_FILTER
+	/* Nor for the repeated reports. */
+	if (duplicate_report_check(info, ad)) {
+		return;
+	}
+#endif /* CONFIG_BT_SCAN_DUPLICATE_FILTER */
+
 	memset(&scan_control, 0, sizeof(scan_control));
 
 	scan_control.all_mode = bt_scan.scan_filters.all_mode;
@@ -1510,12 +1927,17 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	/* Check the address filter. */
 	check_addr(&scan_control, info->addr);
 
-	/* Save advertising buffer state to transfer it
-	 * data to application if futher processing is needed.
-	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	/* The advertising data is only parsed for the filters that need it. */
+	if (scan_control.filter_enabled & ~BT_SCAN_ADDR_FILTER) {
+		/* Save advertising buffer state to transfer it
+		 * data to application if futher processing is needed.
+		 */
+		net_buf_simple_save(ad, &state);
+		bt_data_parse(ad, adv_data_found, (void *)&scan_control);
+		net_buf_simple_restore(ad, &state);
+
+		uuid_match_check(&scan_control);
+	}
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
@@ -1630,3 +2052,26 @@ void bt_scan_conn_attempts_filter_clear(void)
 	k_mutex_unlock(&scan_mutex);
 }
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DUPLICATE_FILTER
+int bt_scan_duplicate_filter_stats_get(struct bt_scan_duplicate_filter_stats *stats)
+{
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	*stats = bt_scan.duplicate_filter.stats;
+	k_mutex_unlock(&scan_mutex);
+
+	return 0;
+}
+
+void bt_scan_duplicate_filter_clear(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	memset(&bt_scan.duplicate_filter, 0, sizeof(bt_scan.duplicate_filter));
+	sys_dlist_init(&bt_scan.duplicate_filter.lru);
+	k_mutex_unlock(&scan_mutex);
+}
+#endif /* CONFIG_BT_SCAN_DUPLICATE_FILTER */
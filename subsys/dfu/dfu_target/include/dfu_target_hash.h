@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file dfu_target_hash.h
+ *
+ * @brief Incremental SHA-256 of the image written to a DFU target.
+ *
+ * DFU targets feed the hash with the data they write, and persist the hash
+ * state together with their write progress so that an interrupted update
+ * can be resumed without hashing the image prefix again.
+ */
+
+#ifndef DFU_TARGET_HASH_H__
+#define DFU_TARGET_HASH_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function to read back data written to the DFU target.
+ *
+ * @param[in]  offset Offset within the image.
+ * @param[out] buf    Buffer for the data.
+ * @param[in]  len    Number of bytes to read.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+typedef int (*dfu_target_hash_read_t)(size_t offset, void *buf, size_t len);
+
+/**
+ * @brief Start hashing a new image.
+ */
+void dfu_target_hash_start(void);
+
+/**
+ * @brief Hash data written to the DFU target.
+ *
+ * @param[in] buf Data written.
+ * @param[in] len Length of data.
+ */
+void dfu_target_hash_update(const void *buf, size_t len);
+
+/**
+ * @brief Invalidate the hash, for instance when a write fails half-way.
+ *
+ * The image is not verified until a new image is started.
+ */
+void dfu_target_hash_invalidate(void);
+
+/**
+ * @brief Persist the hash state.
+ *
+ * Call this at the same point as the write progress is stored, so that the
+ * state covers the bytes the target resumes from.
+ *
+ * @param[in] key Settings key to store the state under, or NULL.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_hash_save(const char *key);
+
+/**
+ * @brief Resume the hash of an image resumed from @p offset.
+ *
+ * Starts a new image if @p offset is zero. Otherwise, the hash continues
+ * from the state in RAM or from the state saved under @p key, if either
+ * covers exactly @p offset bytes. If neither does, the first @p offset bytes
+ * are read back with @p read and hashed again. The hash is invalidated if
+ * that is not possible either.
+ *
+ * @param[in] key    Settings key the state was stored under, or NULL.
+ * @param[in] offset Number of bytes already written to the DFU target.
+ * @param[in] read   Function to read back the image, or NULL.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_hash_resume(const char *key, size_t offset, dfu_target_hash_read_t read);
+
+/**
+ * @brief Delete the persisted hash state.
+ *
+ * @param[in] key Settings key the state was stored under, or NULL.
+ */
+void dfu_target_hash_delete(const char *key);
+
+/**
+ * @brief Verify the image against the expected hash, if one was set.
+ *
+ * @param[in] name Image type, for logging.
+ *
+ * @retval 0 if the hash matches, or if no expected hash was set.
+ * @retval -EBADMSG if the hash does not match.
+ * @retval -EACCES if an expected hash was set, but the hash of the image
+ *	   is not available.
+ */
+int dfu_target_hash_verify(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DFU_TARGET_HASH_H__ */
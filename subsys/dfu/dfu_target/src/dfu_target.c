@@ -8,6 +8,10 @@
 #include <zephyr/dfu/mcuboot.h>
 #include <dfu/dfu_target.h>
 
+#ifdef CONFIG_DFU_TARGET_HASH
+#include "dfu_target_hash.h"
+#endif
+
 #define DEF_DFU_TARGET(name) \
 static const struct dfu_target dfu_target_ ## name  = { \
 	.init = dfu_target_ ## name ## _init, \
@@ -16,6 +20,7 @@ static const struct dfu_target dfu_target_ ## name  = { \
 	.done = dfu_target_ ## name ## _done, \
 	.schedule_update = dfu_target_ ## name ## _schedule_update, \
 	.reset = dfu_target_ ## name ## _reset, \
+	.read = dfu_target_ ## name ## _read, \
 }
 
 #ifdef CONFIG_DFU_TARGET_MODEM_DELTA
@@ -37,6 +42,7 @@ LOG_MODULE_REGISTER(dfu_target, CONFIG_DFU_TARGET_LOG_LEVEL);
 
 static const struct dfu_target *current_target;
 static int current_img_num = -1;
+static int current_img_type;
 
 enum dfu_target_image_type dfu_target_img_type(const void *const buf, size_t len)
 {
@@ -101,6 +107,7 @@ int dfu_target_init(int img_type, int img_num, size_t file_size, dfu_target_call
 
 	current_target = new_target;
 	current_img_num = img_num;
+	current_img_type = img_type;
 
 	return current_target->init(file_size, img_num, cb);
 }
@@ -123,6 +130,15 @@ int dfu_target_write(const void *const buf, size_t len)
 	return current_target->write(buf, len);
 }
 
+int dfu_target_read(size_t offset, void *buf, size_t len)
+{
+	if (current_target == NULL || buf == NULL) {
+		return -EACCES;
+	}
+
+	return current_target->read(offset, buf, len);
+}
+
 int dfu_target_done(bool successful)
 {
 	int err;
@@ -137,6 +153,18 @@ int dfu_target_done(bool successful)
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	if (successful) {
+		err = dfu_target_hash_verify(
+			current_img_type == DFU_TARGET_IMAGE_TYPE_MCUBOOT ? "MCUboot" :
+			current_img_type == DFU_TARGET_IMAGE_TYPE_MODEM_DELTA ? "Modem delta" :
+			"Full modem");
+		if (err != 0) {
+			return err;
+		}
+	}
+#endif
+
 	return 0;
 }
 
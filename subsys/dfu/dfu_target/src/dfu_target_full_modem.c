@@ -145,6 +145,15 @@ int dfu_target_full_modem_schedule_update(int img_num)
 	return 0;
 }
 
+int dfu_target_full_modem_read(size_t offset, void *buf, size_t len)
+{
+	if (!configured) {
+		return -EPERM;
+	}
+
+	return dfu_target_stream_read(offset, buf, len);
+}
+
 int dfu_target_full_modem_reset(void)
 {
 	if (!configured) {
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <mbedtls/sha256.h>
+#include <dfu/dfu_target.h>
+
+#include "dfu_target_hash.h"
+
+#ifdef CONFIG_SETTINGS
+#include <zephyr/settings/settings.h>
+#endif
+
+LOG_MODULE_REGISTER(dfu_target_hash, CONFIG_DFU_TARGET_LOG_LEVEL);
+
+#define SHA256_LEN 32
+
+/* Size of the chunks read back when hashing the prefix of a resumed image */
+#define PREFIX_CHUNK_LEN 128
+
+/* Hash state, persisted along with the write progress of the target */
+struct hash_state {
+	/* Number of bytes hashed */
+	size_t offset;
+	mbedtls_sha256_context ctx;
+};
+
+static struct hash_state state;
+static bool state_valid;
+static uint8_t expected_hash[SHA256_LEN];
+static bool expected_hash_set;
+/* Time spent hashing in this boot, in cycles */
+static uint32_t hash_cycles;
+
+void dfu_target_hash_start(void)
+{
+	mbedtls_sha256_init(&state.ctx);
+	state_valid = (mbedtls_sha256_starts(&state.ctx, false) == 0);
+	state.offset = 0;
+	hash_cycles = 0;
+}
+
+void dfu_target_hash_update(const void *buf, size_t len)
+{
+	uint32_t start = k_cycle_get_32();
+
+	if (!state_valid || len == 0) {
+		return;
+	}
+
+	if (mbedtls_sha256_update(&state.ctx, buf, len) != 0) {
+		LOG_ERR("Failed to hash image");
+		state_valid = false;
+		return;
+	}
+
+	state.offset += len;
+	hash_cycles += k_cycle_get_32() - start;
+}
+
+void dfu_target_hash_invalidate(void)
+{
+	state_valid = false;
+}
+
+int dfu_target_hash_save(const char *key)
+{
+#ifdef CONFIG_SETTINGS
+	int err;
+
+	if (key == NULL || !state_valid) {
+		return 0;
+	}
+
+	err = settings_save_one(key, &state, sizeof(state));
+	if (err) {
+		LOG_WRN("Unable to store hash state (err %d)", err);
+		return err;
+	}
+#endif
+	return 0;
+}
+
+#ifdef CONFIG_SETTINGS
+static int state_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			 void *cb_arg, void *param)
+{
+	ssize_t rc;
+
+	/* A state saved with a different SHA-256 context layout is not used */
+	if (len != sizeof(struct hash_state)) {
+		return -EINVAL;
+	}
+
+	rc = read_cb(cb_arg, param, len);
+
+	return rc == len ? 0 : -EIO;
+}
+#endif
+
+static bool state_load(const char *key, size_t offset)
+{
+#ifdef CONFIG_SETTINGS
+	struct hash_state saved = { 0 };
+
+	if (key != NULL) {
+		if (settings_load_subtree_direct(key, state_load_cb, &saved) != 0 ||
+		    saved.offset != offset) {
+			return false;
+		}
+
+		state = saved;
+		state_valid = true;
+		hash_cycles = 0;
+		return true;
+	}
+#endif
+	/* Without a stored state, only an update resumed in the same boot
+	 * can continue the state in RAM.
+	 */
+	return state_valid && state.offset == offset;
+}
+
+int dfu_target_hash_resume(const char *key, size_t offset, dfu_target_hash_read_t read)
+{
+	uint8_t buf[PREFIX_CHUNK_LEN];
+	size_t pos;
+	size_t len;
+	int err;
+
+	if (offset == 0) {
+		dfu_target_hash_start();
+		return 0;
+	}
+
+	if (state_load(key, offset)) {
+		return 0;
+	}
+
+	if (read == NULL) {
+		LOG_WRN("No hash state at offset %zu, the image will not be verified", offset);
+		state_valid = false;
+		return -ENOENT;
+	}
+
+	/* The saved state does not match the progress, for instance because
+	 * the device was reset between storing the two. Hash the prefix again.
+	 */
+	dfu_target_hash_start();
+
+	for (pos = 0; pos < offset; pos += len) {
+		len = MIN(sizeof(buf), offset - pos);
+
+		err = read(pos, buf, len);
+		if (err) {
+			LOG_WRN("Unable to read image prefix (err %d), "
+				"the image will not be verified", err);
+			state_valid = false;
+			return err;
+		}
+
+		dfu_target_hash_update(buf, len);
+	}
+
+	return 0;
+}
+
+void dfu_target_hash_delete(const char *key)
+{
+#ifdef CONFIG_SETTINGS
+	if (key != NULL) {
+		(void)settings_delete(key);
+	}
+#endif
+}
+
+int dfu_target_hash_get(uint8_t *hash, size_t len)
+{
+	int err;
+	mbedtls_sha256_context ctx;
+
+	if (hash == NULL || len < SHA256_LEN) {
+		return -EINVAL;
+	}
+
+	if (!state_valid) {
+		return -ENODATA;
+	}
+
+	/* Finish a copy, so that the hash can be read at any point */
+	mbedtls_sha256_init(&ctx);
+	mbedtls_sha256_clone(&ctx, &state.ctx);
+	err = mbedtls_sha256_finish(&ctx, hash);
+	mbedtls_sha256_free(&ctx);
+
+	return err ? -EFAULT : 0;
+}
+
+int dfu_target_hash_set(const uint8_t *hash, size_t len)
+{
+	if (hash == NULL) {
+		expected_hash_set = false;
+		return 0;
+	}
+
+	if (len != SHA256_LEN) {
+		return -EINVAL;
+	}
+
+	memcpy(expected_hash, hash, SHA256_LEN);
+	expected_hash_set = true;
+
+	return 0;
+}
+
+int dfu_target_hash_verify(const char *name)
+{
+	int err;
+	uint8_t hash[SHA256_LEN];
+
+	err = dfu_target_hash_get(hash, sizeof(hash));
+	if (err) {
+		if (expected_hash_set) {
+			LOG_ERR("%s image hash not available, cannot verify the image", name);
+			expected_hash_set = false;
+			return -EACCES;
+		}
+		return 0;
+	}
+
+	/* The image was hashed while it was written, instead of being read
+	 * back from flash once complete.
+	 */
+	LOG_INF("%s image: %zu bytes hashed while written, %u us in this boot",
+		name, state.offset, k_cyc_to_us_floor32(hash_cycles));
+
+	if (!expected_hash_set) {
+		return 0;
+	}
+
+	expected_hash_set = false;
+
+	if (memcmp(hash, expected_hash, sizeof(hash)) != 0) {
+		LOG_ERR("%s image hash mismatch", name);
+		return -EBADMSG;
+	}
+
+	LOG_INF("%s image hash verified", name);
+
+	return 0;
+}
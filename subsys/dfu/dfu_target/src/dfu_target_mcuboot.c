@@ -231,6 +231,11 @@ int dfu_target_mcuboot_schedule_update(int img_num)
 	return err;
 }
 
+int dfu_target_mcuboot_read(size_t offset, void *buf, size_t len)
+{
+	return dfu_target_stream_read(offset, buf, len);
+}
+
 int dfu_target_mcuboot_reset(void)
 {
 	stream_buf_bytes = 0;
@@ -12,6 +12,16 @@
 #include <zephyr/logging/log.h>
 #include <dfu/dfu_target.h>
 
+#ifdef CONFIG_DFU_TARGET_HASH
+#include "dfu_target_hash.h"
+#ifdef CONFIG_SETTINGS
+#include <zephyr/settings/settings.h>
+#define HASH_KEY "dfu/modem_delta/sha256"
+#else
+#define HASH_KEY NULL
+#endif
+#endif /* CONFIG_DFU_TARGET_HASH */
+
 LOG_MODULE_REGISTER(dfu_target_modem_delta, CONFIG_DFU_TARGET_LOG_LEVEL);
 
 #define MODEM_MAGIC 0x7544656d
@@ -58,6 +68,10 @@ static int delete_banked_modem_delta_fw(void)
 		}
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	dfu_target_hash_start();
+#endif
+
 	return 0;
 }
 
@@ -114,6 +128,20 @@ int dfu_target_modem_delta_init(size_t file_size, int img_num, dfu_target_callba
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+#ifdef CONFIG_SETTINGS
+	/* settings_subsys_init is idempotent so this is safe to do. */
+	err = settings_subsys_init();
+	if (err) {
+		LOG_WRN("settings_subsys_init failed (err %d)", err);
+	}
+#endif
+	/* The modem keeps the write progress, and the image cannot be read back.
+	 * Continue the hash saved when the update was interrupted.
+	 */
+	(void)dfu_target_hash_resume(HASH_KEY, offset, NULL);
+#endif
+
 	return 0;
 }
 
@@ -151,6 +179,7 @@ int dfu_target_modem_delta_write(const void *const buf, size_t len)
 			return -EINVAL;
 		case NRF_MODEM_DELTA_DFU_INVALID_FILE_OFFSET:
 		case NRF_MODEM_DELTA_DFU_AREA_NOT_BLANK:
+			/* Restarts the hash, the image is written from scratch */
 			delete_banked_modem_delta_fw();
 			err = dfu_target_modem_delta_write(buf, len);
 			if (err != 0) {
@@ -163,6 +192,10 @@ int dfu_target_modem_delta_write(const void *const buf, size_t len)
 		}
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	dfu_target_hash_update(buf, len);
+#endif
+
 	return 0;
 }
 
@@ -170,14 +203,25 @@ int dfu_target_modem_delta_done(bool successful)
 {
 	int err;
 
-	ARG_UNUSED(successful);
-
 	err = nrf_modem_delta_dfu_write_done();
 	if (err != 0) {
 		LOG_ERR("Failed to stop MFU and release resources, error %d", err);
 		return -EFAULT;
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	/* The modem stores its progress on every write. The hash state is only
+	 * stored when the update is interrupted, to spare the flash.
+	 */
+	if (successful) {
+		dfu_target_hash_delete(HASH_KEY);
+	} else {
+		(void)dfu_target_hash_save(HASH_KEY);
+	}
+#else
+	ARG_UNUSED(successful);
+#endif
+
 	return 0;
 }
 
@@ -198,7 +242,20 @@ int dfu_target_modem_delta_schedule_update(int img_num)
 	return err;
 }
 
+int dfu_target_modem_delta_read(size_t offset, void *buf, size_t len)
+{
+	ARG_UNUSED(offset);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(len);
+
+	return -ENOTSUP;
+}
+
 int dfu_target_modem_delta_reset(void)
 {
+#ifdef CONFIG_DFU_TARGET_HASH
+	dfu_target_hash_start();
+	dfu_target_hash_delete(HASH_KEY);
+#endif
 	return nrf_modem_delta_dfu_erase();
 }
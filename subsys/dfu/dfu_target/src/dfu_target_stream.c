@@ -16,6 +16,11 @@
 #include <zephyr/settings/settings.h>
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_TARGET_HASH
+#include "dfu_target_hash.h"
+#define DFU_STREAM_HASH "sha256"
+#endif /* CONFIG_DFU_TARGET_HASH */
+
 LOG_MODULE_REGISTER(dfu_target_stream, CONFIG_DFU_TARGET_LOG_LEVEL);
 
 static struct stream_flash_ctx stream;
@@ -25,6 +30,11 @@ static const char *current_id;
 
 static char current_name_key[32];
 
+#ifdef CONFIG_DFU_TARGET_HASH
+static char current_hash_key[40];
+#define HASH_KEY current_hash_key
+#endif
+
 /**
  * @brief Store the information stored in the stream_flash instance so that it
  *        can be restored from flash in case of a power failure, reboot etc.
@@ -42,6 +52,11 @@ static int store_progress(void)
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	/* The hash covers exactly the bytes written to flash */
+	(void)dfu_target_hash_save(HASH_KEY);
+#endif
+
 	return 0;
 }
 
@@ -91,6 +106,50 @@ static int settings_set(const char *key, size_t len_rd,
 }
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_TARGET_HASH
+#ifndef HASH_KEY
+#define HASH_KEY NULL
+#endif
+
+/**
+ * @brief Write to the stream, hashing data as it is flushed to flash.
+ *
+ * Data is hashed as each buffer is flushed, so that the hash state always
+ * covers the bytes written to flash, which is the progress that is stored.
+ */
+static int hashed_write(const uint8_t *buf, size_t len)
+{
+	int err;
+	size_t chunk;
+
+	while (len > 0) {
+		chunk = MIN(len, stream.buf_len - stream.buf_bytes);
+
+		if (chunk == stream.buf_len - stream.buf_bytes) {
+			/* This chunk fills the buffer, which is then flushed */
+			dfu_target_hash_update(stream.buf, stream.buf_bytes);
+			dfu_target_hash_update(buf, chunk);
+		}
+
+		err = stream_flash_buffered_write(&stream, buf, chunk, false);
+		if (err != 0) {
+			dfu_target_hash_invalidate();
+			return err;
+		}
+
+		buf += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+static int hash_prefix_read(size_t offset, void *buf, size_t len)
+{
+	return dfu_target_stream_read(offset, buf, len);
+}
+#endif /* CONFIG_DFU_TARGET_HASH */
+
 struct stream_flash_ctx *dfu_target_stream_get_stream(void)
 {
 	return &stream;
@@ -126,6 +185,15 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		return -EFAULT;
 	}
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	err = snprintf(current_hash_key, sizeof(current_hash_key), "%s/%s",
+		       current_name_key, DFU_STREAM_HASH);
+	if (err < 0 || err >= sizeof(current_hash_key)) {
+		LOG_ERR("Unable to generate current_hash_key");
+		return -EFAULT;
+	}
+#endif
+
 	static struct settings_handler sh = {
 		.name = MODULE,
 		.h_set = settings_set,
@@ -151,6 +219,12 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 	}
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	/* Continue the hash saved with the progress of a resumed image */
+	(void)dfu_target_hash_resume(HASH_KEY, stream_flash_bytes_written(&stream),
+				     hash_prefix_read);
+#endif
+
 	return 0;
 }
 
@@ -163,7 +237,11 @@ int dfu_target_stream_offset_get(size_t *out)
 
 int dfu_target_stream_write(const uint8_t *buf, size_t len)
 {
+#ifdef CONFIG_DFU_TARGET_HASH
+	int err = hashed_write(buf, len);
+#else
 	int err = stream_flash_buffered_write(&stream, buf, len, false);
+#endif
 
 	if (err != 0) {
 		LOG_ERR("stream_flash_buffered_write error %d", err);
@@ -183,14 +261,48 @@ int dfu_target_stream_write(const uint8_t *buf, size_t len)
 	return err;
 }
 
+int dfu_target_stream_read(size_t offset, uint8_t *buf, size_t len)
+{
+	size_t written = stream_flash_bytes_written(&stream);
+	size_t flash_len;
+	int err;
+
+	if (offset + len > written + stream.buf_bytes) {
+		return -EINVAL;
+	}
+
+	flash_len = offset < written ? MIN(len, written - offset) : 0;
+	if (flash_len > 0) {
+		err = flash_read(stream.fdev, stream.offset + offset, buf, flash_len);
+		if (err != 0) {
+			LOG_ERR("flash_read error %d", err);
+			return err;
+		}
+	}
+
+	if (flash_len < len) {
+		/* The rest is still in the stream buffer */
+		memcpy(buf + flash_len, stream.buf + (offset + flash_len - written),
+		       len - flash_len);
+	}
+
+	return 0;
+}
+
 int dfu_target_stream_done(bool successful)
 {
 	int err = 0;
 
 	if (successful) {
+#ifdef CONFIG_DFU_TARGET_HASH
+		dfu_target_hash_update(stream.buf, stream.buf_bytes);
+#endif
 		err = stream_flash_buffered_write(&stream, NULL, 0, true);
 		if (err != 0) {
 			LOG_ERR("stream_flash_buffered_write error %d", err);
+#ifdef CONFIG_DFU_TARGET_HASH
+			dfu_target_hash_invalidate();
+#endif
 		}
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 		/* Delete state so that a new call to 'init' will
@@ -200,6 +312,9 @@ int dfu_target_stream_done(bool successful)
 		if (err != 0) {
 			LOG_ERR("setting_delete error %d", err);
 		}
+#ifdef CONFIG_DFU_TARGET_HASH
+		dfu_target_hash_delete(HASH_KEY);
+#endif
 
 	} else {
 		/* The stream has not completed, store the progress so that
@@ -224,6 +339,10 @@ int dfu_target_stream_reset(void)
 	stream.buf_bytes = 0;
 	stream.bytes_written = 0;
 
+#ifdef CONFIG_DFU_TARGET_HASH
+	dfu_target_hash_start();
+#endif
+
 	/* Erase just the first page. Stream write will take care of erasing remaining pages
 	 * on a next buffered_write round
 	 */
@@ -4,22 +4,41 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <emds/emds.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/drivers/flash.h>
+#include <zephyr/sys/crc.h>
 #include "emds_flash.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(emds, CONFIG_EMDS_LOG_LEVEL);
 
+/* The entry is in the stored data, at ate_addr. */
+#define EMDS_ENTRY_INDEXED BIT(0)
+/* The entry is kept in flash since the last store, with the data checksum crc. */
+#define EMDS_ENTRY_KEPT BIT(1)
+
 static bool emds_ready;
 static bool emds_initialized;
+/* The ate_addr of the entries are up to date. */
+static bool emds_indexed;
+/* The last store is complete, and the entries kept in flash are part of it. */
+static bool emds_committed;
 
 static sys_slist_t emds_dynamic_entries;
 static struct emds_fs emds_flash;
 static emds_store_cb_t app_store_cb;
+static struct emds_store_stats store_stats;
+
+struct emds_index_ctx {
+	/* Number of entries not found yet */
+	int remaining;
+	bool first;
+	bool committed;
+};
 
 static int emds_fs_init(void)
 {
@@ -67,30 +86,188 @@ static int emds_fs_init(void)
 }
 
 
-static int emds_entries_size(uint32_t *size)
+static uint32_t emds_entry_size(size_t len)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
+
+	return NRFX_CEIL_DIV(len, block_size) * block_size +
+	       NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
+}
+
+static int emds_entries_size(uint32_t *size)
+{
 	int entries = 0;
 
 	*size = 0;
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		*size += NRFX_CEIL_DIV(ch->len, block_size) * block_size;
-		*size += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
+		*size += emds_entry_size(ch->len);
+		entries++;
+	}
+
+	struct emds_dynamic_entry *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		*size += emds_entry_size(ch->entry.len);
+		entries++;
+	}
+
+	return entries;
+}
+
+static int emds_entries_flags_clear(uint8_t flags)
+{
+	int entries = 0;
+
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		ch->flags &= ~flags;
 		entries++;
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		*size += NRFX_CEIL_DIV(ch->entry.len, block_size) * block_size;
-		*size += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
+		ch->entry.flags &= ~flags;
 		entries++;
 	}
 
 	return entries;
 }
 
+static struct emds_entry *emds_entry_find(uint16_t id)
+{
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (ch->id == id) {
+			return ch;
+		}
+	}
+
+	struct emds_dynamic_entry *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		if (ch->entry.id == id) {
+			return &ch->entry;
+		}
+	}
+
+	return NULL;
+}
+
+static bool emds_index_ate(const struct emds_flash_ate_info *ate, void *user_data)
+{
+	struct emds_index_ctx *ctx = user_data;
+	struct emds_entry *entry;
+
+	if (ctx->first) {
+		ctx->first = false;
+		ctx->committed = ate->commit;
+	}
+
+	if (!ate->valid) {
+		/* Without a commit record, only the entries written by the last store after the
+		 * invalidated ones are stored data.
+		 */
+		return ctx->committed;
+	}
+
+	if (ate->commit) {
+		return true;
+	}
+
+	/* The most recently written copy of the entry is the one stored. */
+	entry = emds_entry_find(ate->id);
+	if (entry && !(entry->flags & EMDS_ENTRY_INDEXED)) {
+		entry->ate_addr = ate->addr;
+		entry->flags |= EMDS_ENTRY_INDEXED;
+		ctx->remaining--;
+	}
+
+	return ctx->remaining > 0;
+}
+
+/* Finds the stored entries in one walk of the allocation table. */
+static int emds_index_build(void)
+{
+	struct emds_index_ctx ctx = {
+		.first = true,
+	};
+	int rc;
+
+	ctx.remaining = emds_entries_flags_clear(EMDS_ENTRY_INDEXED);
+	if (ctx.remaining) {
+		rc = emds_flash_ate_walk(&emds_flash, emds_index_ate, &ctx);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	emds_committed = ctx.committed;
+	emds_indexed = true;
+
+	return 0;
+}
+
+static bool emds_keep_ate(const struct emds_flash_ate_info *ate, void *user_data)
+{
+	struct emds_entry *entry = emds_entry_find(ate->id);
+
+	if (!entry || !(entry->flags & EMDS_ENTRY_INDEXED) || entry->ate_addr != ate->addr) {
+		return false;
+	}
+
+	if (!emds_flash_ate_match(&emds_flash, ate->addr, entry->data, entry->len)) {
+		return false;
+	}
+
+	entry->crc = crc32_ieee(entry->data, entry->len);
+	entry->flags |= EMDS_ENTRY_KEPT;
+
+	return true;
+}
+
+static void emds_entry_store(struct emds_entry *entry)
+{
+	ssize_t len;
+
+	if ((entry->flags & EMDS_ENTRY_KEPT) &&
+	    entry->crc == crc32_ieee(entry->data, entry->len)) {
+		store_stats.entries_skipped++;
+		return;
+	}
+
+	len = emds_flash_write(&emds_flash, entry->id, entry->data, entry->len);
+	if (len < 0) {
+		LOG_ERR("Write entry: (%d) error (%d)", entry->id, len);
+		return;
+	}
+
+	if (len != entry->len) {
+		LOG_ERR("Write entry: (%d) failed (%d:%d)", entry->id, entry->len, len);
+	}
+
+	if (len > 0) {
+		store_stats.bytes_written += emds_entry_size(len);
+	}
+
+	store_stats.entries_written++;
+}
+
+static void emds_entry_load(struct emds_entry *entry)
+{
+	ssize_t len;
+
+	if (!(entry->flags & EMDS_ENTRY_INDEXED)) {
+		return;
+	}
+
+	len = emds_flash_ate_read(&emds_flash, entry->ate_addr, entry->data, entry->len);
+	if (len < 0) {
+		LOG_ERR("Read entry: (%d) error (%d)", entry->id, len);
+	} else if (len != entry->len) {
+		LOG_WRN("Read entry: (%d) did not match (%d:%d)", entry->id, entry->len, len);
+	}
+}
+
 int emds_init(emds_store_cb_t cb)
 {
 	int rc;
@@ -130,9 +307,11 @@ int emds_entry_add(struct emds_dynamic_entry *entry)
 		}
 	}
 
+	entry->entry.flags = 0;
 	sys_slist_append(&emds_dynamic_entries, &entry->node);
 
 	emds_ready = false;
+	emds_indexed = false;
 
 	return 0;
 }
@@ -140,6 +319,8 @@ int emds_entry_add(struct emds_dynamic_entry *entry)
 int emds_store(void)
 {
 	uint32_t store_key;
+	uint32_t start;
+	int rc;
 
 	if (!emds_ready) {
 		return -ECANCELED;
@@ -148,37 +329,34 @@ int emds_store(void)
 	/* Lock all interrupts */
 	store_key = irq_lock();
 
+	start = k_cycle_get_32();
+	memset(&store_stats, 0, sizeof(store_stats));
+
 	/* Start the emergency data storage process. */
 	LOG_DBG("Emergency Data Storeage released");
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		ssize_t len = emds_flash_write(&emds_flash,
-					       ch->id, ch->data, ch->len);
-		if (len < 0) {
-			LOG_ERR("Write static entry: (%d) error (%d)",
-				ch->id, len);
-		} else if (len != ch->len) {
-			LOG_ERR("Write static entry: (%d) failed (%d:%d)",
-				ch->id, ch->len, len);
-		}
+		emds_entry_store(ch);
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		ssize_t len = emds_flash_write(&emds_flash,
-					       ch->entry.id, ch->entry.data, ch->entry.len);
-		if (len < 0) {
-			LOG_ERR("Write dynamic entry: (%d) error (%d).",
-				ch->entry.id, len);
-		}
-		if (len != ch->entry.len) {
-			LOG_ERR("Write dynamic entry: (%d) failed (%d:%d).",
-				ch->entry.id, ch->entry.len, len);
-		}
+		emds_entry_store(&ch->entry);
+	}
+
+	/* The kept entries are only loaded if the store is complete. */
+	rc = emds_flash_commit(&emds_flash);
+	if (rc) {
+		LOG_ERR("Write commit record error (%d)", rc);
+	} else {
+		store_stats.bytes_written += emds_entry_size(0);
 	}
 
+	store_stats.time_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
 	emds_ready = false;
+	emds_indexed = false;
 
 	/* Unlock all interrupts */
 	irq_unlock(store_key);
@@ -193,40 +371,25 @@ int emds_store(void)
 int emds_load(void)
 {
 	struct emds_dynamic_entry *ch;
+	int rc;
 
 	if (!emds_initialized) {
 		return -ECANCELED;
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		ssize_t len = emds_flash_read(&emds_flash,
-					      ch->entry.id, ch->entry.data,
-					      ch->entry.len);
-
-		if (len < 0) {
-			if (len != -ENXIO) {
-				LOG_ERR("Read dynamic entry: (%d) error (%d)",
-					ch->entry.id, len);
-			}
-		} else if (len != ch->entry.len) {
-			LOG_WRN("Read dynamic entry: (%d) did not match (%d:%d).",
-				ch->entry.id, ch->entry.len, len);
+	if (!emds_indexed) {
+		rc = emds_index_build();
+		if (rc) {
+			return rc;
 		}
 	}
 
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		emds_entry_load(&ch->entry);
+	}
+
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		ssize_t len = emds_flash_read(&emds_flash,
-					      ch->id, ch->data, ch->len);
-
-		if (len < 0) {
-			if (len != -ENXIO) {
-				LOG_ERR("Read static entry: (%d) error (%d)",
-					ch->id, len);
-			}
-		} else if (len != ch->len) {
-			LOG_WRN("Read static entry: (%d) entry did not match (%d:%d)",
-				ch->id, ch->len, len);
-		}
+		emds_entry_load(ch);
 	}
 
 	return 0;
@@ -238,6 +401,9 @@ int emds_clear(void)
 		return -ECANCELED;
 	}
 
+	emds_indexed = false;
+	(void)emds_entries_flags_clear(EMDS_ENTRY_KEPT);
+
 	return emds_flash_clear(&emds_flash);
 }
 
@@ -250,9 +416,24 @@ int emds_prepare(void)
 		return -ECANCELED;
 	}
 
+	if (!emds_indexed) {
+		rc = emds_index_build();
+		if (rc) {
+			return rc;
+		}
+	}
+
+	(void)emds_entries_flags_clear(EMDS_ENTRY_KEPT);
 	(void)emds_entries_size(&size);
+	/* Commit record */
+	size += emds_entry_size(0);
+
+	/* Entries that have not changed since the last complete store are kept. */
+	rc = emds_flash_prepare(&emds_flash, size, emds_committed ? emds_keep_ate : NULL, NULL);
+
+	/* The store is no longer complete, so nothing is loaded until the next one is. */
+	emds_indexed = false;
 
-	rc = emds_flash_prepare(&emds_flash, size);
 	if (rc) {
 		return rc;
 	}
@@ -286,6 +467,10 @@ uint32_t emds_store_time_get(void)
 			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
 	}
 
+	/* Commit record */
+	store_time_us += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) *
+				CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US;
+
 	return store_time_us;
 }
 
@@ -298,6 +483,11 @@ uint32_t emds_store_size_get(void)
 	return store_size;
 }
 
+void emds_store_stats_get(struct emds_store_stats *stats)
+{
+	*stats = store_stats;
+}
+
 bool emds_is_ready(void)
 {
 	return emds_ready;
@@ -18,6 +18,8 @@ LOG_MODULE_REGISTER(emds_flash, CONFIG_EMDS_LOG_LEVEL);
 
 #define ADDR_OFFS_MASK 0x0000FFFF
 #define EMDS_FLASH_BLOCK_SIZE 4
+/* Id of the commit records. Records are told apart from entries by their zero length. */
+#define EMDS_FLASH_COMMIT_ID 0xFFFF
 
 /* Allocation Table Entry */
 struct emds_ate {
@@ -334,7 +336,8 @@ static int ate_last_recover(struct emds_fs *fs)
 		case ATE_TYPE_VALID:
 			fs->data_wra_offset = align_size(fs, end_ate.offset + end_ate.len);
 			fs->ate_wra -= fs->ate_size;
-			expect_field = ATE_TYPE_VALID | ATE_TYPE_ERASED;
+			/* Entries kept on prepare are followed by invalidated ones. */
+			expect_field = ATE_TYPE_VALID | ATE_TYPE_INVALIDATED | ATE_TYPE_ERASED;
 			break;
 
 		case ATE_TYPE_INVALIDATED:
@@ -363,17 +366,37 @@ static int ate_last_recover(struct emds_fs *fs)
 	return 0;
 }
 
-static int old_entries_invalidate(struct emds_fs *fs)
+static void ate_info_get(uint32_t addr, enum ate_type type, const struct emds_ate *entry,
+			 struct emds_flash_ate_info *info)
+{
+	info->addr = addr;
+	info->valid = (type == ATE_TYPE_VALID);
+	info->id = info->valid ? entry->id : 0;
+	info->len = info->valid ? entry->len : 0;
+	info->commit = info->valid && !entry->len;
+}
+
+static int old_entries_invalidate(struct emds_fs *fs, emds_flash_ate_cb_t keep, void *user_data)
 {
 	int rc = 0;
 	uint8_t inval_buf[fs->ate_size];
 	uint32_t addr = fs->ate_wra + fs->ate_size;
+	struct emds_flash_ate_info info;
+	struct emds_ate entry;
+	enum ate_type type;
 
 	memset(inval_buf, 0, sizeof(inval_buf));
 	while (addr <= (fs->offset + fs->sector_cnt * fs->sector_size) - fs->ate_size) {
-		rc = flash_write(fs->flash_dev, addr, inval_buf, sizeof(inval_buf));
-		if (rc) {
-			return rc;
+		type = ate_check(fs, addr, &entry);
+		ate_info_get(addr, type, &entry, &info);
+
+		/* Commit records are never kept, the next store is not complete yet. */
+		if (type != ATE_TYPE_INVALIDATED &&
+		    !(info.valid && !info.commit && keep && keep(&info, user_data))) {
+			rc = flash_write(fs->flash_dev, addr, inval_buf, sizeof(inval_buf));
+			if (rc) {
+				return rc;
+			}
 		}
 
 		addr += fs->ate_size;
@@ -382,6 +405,27 @@ static int old_entries_invalidate(struct emds_fs *fs)
 	return 0;
 }
 
+static ssize_t ate_data_read(struct emds_fs *fs, const struct emds_ate *entry, void *data,
+			     size_t len)
+{
+	int rc;
+
+	if (len < entry->len) {
+		return -ENOMEM;
+	}
+
+	rc = flash_read(fs->flash_dev, fs->offset + entry->offset, data, entry->len);
+	if (rc) {
+		return rc;
+	}
+
+	if (entry->crc8_data != crc8_ccitt(0xff, data, entry->len)) {
+		return -EFAULT;
+	}
+
+	return entry->len;
+}
+
 int emds_flash_init(struct emds_fs *fs)
 {
 	if (fs->is_initialized) {
@@ -504,24 +548,108 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
 		}
 	}
 
-	if (len < wlk_ate.len) {
-		return -ENOMEM;
+	return ate_data_read(fs, &wlk_ate, data, len);
+}
+
+ssize_t emds_flash_ate_read(struct emds_fs *fs, uint32_t ate_addr, void *data, size_t len)
+{
+	struct emds_ate entry;
+
+	if (!fs->is_initialized) {
+		LOG_ERR("EMDS flash not initialized");
+		return -EACCES;
 	}
 
-	rc = flash_read(fs->flash_dev, fs->offset + wlk_ate.offset, data, wlk_ate.len);
-	if (rc) {
-		return rc;
+	if (ate_check(fs, ate_addr, &entry) != ATE_TYPE_VALID) {
+		return -ENXIO;
 	}
 
-	if (wlk_ate.crc8_data != crc8_ccitt(0xff, data, wlk_ate.len)) {
-		return -EFAULT;
+	return ate_data_read(fs, &entry, data, len);
+}
+
+bool emds_flash_ate_match(struct emds_fs *fs, uint32_t ate_addr, const void *data, size_t len)
+{
+	const uint8_t *data8 = data;
+	uint8_t buf[EMDS_FLASH_BLOCK_SIZE];
+	struct emds_ate entry;
+	size_t bytes_to_cmp;
+	uint32_t addr;
+
+	if (!fs->is_initialized || ate_check(fs, ate_addr, &entry) != ATE_TYPE_VALID) {
+		return false;
 	}
 
-	return wlk_ate.len;
+	if (entry.len != len || entry.crc8_data != crc8_ccitt(0xff, data, len)) {
+		return false;
+	}
+
+	addr = fs->offset + entry.offset;
+	while (len) {
+		bytes_to_cmp = MIN(EMDS_FLASH_BLOCK_SIZE, len);
+		if (flash_read(fs->flash_dev, addr, buf, bytes_to_cmp)) {
+			return false;
+		}
+
+		if (memcmp(data8, buf, bytes_to_cmp)) {
+			return false;
+		}
+
+		len -= bytes_to_cmp;
+		addr += bytes_to_cmp;
+		data8 += bytes_to_cmp;
+	}
+
+	return true;
+}
+
+int emds_flash_ate_walk(struct emds_fs *fs, emds_flash_ate_cb_t cb, void *user_data)
+{
+	struct emds_flash_ate_info info;
+	struct emds_ate entry;
+	enum ate_type type;
+	uint32_t addr;
+
+	if (!fs->is_initialized) {
+		LOG_ERR("EMDS flash not initialized");
+		return -EACCES;
+	}
+
+	for (addr = fs->ate_wra + fs->ate_size;
+	     addr <= (fs->offset + fs->sector_cnt * fs->sector_size) - fs->ate_size;
+	     addr += fs->ate_size) {
+		type = ate_check(fs, addr, &entry);
+		if (type != ATE_TYPE_VALID && type != ATE_TYPE_INVALIDATED) {
+			continue;
+		}
+
+		ate_info_get(addr, type, &entry, &info);
+		if (!cb(&info, user_data)) {
+			break;
+		}
+	}
+
+	return 0;
 }
 
-int emds_flash_prepare(struct emds_fs *fs, int byte_size)
+int emds_flash_commit(struct emds_fs *fs)
 {
+	if (!fs->is_initialized || !fs->is_prepeared) {
+		LOG_ERR("EMDS flash not initialized or not ready for write");
+		return -EACCES;
+	}
+
+	if (fs->ate_size > emds_flash_free_space_get(fs)) {
+		return -ENOMEM;
+	}
+
+	return entry_wrt(fs, EMDS_FLASH_COMMIT_ID, NULL, 0);
+}
+
+int emds_flash_prepare(struct emds_fs *fs, int byte_size, emds_flash_ate_cb_t keep,
+		       void *user_data)
+{
+	bool clear;
+
 	if (!fs->is_initialized) {
 		LOG_ERR("EMDS flash not initialized");
 		return -EACCES;
@@ -531,13 +659,16 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 		return -ENOMEM;
 	}
 
-	int rc = old_entries_invalidate(fs);
+	/* Nothing is kept if the flash area is cleared after invalidation. */
+	clear = fs->force_erase || (byte_size > emds_flash_free_space_get(fs));
+
+	int rc = old_entries_invalidate(fs, clear ? NULL : keep, user_data);
 
 	if (rc) {
 		return rc;
 	}
 
-	if (fs->force_erase || (byte_size > emds_flash_free_space_get(fs))) {
+	if (clear) {
 		emds_flash_clear(fs);
 		fs->force_erase = false;
 	}
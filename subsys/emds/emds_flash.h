@@ -47,6 +47,33 @@ struct emds_fs {
 	bool force_erase;
 };
 
+/**
+ * @brief Allocation table entry information
+ *
+ * @param addr Address of the allocation table entry
+ * @param id Id of the entry, 0 if invalidated
+ * @param len Length of the entry data, 0 if invalidated
+ * @param valid The entry is valid, not invalidated
+ * @param commit The entry is a commit record, written by @ref emds_flash_commit
+ */
+struct emds_flash_ate_info {
+	uint32_t addr;
+	uint16_t id;
+	uint16_t len;
+	bool valid;
+	bool commit;
+};
+
+/**
+ * @brief Callback for allocation table entries.
+ *
+ * @param ate Allocation table entry
+ * @param user_data User data passed with the callback
+ *
+ * @return Meaning depends on the function the callback is passed to.
+ */
+typedef bool (*emds_flash_ate_cb_t)(const struct emds_flash_ate_info *ate, void *user_data);
+
 /**
  * @brief Initialize emergency data storage flash.
  *
@@ -99,24 +126,83 @@ ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size
  */
 ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len);
 
+/**
+ * @brief Read the entry of an allocation table entry.
+ *
+ * Read the entry at a known location, as reported by @ref emds_flash_ate_walk, without
+ * searching the allocation table.
+ *
+ * @param fs Pointer to file system
+ * @param ate_addr Address of the allocation table entry
+ * @param data Pointer to data buffer
+ * @param len Number of bytes in data buffer
+ *
+ * @return Number of bytes read, or negative value of errno.h defined error codes. See
+ * @ref emds_flash_read.
+ */
+ssize_t emds_flash_ate_read(struct emds_fs *fs, uint32_t ate_addr, void *data, size_t len);
+
+/**
+ * @brief Check if an allocation table entry holds the given data.
+ *
+ * @param fs Pointer to file system
+ * @param ate_addr Address of the allocation table entry
+ * @param data Pointer to the data to compare with
+ * @param len Number of bytes of data
+ *
+ * @return True if the entry is valid, and its data is equal to the given data.
+ */
+bool emds_flash_ate_match(struct emds_fs *fs, uint32_t ate_addr, const void *data, size_t len);
+
+/**
+ * @brief Walk the allocation table of the EMDS file system.
+ *
+ * Calls the callback for each valid and invalidated allocation table entry, from the most
+ * recently written one to the oldest one. The walk stops when the callback returns false.
+ *
+ * @param fs Pointer to file system
+ * @param cb Callback for each allocation table entry
+ * @param user_data User data passed to the callback
+ *
+ * @retval 0 on success or negative error code
+ */
+int emds_flash_ate_walk(struct emds_fs *fs, emds_flash_ate_cb_t cb, void *user_data);
+
+/**
+ * @brief Write a commit record to the EMDS file system.
+ *
+ * Marks the end of a complete store. Entries kept by @ref emds_flash_prepare are only part of
+ * the stored data if it is followed by a commit record.
+ *
+ * @param fs Pointer to file system
+ *
+ * @retval 0 on success or negative error code
+ */
+int emds_flash_commit(struct emds_fs *fs);
+
 /**
  * @brief Prepare EMDS file system for next write events.
  *
  * This function should be called at the moment when the user has restored the desired data
- * entries from flash. It will invalidate all prior entries, and potentially clear the flash
- * area.
+ * entries from flash. It will invalidate all prior entries and commit records, except the
+ * entries the keep callback returns true for, and potentially clear the flash area. The most recently written entries
+ * are invalidated first. When the flash area is cleared, the keep callback is not called.
  *
- * @note Calling this function will make any subsequent read attempts fail. Be sure to
- * restore all necessary entries before using this function.
+ * @note Calling this function will make any subsequent read attempts of the invalidated
+ * entries fail. Be sure to restore all necessary entries before using this function.
  *
  * @note Should only be called once.
  *
  * @param fs Pointer to file system
  * @param byte_size Total number of bytes
+ * @param keep Callback for each valid entry, returning true to keep the entry, or NULL to
+ *             invalidate all entries
+ * @param user_data User data passed to the keep callback
  *
  * @retval 0 on success or negative error code
  */
-int emds_flash_prepare(struct emds_fs *fs, int byte_size);
+int emds_flash_prepare(struct emds_fs *fs, int byte_size, emds_flash_ate_cb_t keep,
+		       void *user_data);
 
 /**
  * @brief Get remaining raw space on the flash device.
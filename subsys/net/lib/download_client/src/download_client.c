@@ -34,6 +34,7 @@ int url_parse_host(const char *url, char *host, size_t len);
 
 int http_parse(struct download_client *client, size_t len);
 int http_get_request_send(struct download_client *client);
+int http_get_range_request_send(struct download_client *client, int fd, size_t from);
 
 int coap_block_init(struct download_client *client, size_t from);
 int coap_get_recv_timeout(struct download_client *dl);
@@ -275,12 +276,85 @@ static int host_lookup(const char *host, int family, uint8_t pdn_id,
 	return 0;
 }
 
+static int client_socket_open(struct download_client *dl, int type, int *fd)
+{
+	int err;
+	socklen_t addrlen;
+
+	switch (dl->remote_addr.sa_family) {
+	case AF_INET6:
+		addrlen = sizeof(struct sockaddr_in6);
+		break;
+	case AF_INET:
+		addrlen = sizeof(struct sockaddr_in);
+		break;
+	default:
+		return -EAFNOSUPPORT;
+	}
+
+	if (dl->set_native_tls) {
+		LOG_DBG("Enabled native TLS");
+		type |= SOCK_NATIVE_TLS;
+	}
+
+	LOG_DBG("family: %d, type: %d, proto: %d",
+		dl->remote_addr.sa_family, type, dl->proto);
+
+	*fd = socket(dl->remote_addr.sa_family, type, dl->proto);
+	if (*fd < 0) {
+		LOG_ERR("Failed to create socket, err %d", errno);
+		return -errno;
+	}
+
+	if (dl->config.pdn_id) {
+		err = socket_pdn_id_set(*fd, dl->config.pdn_id);
+		if (err) {
+			goto cleanup;
+		}
+	}
+
+	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
+	     && (dl->config.sec_tag_list != NULL) && (dl->config.sec_tag_count > 0)) {
+		err = socket_sectag_set(*fd, dl->config.sec_tag_list, dl->config.sec_tag_count);
+		if (err) {
+			goto cleanup;
+		}
+
+		if (dl->config.set_tls_hostname) {
+			err = socket_tls_hostname_set(*fd, dl->host);
+			if (err) {
+				goto cleanup;
+			}
+		}
+	}
+
+	LOG_INF("Connecting to %s", dl->host);
+	LOG_DBG("fd %d, addrlen %d, fam %s, port %d",
+		*fd, addrlen, str_family(dl->remote_addr.sa_family),
+		ntohs(dl->remote_addr.sa_family == AF_INET6 ?
+		      SIN6(&dl->remote_addr)->sin6_port : SIN(&dl->remote_addr)->sin_port));
+
+	err = connect(*fd, &dl->remote_addr, addrlen);
+	if (err) {
+		err = -errno;
+		LOG_ERR("Unable to connect, errno %d", -err);
+	}
+
+cleanup:
+	if (err) {
+		/* Unable to connect, close socket */
+		(void)close(*fd);
+		*fd = -1;
+	}
+
+	return err;
+}
+
 static int client_connect(struct download_client *dl)
 {
 	int err;
 	int type;
 	uint16_t port;
-	socklen_t addrlen;
 
 	/* Attempt IPv6 connection if configured, fallback to IPv4 */
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_IPV6)) {
@@ -345,95 +419,266 @@ static int client_connect(struct download_client *dl)
 	switch (dl->remote_addr.sa_family) {
 	case AF_INET6:
 		SIN6(&dl->remote_addr)->sin6_port = htons(port);
-		addrlen = sizeof(struct sockaddr_in6);
 		break;
 	case AF_INET:
 		SIN(&dl->remote_addr)->sin_port = htons(port);
-		addrlen = sizeof(struct sockaddr_in);
 		break;
 	default:
 		return -EAFNOSUPPORT;
 	}
 
-	if (dl->set_native_tls) {
-		LOG_DBG("Enabled native TLS");
-		type |= SOCK_NATIVE_TLS;
+	err = client_socket_open(dl, type, &dl->fd);
+	if (err) {
+		/* Unable to connect */
+		handle_disconnect(dl);
 	}
 
-	LOG_DBG("family: %d, type: %d, proto: %d",
-		dl->remote_addr.sa_family, type, dl->proto);
+	return err;
+}
 
-	dl->fd = socket(dl->remote_addr.sa_family, type, dl->proto);
-	if (dl->fd < 0) {
-		LOG_ERR("Failed to create socket, err %d", errno);
+int socket_send_fd(const struct download_client *client, int fd, size_t len, int timeout)
+{
+	int err;
+	int sent;
+	size_t off = 0;
+
+	err = set_snd_socket_timeout(fd, timeout);
+	if (err) {
 		return -errno;
 	}
 
-	if (dl->config.pdn_id) {
-		err = socket_pdn_id_set(dl->fd, dl->config.pdn_id);
-		if (err) {
-			goto cleanup;
+	while (len) {
+		sent = send(fd, client->buf + off, len, 0);
+		if (sent < 0) {
+			return -errno;
 		}
+
+		off += sent;
+		len -= sent;
 	}
 
-	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
-	     && (dl->config.sec_tag_list != NULL) && (dl->config.sec_tag_count > 0)) {
-		err = socket_sectag_set(dl->fd, dl->config.sec_tag_list, dl->config.sec_tag_count);
-		if (err) {
-			goto cleanup;
+	return 0;
+}
+
+int socket_send(const struct download_client *client, size_t len, int timeout)
+{
+	return socket_send_fd(client, client->fd, len, timeout);
+}
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_PARALLEL)
+
+#define PARALLEL_CONN_MAX CONFIG_DOWNLOAD_CLIENT_PARALLEL_CONN_MAX
+#define PARALLEL_WINDOW_INIT MIN(2, PARALLEL_CONN_MAX)
+/* Idle connection, no range in flight */
+#define RANGE_IDLE SIZE_MAX
+
+static void parallel_init(struct download_client *dl)
+{
+	for (int i = 0; i < PARALLEL_CONN_MAX; i++) {
+		dl->parallel.fd[i] = -1;
+		dl->parallel.start[i] = RANGE_IDLE;
+	}
+
+	dl->parallel.next = 0;
+	dl->parallel.window = PARALLEL_WINDOW_INIT;
+	dl->parallel.samples = 0;
+	dl->parallel.sample_time = 0;
+	dl->parallel.rate = 0;
+}
+
+/* Close the extra connections and forget the ranges in flight.
+ * The connection in `dl->fd` is left open.
+ */
+static void parallel_close(struct download_client *dl)
+{
+	for (int i = 0; i < PARALLEL_CONN_MAX; i++) {
+		if (dl->parallel.fd[i] != -1 && dl->parallel.fd[i] != dl->fd) {
+			(void)close(dl->parallel.fd[i]);
 		}
+		dl->parallel.fd[i] = -1;
+		dl->parallel.start[i] = RANGE_IDLE;
+	}
 
-		if (dl->config.set_tls_hostname) {
-			err = socket_tls_hostname_set(dl->fd, dl->host);
-			if (err) {
-				goto cleanup;
-			}
+	dl->parallel.next = 0;
+}
+
+/* Adapt the number of ranges in flight to the measured throughput.
+ * The window keeps growing as long as the throughput improves noticeably,
+ * and shrinks back when it degrades, e.g. when the link is saturated
+ * and the connections just compete with each other.
+ */
+static void parallel_window_adapt(struct download_client *dl)
+{
+	int64_t elapsed;
+	uint32_t rate;
+	uint32_t prev = dl->parallel.rate;
+
+	if (dl->parallel.sample_time == 0) {
+		dl->parallel.sample_time = k_uptime_get();
+		dl->parallel.sample_progress = dl->progress;
+		return;
+	}
+
+	/* Sample over a few round trips of the whole window */
+	if (++dl->parallel.samples < 2 * dl->parallel.window) {
+		return;
+	}
+
+	elapsed = k_uptime_get() - dl->parallel.sample_time;
+	if (elapsed <= 0) {
+		return;
+	}
+
+	rate = (uint64_t)(dl->progress - dl->parallel.sample_progress) * MSEC_PER_SEC / elapsed;
+
+	if (prev == 0 || rate > prev + prev / 8) {
+		if (dl->parallel.window < PARALLEL_CONN_MAX) {
+			dl->parallel.window++;
+		}
+	} else if (rate < prev - prev / 8) {
+		if (dl->parallel.window > 1) {
+			dl->parallel.window--;
 		}
 	}
 
-	LOG_INF("Connecting to %s", dl->host);
-	LOG_DBG("fd %d, addrlen %d, fam %s, port %d",
-		dl->fd, addrlen, str_family(dl->remote_addr.sa_family), port);
+	LOG_DBG("Throughput %u B/s, window %u", rate, dl->parallel.window);
 
-	err = connect(dl->fd, &dl->remote_addr, addrlen);
-	if (err) {
-		err = -errno;
-		LOG_ERR("Unable to connect, errno %d", -err);
+	dl->parallel.rate = rate;
+	dl->parallel.samples = 0;
+	dl->parallel.sample_time = k_uptime_get();
+	dl->parallel.sample_progress = dl->progress;
+}
+
+static int parallel_slot_of(const struct download_client *dl, int fd)
+{
+	for (int i = 0; i < PARALLEL_CONN_MAX; i++) {
+		if (dl->parallel.fd[i] == fd) {
+			return i;
+		}
 	}
 
-cleanup:
-	if (err) {
-		/* Unable to connect, close socket */
-		handle_disconnect(dl);
+	return -1;
+}
+
+/* Find an idle slot to request a range on, other than the current connection.
+ * Slots with an open connection are preferred over opening a new one.
+ */
+static int parallel_slot_idle(const struct download_client *dl)
+{
+	int slot = -1;
+
+	for (int i = 0; i < PARALLEL_CONN_MAX; i++) {
+		if (dl->parallel.start[i] != RANGE_IDLE || dl->parallel.fd[i] == dl->fd) {
+			continue;
+		}
+		if (dl->parallel.fd[i] != -1) {
+			return i;
+		}
+		if (slot == -1) {
+			slot = i;
+		}
 	}
 
-	return err;
+	return slot;
 }
 
-int socket_send(const struct download_client *client, size_t len, int timeout)
+/* Request the next fragment and keep up to `window` fragments in flight,
+ * each on its own connection. Responses are received in order, one connection
+ * at a time, so that fragments are delivered sequentially from the one buffer;
+ * the responses for the later ranges wait in the socket buffers meanwhile.
+ */
+static int parallel_request_send(struct download_client *dl)
 {
 	int err;
-	int sent;
-	size_t off = 0;
+	int cur;
+	int slot;
+	int in_flight = 1;
+	size_t frag = dl->config.frag_size_override ?
+		      dl->config.frag_size_override : CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+
+	parallel_window_adapt(dl);
+
+	/* Track the current connection */
+	cur = parallel_slot_of(dl, dl->fd);
+	if (cur == -1) {
+		cur = parallel_slot_of(dl, -1);
+		__ASSERT_NO_MSG(cur != -1);
+		dl->parallel.fd[cur] = dl->fd;
+		dl->parallel.start[cur] = RANGE_IDLE;
+	}
+
+	/* Receive from the connection the next range was requested on, if any */
+	for (int i = 0; i < PARALLEL_CONN_MAX; i++) {
+		if (dl->parallel.start[i] == dl->progress) {
+			cur = i;
+			break;
+		}
+	}
 
-	err = set_snd_socket_timeout(client->fd, timeout);
-	if (err) {
-		return -errno;
+	if (dl->parallel.start[cur] != dl->progress) {
+		err = http_get_range_request_send(dl, dl->parallel.fd[cur], dl->progress);
+		if (err) {
+			return err;
+		}
 	}
 
-	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
-		if (sent < 0) {
-			return -errno;
+	dl->fd = dl->parallel.fd[cur];
+	dl->parallel.start[cur] = RANGE_IDLE;
+	dl->http.has_header = false;
+	dl->http.ranged = true;
+
+	dl->parallel.next = MAX(dl->parallel.next, dl->progress + frag);
+
+	for (int i = 0; i < PARALLEL_CONN_MAX; i++) {
+		if (dl->parallel.start[i] != RANGE_IDLE) {
+			in_flight++;
 		}
+	}
 
-		off += sent;
-		len -= sent;
+	/* Fill the window. Failing to do so is not fatal,
+	 * the download just carries on with fewer ranges in flight.
+	 */
+	while (in_flight < dl->parallel.window && dl->parallel.next < dl->file_size) {
+		slot = parallel_slot_idle(dl);
+		if (slot == -1) {
+			break;
+		}
+
+		if (dl->parallel.fd[slot] == -1) {
+			err = client_socket_open(dl, SOCK_STREAM, &dl->parallel.fd[slot]);
+			if (err) {
+				LOG_WRN("Failed to open parallel connection, err %d", err);
+				break;
+			}
+		}
+
+		err = http_get_range_request_send(dl, dl->parallel.fd[slot], dl->parallel.next);
+		if (err) {
+			(void)close(dl->parallel.fd[slot]);
+			dl->parallel.fd[slot] = -1;
+			break;
+		}
+
+		dl->parallel.start[slot] = dl->parallel.next;
+		dl->parallel.next += frag;
+		in_flight++;
 	}
 
 	return 0;
 }
 
+#else
+
+static void parallel_init(struct download_client *dl)
+{
+}
+
+static void parallel_close(struct download_client *dl)
+{
+}
+
+#endif /* CONFIG_DOWNLOAD_CLIENT_PARALLEL */
+
 static int request_send(struct download_client *dl)
 {
 	if (dl->fd < 0) {
@@ -442,6 +687,12 @@ static int request_send(struct download_client *dl)
 	switch (dl->proto) {
 	case IPPROTO_TCP:
 	case IPPROTO_TLS_1_2:
+#if defined(CONFIG_DOWNLOAD_CLIENT_PARALLEL)
+		if (dl->file_size) {
+			/* File size is known after the first fragment */
+			return parallel_request_send(dl);
+		}
+#endif
 		return http_get_request_send(dl);
 	case IPPROTO_UDP:
 	case IPPROTO_DTLS_1_2:
@@ -489,6 +740,7 @@ static int reconnect(struct download_client *dl)
 	int err;
 
 	LOG_INF("Reconnecting...");
+	parallel_close(dl);
 	if (dl->fd >= 0) {
 		err = close(dl->fd);
 		if (err) {
@@ -716,6 +968,7 @@ static int handle_disconnect(struct download_client *client)
 
 	k_mutex_lock(&client->mutex, K_FOREVER);
 
+	parallel_close(client);
 	if (client->fd != -1) {
 		err = close(client->fd);
 		if (err) {
@@ -835,6 +1088,9 @@ void download_thread(void *client, void *a, void *b)
 			}
 		}
 
+		/* Drop any ranges still in flight on the extra connections */
+		parallel_close(dl);
+
 		if (is_downloading(dl)) {
 			if (dl->close_when_done) {
 				set_state(dl, DOWNLOAD_CLIENT_CLOSING);
@@ -862,6 +1118,7 @@ int download_client_init(struct download_client *const client,
 	memset(client, 0, sizeof(*client));
 	client->fd = -1;
 	client->callback = callback;
+	parallel_init(client);
 	k_sem_init(&client->wait_for_download, 0, 1);
 	k_mutex_init(&client->mutex);
 
@@ -952,6 +1209,8 @@ int download_client_start(struct download_client *client, const char *file,
 	client->progress = from;
 	client->offset = 0;
 	client->http.has_header = false;
+	client->http.etag = 0;
+	parallel_init(client);
 	if (is_idle(client)) {
 		set_state(client, DOWNLOAD_CLIENT_CONNECTING);
 	} else {
@@ -1006,3 +1265,16 @@ int download_client_file_size_get(struct download_client *client, size_t *size)
 
 	return 0;
 }
+
+int download_client_etag_get(struct download_client *client, uint32_t *etag)
+{
+	if (!client || !etag) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&client->mutex, K_FOREVER);
+	*etag = client->http.etag;
+	k_mutex_unlock(&client->mutex);
+
+	return *etag ? 0 : -ENODATA;
+}
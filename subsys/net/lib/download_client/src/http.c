@@ -45,6 +45,26 @@ extern char *strnstr(const char *haystack, const char *needle, size_t haystack_s
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
 int socket_send(const struct download_client *client, size_t len, int timeout);
+int socket_send_fd(const struct download_client *client, int fd, size_t len, int timeout);
+
+/* Offset of last byte in range starting at `from` (Content-Range) */
+static size_t http_range_end(const struct download_client *client, size_t from)
+{
+	size_t off;
+
+	if (client->config.frag_size_override) {
+		off = from + client->config.frag_size_override - 1;
+	} else {
+		off = from + CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
+	}
+
+	if (client->file_size != 0) {
+		/* Don't request bytes past the end of file */
+		off = MIN(off, client->file_size - 1);
+	}
+
+	return off;
+}
 
 int http_get_request_send(struct download_client *client)
 {
@@ -69,18 +89,7 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
-	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
-
-	if (client->file_size != 0) {
-		/* Don't request bytes past the end of file */
-		off = MIN(off, client->file_size - 1);
-	}
+	off = http_range_end(client, client->progress);
 
 	if (client->proto == IPPROTO_TLS_1_2
 	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
@@ -118,6 +127,70 @@ int http_get_request_send(struct download_client *client)
 	return 0;
 }
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_PARALLEL)
+/* Send a ranged GET for the fragment starting at `from` on connection `fd`,
+ * which is not necessarily the connection data is being received on.
+ * The receive state of the client is left untouched.
+ */
+int http_get_range_request_send(struct download_client *client, int fd, size_t from)
+{
+	int err;
+	int len;
+	char host[HOSTNAME_SIZE];
+	char file[FILENAME_SIZE];
+
+	__ASSERT_NO_MSG(client->host);
+	__ASSERT_NO_MSG(client->file);
+	__ASSERT_NO_MSG(client->offset == 0);
+
+	err = url_parse_host(client->host, host, sizeof(host));
+	if (err) {
+		return err;
+	}
+
+	err = url_parse_file(client->file, file, sizeof(file));
+	if (err) {
+		return err;
+	}
+
+	len = snprintf(client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, HTTP_GET_RANGE,
+		       file, host, from, http_range_end(client, from));
+	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+		return -ENOMEM;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+	}
+
+	err = socket_send_fd(client, fd, len, 0);
+	if (err) {
+		LOG_ERR("Failed to send HTTP request, errno %d", errno);
+		return err;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_DOWNLOAD_CLIENT_PARALLEL */
+
+/* FNV-1a hash of a header value, up to the end of the line */
+static uint32_t http_header_value_hash(const char *p, const char *end)
+{
+	uint32_t hash = 2166136261U;
+
+	while (p < end && *p == ' ') {
+		p++;
+	}
+
+	while (p < end && *p != '\r' && *p != '\n') {
+		hash = (hash ^ (uint8_t)*p++) * 16777619U;
+	}
+
+	/* Zero means no entity tag */
+	return hash ? hash : 1;
+}
+
 /* Returns:
  *  1 while the header is being received
  *  0 if the header has been fully received
@@ -221,6 +294,16 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 
 		client->file_size += atoi(p + 1);
 		LOG_DBG("File size = %u", client->file_size);
+	} else if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_PARALLEL) && client->http.ranged) {
+		/* With several ranges in flight, make sure this response
+		 * carries the range we are waiting for.
+		 */
+		p = strnstr(client->buf, "content-range: bytes ", sizeof(client->buf));
+		if (p && strtoul(p + strlen("content-range: bytes "), NULL, 10) !=
+			 client->progress) {
+			LOG_ERR("Unexpected range in response");
+			return -EBADMSG;
+		}
 	}
 
 	p = strnstr(client->buf, "connection: close", sizeof(client->buf));
@@ -229,6 +312,18 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 		client->http.connection_close = true;
 	}
 
+	p = strnstr(client->buf, "\r\netag:", *hdr_len);
+	if (p) {
+		uint32_t etag = http_header_value_hash(p + strlen("\r\netag:"),
+						       client->buf + *hdr_len);
+
+		if (client->http.etag != 0 && client->http.etag != etag) {
+			LOG_ERR("File changed on the server during download");
+			return -EBADMSG;
+		}
+		client->http.etag = etag;
+	}
+
 	client->http.has_header = true;
 
 	return 0;
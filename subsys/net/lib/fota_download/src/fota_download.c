@@ -14,6 +14,12 @@
 
 #include "fota_download_util.h"
 
+#if defined(CONFIG_FOTA_DOWNLOAD_JOURNAL)
+#include <zephyr/settings/settings.h>
+
+#define JOURNAL_KEY "fota_dl/journal"
+#endif
+
 #if defined(PM_S1_ADDRESS) || defined(CONFIG_DFU_TARGET_MCUBOOT)
 /* MCUBoot support is required */
 #include <fw_info.h>
@@ -51,6 +57,203 @@ enum flags_t {
 static atomic_t flags;
 static enum fota_download_error_cause error_state = FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR;
 
+#if defined(CONFIG_FOTA_DOWNLOAD_JOURNAL)
+#define IMAGE_HASH_LEN 32
+
+/* Progress of the current download, persisted to resume it after a reboot */
+static struct fota_download_journal {
+	uint32_t host_hash;
+	uint32_t file_hash;
+	/* Hash of the entity tag (ETag) of the file, zero if none */
+	uint32_t etag;
+	uint32_t file_size;
+	/* Number of bytes written to the DFU target */
+	uint32_t offset;
+	/* Progress of the DFU target when the journal was saved, zero if the
+	 * image hash is not available
+	 */
+	uint32_t image_offset;
+	/* SHA-256 the DFU target computed up to image_offset */
+	uint8_t image_hash[IMAGE_HASH_LEN];
+} journal;
+static size_t journal_saved_offset;
+
+/* Take the hash the DFU target keeps of the image it has written, so that
+ * the partial image can be matched against the journal without reading it.
+ */
+static void journal_image_hash_get(void)
+{
+	journal.image_offset = 0;
+
+#if defined(CONFIG_DFU_TARGET_HASH)
+	size_t offset;
+
+	if (dfu_target_offset_get(&offset) != 0 ||
+	    dfu_target_hash_get(journal.image_hash, sizeof(journal.image_hash)) != 0) {
+		return;
+	}
+
+	journal.image_offset = offset;
+#endif
+}
+
+/* The hash can only be compared at the progress it was taken at. The
+ * complete image is verified by the DFU target in any case.
+ */
+static bool journal_image_hash_differs(const struct fota_download_journal *saved,
+				       size_t offset)
+{
+#if defined(CONFIG_DFU_TARGET_HASH)
+	uint8_t hash[IMAGE_HASH_LEN];
+
+	if (saved->image_offset == offset &&
+	    dfu_target_hash_get(hash, sizeof(hash)) == 0) {
+		return memcmp(hash, saved->image_hash, sizeof(hash)) != 0;
+	}
+#endif
+	return false;
+}
+
+static int journal_save(void)
+{
+	int err;
+
+	if (journal.file_size == 0) {
+		/* Download did not begin */
+		return 0;
+	}
+
+	journal_image_hash_get();
+
+	err = settings_save_one(JOURNAL_KEY, &journal, sizeof(journal));
+	if (err) {
+		/* Not critical, a bit more will be downloaded if resuming */
+		LOG_WRN("Unable to save download journal, err %d", err);
+		return err;
+	}
+
+	journal_saved_offset = journal.offset;
+
+	return 0;
+}
+
+static void journal_clear(void)
+{
+	int err;
+
+	memset(&journal, 0, sizeof(journal));
+	journal_saved_offset = 0;
+
+	err = settings_delete(JOURNAL_KEY);
+	if (err) {
+		LOG_WRN("Unable to delete download journal, err %d", err);
+	}
+}
+
+static int journal_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			   void *cb_arg, void *param)
+{
+	ssize_t rc;
+
+	if (len != sizeof(journal)) {
+		return -EINVAL;
+	}
+
+	rc = read_cb(cb_arg, param, len);
+
+	return rc == len ? 0 : -EIO;
+}
+
+static int journal_load(struct fota_download_journal *saved)
+{
+	int err;
+
+	memset(saved, 0, sizeof(*saved));
+
+	err = settings_load_subtree_direct(JOURNAL_KEY, journal_load_cb, saved);
+	if (err) {
+		return err;
+	}
+
+	return saved->file_size ? 0 : -ENOENT;
+}
+
+static void journal_begin(size_t file_size)
+{
+	memset(&journal, 0, sizeof(journal));
+	journal.host_hash = dl_host_hash;
+	journal.file_hash = dl_file_hash;
+	(void)download_client_etag_get(&dlc, &journal.etag);
+	journal.file_size = file_size;
+
+	(void)journal_save();
+}
+
+static void journal_update(size_t len)
+{
+	journal.offset += len;
+
+	if (journal.offset - journal_saved_offset >= CONFIG_FOTA_DOWNLOAD_JOURNAL_INTERVAL) {
+		(void)journal_save();
+	}
+}
+
+/* Check the partial image in the DFU target against the journal.
+ * The image is stale if the journal is missing, if it was written for
+ * another resource locator or another version of the file, or if the hash
+ * of the image differs from the one in the journal.
+ */
+static bool partial_image_is_stale(size_t offset, size_t file_size)
+{
+	struct fota_download_journal saved;
+	uint32_t etag = 0;
+	int err;
+
+	err = journal_load(&saved);
+	if (err) {
+		LOG_WRN("No download journal for the partial image");
+		return true;
+	}
+
+	(void)download_client_etag_get(&dlc, &etag);
+
+	if (saved.host_hash != dl_host_hash || saved.file_hash != dl_file_hash) {
+		LOG_INF("Partial image is from another resource locator");
+		return true;
+	}
+
+	if (saved.etag != etag || saved.file_size != file_size) {
+		LOG_INF("File changed since the partial image was downloaded");
+		return true;
+	}
+
+	if (journal_image_hash_differs(&saved, offset)) {
+		LOG_WRN("Partial image does not match the journal");
+		return true;
+	}
+
+	journal = saved;
+	journal.offset = offset;
+	journal_saved_offset = journal.offset;
+
+	return false;
+}
+#else
+static void journal_begin(size_t file_size)
+{
+}
+
+static void journal_update(size_t len)
+{
+}
+
+static bool partial_image_is_stale(size_t offset, size_t file_size)
+{
+	/* Without a journal, only a partial image from this boot can be resumed */
+	return atomic_test_bit(&flags, FLAG_NEW_URI);
+}
+#endif /* CONFIG_FOTA_DOWNLOAD_JOURNAL */
+
 static void send_evt(enum fota_download_evt_id id)
 {
 	__ASSERT(id != FOTA_DOWNLOAD_EVT_PROGRESS, "use send_progress");
@@ -92,6 +295,13 @@ static void send_progress(int progress)
 
 static void stopped(void)
 {
+#if defined(CONFIG_FOTA_DOWNLOAD_JOURNAL)
+	if (!is_error() && !atomic_test_bit(&flags, FLAG_CANCEL)) {
+		journal_clear();
+	} else {
+		(void)journal_save();
+	}
+#endif
 	atomic_clear_bit(&flags, FLAG_DOWNLOADING);
 	if (is_error()) {
 		send_error_evt();
@@ -172,7 +382,7 @@ static int download_client_callback(const struct download_client_evt *event)
 
 			/* Is there a DFU already running? */
 			if (offset != 0) {
-				if (atomic_test_bit(&flags, FLAG_NEW_URI)) {
+				if (partial_image_is_stale(offset, file_size)) {
 					atomic_clear_bit(&flags, FLAG_RESUME);
 					/* Image is different, reset DFU target */
 					err = dfu_target_reset();
@@ -191,6 +401,7 @@ static int download_client_callback(const struct download_client_evt *event)
 						set_error_state(FOTA_DOWNLOAD_ERROR_CAUSE_INTERNAL);
 						goto error_and_close;
 					}
+					journal_begin(file_size);
 				} else {
 					/* Abort current download procedure, and
 					 * schedule new download from offset.
@@ -205,6 +416,7 @@ static int download_client_callback(const struct download_client_evt *event)
 				}
 			} else {
 				atomic_clear_bit(&flags, FLAG_RESUME);
+				journal_begin(file_size);
 			}
 		}
 
@@ -220,6 +432,8 @@ static int download_client_callback(const struct download_client_evt *event)
 			goto error_and_close;
 		}
 
+		journal_update(event->fragment.len);
+
 		if (IS_ENABLED(CONFIG_FOTA_DOWNLOAD_PROGRESS_EVT)) {
 			err = dfu_target_offset_get(&offset);
 			if (err != 0) {
@@ -545,6 +759,15 @@ int fota_download_init(fota_download_callback_t client_callback)
 	}
 #endif
 
+#ifdef CONFIG_FOTA_DOWNLOAD_JOURNAL
+	/* settings_subsys_init is idempotent so this is safe to do. */
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("settings_subsys_init failed (err %d)", err);
+		return err;
+	}
+#endif
+
 	k_work_init_delayable(&dlc_with_offset_work, download_with_offset);
 
 	err = download_client_init(&dlc, download_client_callback);
@@ -50,6 +50,12 @@ enum nrf_cloud_rcv_topic {
 /** Format identifier for remainder of this binary blob */
 #define NRF_CLOUD_DICT_LOG_FMT 0x0001
 
+/** Format identifier for a dictionary-based log compressed as one LZ4 block.
+ *  The header is followed by the uncompressed length as a little-endian uint32_t,
+ *  then by the LZ4 block.
+ */
+#define NRF_CLOUD_DICT_LOG_LZ_FMT 0x0002
+
 /** @brief Header preceding binary blobs so nRF Cloud can
  *  process them in correct order using ts_ms and sequence fields.
  */
@@ -66,6 +72,9 @@ struct nrf_cloud_bin_hdr {
 	uint32_t sequence;
 } __packed;
 
+/** Size of the header preceding the LZ4 block of a compressed dictionary-based log */
+#define NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE (sizeof(struct nrf_cloud_bin_hdr) + sizeof(uint32_t))
+
 /** @brief Structure to receive dynamically allocated strings containing
  *  details for FOTA job update.
  */
@@ -43,6 +43,87 @@ void logs_init_context(void *rest_ctx, const char *dev_id, int log_level,
 		       uint8_t dom_id, int64_t ts,
 		       struct nrf_cloud_log_context *context);
 
+/** @brief The most recent log message passed on, to suppress repetitions of it */
+struct nrf_cloud_log_dedup {
+	/** CRC32 over the source, level and log package of the message */
+	uint32_t crc;
+	uint32_t src_id;
+	uint8_t dom_id;
+	int level;
+	/** Uptime in ms when the message was passed on */
+	int64_t uptime_ms;
+	/** Time in ms during which repetitions are suppressed */
+	uint32_t window_ms;
+	/** Number of suppressed repetitions */
+	uint32_t repeats;
+	bool valid;
+};
+
+/** @brief Token bucket of a log source */
+struct nrf_cloud_log_token_bucket {
+	/** Tokens in thousandths of a message */
+	uint32_t tokens;
+	/** Lower 32 bits of the uptime in ms at the last refill */
+	uint32_t last_ms;
+};
+
+/** @brief Per-source rate limiter for log messages */
+struct nrf_cloud_log_rate_limit {
+	/** Sustained number of messages per second per source */
+	uint32_t lines_per_sec;
+	/** Number of messages a source can send in a burst */
+	uint32_t burst;
+	/** Buckets of the sources; the last one is shared by sources beyond the array */
+	struct nrf_cloud_log_token_bucket *buckets;
+	size_t bucket_cnt;
+	/** Set once the buckets are filled */
+	bool initialized;
+};
+
+/**
+ * @brief Check whether a log message repeats the most recent one.
+ *
+ * A repetition is counted in dedup->repeats.
+ *
+ * @return true if the message is a repetition within the window and must be suppressed.
+ */
+bool nrf_cloud_log_dedup_check(struct nrf_cloud_log_dedup *dedup, uint32_t crc, int64_t now_ms);
+
+/** @brief Record a log message that was passed on as the most recent one. */
+void nrf_cloud_log_dedup_set(struct nrf_cloud_log_dedup *dedup, uint32_t crc,
+			     uint32_t src_id, uint8_t dom_id, int level, int64_t now_ms);
+
+/**
+ * @brief Take the repetitions of the most recent message once its window has passed.
+ *
+ * Later repetitions of the message are no longer suppressed, so the repetitions
+ * counted so far can be reported without waiting for the next message.
+ *
+ * @return Number of repetitions to report, 0 if there are none or the window has not passed.
+ */
+uint32_t nrf_cloud_log_dedup_flush(struct nrf_cloud_log_dedup *dedup, int64_t now_ms);
+
+/**
+ * @brief Take a token for a log message from the bucket of its source.
+ *
+ * @return true if the message can be passed on, false if it must be dropped.
+ */
+bool nrf_cloud_log_rate_limit_take(struct nrf_cloud_log_rate_limit *limit, uint32_t src_id,
+				   uint32_t now_ms);
+
+/**
+ * @brief Compress a dictionary-based log block.
+ *
+ * The block starts with a struct nrf_cloud_bin_hdr. The output has the same header with
+ * the NRF_CLOUD_DICT_LOG_LZ_FMT format, followed by the uncompressed length as a
+ * little-endian uint32_t and a single LZ4 block.
+ *
+ * @retval Length of the output.
+ * @retval -EINVAL The block or the output buffer is too small to hold the header.
+ * @retval -ENOSPC The compressed block is not smaller, or does not fit in the output.
+ */
+int nrf_cloud_log_dict_compress(const uint8_t *block, size_t len, uint8_t *out, size_t out_size);
+
 #ifdef __cplusplus
 }
 #endif
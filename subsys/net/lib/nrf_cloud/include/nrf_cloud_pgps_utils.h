@@ -36,6 +36,23 @@ extern "C" {
 #define BLOCK_SIZE			PGPS_PREDICTION_STORAGE_SIZE
 #define NO_BLOCK			-1
 
+#define NPGPS_NO_SAVED_BLOCK		0xFFU
+#define NPGPS_VALID_WORDS		DIV_ROUND_UP(NUM_PREDICTIONS, 32)
+
+/* Location of each stored prediction, saved together with the P-GPS header,
+ * so predictions can be found at boot without reading every storage slot.
+ */
+struct npgps_saved_index {
+	/* Identifies the prediction set; must match the saved P-GPS header */
+	int16_t gps_day;
+	uint16_t prediction_count;
+	int32_t gps_time_of_day;
+	/* Storage block of each prediction in time order, or NPGPS_NO_SAVED_BLOCK */
+	uint8_t block[NUM_PREDICTIONS];
+	/* Bitmap of predictions which passed full validation */
+	uint32_t validated[NPGPS_VALID_WORDS];
+};
+
 struct gps_location {
 	int32_t latitude;
 	int32_t longitude;
@@ -55,6 +72,8 @@ void npgps_download_unlock(void);
 /* settings functions */
 int npgps_save_header(struct nrf_cloud_pgps_header *header);
 const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
+int npgps_save_index(const struct npgps_saved_index *saved);
+const struct npgps_saved_index *npgps_get_saved_index(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
@@ -320,3 +320,11 @@ bool nrf_cloud_is_dict_logging_enabled(void)
 	return IS_ENABLED(CONFIG_NRF_CLOUD_LOG_BACKEND) &&
 	       IS_ENABLED(CONFIG_LOG_BACKEND_NRF_CLOUD_OUTPUT_DICTIONARY);
 }
+
+#if !defined(CONFIG_NRF_CLOUD_LOG_BACKEND)
+int nrf_cloud_log_stats_get(struct nrf_cloud_log_stats *stats)
+{
+	ARG_UNUSED(stats);
+	return -ENOTSUP;
+}
+#endif
@@ -12,6 +12,7 @@
 #include <zephyr/logging/log_backend.h>
 #include <zephyr/sys/ring_buffer.h>
 #include <zephyr/sys/base64.h>
+#include <zephyr/sys/crc.h>
 #include <date_time.h>
 #include "nrf_cloud_fsm.h"
 #include "nrf_cloud_mem.h"
@@ -51,18 +52,34 @@ static const struct log_backend_api logger_api = {
 	.notify		= logger_notify
 };
 
-static struct nrf_cloud_log_stats {
-	/** Total number of lines logged */
-	uint32_t lines_rendered;
-	/** Total number of bytes (before TLS) logged */
-	uint32_t bytes_rendered;
-	/** Total number of lines sent */
-	uint32_t lines_sent;
-	/** Total number of bytes (before TLS) sent */
-	uint32_t bytes_sent;
-	/** Total number of bytes (before TLS) sent */
-	uint32_t lines_dropped;
-} stats;
+static struct nrf_cloud_log_stats stats;
+
+#if defined(CONFIG_NRF_CLOUD_LOG_DEDUP)
+static struct nrf_cloud_log_dedup dedup = {
+	.window_ms = CONFIG_NRF_CLOUD_LOG_DEDUP_WINDOW_MS,
+};
+
+/* Wakes the logging thread when the window of a repeated message ends, so that the
+ * repetitions are reported even if no other message follows.
+ */
+static void dedup_flush_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(dedup_flush_work, dedup_flush_work_fn);
+#endif
+
+#if defined(CONFIG_NRF_CLOUD_LOG_RATE_LIMIT)
+static struct nrf_cloud_log_token_bucket buckets[CONFIG_NRF_CLOUD_LOG_RATE_LIMIT_SOURCES];
+static struct nrf_cloud_log_rate_limit rate_limit = {
+	.lines_per_sec = CONFIG_NRF_CLOUD_LOG_RATE_LIMIT_LINES_PER_SEC,
+	.burst = CONFIG_NRF_CLOUD_LOG_RATE_LIMIT_BURST,
+	.buckets = buckets,
+	.bucket_cnt = ARRAY_SIZE(buckets),
+};
+#endif
+
+#if defined(CONFIG_NRF_CLOUD_LOG_COMPRESS)
+/* Compressed output; 1 extra byte so the buffer can be null terminated like the ring buffer */
+static uint8_t lz_buf[CONFIG_NRF_CLOUD_LOG_RING_BUF_SIZE + 1];
+#endif
 
 /* Information about a log message is stored in the log_context by the logger_process backend
  * function, then used by the logger_out function when encoding messages for transport.
@@ -218,6 +235,62 @@ static int log_msg_filter(uint32_t src_id, int level)
 	return 0;
 }
 
+#if defined(CONFIG_NRF_CLOUD_LOG_DEDUP)
+static uint32_t msg_crc_get(struct log_msg *msg, uint32_t src_id, int level)
+{
+	uint32_t crc;
+	uint8_t *data;
+	size_t len;
+
+	crc = crc32_ieee_update(0, (const uint8_t *)&src_id, sizeof(src_id));
+	crc = crc32_ieee_update(crc, (const uint8_t *)&level, sizeof(level));
+	data = log_msg_get_package(msg, &len);
+	crc = crc32_ieee_update(crc, data, len);
+	data = log_msg_get_data(msg, &len);
+
+	return crc32_ieee_update(crc, data, len);
+}
+
+static void dedup_flush_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	/* The state is only accessed by the logging thread, see logger_notify() */
+	log_thread_trigger();
+}
+
+static void dedup_summary_send(uint32_t repeats)
+{
+	const char *src_name;
+	int len;
+
+	/* A line of text cannot be mixed into a binary dictionary log */
+	if (log_format_current != LOG_OUTPUT_TEXT) {
+		return;
+	}
+
+	src_name = dedup.src_id != UNKNOWN_LOG_SOURCE ?
+		   log_source_name_get(dedup.dom_id, dedup.src_id) : NULL;
+	logs_init_context(rest_ctx, device_id, dedup.level, dedup.src_id, src_name,
+			  dedup.dom_id, k_uptime_get(), &log_context);
+
+	len = snprintk((char *)log_buf, CONFIG_NRF_CLOUD_LOG_BUF_SIZE,
+		       "Previous message repeated %u times", repeats);
+	if (len > 0) {
+		(void)logger_out(log_buf, MIN(len, CONFIG_NRF_CLOUD_LOG_BUF_SIZE - 1), NULL);
+	}
+}
+
+static void dedup_update(uint32_t crc, uint32_t src_id, uint8_t dom_id, int level)
+{
+	if (dedup.valid && dedup.repeats) {
+		dedup_summary_send(dedup.repeats);
+	}
+
+	nrf_cloud_log_dedup_set(&dedup, crc, src_id, dom_id, level, k_uptime_get());
+}
+#endif /* CONFIG_NRF_CLOUD_LOG_DEDUP */
+
 static void logger_process(const struct log_backend *const backend, union log_msg_generic *msg)
 {
 	log_format_func_t log_output_func;
@@ -236,6 +309,29 @@ static void logger_process(const struct log_backend *const backend, union log_ms
 		return;
 	}
 
+#if defined(CONFIG_NRF_CLOUD_LOG_DEDUP)
+	uint32_t crc = msg_crc_get(&msg->log, src_id, level);
+
+	if (nrf_cloud_log_dedup_check(&dedup, crc, k_uptime_get())) {
+		stats.lines_deduplicated++;
+		/* Not rescheduled by later repetitions, the window starts with the first message */
+		k_work_schedule(&dedup_flush_work,
+				K_MSEC(dedup.uptime_ms + dedup.window_ms - k_uptime_get()));
+		return;
+	}
+#endif
+
+#if defined(CONFIG_NRF_CLOUD_LOG_RATE_LIMIT)
+	if (!nrf_cloud_log_rate_limit_take(&rate_limit, src_id, k_uptime_get_32())) {
+		stats.lines_rate_limited++;
+		return;
+	}
+#endif
+
+#if defined(CONFIG_NRF_CLOUD_LOG_DEDUP)
+	dedup_update(crc, src_id, dom_id, level);
+#endif
+
 	const char *src_name = src_id != UNKNOWN_LOG_SOURCE ?
 			       log_source_name_get(dom_id, src_id) : NULL;
 	int64_t ts = log_output_timestamp_to_us(log_msg_get_timestamp(&msg->log)) / 1000U;
@@ -257,6 +353,12 @@ static void logger_dropped(const struct log_backend *const backend, uint32_t cnt
 static void logger_panic(const struct log_backend *const backend)
 {
 	if (backend == &log_nrf_cloud_backend) {
+#if defined(CONFIG_NRF_CLOUD_LOG_DEDUP)
+		if (dedup.valid && dedup.repeats) {
+			dedup_summary_send(dedup.repeats);
+			dedup.repeats = 0;
+		}
+#endif
 		log_output_flush(&log_nrf_cloud_output);
 	}
 }
@@ -311,20 +413,73 @@ static void logger_notify(const struct log_backend *const backend, enum log_back
 		return;
 	}
 
+#if defined(CONFIG_NRF_CLOUD_LOG_DEDUP)
+	uint32_t repeats = nrf_cloud_log_dedup_flush(&dedup, k_uptime_get());
+
+	if (repeats) {
+		dedup_summary_send(repeats);
+	}
+#endif
+
 	/* Flush our transmission buffer */
 	send_ring_buffer();
 	if (CONFIG_NRF_CLOUD_LOG_LOG_LEVEL >= LOG_LEVEL_DBG) {
 		LOG_DBG("Buffered lines:%u, bytes:%u; logged lines:%u, bytes:%u; "
-			"sent lines:%u, bytes:%u; dropped lines:%u",
+			"sent lines:%u, bytes:%u; dropped lines:%u; "
+			"deduplicated lines:%u, rate limited lines:%u; compression:%u%%",
 			log_buffered_cnt(), ring_buf_size_get(&log_nrf_cloud_rb),
 			stats.lines_rendered, stats.bytes_rendered,
 			stats.lines_sent, stats.bytes_sent,
-			stats.lines_dropped);
+			stats.lines_dropped,
+			stats.lines_deduplicated, stats.lines_rate_limited,
+			stats.bytes_uncompressed ?
+			(uint32_t)((uint64_t)stats.bytes_compressed * 100U /
+				   stats.bytes_uncompressed) : 100U);
 	} else {
 		LOG_INF("Sent lines:%u, bytes:%u", stats.lines_sent, stats.bytes_sent);
 	}
 }
 
+int nrf_cloud_log_stats_get(struct nrf_cloud_log_stats *out)
+{
+	if (!out) {
+		return -EINVAL;
+	}
+
+	*out = stats;
+	return 0;
+}
+
+#if defined(CONFIG_NRF_CLOUD_LOG_COMPRESS)
+/* Replace the dictionary log block in output with its compressed form, if smaller. */
+static void dict_block_compress(struct nrf_cloud_tx_data *output)
+{
+	size_t raw_len;
+	int len;
+
+	if (output->data.len <= NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE) {
+		return;
+	}
+
+	raw_len = output->data.len - sizeof(struct nrf_cloud_bin_hdr);
+	len = nrf_cloud_log_dict_compress(output->data.ptr, output->data.len,
+					  lz_buf, sizeof(lz_buf) - 1);
+	if (len < 0) {
+		stats.bytes_uncompressed += raw_len;
+		stats.bytes_compressed += raw_len;
+		return;
+	}
+
+	output->data.ptr = lz_buf;
+	output->data.len = len;
+	lz_buf[output->data.len] = '\0';
+
+	stats.bytes_uncompressed += raw_len;
+	stats.bytes_compressed += len - sizeof(struct nrf_cloud_bin_hdr);
+	LOG_DBG("Compressed %zu bytes to %d", raw_len, len);
+}
+#endif /* CONFIG_NRF_CLOUD_LOG_COMPRESS */
+
 static int send_ring_buffer(void)
 {
 	int err = 0;
@@ -363,6 +518,12 @@ static int send_ring_buffer(void)
 
 	p[output.data.len] = '\0';
 
+#if defined(CONFIG_NRF_CLOUD_LOG_COMPRESS)
+	if (log_format_current == LOG_OUTPUT_DICT) {
+		dict_block_compress(&output);
+	}
+#endif
+
 	LOG_DBG("Ready to transmit %zd bytes...", output.data.len);
 	if (IS_ENABLED(CONFIG_NRF_CLOUD_MQTT)) {
 		err = nrf_cloud_send(&output);
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Suppression of repeated messages, per-source rate limiting and compression of
+ * dictionary log blocks for the nRF Cloud logging backend.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <net/nrf_cloud.h>
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_log_internal.h"
+
+#if defined(CONFIG_LZ4)
+#include <lz4.h>
+#endif
+
+/* Tokens are kept in thousandths of a line so that a refill rate given in lines per
+ * second can be applied with millisecond resolution using integer arithmetic.
+ */
+#define TOKEN_SCALE 1000U
+
+bool nrf_cloud_log_dedup_check(struct nrf_cloud_log_dedup *dedup, uint32_t crc, int64_t now_ms)
+{
+	if (dedup->valid && (dedup->crc == crc) &&
+	    ((now_ms - dedup->uptime_ms) < dedup->window_ms)) {
+		dedup->repeats++;
+		return true;
+	}
+	return false;
+}
+
+void nrf_cloud_log_dedup_set(struct nrf_cloud_log_dedup *dedup, uint32_t crc,
+			     uint32_t src_id, uint8_t dom_id, int level, int64_t now_ms)
+{
+	dedup->crc = crc;
+	dedup->src_id = src_id;
+	dedup->dom_id = dom_id;
+	dedup->level = level;
+	dedup->uptime_ms = now_ms;
+	dedup->repeats = 0;
+	dedup->valid = true;
+}
+
+uint32_t nrf_cloud_log_dedup_flush(struct nrf_cloud_log_dedup *dedup, int64_t now_ms)
+{
+	uint32_t repeats = dedup->repeats;
+
+	if (!dedup->valid || !repeats || ((now_ms - dedup->uptime_ms) < dedup->window_ms)) {
+		return 0;
+	}
+
+	dedup->repeats = 0;
+	return repeats;
+}
+
+bool nrf_cloud_log_rate_limit_take(struct nrf_cloud_log_rate_limit *limit, uint32_t src_id,
+				   uint32_t now_ms)
+{
+	const uint32_t token_max = limit->burst * TOKEN_SCALE;
+	struct nrf_cloud_log_token_bucket *bucket;
+	uint32_t elapsed;
+
+	if (!limit->initialized) {
+		for (size_t i = 0; i < limit->bucket_cnt; i++) {
+			limit->buckets[i].tokens = token_max;
+			limit->buckets[i].last_ms = now_ms;
+		}
+		limit->initialized = true;
+	}
+
+	/* Sources beyond the table, and unknown sources, share the last bucket */
+	bucket = &limit->buckets[MIN(src_id, limit->bucket_cnt - 1)];
+
+	/* Limit the elapsed time so the refill below cannot overflow */
+	elapsed = MIN(now_ms - bucket->last_ms, token_max);
+	bucket->tokens = MIN(bucket->tokens + elapsed * limit->lines_per_sec, token_max);
+	bucket->last_ms = now_ms;
+
+	if (bucket->tokens < TOKEN_SCALE) {
+		return false;
+	}
+	bucket->tokens -= TOKEN_SCALE;
+	return true;
+}
+
+#if defined(CONFIG_LZ4)
+/* Shared by all blocks, the logging subsystem passes them to the backend one at a time. */
+static LZ4_stream_t lz4_state;
+
+int nrf_cloud_log_dict_compress(const uint8_t *block, size_t len, uint8_t *out, size_t out_size)
+{
+	struct nrf_cloud_bin_hdr *hdr;
+	size_t raw_len;
+	int lz_len;
+
+	if ((len <= NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE) ||
+	    (out_size <= NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE)) {
+		return -EINVAL;
+	}
+
+	raw_len = len - sizeof(*hdr);
+	lz_len = LZ4_compress_fast_extState(&lz4_state, (const char *)block + sizeof(*hdr),
+					    (char *)out + NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE,
+					    raw_len, out_size - NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE, 1);
+	/* Not compressed if it does not fit, or is not smaller */
+	if ((lz_len <= 0) || ((lz_len + sizeof(uint32_t)) >= raw_len)) {
+		return -ENOSPC;
+	}
+
+	memcpy(out, block, sizeof(*hdr));
+	hdr = (struct nrf_cloud_bin_hdr *)out;
+	hdr->format = NRF_CLOUD_DICT_LOG_LZ_FMT;
+	sys_put_le32(raw_len, &out[sizeof(*hdr)]);
+
+	return NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE + lz_len;
+}
+#endif /* CONFIG_LZ4 */
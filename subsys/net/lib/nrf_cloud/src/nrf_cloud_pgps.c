@@ -88,6 +88,13 @@ struct pgps_index {
 	 * a pointer.
 	 */
 	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+	/* Bitmap of predictions, by prediction number, which passed full validation
+	 * against their expected time since they were stored.
+	 */
+	ATOMIC_DEFINE(validated, NUM_PREDICTIONS);
+#endif
 };
 
 static struct pgps_index index;
@@ -199,6 +206,139 @@ static struct nrf_cloud_pgps_prediction *get_prediction_slot(int slot, off_t *fl
 	return get_cached_prediction(off);
 }
 
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+static bool prediction_validated(int pnum)
+{
+	return atomic_test_bit(index.validated, pnum);
+}
+
+static void prediction_validated_set(int pnum, bool validated)
+{
+	atomic_set_bit_to(index.validated, pnum, validated);
+}
+
+static void save_prediction_index(void)
+{
+	struct npgps_saved_index saved;
+	int block;
+	int err;
+
+	memset(&saved, 0, sizeof(saved));
+	saved.gps_day = index.header.gps_day;
+	saved.gps_time_of_day = index.header.gps_time_of_day;
+	saved.prediction_count = index.header.prediction_count;
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		block = NO_BLOCK;
+		if ((pnum < saved.prediction_count) && index.predictions[pnum]) {
+			block = get_prediction_block(pnum);
+		}
+		if (block == NO_BLOCK) {
+			saved.block[pnum] = NPGPS_NO_SAVED_BLOCK;
+			continue;
+		}
+		saved.block[pnum] = (uint8_t)block;
+		if (prediction_validated(pnum)) {
+			saved.validated[pnum / 32] |= BIT(pnum % 32);
+		}
+	}
+
+	err = npgps_save_index(&saved);
+	if (err) {
+		LOG_ERR("Error saving prediction index:%d", err);
+	}
+}
+
+/* Set up the catalog of predictions from the saved index, if it belongs to the
+ * current prediction set. Returns false if the storage must be scanned instead.
+ */
+static bool load_prediction_index(void)
+{
+	const struct npgps_saved_index *saved = npgps_get_saved_index();
+	uint16_t count = index.header.prediction_count;
+	uint8_t block;
+
+	if ((saved->prediction_count != count) ||
+	    (saved->gps_day != index.header.gps_day) ||
+	    (saved->gps_time_of_day != index.header.gps_time_of_day)) {
+		LOG_DBG("Saved prediction index does not match header");
+		return false;
+	}
+
+	for (int pnum = 0; pnum < count; pnum++) {
+		block = saved->block[pnum];
+		/* A download may have stored more predictions than the index knows
+		 * about, so scan the storage if any prediction is missing.
+		 */
+		if (block >= NUM_BLOCKS) {
+			LOG_DBG("Prediction num:%d not in saved index", pnum);
+			memset(index.predictions, 0, sizeof(index.predictions));
+			memset(index.validated, 0, sizeof(index.validated));
+			return false;
+		}
+		index.predictions[pnum] = (struct nrf_cloud_pgps_prediction *)
+			(storage_addr + block * PGPS_PREDICTION_STORAGE_SIZE);
+		prediction_validated_set(pnum, saved->validated[pnum / 32] & BIT(pnum % 32));
+	}
+
+	LOG_DBG("Loaded saved prediction index");
+	return true;
+}
+#else
+static bool prediction_validated(int pnum)
+{
+	ARG_UNUSED(pnum);
+	return false;
+}
+
+static void prediction_validated_set(int pnum, bool validated)
+{
+	ARG_UNUSED(pnum);
+	ARG_UNUSED(validated);
+}
+
+static void save_prediction_index(void)
+{
+}
+
+static bool load_prediction_index(void)
+{
+	return false;
+}
+#endif /* CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX */
+
+/**
+ * @brief Check only the sentinel of a stored prediction, which is written after
+ * the rest of the prediction. This is enough for a prediction that was fully
+ * validated before, and avoids reading the whole prediction from external flash.
+ */
+static int validate_prediction_sentinel(int pnum, uint16_t gps_day, uint32_t gps_time_of_day)
+{
+	uint32_t expected_sentinel = npgps_gps_day_time_to_sec(gps_day, gps_time_of_day);
+	uint32_t stored_sentinel;
+	off_t off = (off_t)index.predictions[pnum] +
+		    offsetof(struct nrf_cloud_pgps_prediction, sentinel);
+
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+	int err = flash_area_read(prediction_flash_area, off - prediction_flash_area->fa_off,
+				  &stored_sentinel, sizeof(stored_sentinel));
+
+	if (err) {
+		LOG_ERR("Error %d reading sentinel from flash offset 0x%lx", err, off);
+		return err;
+	}
+#else
+	stored_sentinel = UNALIGNED_GET((uint32_t *)off);
+#endif
+
+	if (expected_sentinel != stored_sentinel) {
+		LOG_ERR("Prediction num:%d has stored_sentinel:0x%08X, expected:0x%08X",
+			pnum, stored_sentinel, expected_sentinel);
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
 				    struct nrf_cloud_pgps_prediction *p)
 {
@@ -336,12 +476,13 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	discard_prediction_buffer();
 	for (pnum = 0; pnum < count; pnum++) {
 		index.predictions[pnum] = NULL;
+		prediction_validated_set(pnum, false);
 	}
 
 	npgps_reset_block_pool();
 
-	/* build catalog of predictions by block */
-	for (i = 0; i < count; i++) {
+	/* build catalog of predictions by block, unless the saved index has it */
+	for (i = load_prediction_index() ? count : 0; i < count; i++) {
 		pred = (struct nrf_cloud_pgps_prediction *)get_prediction_slot(i, &off);
 		if (pred == NULL) {
 			LOG_ERR("Prediction at idx:%d not accessible", i);
@@ -369,7 +510,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		gps_sec = start_gps_sec + pnum * period_min * SEC_PER_MIN;
 		npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
 
-		pred = get_prediction(pnum);
+		pred = index.predictions[pnum];
 		if (pred == NULL) {
 			LOG_WRN("Prediction num:%u missing", pnum);
 			/* request partial data; download interrupted? */
@@ -378,8 +519,13 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 			break;
 		}
 
-		err = validate_prediction(pred, gps_day, gps_time_of_day,
-					  period_min, true, false);
+		if (prediction_validated(pnum)) {
+			err = validate_prediction_sentinel(pnum, gps_day, gps_time_of_day);
+		} else {
+			pred = get_prediction(pnum);
+			err = pred ? validate_prediction(pred, gps_day, gps_time_of_day,
+							 period_min, true, false) : -EIO;
+		}
 		if (err) {
 			LOG_ERR("Prediction num:%u, gps_day:%u, "
 				"gps_time_of_day:%u is bad:%d; loc:%p",
@@ -394,7 +540,17 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", pred);
 		npgps_mark_block_used(i, true);
+		prediction_validated_set(pnum, true);
+	}
+
+	/* drop predictions after the first bad one from the catalog, so the saved
+	 * index only refers to predictions that are in use
+	 */
+	for (int stale = pnum; stale < count; stale++) {
+		index.predictions[stale] = NULL;
+		prediction_validated_set(stale, false);
 	}
+	save_prediction_index();
 
 	/* find first free block in flash, if any, after chronologicaly
 	 * last good prediction, if any; this is where any new downloads
@@ -427,6 +583,39 @@ static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_da
 	}
 }
 
+/* Fully validate only the predictions stored since the last validation,
+ * then save the index so they are not read again at boot.
+ */
+static void validate_new_predictions(void)
+{
+	struct nrf_cloud_pgps_prediction *pred;
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)) {
+		return;
+	}
+
+	for (int pnum = 0; pnum < index.header.prediction_count; pnum++) {
+		if (!index.predictions[pnum] || prediction_validated(pnum)) {
+			continue;
+		}
+
+		get_prediction_day_time(pnum, NULL, &gps_day, &gps_time_of_day);
+		pred = get_prediction(pnum);
+		err = pred ? validate_prediction(pred, gps_day, gps_time_of_day,
+						 index.header.prediction_period_min,
+						 true, false) : -EIO;
+		if (err) {
+			LOG_WRN("Prediction num:%u did not validate:%d", pnum, err);
+			continue;
+		}
+		prediction_validated_set(pnum, true);
+	}
+	save_prediction_index();
+}
+
 static void discard_oldest_predictions(int num)
 {
 	int i;
@@ -454,6 +643,7 @@ static void discard_oldest_predictions(int num)
 	for (i = last; i < index.header.prediction_count; i++) {
 		pnum = i - last;
 		index.predictions[pnum] = index.predictions[i];
+		prediction_validated_set(pnum, prediction_validated(i));
 	}
 
 	/* set prediction pointers for 'last' in the newly empty
@@ -462,6 +652,7 @@ static void discard_oldest_predictions(int num)
 	for (pnum = index.header.prediction_count - last; pnum <
 	      index.header.prediction_count; pnum++) {
 		index.predictions[pnum] = NULL;
+		prediction_validated_set(pnum, false);
 	}
 	npgps_print_blocks();
 
@@ -680,6 +871,13 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	index.cur_pnum = pnum;
 	*prediction = get_prediction(pnum);
 	if (*prediction) {
+		if (prediction_validated(pnum) && !margin) {
+			/* The prediction matched its expected time when it was validated,
+			 * and pnum was chosen so that the current time falls within it.
+			 */
+			start_expiration_timer(pnum, cur_gps_sec);
+			return pnum;
+		}
 		err = validate_prediction(*prediction,
 					  cur_gps_day, cur_gps_time_of_day,
 					  period_min, false, margin);
@@ -1313,6 +1511,7 @@ int nrf_cloud_pgps_process_update(uint8_t *buf, size_t len)
 		}
 		log_pgps_header("pgps_header: ", header);
 		npgps_save_header(header);
+		save_prediction_index();
 
 		len -= sizeof(*header);
 		buf += sizeof(*header);
@@ -1518,6 +1717,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 				}
 
 				LOG_INF("All P-GPS data received. Done.");
+				validate_new_predictions();
 				state = PGPS_READY;
 				if (evt_handler) {
 					struct nrf_cloud_pgps_event evt = {
@@ -1588,10 +1788,14 @@ int nrf_cloud_pgps_begin_update(void)
 		index.period_sec =
 			index.header.prediction_period_min * SEC_PER_MIN;
 		memset(index.predictions, 0, sizeof(index.predictions));
+		for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+			prediction_validated_set(pnum, false);
+		}
 	} else {
 		for (uint8_t pnum = index.pnum_offset;
 		     pnum < index.expected_count + index.pnum_offset; pnum++) {
 			index.predictions[pnum] = NULL;
+			prediction_validated_set(pnum, false);
 		}
 	}
 	index.loading_count = 0;
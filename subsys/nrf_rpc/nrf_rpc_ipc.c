@@ -13,11 +13,31 @@
 #include <zephyr/ipc/ipc_service.h>
 
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/slist.h>
 
 LOG_MODULE_REGISTER(nrf_rpc_ipc, CONFIG_NRF_RPC_TR_LOG_LEVEL);
 
 #define EPT_BIND_TIMEOUT K_MSEC(CONFIG_NRF_RPC_IPC_SERVICE_BIND_TIMEOUT_MS)
 
+/* Header of the Tx buffers allocated here, rather than lent by the IPC Service backend. */
+struct tx_buf_hdr {
+	sys_snode_t node;
+	bool pooled;	/* From tx_pool, otherwise from the system heap. */
+};
+
+#define TX_POOL_BLOCK_SIZE \
+	ROUND_UP(sizeof(struct tx_buf_hdr) + CONFIG_NRF_RPC_IPC_TX_POOL_SIZE, sizeof(void *))
+
+/* Tx buffers used when the IPC Service backend cannot lend its shared memory buffers.
+ * Fixed size blocks, so that the pool holds exactly CONFIG_NRF_RPC_IPC_TX_POOL_PACKETS packets.
+ */
+static K_MEM_SLAB_DEFINE(tx_pool, TX_POOL_BLOCK_SIZE, CONFIG_NRF_RPC_IPC_TX_POOL_PACKETS,
+			 sizeof(void *));
+
+/* The allocated Tx buffers, to tell them from the buffers of the backend. */
+static sys_slist_t tx_bufs = SYS_SLIST_STATIC_INIT(&tx_bufs);
+static struct k_spinlock tx_bufs_lock;
+
 /* Utility macro for dumping content of the packets with limit of 32 bytes
  * to prevent overflowing the logs.
  */
@@ -145,11 +165,67 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 	return 0;
 }
 
+static void *tx_buf_hdr_alloc(size_t size)
+{
+	struct tx_buf_hdr *hdr = NULL;
+	k_spinlock_key_t key;
+
+	/* Do not wait for the pool, it may be held by the caller for a packet in progress. */
+	if (sizeof(*hdr) + size <= TX_POOL_BLOCK_SIZE &&
+	    k_mem_slab_alloc(&tx_pool, (void **)&hdr, K_NO_WAIT) == 0) {
+		hdr->pooled = true;
+	} else {
+		hdr = k_malloc(sizeof(*hdr) + size);
+		if (!hdr) {
+			return NULL;
+		}
+		hdr->pooled = false;
+	}
+
+	key = k_spin_lock(&tx_bufs_lock);
+	sys_slist_append(&tx_bufs, &hdr->node);
+	k_spin_unlock(&tx_bufs_lock, key);
+
+	return hdr + 1;
+}
+
+/* Returns the header of a buffer allocated by tx_buf_hdr_alloc(), and stops tracking it.
+ * Returns NULL for the buffers of the backend.
+ */
+static struct tx_buf_hdr *tx_buf_hdr_take(const void *buf)
+{
+	struct tx_buf_hdr *hdr;
+	struct tx_buf_hdr *prev = NULL;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&tx_bufs_lock);
+	SYS_SLIST_FOR_EACH_CONTAINER(&tx_bufs, hdr, node) {
+		if ((const void *)(hdr + 1) == buf) {
+			sys_slist_remove(&tx_bufs, prev ? &prev->node : NULL, &hdr->node);
+			break;
+		}
+		prev = hdr;
+	}
+	k_spin_unlock(&tx_bufs_lock, key);
+
+	return hdr;
+}
+
+static void tx_buf_hdr_free(struct tx_buf_hdr *hdr)
+{
+	if (hdr->pooled) {
+		k_mem_slab_free(&tx_pool, (void **)&hdr);
+	} else {
+		k_free(hdr);
+	}
+}
+
 int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 {
 	int err;
 	struct nrf_rpc_ipc *ipc_config = transport->ctx;
 	struct nrf_rpc_ipc_endpoint *endpoint = &ipc_config->endpoint;
+	struct tx_buf_hdr *hdr;
 
 	if (!ipc_config->used) {
 		LOG_ERR("nRF RPC transport is not initialized");
@@ -159,7 +235,18 @@ int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 	LOG_DBG("Sending %u bytes", length);
 	DUMP_LIMITED_DBG(data, length, "Data: ");
 
-	err = ipc_service_send(&endpoint->ept, data, length);
+	hdr = tx_buf_hdr_take(data);
+	if (hdr) {
+		err = ipc_service_send(&endpoint->ept, data, length);
+		tx_buf_hdr_free(hdr);
+	} else {
+		/* The buffer is in the shared memory and belongs to the backend after this. */
+		err = ipc_service_send_nocopy(&endpoint->ept, data, length);
+		if (err < 0) {
+			(void)ipc_service_drop_tx_buffer(&endpoint->ept, data);
+		}
+	}
+
 	if (err < 0) {
 		LOG_ERR("ipc_service_send returned err: %d", err);
 	} else if (err > 0) {
@@ -167,8 +254,6 @@ int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 		err = 0;
 	}
 
-	k_free((void *)data);
-
 	return translate_error(err);
 }
 
@@ -182,7 +267,20 @@ void *tx_buf_alloc(const struct nrf_rpc_tr *transport, size_t *size)
 		goto error;
 	}
 
-	data = k_malloc(*size);
+	if (IS_ENABLED(CONFIG_NRF_RPC_IPC_ZERO_COPY)) {
+		uint32_t len = *size;
+
+		/* Fall back to the pool if the backend does not support it or is out of
+		 * buffers, rather than wait for one.
+		 */
+		if (ipc_service_get_tx_buffer(&ipc_config->endpoint.ept, &data, &len,
+					      K_NO_WAIT) == 0) {
+			return data;
+		}
+	}
+
+	/* Buffers return to the pool or the heap as soon as they are sent. */
+	data = tx_buf_hdr_alloc(*size);
 	if (!data) {
 		LOG_ERR("Failed to allocate Tx buffer.");
 		goto error;
@@ -200,13 +298,19 @@ error:
 void tx_buf_free(const struct nrf_rpc_tr *transport, void *buf)
 {
 	struct nrf_rpc_ipc *ipc_config = transport->ctx;
+	struct tx_buf_hdr *hdr;
 
 	if (!ipc_config->used) {
 		LOG_ERR("nRF RPC transport is not initialized");
 		return;
 	}
 
-	k_free(buf);
+	hdr = tx_buf_hdr_take(buf);
+	if (hdr) {
+		tx_buf_hdr_free(hdr);
+	} else {
+		(void)ipc_service_drop_tx_buffer(&ipc_config->endpoint.ept, buf);
+	}
 }
 
 const struct nrf_rpc_tr_api nrf_rpc_ipc_service_api = {
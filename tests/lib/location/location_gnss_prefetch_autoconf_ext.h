@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Cause nrf/lib/location to act as though A-GPS with assistance data prefetching is enabled.
+ * The A-GPS data is requested from the application, see CONFIG_LOCATION_SERVICE_EXTERNAL.
+ */
+#define CONFIG_NRF_CLOUD_AGPS 1
+#define CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH 1
+#define CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH_LEAD_TIME 1
@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Cause nrf/lib/location to look up the Wi-Fi interface by the nRF700x device name, wlan0.
+ * The test provides an interface with that name.
+ */
+#define CONFIG_WIFI_NRF700X 1
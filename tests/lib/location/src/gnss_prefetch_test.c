@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <modem/at_monitor.h>
+#include <modem/location.h>
+#include <modem/lte_lc.h>
+#include <mock_nrf_modem_at.h>
+
+#include "cmock_nrf_modem_at.h"
+#include "cmock_nrf_modem_gnss.h"
+#include "cmock_modem_key_mgmt.h"
+#include "cmock_rest_client.h"
+
+/* NOTE: Sleep, e.g. k_sleep(K_MSEC(1)), is used after many location library API
+ *       function calls because otherwise some of the threaded work in location library
+ *       may not run.
+ */
+
+/* Same as in the library. */
+#define AGPS_EXPIRY_THRESHOLD (80 * 60)
+
+/* Periodic interval [s]. The prefetch window opens
+ * CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH_LEAD_TIME seconds before the next request.
+ */
+#define INTERVAL 2
+
+static struct nrf_modem_gnss_pvt_data_frame test_pvt_data;
+static struct location_gnss_assistance_stats stats_before;
+static int assistance_request_count;
+
+K_SEM_DEFINE(location_event_sem, 0, 1);
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT commands/notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+/* method_gnss_event_handler() is implemented in the library and we'll call it directly
+ * to fake received GNSS event.
+ */
+extern void method_gnss_event_handler(int event);
+
+/* A-GPS data is not injected in these tests. */
+int nrf_cloud_agps_process(const char *buf, size_t buf_len)
+{
+	return -ENOTSUP;
+}
+
+void setUp(void)
+{
+	memset(&test_pvt_data, 0, sizeof(test_pvt_data));
+	test_pvt_data.flags = NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID;
+	test_pvt_data.latitude = 61.005;
+	test_pvt_data.longitude = -45.997;
+	test_pvt_data.accuracy = 15.83;
+
+	assistance_request_count = 0;
+	k_sem_reset(&location_event_sem);
+
+	/* The statistics accumulate over the tests, the tests check the changes. */
+	(void)location_gnss_assistance_stats_get(&stats_before);
+
+	mock_nrf_modem_at_Init();
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_at_Verify();
+}
+
+static void location_event_handler(const struct location_event_data *event_data)
+{
+	switch (event_data->id) {
+	case LOCATION_EVT_GNSS_ASSISTANCE_REQUEST:
+		assistance_request_count++;
+		break;
+
+	case LOCATION_EVT_LOCATION:
+		TEST_ASSERT_EQUAL(LOCATION_METHOD_GNSS, event_data->method);
+		k_sem_give(&location_event_sem);
+		break;
+
+	default:
+		TEST_FAIL_MESSAGE("Unexpected location event");
+		break;
+	}
+}
+
+/* Sets all expiry times to the same value. */
+static void agps_expiry_set(struct nrf_modem_gnss_agps_expiry *expiry, uint16_t value)
+{
+	memset(expiry, 0, sizeof(*expiry));
+
+	for (int i = 0; i < NRF_MODEM_GNSS_NUM_GPS_SATELLITES; i++) {
+		expiry->ephe_expiry[i] = value;
+		expiry->alm_expiry[i] = value;
+	}
+
+	expiry->utc_expiry = value;
+	expiry->klob_expiry = value;
+	expiry->neq_expiry = value;
+	expiry->integrity_expiry = value;
+	expiry->position_expiry = value;
+}
+
+static void helper_agps_expiry_get_expect(uint16_t value)
+{
+	static struct nrf_modem_gnss_agps_expiry expiry;
+
+	agps_expiry_set(&expiry, value);
+
+	__cmock_nrf_modem_gnss_agps_expiry_get_ExpectAndReturn(NULL, 0);
+	__cmock_nrf_modem_gnss_agps_expiry_get_IgnoreArg_agps_expiry();
+	__cmock_nrf_modem_gnss_agps_expiry_get_ReturnMemThruPtr_agps_expiry(&expiry,
+									     sizeof(expiry));
+}
+
+/* Assistance data is requested from the application after the registration status check. */
+static void helper_assistance_request_expect(void)
+{
+	/* Not registered, the request timestamp is not stored. */
+	__mock_nrf_modem_at_scanf_ExpectAndReturn(
+		"AT+CEREG?", "+CEREG: %*u,%hu,%*[^,],\"%x\",", 0);
+}
+
+static void helper_gnss_start_expect(void)
+{
+	__cmock_nrf_modem_gnss_fix_interval_set_ExpectAndReturn(1, 0);
+	__cmock_nrf_modem_gnss_use_case_set_ExpectAndReturn(
+		NRF_MODEM_GNSS_USE_CASE_MULTIPLE_HOT_START, 0);
+	__cmock_nrf_modem_gnss_start_ExpectAndReturn(0);
+
+	/* TODO: Cannot determine the used system mode but it's set as zero by default in lte_lc */
+	__mock_nrf_modem_at_scanf_ExpectAndReturn(
+		"AT%XSYSTEMMODE?", "%%XSYSTEMMODE: %d,%d,%d,%d", 4);
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* LTE-M support */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* NB-IoT support */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* GNSS support */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(0); /* LTE preference */
+}
+
+static void helper_gnss_fix(void)
+{
+	__cmock_nrf_modem_gnss_read_ExpectAndReturn(
+		NULL, sizeof(test_pvt_data), NRF_MODEM_GNSS_DATA_PVT, 0);
+	__cmock_nrf_modem_gnss_read_IgnoreArg_buf();
+	__cmock_nrf_modem_gnss_read_ReturnMemThruPtr_buf(&test_pvt_data, sizeof(test_pvt_data));
+	__cmock_nrf_modem_gnss_stop_ExpectAndReturn(0);
+	method_gnss_event_handler(NRF_MODEM_GNSS_EVT_PVT);
+
+	/* Wait for location_event_handler call for 3 seconds.
+	 * If it doesn't happen, next assert will fail the test.
+	 */
+	TEST_ASSERT_EQUAL(0, k_sem_take(&location_event_sem, K_SECONDS(3)));
+}
+
+static void helper_stats_delta_check(uint32_t prefetches, uint32_t on_demand,
+				     uint32_t lte_wakeups, uint32_t warm_starts)
+{
+	struct location_gnss_assistance_stats stats;
+
+	TEST_ASSERT_EQUAL(0, location_gnss_assistance_stats_get(&stats));
+	TEST_ASSERT_EQUAL(prefetches, stats.prefetches - stats_before.prefetches);
+	TEST_ASSERT_EQUAL(on_demand, stats.on_demand - stats_before.on_demand);
+	TEST_ASSERT_EQUAL(lte_wakeups, stats.lte_wakeups - stats_before.lte_wakeups);
+	TEST_ASSERT_EQUAL(warm_starts, stats.warm_starts - stats_before.warm_starts);
+}
+
+/* Test successful initialization. */
+void test_location_init(void)
+{
+	int ret;
+
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	__cmock_modem_key_mgmt_exists_IgnoreAndReturn(0);
+	__cmock_modem_key_mgmt_write_IgnoreAndReturn(0);
+
+	ret = location_init(location_event_handler);
+	TEST_ASSERT_EQUAL(0, ret);
+}
+
+void test_location_gnss_assistance_stats_get_null(void)
+{
+	TEST_ASSERT_EQUAL(-EINVAL, location_gnss_assistance_stats_get(NULL));
+}
+
+/* Test that assistance data needed when GNSS is started is requested on demand, and that
+ * the request is counted as an LTE wakeup in RRC idle mode.
+ */
+void test_location_gnss_assistance_on_demand(void)
+{
+	int err;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_GNSS};
+
+	location_config_defaults_set(&config, 1, methods);
+	config.methods[0].gnss.timeout = 120 * MSEC_PER_SEC;
+	config.methods[0].gnss.accuracy = LOCATION_ACCURACY_NORMAL;
+
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	helper_agps_expiry_get_expect(0);
+	helper_assistance_request_expect();
+	helper_gnss_start_expect();
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(200));
+
+	TEST_ASSERT_EQUAL(1, assistance_request_count);
+
+	helper_gnss_fix();
+
+	helper_stats_delta_check(0, 1, 1, 0);
+}
+
+/* Test periodic requests:
+ * 1. The assistance data remains valid for less than the interval, so it is prefetched when
+ *    LTE enters RRC connected mode within the prefetch window.
+ * 2. The second request checks the assistance data need, which is remembered to be valid for
+ *    longer than the interval. The prefetch is skipped.
+ * 3. The third request starts GNSS without checking the assistance data need.
+ */
+void test_location_gnss_assistance_prefetch(void)
+{
+	int err;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_GNSS};
+
+	location_config_defaults_set(&config, 1, methods);
+	config.interval = INTERVAL;
+	config.methods[0].gnss.timeout = 120 * MSEC_PER_SEC;
+	config.methods[0].gnss.accuracy = LOCATION_ACCURACY_NORMAL;
+
+	/* 1. Valid for one second, expires before the next request. */
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	helper_agps_expiry_get_expect(AGPS_EXPIRY_THRESHOLD + 1);
+	helper_gnss_start_expect();
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(200));
+
+	helper_gnss_fix();
+
+	/* The prefetch window is open, but the prefetch waits for LTE to become active. */
+	k_sleep(K_MSEC(1300));
+	TEST_ASSERT_EQUAL(0, assistance_request_count);
+
+	helper_agps_expiry_get_expect(0);
+	helper_assistance_request_expect();
+	at_monitor_dispatch("+CSCON: 1");
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(1, assistance_request_count);
+	helper_stats_delta_check(1, 0, 0, 0);
+
+	at_monitor_dispatch("+CSCON: 0");
+
+	/* 2. The prefetch cleared the validity, so the need is checked again. */
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	helper_agps_expiry_get_expect(UINT16_MAX);
+	helper_gnss_start_expect();
+
+	k_sleep(K_MSEC(1000));
+	helper_gnss_fix();
+
+	/* 3. The prefetch in between must not query GNSS, nor does the request. */
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	helper_gnss_start_expect();
+
+	k_sleep(K_MSEC(INTERVAL * MSEC_PER_SEC + 500));
+	helper_gnss_fix();
+
+	TEST_ASSERT_EQUAL(1, assistance_request_count);
+	helper_stats_delta_check(1, 0, 0, 1);
+
+	__cmock_nrf_modem_gnss_stop_ExpectAndReturn(0);
+	err = location_request_cancel();
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(1));
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int location_test_sys_init(void)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
+
+SYS_INIT(location_test_sys_init, POST_KERNEL, 0);
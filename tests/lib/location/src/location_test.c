@@ -423,6 +423,76 @@ void test_location_cellular_cancel_during_ncellmeas(void)
 	k_sleep(K_MSEC(1));
 }
 
+/* Test time-to-fix statistics of a cellular location. */
+void test_location_ttff_stats(void)
+{
+	int err;
+	uint32_t hist_sum = 0;
+	struct location_ttff_stats stats;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_CELLULAR};
+
+	err = location_ttff_stats_get(NULL);
+	TEST_ASSERT_EQUAL(-EINVAL, err);
+
+	/* Do not depend on the locations acquired by the other tests */
+	location_ttff_stats_reset();
+
+	location_config_defaults_set(&config, 1, methods);
+	config.methods[0].cellular.cell_count = 2;
+
+	test_location_event_data.id = LOCATION_EVT_LOCATION;
+	test_location_event_data.location.latitude = 61.50375;
+	test_location_event_data.location.longitude = 23.896979;
+	test_location_event_data.location.accuracy = 750.0;
+	test_location_event_data.location.datetime.valid = false;
+
+	location_callback_called_expected = true;
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT+CGACT?", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)cgact_resp_active, sizeof(cgact_resp_active));
+
+	cellular_rest_req_resp_handle();
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(1));
+
+	at_monitor_dispatch(ncellmeas_resp);
+
+	/* Statistics are recorded before the event handler is called. Give the semaphore
+	 * back for tearDown().
+	 */
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_handler_called_sem, K_SECONDS(3)));
+	k_sem_give(&event_handler_called_sem);
+
+	err = location_ttff_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, err);
+
+	TEST_ASSERT_EQUAL(0, stats.gnss.fixes);
+	TEST_ASSERT_EQUAL(1, stats.cellular.fixes);
+	TEST_ASSERT_EQUAL(0, stats.wifi.fixes);
+	TEST_ASSERT_EQUAL(0, stats.wifi_cellular.fixes);
+
+	TEST_ASSERT_EQUAL(stats.cellular.min_ms, stats.cellular.max_ms);
+	TEST_ASSERT_EQUAL(stats.cellular.min_ms, stats.cellular.total_ms);
+	for (int i = 0; i < LOCATION_TTFF_HIST_BUCKETS; i++) {
+		hist_sum += stats.cellular.hist[i];
+	}
+	TEST_ASSERT_EQUAL(1, hist_sum);
+
+	location_ttff_stats_reset();
+
+	err = location_ttff_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(0, stats.gnss.fixes);
+	TEST_ASSERT_EQUAL(0, stats.cellular.fixes);
+}
+
 /********* GENERAL ERROR TESTS ***********************/
 
 /* Test location request with unknown method. */
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+#include <modem/at_monitor.h>
+#include <modem/location.h>
+#include <modem/lte_lc.h>
+#include <mock_nrf_modem_at.h>
+
+#include "cmock_nrf_modem_at.h"
+#include "cmock_nrf_modem_gnss.h"
+#include "cmock_modem_key_mgmt.h"
+#include "cmock_rest_client.h"
+
+/* NOTE: Sleep, e.g. k_sleep(K_MSEC(1)), is used after many location library API
+ *       function calls because otherwise some of the threaded work in location library
+ *       may not run.
+ */
+
+#define DEADLINE_MS CONFIG_LOCATION_SCAN_MERGE_DEADLINE_MS
+#define MAX_AGE_MS CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS
+
+/* The tests rely on the reused results expiring before the scan deadline. */
+BUILD_ASSERT(MAX_AGE_MS < DEADLINE_MS);
+
+static int wifi_scan_requests;
+static bool ext_request_cell_data;
+static int ext_request_wifi_cnt;
+
+K_SEM_DEFINE(ext_request_sem, 0, 1);
+K_SEM_DEFINE(location_event_sem, 0, 1);
+
+/* Strings for cellular positioning */
+static const char ncellmeas_resp[] =
+	"%NCELLMEAS:0,\"00011B07\",\"26295\",\"00B7\",2300,7,63,31,"
+	"150344527,2300,8,60,29,0,2400,11,55,26,184\r\n";
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT commands/notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+/* method_gnss_event_handler() is implemented in the library, needed for the initialization. */
+extern void method_gnss_event_handler(int event);
+/* scan_wifi_net_mgmt_event_handler() is implemented in the library and we'll call it directly
+ * to fake received Wi-Fi scan events.
+ */
+extern void scan_wifi_net_mgmt_event_handler(struct net_mgmt_event_callback *cb,
+					     uint32_t mgmt_event, struct net_if *iface);
+
+/* Wi-Fi interface the library looks up by name, see location_scan_autoconf_ext.h. */
+static void wlan0_iface_init(struct net_if *iface)
+{
+	ARG_UNUSED(iface);
+}
+
+static int wlan0_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return -ENOTSUP;
+}
+
+static struct dummy_api wlan0_api = {
+	.iface_api.init = wlan0_iface_init,
+	.send = wlan0_send,
+};
+
+NET_DEVICE_INIT(wlan0, "wlan0", NULL, NULL, NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&wlan0_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+/* Wi-Fi L2 is not enabled, the scan request is handled here. */
+int net_mgmt_NET_REQUEST_WIFI_SCAN(uint32_t mgmt_request, struct net_if *iface,
+				   void *data, size_t len)
+{
+	wifi_scan_requests++;
+
+	return 0;
+}
+
+void setUp(void)
+{
+	wifi_scan_requests = 0;
+	ext_request_cell_data = false;
+	ext_request_wifi_cnt = 0;
+	k_sem_reset(&ext_request_sem);
+	k_sem_reset(&location_event_sem);
+
+	/* Let the results of the previous test expire so that each test starts with new scans */
+	k_sleep(K_MSEC(MAX_AGE_MS + 1));
+
+	mock_nrf_modem_at_Init();
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_at_Verify();
+}
+
+static void location_event_handler(const struct location_event_data *event_data)
+{
+	const struct location_data_cloud *request = &event_data->cloud_location_request;
+
+	switch (event_data->id) {
+	case LOCATION_EVT_CLOUD_LOCATION_EXT_REQUEST:
+		ext_request_cell_data = request->cell_data != NULL;
+		ext_request_wifi_cnt = request->wifi_data != NULL ? request->wifi_data->cnt : 0;
+		k_sem_give(&ext_request_sem);
+		break;
+
+	case LOCATION_EVT_LOCATION:
+		k_sem_give(&location_event_sem);
+		break;
+
+	default:
+		TEST_FAIL_MESSAGE("Unexpected location event");
+		break;
+	}
+}
+
+static void helper_wifi_scan_results(int count)
+{
+	struct net_mgmt_event_callback cb = { 0 };
+	struct wifi_scan_result entry = {
+		.ssid = "Nordic",
+		.ssid_length = 6,
+		.channel = 1,
+		.rssi = -60,
+		.mac_length = WIFI_MAC_ADDR_LEN,
+	};
+
+	cb.info = &entry;
+	cb.info_length = sizeof(entry);
+
+	for (int i = 0; i < count; i++) {
+		entry.mac[WIFI_MAC_ADDR_LEN - 1] = i;
+		scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_RESULT, NULL);
+	}
+}
+
+static void helper_wifi_scan_done(void)
+{
+	struct net_mgmt_event_callback cb = { 0 };
+	struct wifi_status status = { .status = 0 };
+
+	cb.info = &status;
+	cb.info_length = sizeof(status);
+
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_DONE, NULL);
+}
+
+static void helper_location_request(void)
+{
+	int err;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_WIFI, LOCATION_METHOD_CELLULAR};
+
+	location_config_defaults_set(&config, ARRAY_SIZE(methods), methods);
+	config.methods[1].cellular.cell_count = 2;
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(1));
+}
+
+/* Checks the combined cloud request and completes the location request with its result. */
+static void helper_ext_request_check(bool cell_data, int wifi_cnt)
+{
+	struct location_data location = {
+		.latitude = 61.50375,
+		.longitude = 23.896979,
+		.accuracy = 30.0,
+	};
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&ext_request_sem, K_SECONDS(3)));
+	TEST_ASSERT_EQUAL(cell_data, ext_request_cell_data);
+	TEST_ASSERT_EQUAL(wifi_cnt, ext_request_wifi_cnt);
+
+	location_cloud_location_ext_result_set(LOCATION_EXT_RESULT_SUCCESS, &location);
+	TEST_ASSERT_EQUAL(0, k_sem_take(&location_event_sem, K_SECONDS(3)));
+}
+
+/* Test successful initialization. */
+void test_location_init(void)
+{
+	int ret;
+
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	__cmock_modem_key_mgmt_exists_IgnoreAndReturn(0);
+	__cmock_modem_key_mgmt_write_IgnoreAndReturn(0);
+
+	ret = location_init(location_event_handler);
+	TEST_ASSERT_EQUAL(0, ret);
+}
+
+/* Test that the cell measurement is cancelled at the deadline after the Wi-Fi scan has
+ * completed, and the Wi-Fi access points are sent alone.
+ */
+void test_location_scan_deadline_cellular(void)
+{
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	helper_location_request();
+	TEST_ASSERT_EQUAL(1, wifi_scan_requests);
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEASSTOP", 0);
+
+	helper_wifi_scan_results(3);
+	helper_wifi_scan_done();
+
+	k_sleep(K_MSEC(DEADLINE_MS - 10));
+	TEST_ASSERT_EQUAL(-EBUSY, k_sem_take(&ext_request_sem, K_NO_WAIT));
+
+	/* Cancelled before the first measurement result, so there are no cells */
+	helper_ext_request_check(false, 3);
+}
+
+/* Test that the Wi-Fi scan is cancelled at the deadline after the cell measurement has
+ * completed, and the access points found so far are sent with the cells.
+ */
+void test_location_scan_deadline_wifi(void)
+{
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	helper_location_request();
+
+	helper_wifi_scan_results(2);
+	at_monitor_dispatch(ncellmeas_resp);
+
+	k_sleep(K_MSEC(DEADLINE_MS - 10));
+	TEST_ASSERT_EQUAL(-EBUSY, k_sem_take(&ext_request_sem, K_NO_WAIT));
+
+	helper_ext_request_check(true, 2);
+}
+
+/* Test that a Wi-Fi scan completing after the cell measurement does not leave the deadline
+ * running, as it would cancel the cell measurement of the next request.
+ */
+void test_location_scan_deadline_not_left_running(void)
+{
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	helper_location_request();
+
+	at_monitor_dispatch(ncellmeas_resp);
+	k_sleep(K_MSEC(1));
+	helper_wifi_scan_results(3);
+	helper_wifi_scan_done();
+
+	helper_ext_request_check(true, 3);
+
+	/* Results are not reused any more, but the deadline has not expired yet */
+	k_sleep(K_MSEC(MAX_AGE_MS + 1));
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	helper_location_request();
+	TEST_ASSERT_EQUAL(2, wifi_scan_requests);
+
+	/* No AT%NCELLMEASSTOP is expected */
+	k_sleep(K_MSEC(DEADLINE_MS));
+
+	at_monitor_dispatch(ncellmeas_resp);
+	k_sleep(K_MSEC(1));
+	helper_wifi_scan_results(2);
+	helper_wifi_scan_done();
+
+	helper_ext_request_check(true, 2);
+}
+
+/* Test that recent scan results are reused instead of scanning again, and that they are
+ * not reused after CONFIG_LOCATION_SCAN_RESULTS_MAX_AGE_MS.
+ */
+void test_location_scan_results_reuse(void)
+{
+	int err;
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	helper_location_request();
+
+	at_monitor_dispatch(ncellmeas_resp);
+	k_sleep(K_MSEC(1));
+	helper_wifi_scan_results(3);
+	helper_wifi_scan_done();
+
+	helper_ext_request_check(true, 3);
+
+	/* No AT%NCELLMEAS or Wi-Fi scan request is expected */
+	helper_location_request();
+	TEST_ASSERT_EQUAL(1, wifi_scan_requests);
+
+	helper_ext_request_check(true, 3);
+
+	k_sleep(K_MSEC(MAX_AGE_MS + 1));
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	helper_location_request();
+	TEST_ASSERT_EQUAL(2, wifi_scan_requests);
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEASSTOP", 0);
+
+	err = location_request_cancel();
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(1));
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int location_test_sys_init(void)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
+
+SYS_INIT(location_test_sys_init, POST_KERNEL, 0);
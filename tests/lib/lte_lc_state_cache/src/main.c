@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <modem/lte_lc.h>
+#include <nrf_errno.h>
+#include <mock_nrf_modem_at.h>
+
+#include "cmock_nrf_modem_at.h"
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT notifications.
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+static const char cereg_roaming[] =
+	"+CEREG: 5,\"4321\",\"12345678\",7,,,\"11100000\",\"00010011\"\r\n";
+static const char cereg_searching[] = "+CEREG: 2\r\n";
+static const char xmonitor_resp[] =
+	"%XMONITOR: 5,\"Operator\",\"OP\",\"20065\",\"4321\",7,20,\"12345678\","
+	"334,6200,66,44,\"\","
+	"\"11100000\",\"00010011\",\"01001001\"";
+
+static struct lte_lc_state_cache_stats stats_start;
+
+static void notif_dispatch(const char *notif)
+{
+	static char buf[256];
+
+	strcpy(buf, notif);
+	at_monitor_dispatch(buf);
+
+	/* Notifications are handled from a work queue. */
+	k_sleep(K_MSEC(10));
+}
+
+static void stats_assert(uint32_t hits, uint32_t misses)
+{
+	struct lte_lc_state_cache_stats stats;
+
+	TEST_ASSERT_EQUAL(0, lte_lc_state_cache_stats_get(&stats));
+	TEST_ASSERT_EQUAL(hits, stats.hits - stats_start.hits);
+	TEST_ASSERT_EQUAL(misses, stats.misses - stats_start.misses);
+}
+
+static void lc_init(void)
+{
+	__mock_nrf_modem_at_scanf_ExpectAndReturn(
+		"AT%XSYSTEMMODE?", "%%XSYSTEMMODE: %d,%d,%d,%d", 4);
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* ltem_mode */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* nbiot_mode */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* gps_mode */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(0); /* mode_preference */
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%XSYSTEMMODE=%s,%c", EXIT_SUCCESS);
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CEREG=5", EXIT_SUCCESS);
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CSCON=1", EXIT_SUCCESS);
+
+	TEST_ASSERT_EQUAL(EXIT_SUCCESS, lte_lc_init());
+}
+
+static void lc_deinit(void)
+{
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CFUN=%d", EXIT_SUCCESS);
+
+	TEST_ASSERT_EQUAL(EXIT_SUCCESS, lte_lc_deinit());
+}
+
+static void nw_reg_status_query_expect(enum lte_lc_nw_reg_status status)
+{
+	__mock_nrf_modem_at_scanf_ExpectAndReturn(
+		"AT+CEREG?", "+CEREG: %*u,%hu,%*[^,],\"%x\",", 2);
+	__mock_nrf_modem_at_scanf_ReturnVarg_uint16(status);
+	__mock_nrf_modem_at_scanf_ReturnVarg_uint32(0x12345678);
+}
+
+void setUp(void)
+{
+	mock_nrf_modem_at_Init();
+
+	lc_init();
+
+	TEST_ASSERT_EQUAL(0, lte_lc_state_cache_stats_get(&stats_start));
+}
+
+void tearDown(void)
+{
+	lc_deinit();
+
+	mock_nrf_modem_at_Verify();
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int sys_init_helper(void)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+void test_state_cache_null(void)
+{
+	TEST_ASSERT_EQUAL(-EINVAL, lte_lc_state_get(NULL));
+	TEST_ASSERT_EQUAL(-EINVAL, lte_lc_state_cache_stats_get(NULL));
+}
+
+void test_state_cache_cereg(void)
+{
+	enum lte_lc_nw_reg_status status;
+	enum lte_lc_lte_mode mode;
+
+	notif_dispatch(cereg_roaming);
+
+	/* No AT commands are expected. */
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+	TEST_ASSERT_EQUAL(LTE_LC_NW_REG_REGISTERED_ROAMING, status);
+
+	TEST_ASSERT_EQUAL(0, lte_lc_lte_mode_get(&mode));
+	TEST_ASSERT_EQUAL(LTE_LC_LTE_MODE_LTEM, mode);
+
+	notif_dispatch(cereg_searching);
+
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+	TEST_ASSERT_EQUAL(LTE_LC_NW_REG_SEARCHING, status);
+
+	TEST_ASSERT_EQUAL(0, lte_lc_lte_mode_get(&mode));
+	TEST_ASSERT_EQUAL(LTE_LC_LTE_MODE_NONE, mode);
+
+	stats_assert(4, 0);
+}
+
+void test_state_cache_snapshot(void)
+{
+	struct lte_lc_state state;
+
+	notif_dispatch(cereg_roaming);
+	notif_dispatch("+CSCON: 1\r\n");
+
+	TEST_ASSERT_EQUAL(0, lte_lc_state_get(&state));
+	TEST_ASSERT_EQUAL(BIT(LTE_LC_STATE_NW_REG_STATUS) | BIT(LTE_LC_STATE_CELL) |
+			  BIT(LTE_LC_STATE_LTE_MODE) | BIT(LTE_LC_STATE_RRC_MODE),
+			  state.valid);
+	TEST_ASSERT_EQUAL(LTE_LC_NW_REG_REGISTERED_ROAMING, state.nw_reg_status);
+	TEST_ASSERT_EQUAL(0x12345678, state.cell.id);
+	TEST_ASSERT_EQUAL(0x4321, state.cell.tac);
+	TEST_ASSERT_EQUAL(LTE_LC_LTE_MODE_LTEM, state.lte_mode);
+	TEST_ASSERT_EQUAL(LTE_LC_RRC_MODE_CONNECTED, state.rrc_mode);
+
+	/* Taking a snapshot is not a getter call. */
+	stats_assert(0, 0);
+}
+
+void test_state_cache_psm(void)
+{
+	int tau, active_time;
+
+	notif_dispatch(cereg_roaming);
+
+	/* Without event handlers the PSM configuration is not read on registration. */
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT%%XMONITOR", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)xmonitor_resp, sizeof(xmonitor_resp));
+
+	TEST_ASSERT_EQUAL(0, lte_lc_psm_get(&tau, &active_time));
+	TEST_ASSERT_EQUAL(11400, tau);
+	TEST_ASSERT_EQUAL(-1, active_time);
+
+	tau = 0;
+	active_time = 0;
+
+	TEST_ASSERT_EQUAL(0, lte_lc_psm_get(&tau, &active_time));
+	TEST_ASSERT_EQUAL(11400, tau);
+	TEST_ASSERT_EQUAL(-1, active_time);
+
+	stats_assert(1, 1);
+
+	/* A registration update invalidates the PSM configuration. */
+	notif_dispatch(cereg_roaming);
+
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT%%XMONITOR", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)xmonitor_resp, sizeof(xmonitor_resp));
+
+	TEST_ASSERT_EQUAL(0, lte_lc_psm_get(&tau, &active_time));
+
+	stats_assert(1, 2);
+}
+
+void test_state_cache_func_mode(void)
+{
+	enum lte_lc_func_mode mode;
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CEREG=5", EXIT_SUCCESS);
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CSCON=1", EXIT_SUCCESS);
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CFUN=%d", EXIT_SUCCESS);
+	TEST_ASSERT_EQUAL(0, lte_lc_func_mode_set(LTE_LC_FUNC_MODE_NORMAL));
+
+	TEST_ASSERT_EQUAL(0, lte_lc_func_mode_get(&mode));
+	TEST_ASSERT_EQUAL(LTE_LC_FUNC_MODE_NORMAL, mode);
+
+	/* The resulting mode is only known to the modem. */
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CFUN=%d", EXIT_SUCCESS);
+	TEST_ASSERT_EQUAL(0, lte_lc_func_mode_set(LTE_LC_FUNC_MODE_DEACTIVATE_GNSS));
+
+	__mock_nrf_modem_at_scanf_ExpectAndReturn("AT+CFUN?", "+CFUN: %hu", 1);
+	__mock_nrf_modem_at_scanf_ReturnVarg_uint16(LTE_LC_FUNC_MODE_NORMAL);
+
+	TEST_ASSERT_EQUAL(0, lte_lc_func_mode_get(&mode));
+	TEST_ASSERT_EQUAL(LTE_LC_FUNC_MODE_NORMAL, mode);
+
+	stats_assert(1, 1);
+}
+
+void test_state_cache_max_age(void)
+{
+	enum lte_lc_nw_reg_status status;
+
+	notif_dispatch(cereg_roaming);
+
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+
+	k_sleep(K_MSEC(CONFIG_LTE_LC_STATE_CACHE_MAX_AGE_MS + 10));
+
+	nw_reg_status_query_expect(LTE_LC_NW_REG_REGISTERED_HOME);
+
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+	TEST_ASSERT_EQUAL(LTE_LC_NW_REG_REGISTERED_HOME, status);
+
+	/* The response refreshes the cache. */
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+	TEST_ASSERT_EQUAL(LTE_LC_NW_REG_REGISTERED_HOME, status);
+
+	stats_assert(2, 1);
+}
+
+void test_state_cache_not_subscribed(void)
+{
+	enum lte_lc_nw_reg_status status;
+
+	/* Forget the notification subscriptions. */
+	lc_deinit();
+
+	/* Without notifications, a response can not be cached. */
+	nw_reg_status_query_expect(LTE_LC_NW_REG_NOT_REGISTERED);
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+
+	nw_reg_status_query_expect(LTE_LC_NW_REG_NOT_REGISTERED);
+	TEST_ASSERT_EQUAL(0, lte_lc_nw_reg_status_get(&status));
+
+	stats_assert(0, 2);
+
+	/* For tearDown() */
+	lc_init();
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
+
+SYS_INIT(sys_init_helper, POST_KERNEL, 0);
@@ -195,6 +195,32 @@ int trace_backend_write_stub(const void *data, size_t len, int cmock_num_calls)
 	return (int)len;
 }
 
+/* Writes only half of the first fragment on the first call, the rest on later calls. */
+int trace_backend_write_vec_stub(const struct nrf_modem_trace_data *frags, size_t n_frags,
+				 int cmock_num_calls)
+{
+	static int n;
+	struct nrf_modem_trace_data *frag;
+	size_t written = 0;
+
+	trace_backend_write_cmock_num_calls = cmock_num_calls + 1;
+
+	for (size_t i = 0; i < n_frags; i++) {
+		frag = &write_frags[n++ % MAX_N_STATIC_FRAGS];
+		frag->data = frags[i].data;
+		frag->len = (cmock_num_calls == 0) ? frags[i].len / 2 : frags[i].len;
+
+		k_fifo_alloc_put(&write_fifo, frag);
+		written += frag->len;
+
+		if (cmock_num_calls == 0) {
+			break;
+		}
+	}
+
+	return (int)written;
+}
+
 /* Function implementing a mechanism to synchronize main testing thread with trace thread via
  * a semaphore. This is the last function in the execution flow that can be mocked.
  */
@@ -432,10 +458,58 @@ void test_nrf_modem_lib_trace_data_size(void)
 	TEST_ASSERT_EQUAL(1234, ret);
 }
 
+void test_trace_thread_handler_write_vec(void)
+{
+	struct nrf_modem_trace_data header = { 0 };
+	struct nrf_modem_trace_data data = { 0 };
+	struct nrf_modem_trace_data *write;
+
+	__cmock_trace_backend_init_ExpectAndReturn(nrf_modem_trace_processed, 0);
+	__cmock_nrf_modem_trace_get_Stub(nrf_modem_trace_get_stub);
+	__cmock_trace_backend_write_vec_Stub(trace_backend_write_vec_stub);
+	__cmock_trace_backend_deinit_Stub(trace_backend_deinit_stub);
+
+	trace_backend.write_vec = trace_backend_write_vec;
+
+	NRF_MODEM_LIB_ON_INIT_callback();
+
+	generate_trace_frag(&header);
+	generate_trace_frag(&data);
+	header.len = 100;
+
+	k_fifo_alloc_put(&get_fifo, &header);
+	k_fifo_alloc_put(&get_fifo, &data);
+
+	/* The first half of the header is written on its own. */
+	write = k_fifo_get(&write_fifo, K_FOREVER);
+	TEST_ASSERT_EQUAL_PTR(header.data, write->data);
+	TEST_ASSERT_EQUAL_size_t(50, write->len);
+
+	/* The rest of the header is resumed from where the backend stopped. */
+	write = k_fifo_get(&write_fifo, K_FOREVER);
+	TEST_ASSERT_EQUAL_PTR((const uint8_t *)header.data + 50, write->data);
+	TEST_ASSERT_EQUAL_size_t(50, write->len);
+
+	/* The remaining fragments are written in one call. */
+	write = k_fifo_get(&write_fifo, K_FOREVER);
+	TEST_ASSERT_EQUAL_PTR(data.data, write->data);
+	TEST_ASSERT_EQUAL_size_t(data.len, write->len);
+
+	TEST_ASSERT_EQUAL(1, nrf_modem_trace_get_cmock_num_calls);
+	TEST_ASSERT_EQUAL(3, trace_backend_write_cmock_num_calls);
+
+	nrf_modem_trace_get_error = -ESHUTDOWN;
+
+	wait_trace_deinit();
+
+	trace_backend.write_vec = NULL;
+}
+
 void test_nrf_modem_lib_trace_enotsup(void)
 {
 	int ret;
 	char buf[10];
+	struct nrf_modem_lib_trace_backend_stats stats;
 	struct nrf_modem_lib_trace_backend trace_backend_orig;
 
 	trace_backend_orig.read = trace_backend.read;
@@ -455,6 +529,9 @@ void test_nrf_modem_lib_trace_enotsup(void)
 	ret = nrf_modem_lib_trace_clear();
 	TEST_ASSERT_EQUAL(-ENOTSUP, ret);
 
+	ret = nrf_modem_lib_trace_backend_stats_get(&stats);
+	TEST_ASSERT_EQUAL(-ENOTSUP, ret);
+
 	trace_backend = trace_backend_orig;
 }
 
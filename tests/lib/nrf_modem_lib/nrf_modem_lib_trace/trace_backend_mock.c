@@ -21,6 +21,11 @@ int trace_backend_write(const void *data, size_t len)
 	return 0;
 }
 
+int trace_backend_write_vec(const struct nrf_modem_trace_data *frags, size_t n_frags)
+{
+	return 0;
+}
+
 size_t trace_backend_data_size(void)
 {
 	return 0;
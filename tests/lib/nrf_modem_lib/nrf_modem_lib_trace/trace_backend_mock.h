@@ -12,6 +12,8 @@ int trace_backend_deinit(void);
 
 int trace_backend_write(const void *data, size_t len);
 
+int trace_backend_write_vec(const struct nrf_modem_trace_data *frags, size_t n_frags);
+
 size_t trace_backend_data_size(void);
 
 int trace_backend_read(void *buf, size_t len);
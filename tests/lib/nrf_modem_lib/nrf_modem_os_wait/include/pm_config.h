@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PM_CONFIG_H__
+#define PM_CONFIG_H__
+
+/* The shared memory heap is never initialized by this test. */
+#define PM_NRF_MODEM_LIB_TX_ADDRESS 0
+
+#endif /* PM_CONFIG_H__ */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+
+#include <zephyr/kernel.h>
+#include <nrf_modem_os.h>
+
+#include "cmock_nrf_modem.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* Simulated time does not advance while the CPU is busy, use host time instead. */
+#include <native_rtc.h>
+#define TIME_NOW_US() native_rtc_gettime_us(RTC_CLOCK_REALTIME)
+#else
+#define TIME_NOW_US() k_cyc_to_us_floor64(k_cycle_get_32())
+#endif
+
+#define WAITERS_MAX 32
+#define WAITER_STACK_SIZE 1024
+#define WAITER_PRIO 1
+#define ITERATIONS 1000
+
+/* Referenced by the unit under test, normally defined in diag.c */
+uint32_t nrf_modem_lib_failed_allocs;
+uint32_t nrf_modem_lib_shmem_failed_allocs;
+
+static struct waiter {
+	struct k_thread thread;
+	uint32_t context;
+	atomic_t notified;
+} waiters[WAITERS_MAX];
+
+static K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, WAITERS_MAX, WAITER_STACK_SIZE);
+static K_SEM_DEFINE(woken_sem, 0, 1);
+static atomic_t stop;
+
+static void waiter_fn(void *p1, void *p2, void *p3)
+{
+	struct waiter *waiter = p1;
+	int32_t timeout;
+
+	while (!atomic_get(&stop)) {
+		timeout = NRF_MODEM_OS_FOREVER;
+		(void)nrf_modem_os_timedwait(waiter->context, &timeout);
+
+		if (atomic_cas(&waiter->notified, 1, 0)) {
+			k_sem_give(&woken_sem);
+		}
+	}
+}
+
+static void waiters_start(size_t count)
+{
+	atomic_clear(&stop);
+
+	for (size_t i = 0; i < count; i++) {
+		waiters[i].context = i + 1;
+		atomic_clear(&waiters[i].notified);
+
+		k_thread_create(&waiters[i].thread, waiter_stacks[i],
+				K_THREAD_STACK_SIZEOF(waiter_stacks[i]), waiter_fn,
+				&waiters[i], NULL, NULL, WAITER_PRIO, 0, K_NO_WAIT);
+	}
+
+	/* Let every waiter pass the initial readiness check and go to sleep. */
+	k_sleep(K_MSEC(10));
+}
+
+static void waiters_stop(size_t count)
+{
+	atomic_set(&stop, 1);
+	nrf_modem_os_event_notify(0);
+
+	for (size_t i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL(0, k_thread_join(&waiters[i].thread, K_SECONDS(1)));
+	}
+}
+
+/* Measures the time from notifying a context until the thread waiting on it runs,
+ * while the other threads stay blocked on their own contexts.
+ */
+static void wakeup_latency_measure(size_t count)
+{
+	struct waiter *target;
+	uint64_t start, elapsed = 0;
+
+	waiters_start(count);
+
+	for (size_t n = 0; n < ITERATIONS; n++) {
+		target = &waiters[n % count];
+		atomic_set(&target->notified, 1);
+
+		start = TIME_NOW_US();
+		nrf_modem_os_event_notify(target->context);
+		TEST_ASSERT_EQUAL(0, k_sem_take(&woken_sem, K_SECONDS(1)));
+		elapsed += TIME_NOW_US() - start;
+
+		/* Let the target thread go back to sleep. */
+		k_sleep(K_MSEC(1));
+	}
+
+	waiters_stop(count);
+
+	printk("Blocked threads: %2zu, average wakeup latency [ns]: %llu\n",
+	       count, (unsigned long long)(elapsed * 1000 / ITERATIONS));
+}
+
+void setUp(void)
+{
+	__cmock_nrf_modem_is_initialized_IgnoreAndReturn(1);
+}
+
+void tearDown(void)
+{
+}
+
+void test_nrf_modem_os_wakeup_latency(void)
+{
+	for (size_t count = 1; count <= WAITERS_MAX; count *= 2) {
+		wakeup_latency_measure(count);
+	}
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
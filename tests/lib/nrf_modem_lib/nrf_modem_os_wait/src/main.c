@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+
+#include <zephyr/kernel.h>
+#include <nrf_modem_os.h>
+#include <nrf_errno.h>
+
+#include "cmock_nrf_modem.h"
+
+#define WAITERS_MAX 32
+#define WAITER_STACK_SIZE 1024
+#define WAITER_PRIO 1
+#define ITERATIONS 100
+/* Fewer than the thread monitor entries in the unit under test */
+#define TIMEOUT_WAITERS 12
+#define TIMEOUT_WAITS 20
+#define TIMEOUT_MS 5
+
+/* Referenced by the unit under test, normally defined in diag.c */
+uint32_t nrf_modem_lib_failed_allocs;
+uint32_t nrf_modem_lib_shmem_failed_allocs;
+
+static struct waiter {
+	struct k_thread thread;
+	uint32_t context;
+	atomic_t notified;
+	atomic_t returns;
+	atomic_t early_returns;
+} waiters[WAITERS_MAX];
+
+static K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, WAITERS_MAX, WAITER_STACK_SIZE);
+static K_SEM_DEFINE(woken_sem, 0, 1);
+static atomic_t stop;
+
+static void waiter_fn(void *p1, void *p2, void *p3)
+{
+	struct waiter *waiter = p1;
+	int32_t timeout;
+
+	while (!atomic_get(&stop)) {
+		timeout = NRF_MODEM_OS_FOREVER;
+		(void)nrf_modem_os_timedwait(waiter->context, &timeout);
+
+		atomic_inc(&waiter->returns);
+		if (atomic_cas(&waiter->notified, 1, 0)) {
+			k_sem_give(&woken_sem);
+		}
+	}
+}
+
+static void timeout_waiter_fn(void *p1, void *p2, void *p3)
+{
+	struct waiter *waiter = p1;
+	int32_t timeout;
+
+	for (size_t i = 0; i < TIMEOUT_WAITS; i++) {
+		timeout = TIMEOUT_MS;
+		if (nrf_modem_os_timedwait(waiter->context, &timeout) == 0) {
+			/* Returned without an event or a timeout, to re-check readiness */
+			atomic_inc(&waiter->early_returns);
+		}
+	}
+}
+
+static void waiters_create(size_t count, k_thread_entry_t fn)
+{
+	for (size_t i = 0; i < count; i++) {
+		waiters[i].context = i + 1;
+		atomic_clear(&waiters[i].notified);
+		atomic_clear(&waiters[i].returns);
+		atomic_clear(&waiters[i].early_returns);
+
+		k_thread_create(&waiters[i].thread, waiter_stacks[i],
+				K_THREAD_STACK_SIZEOF(waiter_stacks[i]), fn,
+				&waiters[i], NULL, NULL, WAITER_PRIO, 0, K_NO_WAIT);
+	}
+}
+
+static void waiters_start(size_t count)
+{
+	atomic_clear(&stop);
+
+	waiters_create(count, waiter_fn);
+
+	/* Let every waiter pass the initial readiness check and go to sleep. */
+	k_sleep(K_MSEC(10));
+}
+
+static void waiters_stop(size_t count)
+{
+	atomic_set(&stop, 1);
+	nrf_modem_os_event_notify(0);
+
+	for (size_t i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL(0, k_thread_join(&waiters[i].thread, K_SECONDS(1)));
+	}
+}
+
+static void wakeup_check(size_t count)
+{
+	struct waiter *target;
+	atomic_val_t returns[WAITERS_MAX];
+
+	waiters_start(count);
+
+	for (size_t n = 0; n < ITERATIONS; n++) {
+		target = &waiters[n % count];
+
+		for (size_t i = 0; i < count; i++) {
+			returns[i] = atomic_get(&waiters[i].returns);
+		}
+
+		atomic_set(&target->notified, 1);
+
+		nrf_modem_os_event_notify(target->context);
+		TEST_ASSERT_EQUAL(0, k_sem_take(&woken_sem, K_SECONDS(1)));
+
+		/* Only the thread waiting on the notified context may wake up. */
+		for (size_t i = 0; i < count; i++) {
+			if (&waiters[i] != target) {
+				TEST_ASSERT_EQUAL(returns[i], atomic_get(&waiters[i].returns));
+			}
+		}
+
+		/* Let the target thread go back to sleep. */
+		k_sleep(K_MSEC(1));
+	}
+
+	waiters_stop(count);
+}
+
+void setUp(void)
+{
+	__cmock_nrf_modem_is_initialized_IgnoreAndReturn(1);
+}
+
+void tearDown(void)
+{
+}
+
+void test_nrf_modem_os_wakeup_1(void)
+{
+	wakeup_check(1);
+}
+
+void test_nrf_modem_os_wakeup_2(void)
+{
+	wakeup_check(2);
+}
+
+void test_nrf_modem_os_wakeup_4(void)
+{
+	wakeup_check(4);
+}
+
+void test_nrf_modem_os_wakeup_8(void)
+{
+	wakeup_check(8);
+}
+
+void test_nrf_modem_os_wakeup_16(void)
+{
+	wakeup_check(16);
+}
+
+void test_nrf_modem_os_wakeup_32(void)
+{
+	wakeup_check(32);
+}
+
+void test_nrf_modem_os_timedwait_no_wait(void)
+{
+	int32_t timeout = NRF_MODEM_OS_NO_WAIT;
+
+	TEST_ASSERT_EQUAL(-NRF_EAGAIN, nrf_modem_os_timedwait(1, &timeout));
+}
+
+void test_nrf_modem_os_timedwait_contention(void)
+{
+	waiters_create(TIMEOUT_WAITERS, timeout_waiter_fn);
+
+	for (size_t i = 0; i < TIMEOUT_WAITERS; i++) {
+		TEST_ASSERT_EQUAL(0, k_thread_join(&waiters[i].thread, K_SECONDS(5)));
+	}
+
+	/* Without events, each thread re-checks its readiness at most once, when it first
+	 * gets a thread monitor entry. Threads must not evict each other's entries.
+	 */
+	for (size_t i = 0; i < TIMEOUT_WAITERS; i++) {
+		TEST_ASSERT_LESS_OR_EQUAL(1, atomic_get(&waiters[i].early_returns));
+	}
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
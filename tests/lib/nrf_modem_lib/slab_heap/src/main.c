@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "slab_heap.h"
+
+LOG_MODULE_REGISTER(nrf_modem, 0);
+
+#define HEAP_SIZE 2048
+
+K_HEAP_DEFINE(test_heap, HEAP_SIZE);
+
+static struct slab_heap_class classes[] = {
+	SLAB_HEAP_CLASS(30, 2),
+	SLAB_HEAP_CLASS(64, 1),
+	SLAB_HEAP_CLASS(128, 0),
+};
+
+static struct slab_heap sh = {
+	.heap = &test_heap,
+	.classes = classes,
+	.num_classes = ARRAY_SIZE(classes),
+};
+
+static bool in_class(const struct slab_heap_class *class, const void *mem)
+{
+	const char *p = mem;
+
+	return p >= class->buf && p < class->buf + class->block_size * class->num_blocks;
+}
+
+void setUp(void)
+{
+	memset(sh.size_hist, 0, sizeof(sh.size_hist));
+
+	for (size_t i = 0; i < ARRAY_SIZE(classes); i++) {
+		classes[i].max_used = 0;
+		atomic_clear(&classes[i].fallbacks);
+	}
+
+	slab_heap_init(&sh);
+}
+
+void tearDown(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(classes); i++) {
+		if (classes[i].buf) {
+			k_heap_free(&test_heap, classes[i].buf);
+		}
+	}
+}
+
+void test_slab_heap_class_init(void)
+{
+	TEST_ASSERT_EQUAL(32, classes[0].block_size);
+	TEST_ASSERT_NOT_NULL(classes[0].buf);
+	TEST_ASSERT_NOT_NULL(classes[1].buf);
+	/* Classes without blocks are disabled. */
+	TEST_ASSERT_NULL(classes[2].buf);
+	TEST_ASSERT_EQUAL(0, (uintptr_t)classes[0].buf % SLAB_HEAP_ALIGN);
+}
+
+void test_slab_heap_alloc_smallest_fit(void)
+{
+	void *a = slab_heap_alloc(&sh, 8);
+	void *b = slab_heap_alloc(&sh, 40);
+
+	TEST_ASSERT_TRUE(in_class(&classes[0], a));
+	TEST_ASSERT_TRUE(in_class(&classes[1], b));
+
+	slab_heap_free(&sh, a);
+	slab_heap_free(&sh, b);
+
+	TEST_ASSERT_EQUAL(0, k_mem_slab_num_used_get(&classes[0].slab));
+	TEST_ASSERT_EQUAL(0, k_mem_slab_num_used_get(&classes[1].slab));
+}
+
+void test_slab_heap_fallback(void)
+{
+	void *mem[4];
+
+	/* Two blocks of the first class, then the second class, then the heap. */
+	for (size_t i = 0; i < ARRAY_SIZE(mem); i++) {
+		mem[i] = slab_heap_alloc(&sh, 16);
+		TEST_ASSERT_NOT_NULL(mem[i]);
+	}
+
+	TEST_ASSERT_TRUE(in_class(&classes[0], mem[0]));
+	TEST_ASSERT_TRUE(in_class(&classes[0], mem[1]));
+	TEST_ASSERT_TRUE(in_class(&classes[1], mem[2]));
+	TEST_ASSERT_FALSE(in_class(&classes[0], mem[3]));
+	TEST_ASSERT_FALSE(in_class(&classes[1], mem[3]));
+
+	TEST_ASSERT_EQUAL(2, classes[0].max_used);
+	TEST_ASSERT_EQUAL(2, atomic_get(&classes[0].fallbacks));
+	TEST_ASSERT_EQUAL(1, atomic_get(&classes[1].fallbacks));
+
+	for (size_t i = 0; i < ARRAY_SIZE(mem); i++) {
+		slab_heap_free(&sh, mem[i]);
+	}
+}
+
+void test_slab_heap_oversized(void)
+{
+	void *mem = slab_heap_alloc(&sh, 512);
+
+	TEST_ASSERT_NOT_NULL(mem);
+	TEST_ASSERT_FALSE(in_class(&classes[0], mem));
+	TEST_ASSERT_FALSE(in_class(&classes[1], mem));
+	TEST_ASSERT_EQUAL(0, atomic_get(&classes[0].fallbacks));
+
+	slab_heap_free(&sh, mem);
+}
+
+void test_slab_heap_size_hist(void)
+{
+	const size_t sizes[] = { 1, 16, 17, 2048, 4096 };
+
+	for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+		slab_heap_free(&sh, slab_heap_alloc(&sh, sizes[i]));
+	}
+
+	TEST_ASSERT_EQUAL(2, atomic_get(&sh.size_hist[0]));
+	TEST_ASSERT_EQUAL(1, atomic_get(&sh.size_hist[1]));
+	TEST_ASSERT_EQUAL(2, atomic_get(&sh.size_hist[SLAB_HEAP_HIST_BUCKETS - 1]));
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <lz4.h>
+
+#include "trace_lz4.h"
+
+#define INPUT_SIZE 1024
+
+static const uint8_t frame_header[] = { 0x04, 0x22, 0x4D, 0x18, 0x60, 0x40, 0x82 };
+
+static uint8_t input[INPUT_SIZE];
+static uint8_t frame[TRACE_LZ4_FRAME_BOUND(INPUT_SIZE)];
+static uint8_t output[INPUT_SIZE];
+static uint32_t rand_state;
+
+/* Deterministic pseudo-random data, so that failures are reproducible. */
+static uint32_t rand_next(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static int frame_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t dst_size)
+{
+	uint32_t block_len;
+	int ret;
+
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(frame_header, src, sizeof(frame_header));
+	src += sizeof(frame_header);
+
+	block_len = sys_get_le32(src);
+	src += 4;
+
+	if (block_len & BIT(31)) {
+		block_len &= ~BIT(31);
+		TEST_ASSERT_LESS_OR_EQUAL(dst_size, block_len);
+		memcpy(dst, src, block_len);
+		ret = block_len;
+	} else {
+		ret = LZ4_decompress_safe((const char *)src, (char *)dst, block_len, dst_size);
+	}
+
+	/* End mark */
+	TEST_ASSERT_EQUAL(0, sys_get_le32(src + block_len));
+	TEST_ASSERT_EQUAL(len, sizeof(frame_header) + 4 + block_len + 4);
+
+	return ret;
+}
+
+static void roundtrip(size_t len)
+{
+	size_t frame_len;
+	int ret;
+
+	frame_len = trace_lz4_frame_compress(input, len, frame);
+	TEST_ASSERT_LESS_OR_EQUAL(TRACE_LZ4_FRAME_BOUND(len), frame_len);
+
+	ret = frame_decode(frame, frame_len, output, sizeof(output));
+	TEST_ASSERT_EQUAL(len, ret);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(input, output, len);
+}
+
+void setUp(void)
+{
+	memset(input, 0, sizeof(input));
+	memset(output, 0, sizeof(output));
+	rand_state = 0x2545F491;
+}
+
+void tearDown(void)
+{
+}
+
+void test_lz4_compress_repetitive(void)
+{
+	for (size_t i = 0; i < sizeof(input); i++) {
+		input[i] = "modem trace "[i % 12];
+	}
+
+	roundtrip(sizeof(input));
+
+	/* Repetitive data must compress. */
+	TEST_ASSERT_LESS_THAN(sizeof(input) / 4, trace_lz4_frame_compress(input, sizeof(input),
+									  frame));
+}
+
+void test_lz4_compress_zeros(void)
+{
+	roundtrip(sizeof(input));
+}
+
+void test_lz4_compress_random(void)
+{
+	for (size_t i = 0; i < sizeof(input); i++) {
+		input[i] = rand_next();
+	}
+
+	/* Incompressible data is stored. */
+	roundtrip(sizeof(input));
+	TEST_ASSERT_EQUAL(TRACE_LZ4_FRAME_BOUND(sizeof(input)),
+			  trace_lz4_frame_compress(input, sizeof(input), frame));
+}
+
+void test_lz4_compress_short(void)
+{
+	for (size_t len = 0; len < 32; len++) {
+		memset(input, 'a', len);
+		roundtrip(len);
+	}
+}
+
+void test_lz4_compress_mixed(void)
+{
+	/* Low entropy data with short and long matches. */
+	for (size_t i = 0; i < sizeof(input); i++) {
+		input[i] = (rand_next() % 4) ? i / 64 : rand_next();
+	}
+
+	roundtrip(sizeof(input));
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -16,8 +16,11 @@ extern struct nrf_modem_lib_trace_backend trace_backend;
 
 #define BACKEND_RTT_BUF_SIZE CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RTT_BUF_SIZE
 
+static size_t processed_len;
+
 static int callback(size_t len)
 {
+	processed_len += len;
 	return 0;
 }
 
@@ -98,6 +101,33 @@ void test_trace_backend_write_rtt(void)
 	trace_backend.write(sample_trace_data, sizeof(sample_trace_data));
 }
 
+/* Test that a vector of trace fragments is forwarded to RTT and processed at once. */
+void test_trace_backend_write_vec_rtt(void)
+{
+	const uint8_t frag_data_1[32];
+	const uint8_t frag_data_2[BACKEND_RTT_BUF_SIZE + 16];
+	const struct nrf_modem_trace_data frags[] = {
+		{ .data = frag_data_1, .len = sizeof(frag_data_1) },
+		{ .data = frag_data_2, .len = sizeof(frag_data_2) },
+	};
+	int ret;
+
+	test_trace_backend_init_rtt();
+	processed_len = 0;
+
+	__cmock_SEGGER_RTT_WriteNoLock_ExpectAndReturn(
+		trace_rtt_channel, frag_data_1, sizeof(frag_data_1), sizeof(frag_data_1));
+	__cmock_SEGGER_RTT_WriteNoLock_ExpectAndReturn(
+		trace_rtt_channel, frag_data_2, BACKEND_RTT_BUF_SIZE, BACKEND_RTT_BUF_SIZE);
+	__cmock_SEGGER_RTT_WriteNoLock_ExpectAndReturn(
+		trace_rtt_channel, &frag_data_2[BACKEND_RTT_BUF_SIZE], 16, 16);
+
+	ret = trace_backend.write_vec(frags, ARRAY_SIZE(frags));
+
+	TEST_ASSERT_EQUAL(sizeof(frag_data_1) + sizeof(frag_data_2), ret);
+	TEST_ASSERT_EQUAL(sizeof(frag_data_1) + sizeof(frag_data_2), processed_len);
+}
+
 int main(void)
 {
 	(void)unity_main();
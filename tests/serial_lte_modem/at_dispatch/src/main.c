@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <ctype.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "slm_at_dispatch.h"
+
+/* Most name comparisons in a lookup, against one per command with a linear search. */
+#define PROBES_MAX 8
+
+static int handler(enum at_cmd_type cmd_type)
+{
+	return 0;
+}
+
+/* All the commands of serial LTE modem with every feature enabled. */
+static const struct slm_at_cmd cmd_list[] = {
+	{"AT#XSLMVER", handler}, {"AT#XSLEEP", handler}, {"AT#XSHUTDOWN", handler},
+	{"AT#XRESET", handler}, {"AT#XMODEMRESET", handler}, {"AT#XUUID", handler},
+	{"AT#XCLAC", handler}, {"AT#XSLMUART", handler}, {"AT#XDATACTRL", handler},
+	{"AT#XTCPSVR", handler}, {"AT#XTCPCLI", handler}, {"AT#XTCPSEND", handler},
+	{"AT#XTCPHANGUP", handler}, {"AT#XUDPSVR", handler}, {"AT#XUDPCLI", handler},
+	{"AT#XUDPSEND", handler}, {"AT#XSOCKET", handler}, {"AT#XSSOCKET", handler},
+	{"AT#XSOCKETSELECT", handler}, {"AT#XSOCKETOPT", handler}, {"AT#XSSOCKETOPT", handler},
+	{"AT#XBIND", handler}, {"AT#XCONNECT", handler}, {"AT#XLISTEN", handler},
+	{"AT#XACCEPT", handler}, {"AT#XSEND", handler}, {"AT#XRECV", handler},
+	{"AT#XSENDTO", handler}, {"AT#XRECVFROM", handler}, {"AT#XPOLL", handler},
+	{"AT#XGETADDRINFO", handler}, {"AT#XCMNG", handler}, {"AT#XPING", handler},
+	{"AT#XSMS", handler}, {"AT#XFOTA", handler}, {"AT#XNRFCLOUD", handler},
+	{"AT#XCELLPOS", handler}, {"AT#XWIFIPOS", handler}, {"AT#XGPS", handler},
+	{"AT#XGPSDEL", handler}, {"AT#XAGPS", handler}, {"AT#XPGPS", handler},
+	{"AT#XFTP", handler}, {"AT#XTFTP", handler}, {"AT#XMQTTCON", handler},
+	{"AT#XMQTTPUB", handler}, {"AT#XMQTTSUB", handler}, {"AT#XMQTTUNSUB", handler},
+	{"AT#XHTTPCCON", handler}, {"AT#XHTTPCREQ", handler}, {"AT#XTWILS", handler},
+	{"AT#XTWIW", handler}, {"AT#XTWIR", handler}, {"AT#XTWIWR", handler},
+	{"AT#XGPIOCFG", handler}, {"AT#XGPIO", handler}, {"AT#XCARRIER", handler},
+};
+
+/* Commands from a host MCU running a socket based application, roughly in proportion.
+ * Most lines are passed through to the modem.
+ */
+static const char *const cmd_mix[] = {
+	"AT+CEREG?\r\n",
+	"AT+CESQ\r\n",
+	"AT%XMONITOR\r\n",
+	"AT+CFUN?\r\n",
+	"AT+CGDCONT?\r\n",
+	"AT%XSYSTEMMODE?\r\n",
+	"AT+CSCON?\r\n",
+	"AT#XSOCKET=1,1,0\r\n",
+	"AT#XCONNECT=\"example.com\",80\r\n",
+	"AT#XSEND=\"GET / HTTP/1.1\\r\\nHost: example.com\\r\\n\\r\\n\"\r\n",
+	"AT#XRECV=10\r\n",
+	"AT#XRECV=10\r\n",
+	"AT#XPOLL=1000\r\n",
+	"AT#XSOCKET?\r\n",
+	"AT#XSOCKET=0\r\n",
+	"AT#XGPS=1,0\r\n",
+	"AT#XSLEEP=2\r\n",
+	"AT+COPS?\r\n",
+};
+
+static struct slm_at_dispatch dispatch;
+
+/* The lookup used before, see slm_util_cmd_casecmp(). */
+static bool linear_cmd_casecmp(const char *cmd, const char *slm_cmd)
+{
+	int i;
+	int slm_cmd_len = strlen(slm_cmd);
+
+	if (strlen(cmd) < slm_cmd_len) {
+		return false;
+	}
+
+	for (i = 0; i < slm_cmd_len; i++) {
+		if (toupper((int)*(cmd + i)) != toupper((int)*(slm_cmd + i))) {
+			return false;
+		}
+	}
+	if (strlen(cmd) > (slm_cmd_len + 2)) {
+		char ch = *(cmd + i);
+
+		return ((ch == '=') || (ch == '?'));
+	}
+
+	return true;
+}
+
+static const struct slm_at_cmd *linear_find(const char *at_cmd)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cmd_list); i++) {
+		if (linear_cmd_casecmp(at_cmd, cmd_list[i].string)) {
+			return &cmd_list[i];
+		}
+	}
+
+	return NULL;
+}
+
+void setUp(void)
+{
+	TEST_ASSERT_EQUAL(0, slm_at_dispatch_init(&dispatch, cmd_list, ARRAY_SIZE(cmd_list)));
+}
+
+void tearDown(void)
+{
+}
+
+void test_slm_at_dispatch_all_commands(void)
+{
+	char cmd[32];
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmd_list); i++) {
+		strcpy(cmd, cmd_list[i].string);
+		TEST_ASSERT_EQUAL_PTR(&cmd_list[i], slm_at_dispatch_find(&dispatch, cmd));
+
+		strcat(cmd, "=?\r\n");
+		TEST_ASSERT_EQUAL_PTR(&cmd_list[i], slm_at_dispatch_find(&dispatch, cmd));
+	}
+}
+
+void test_slm_at_dispatch_command_types(void)
+{
+	const struct slm_at_cmd *gps = slm_at_dispatch_find(&dispatch, "AT#XGPS");
+
+	TEST_ASSERT_NOT_NULL(gps);
+	TEST_ASSERT_EQUAL_PTR(gps, slm_at_dispatch_find(&dispatch, "AT#XGPS=1,0\r\n"));
+	TEST_ASSERT_EQUAL_PTR(gps, slm_at_dispatch_find(&dispatch, "AT#XGPS?\r\n"));
+	TEST_ASSERT_EQUAL_PTR(gps, slm_at_dispatch_find(&dispatch, "at#xgps=?"));
+	TEST_ASSERT_EQUAL_PTR(gps, slm_at_dispatch_find(&dispatch, "At#XgPs\n"));
+}
+
+void test_slm_at_dispatch_longest_name(void)
+{
+	TEST_ASSERT_EQUAL_STRING("AT#XSOCKETSELECT",
+		slm_at_dispatch_find(&dispatch, "AT#XSOCKETSELECT=1\r\n")->string);
+	TEST_ASSERT_EQUAL_STRING("AT#XSOCKET",
+		slm_at_dispatch_find(&dispatch, "AT#XSOCKET=1,1,0\r\n")->string);
+	TEST_ASSERT_EQUAL_STRING("AT#XGPSDEL",
+		slm_at_dispatch_find(&dispatch, "AT#XGPSDEL=31\r\n")->string);
+}
+
+void test_slm_at_dispatch_unknown(void)
+{
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, "AT+CFUN=1\r\n"));
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, "AT%XMONITOR"));
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, "AT#XSOCK=1\r\n"));
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, "AT#XSOCKETSEL\r\n"));
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, "AT#XGPSX\r\n"));
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, "AT"));
+	TEST_ASSERT_NULL(slm_at_dispatch_find(&dispatch, ""));
+}
+
+void test_slm_at_dispatch_init_errors(void)
+{
+	static const struct slm_at_cmd duplicates[] = {
+		{"AT#XSEND", handler}, {"AT#XRECV", handler}, {"at#xsend", handler},
+	};
+	static struct slm_at_cmd too_many[SLM_AT_DISPATCH_SLOTS];
+	struct slm_at_dispatch index;
+
+	TEST_ASSERT_EQUAL(-EEXIST,
+			  slm_at_dispatch_init(&index, duplicates, ARRAY_SIZE(duplicates)));
+	TEST_ASSERT_EQUAL(-ENOMEM,
+			  slm_at_dispatch_init(&index, too_many, ARRAY_SIZE(too_many)));
+}
+
+void test_slm_at_dispatch_command_mix(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cmd_mix); i++) {
+		TEST_ASSERT_EQUAL_PTR(linear_find(cmd_mix[i]),
+				      slm_at_dispatch_find(&dispatch, cmd_mix[i]));
+	}
+}
+
+void test_slm_at_dispatch_probe_length(void)
+{
+	size_t run = 0;
+	size_t run_max = 0;
+
+	/* A lookup stops at the first empty slot, so the longest run of used slots bounds
+	 * the name comparisons for both found and unknown commands. The table wraps around.
+	 */
+	for (size_t i = 0; i < 2 * SLM_AT_DISPATCH_SLOTS; i++) {
+		if (dispatch.slots[i % SLM_AT_DISPATCH_SLOTS] != 0) {
+			run++;
+			run_max = MAX(run, run_max);
+		} else {
+			run = 0;
+		}
+	}
+
+	TEST_ASSERT_LESS_OR_EQUAL(PROBES_MAX, run_max);
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
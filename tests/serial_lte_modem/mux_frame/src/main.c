@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "slm_mux_frame.h"
+
+#define MTU 64
+#define MAX_FRAMES 8
+
+static struct slm_mux_decoder decoder;
+static uint8_t payload_buf[MTU];
+
+static struct {
+	uint8_t channel;
+	uint8_t type;
+	uint16_t len;
+	uint8_t payload[MTU];
+} frames[MAX_FRAMES];
+static size_t frame_count;
+
+static void frame_handler(const struct slm_mux_frame *frame, void *ctx)
+{
+	TEST_ASSERT_EQUAL_PTR(&decoder, ctx);
+	TEST_ASSERT_LESS_THAN(MAX_FRAMES, frame_count);
+
+	frames[frame_count].channel = frame->channel;
+	frames[frame_count].type = frame->type;
+	frames[frame_count].len = frame->len;
+	memcpy(frames[frame_count].payload, frame->payload, frame->len);
+	frame_count++;
+
+	/* Like exiting the multiplexing mode. */
+	if (frame->channel == 0 && frame->type == SLM_MUX_TYPE_CLOSE) {
+		slm_mux_decoder_stop(&decoder);
+	}
+}
+
+static size_t encode(uint8_t *buf, uint8_t channel, const char *payload)
+{
+	return slm_mux_frame_encode(buf, SLM_MUX_FRAME_SIZE(MTU), channel, SLM_MUX_TYPE_DATA,
+				    (const uint8_t *)payload, strlen(payload));
+}
+
+static void frame_assert(size_t index, uint8_t channel, const char *payload)
+{
+	TEST_ASSERT_EQUAL(channel, frames[index].channel);
+	TEST_ASSERT_EQUAL(SLM_MUX_TYPE_DATA, frames[index].type);
+	TEST_ASSERT_EQUAL(strlen(payload), frames[index].len);
+	TEST_ASSERT_EQUAL_MEMORY(payload, frames[index].payload, frames[index].len);
+}
+
+void setUp(void)
+{
+	frame_count = 0;
+	slm_mux_decoder_init(&decoder, payload_buf, sizeof(payload_buf), frame_handler, &decoder);
+}
+
+void tearDown(void)
+{
+}
+
+void test_slm_mux_frame_encode(void)
+{
+	uint8_t buf[SLM_MUX_FRAME_SIZE(MTU)];
+	size_t len = encode(buf, 3, "AT\r");
+
+	TEST_ASSERT_EQUAL(SLM_MUX_FRAME_SIZE(3), len);
+	TEST_ASSERT_EQUAL(SLM_MUX_SOF, buf[0]);
+	TEST_ASSERT_EQUAL(3, buf[1]);
+	TEST_ASSERT_EQUAL(SLM_MUX_TYPE_DATA, buf[2]);
+	TEST_ASSERT_EQUAL(3, buf[3]);
+	TEST_ASSERT_EQUAL(0, buf[4]);
+	TEST_ASSERT_EQUAL_MEMORY("AT\r", &buf[SLM_MUX_HEADER_SIZE], 3);
+	TEST_ASSERT_EQUAL(slm_mux_fcs(buf, &buf[SLM_MUX_HEADER_SIZE], 3), buf[len - 1]);
+
+	/* Does not fit. */
+	TEST_ASSERT_EQUAL(0, slm_mux_frame_encode(buf, SLM_MUX_FRAME_SIZE(2), 0,
+						  SLM_MUX_TYPE_DATA, buf, 3));
+}
+
+void test_slm_mux_frame_decode(void)
+{
+	uint8_t buf[2 * SLM_MUX_FRAME_SIZE(MTU)];
+	size_t len;
+
+	len = encode(buf, 0, "AT#XSOCKET?\r\n");
+	len += slm_mux_frame_encode(&buf[len], sizeof(buf) - len, 2, SLM_MUX_TYPE_CLOSE, NULL, 0);
+
+	TEST_ASSERT_EQUAL(len, slm_mux_decode(&decoder, buf, len));
+
+	TEST_ASSERT_EQUAL(2, frame_count);
+	frame_assert(0, 0, "AT#XSOCKET?\r\n");
+	TEST_ASSERT_EQUAL(2, frames[1].channel);
+	TEST_ASSERT_EQUAL(SLM_MUX_TYPE_CLOSE, frames[1].type);
+	TEST_ASSERT_EQUAL(0, frames[1].len);
+	TEST_ASSERT_EQUAL(0, decoder.errors);
+}
+
+void test_slm_mux_frame_decode_split(void)
+{
+	uint8_t buf[SLM_MUX_FRAME_SIZE(MTU)];
+	size_t len = encode(buf, 1, "GET / HTTP/1.1\r\n");
+
+	/* One byte at a time, as UART buffers may end anywhere. */
+	for (size_t i = 0; i < len; i++) {
+		TEST_ASSERT_EQUAL(0, frame_count);
+		slm_mux_decode(&decoder, &buf[i], 1);
+	}
+
+	TEST_ASSERT_EQUAL(1, frame_count);
+	frame_assert(0, 1, "GET / HTTP/1.1\r\n");
+}
+
+void test_slm_mux_frame_decode_resync(void)
+{
+	uint8_t buf[3 * SLM_MUX_FRAME_SIZE(MTU)];
+	size_t len = 0;
+	size_t corrupt;
+
+	/* Line noise before the first frame is skipped. */
+	memcpy(buf, "\r\n", 2);
+	len += 2;
+	len += encode(&buf[len], 1, "first");
+	corrupt = len;
+	len += encode(&buf[len], 1, "second");
+	len += encode(&buf[len], 2, "third");
+	buf[corrupt + SLM_MUX_HEADER_SIZE] ^= 0x01;
+
+	slm_mux_decode(&decoder, buf, len);
+
+	TEST_ASSERT_EQUAL(2, frame_count);
+	frame_assert(0, 1, "first");
+	frame_assert(1, 2, "third");
+	TEST_ASSERT_EQUAL(1, decoder.errors);
+}
+
+void test_slm_mux_frame_decode_too_long(void)
+{
+	uint8_t header[SLM_MUX_HEADER_SIZE];
+	uint8_t buf[SLM_MUX_FRAME_SIZE(MTU)];
+	size_t len;
+
+	slm_mux_header_encode(header, 1, SLM_MUX_TYPE_DATA, MTU + 1);
+	slm_mux_decode(&decoder, header, sizeof(header));
+	TEST_ASSERT_EQUAL(1, decoder.errors);
+
+	len = encode(buf, 1, "ok");
+	slm_mux_decode(&decoder, buf, len);
+
+	TEST_ASSERT_EQUAL(1, frame_count);
+	frame_assert(0, 1, "ok");
+}
+
+void test_slm_mux_frame_decode_stop(void)
+{
+	uint8_t buf[2 * SLM_MUX_FRAME_SIZE(MTU) + 16];
+	size_t len;
+	size_t end;
+
+	len = encode(buf, 1, "data");
+	len += slm_mux_frame_encode(&buf[len], sizeof(buf) - len, 0, SLM_MUX_TYPE_CLOSE, NULL, 0);
+	end = len;
+	/* Not framed, must not be decoded even though it looks like a frame. */
+	len += encode(&buf[len], 1, "AT");
+
+	TEST_ASSERT_EQUAL(end, slm_mux_decode(&decoder, buf, len));
+	TEST_ASSERT_EQUAL(2, frame_count);
+	frame_assert(0, 1, "data");
+	TEST_ASSERT_EQUAL(SLM_MUX_TYPE_CLOSE, frames[1].type);
+
+	TEST_ASSERT_EQUAL(0, slm_mux_decode(&decoder, &buf[end], len - end));
+	TEST_ASSERT_EQUAL(2, frame_count);
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+
+#include "slm_proxy_poll.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* Simulated time does not advance while the CPU is busy, use host time instead. */
+#include <native_rtc.h>
+#define TIME_NOW_US() native_rtc_gettime_us(RTC_CLOCK_REALTIME)
+#else
+#define TIME_NOW_US() k_cyc_to_us_floor64(k_cycle_get_32())
+#endif
+
+#define SOCKETS		CONFIG_SLM_PROXY_POLL_SOCKETS
+#define EVENT_TIMEOUT	K_SECONDS(1)
+#define ITERATIONS	200
+
+/* Stack of the proxy threads before the event loop, one per TCP or UDP proxy. */
+#define PROXY_THREAD_STACK_SIZE KB(4)
+
+/* Like the proxies: one end of the pair is polled, the other one is the remote. */
+static struct connection {
+	int sock;
+	int remote;
+} connections[SOCKETS];
+
+static K_SEM_DEFINE(event_sem, 0, SOCKETS);
+
+static void event_handler(int fd, short revents, void *ctx)
+{
+	char buf[16];
+
+	ARG_UNUSED(ctx);
+
+	if (revents & POLLIN) {
+		(void)recv(fd, buf, sizeof(buf), 0);
+	}
+	k_sem_give(&event_sem);
+}
+
+static void stack_used_get(const struct k_thread *thread, void *user_data)
+{
+	size_t *used = user_data;
+	size_t unused;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+
+	if (name != NULL && strcmp(name, "slm_proxy_poll") == 0 &&
+	    k_thread_stack_space_get(thread, &unused) == 0) {
+		*used = thread->stack_info.size - unused;
+	}
+}
+
+/* Peak stack use of the event loop thread. */
+static size_t loop_stack_used(void)
+{
+	size_t used = 0;
+
+	k_thread_foreach(stack_used_get, &used);
+	TEST_ASSERT_NOT_EQUAL(0, used);
+
+	return used;
+}
+
+/* Time to handle one event on each of the connections, with all of them polled. */
+static void connections_measure(int count)
+{
+	uint64_t start, elapsed = 0;
+	size_t used;
+	int fds[2];
+
+	for (int i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+		connections[i].sock = fds[0];
+		connections[i].remote = fds[1];
+		TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[i].sock, POLLIN,
+							event_handler, NULL));
+	}
+	k_sleep(K_MSEC(10));
+
+	for (int n = 0; n < ITERATIONS; n++) {
+		start = TIME_NOW_US();
+		for (int i = 0; i < count; i++) {
+			TEST_ASSERT_EQUAL(1, send(connections[i].remote, "x", 1, 0));
+		}
+		for (int i = 0; i < count; i++) {
+			TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+		}
+		elapsed += TIME_NOW_US() - start;
+	}
+
+	for (int i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL(0, slm_proxy_poll_remove(connections[i].sock));
+		close(connections[i].sock);
+		close(connections[i].remote);
+	}
+
+	used = loop_stack_used();
+	printk("Connections: %d, events served in [us]: %llu, per connection [ns]: %llu\n",
+	       count, (unsigned long long)(elapsed / ITERATIONS),
+	       (unsigned long long)(elapsed * 1000 / ITERATIONS / count));
+	printk("Event loop stack used: %zu bytes, thread per connection: %zu bytes\n",
+	       used, count * (sizeof(struct k_thread) + PROXY_THREAD_STACK_SIZE));
+}
+
+void setUp(void)
+{
+	k_sem_reset(&event_sem);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_init());
+}
+
+void tearDown(void)
+{
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_uninit());
+}
+
+void test_proxy_poll_connection_scaling(void)
+{
+	for (int count = 1; count <= SOCKETS; count++) {
+		connections_measure(count);
+	}
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
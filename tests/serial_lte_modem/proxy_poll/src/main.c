@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+
+#include "slm_proxy_poll.h"
+
+#define SOCKETS		CONFIG_SLM_PROXY_POLL_SOCKETS
+/* The loop polls without a time-out, so events are only handled if it is woken up. */
+#define EVENT_TIMEOUT	K_SECONDS(1)
+
+/* Like the proxies: one end of the pair is polled, the other one is the remote. */
+static struct connection {
+	int sock;
+	int remote;
+	int received;
+	bool close_on_recv;
+} connections[SOCKETS];
+
+static K_SEM_DEFINE(event_sem, 0, SOCKETS);
+
+static void event_handler(int fd, short revents, void *ctx)
+{
+	struct connection *conn = ctx;
+	bool hangup = (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+	char buf[16];
+	int ret;
+
+	TEST_ASSERT_EQUAL(conn->sock, fd);
+
+	if (revents & POLLIN) {
+		ret = recv(fd, buf, sizeof(buf), 0);
+		if (ret > 0) {
+			conn->received += ret;
+		} else if (ret == 0) {
+			hangup = true;
+		}
+	}
+	if (conn->close_on_recv || hangup) {
+		/* Handlers remove their own sockets on disconnect. */
+		TEST_ASSERT_EQUAL(0, slm_proxy_poll_remove(fd));
+		close(fd);
+		conn->sock = -1;
+	}
+	k_sem_give(&event_sem);
+}
+
+static void connection_open(struct connection *conn)
+{
+	int fds[2];
+
+	TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+	conn->sock = fds[0];
+	conn->remote = fds[1];
+	conn->received = 0;
+	conn->close_on_recv = false;
+}
+
+static void connection_close(struct connection *conn)
+{
+	if (conn->sock >= 0) {
+		(void)slm_proxy_poll_remove(conn->sock);
+		close(conn->sock);
+		conn->sock = -1;
+	}
+	if (conn->remote >= 0) {
+		close(conn->remote);
+		conn->remote = -1;
+	}
+}
+
+void setUp(void)
+{
+	for (int i = 0; i < SOCKETS; i++) {
+		connections[i].sock = -1;
+		connections[i].remote = -1;
+	}
+	k_sem_reset(&event_sem);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_init());
+}
+
+void tearDown(void)
+{
+	for (int i = 0; i < SOCKETS; i++) {
+		connection_close(&connections[i]);
+	}
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_uninit());
+}
+
+void test_proxy_poll_add_remove(void)
+{
+	for (int i = 0; i < SOCKETS; i++) {
+		connection_open(&connections[i]);
+		TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[i].sock, POLLIN,
+							event_handler, &connections[i]));
+	}
+
+	TEST_ASSERT_EQUAL(-EINVAL, slm_proxy_poll_add(-1, POLLIN, event_handler, NULL));
+	TEST_ASSERT_EQUAL(-EINVAL, slm_proxy_poll_add(connections[0].remote, POLLIN, NULL, NULL));
+	TEST_ASSERT_EQUAL(-EEXIST, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						      event_handler, &connections[0]));
+	/* All the entries are in use. */
+	TEST_ASSERT_EQUAL(-ENOMEM, slm_proxy_poll_add(connections[0].remote, POLLIN,
+						      event_handler, &connections[0]));
+
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_remove(connections[0].sock));
+	TEST_ASSERT_EQUAL(-ENOENT, slm_proxy_poll_remove(connections[0].sock));
+	TEST_ASSERT_EQUAL(-EINVAL, slm_proxy_poll_remove(-1));
+}
+
+void test_proxy_poll_dispatch_all(void)
+{
+	for (int i = 0; i < SOCKETS; i++) {
+		connection_open(&connections[i]);
+		TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[i].sock, POLLIN,
+							event_handler, &connections[i]));
+	}
+
+	/* Every connection is served by the one thread. */
+	for (int i = 0; i < SOCKETS; i++) {
+		TEST_ASSERT_EQUAL(i + 1, send(connections[i].remote, "0123456789", i + 1, 0));
+	}
+	for (int i = 0; i < SOCKETS; i++) {
+		TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	}
+	for (int i = 0; i < SOCKETS; i++) {
+		TEST_ASSERT_EQUAL(i + 1, connections[i].received);
+	}
+}
+
+void test_proxy_poll_removed_not_handled(void)
+{
+	connection_open(&connections[0]);
+	connection_open(&connections[1]);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						event_handler, &connections[0]));
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[1].sock, POLLIN,
+						event_handler, &connections[1]));
+
+	/* Removed while the loop is polling, as AT#XTCPCLI=0 does. */
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_remove(connections[0].sock));
+	TEST_ASSERT_EQUAL(1, send(connections[0].remote, "x", 1, 0));
+	TEST_ASSERT_EQUAL(1, send(connections[1].remote, "y", 1, 0));
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(-EAGAIN, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(0, connections[0].received);
+	TEST_ASSERT_EQUAL(1, connections[1].received);
+}
+
+void test_proxy_poll_handler_removes(void)
+{
+	connection_open(&connections[0]);
+	connections[0].close_on_recv = true;
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						event_handler, &connections[0]));
+
+	TEST_ASSERT_EQUAL(1, send(connections[0].remote, "x", 1, 0));
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(-1, connections[0].sock);
+
+	/* The entry is free again. */
+	connection_close(&connections[0]);
+	connection_open(&connections[0]);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						event_handler, &connections[0]));
+	TEST_ASSERT_EQUAL(1, send(connections[0].remote, "x", 1, 0));
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(1, connections[0].received);
+}
+
+void test_proxy_poll_remote_hangup(void)
+{
+	connection_open(&connections[0]);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						event_handler, &connections[0]));
+
+	close(connections[0].remote);
+	connections[0].remote = -1;
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(-1, connections[0].sock);
+}
+
+void test_proxy_poll_add_while_polling(void)
+{
+	connection_open(&connections[0]);
+	connection_open(&connections[1]);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						event_handler, &connections[0]));
+	/* Let the loop block in poll() with the first socket only. */
+	k_sleep(K_MSEC(10));
+
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[1].sock, POLLIN,
+						event_handler, &connections[1]));
+	TEST_ASSERT_EQUAL(1, send(connections[1].remote, "x", 1, 0));
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(0, connections[0].received);
+	TEST_ASSERT_EQUAL(1, connections[1].received);
+}
+
+void test_proxy_poll_events_set(void)
+{
+	connection_open(&connections[0]);
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_add(connections[0].sock, POLLIN,
+						event_handler, &connections[0]));
+	k_sleep(K_MSEC(10));
+
+	/* Paused, as the TCP server does for the connections not in data mode. */
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_events_set(connections[0].sock, 0));
+	TEST_ASSERT_EQUAL(1, send(connections[0].remote, "x", 1, 0));
+	TEST_ASSERT_EQUAL(-EAGAIN, k_sem_take(&event_sem, K_MSEC(100)));
+	TEST_ASSERT_EQUAL(0, connections[0].received);
+
+	/* The pending data is received when resumed. */
+	TEST_ASSERT_EQUAL(0, slm_proxy_poll_events_set(connections[0].sock, POLLIN));
+	TEST_ASSERT_EQUAL(0, k_sem_take(&event_sem, EVENT_TIMEOUT));
+	TEST_ASSERT_EQUAL(1, connections[0].received);
+
+	TEST_ASSERT_EQUAL(-EINVAL, slm_proxy_poll_events_set(-1, POLLIN));
+	TEST_ASSERT_EQUAL(-ENOENT, slm_proxy_poll_events_set(connections[0].remote, POLLIN));
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
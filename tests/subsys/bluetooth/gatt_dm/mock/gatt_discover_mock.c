@@ -5,6 +5,8 @@
  */
 #include <stdbool.h>
 #include <inttypes.h>
+#include <string.h>
+#include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/kernel.h>
@@ -19,15 +21,72 @@ static struct bt_discover_mock {
 	struct bt_conn *conn;
 	struct bt_gatt_discover_params *params;
 	struct k_work_delayable work;
+	size_t count;
 } discover_mock_data;
 
+/* Settings of the read mock */
+static struct bt_read_mock {
+	const uint8_t *db_hash;
+	int err;
+	struct bt_conn *conn;
+	struct bt_gatt_read_params *params;
+	struct k_work_delayable work;
+} read_mock_data;
+
+/* Settings of the connection mock */
+static struct bt_conn_mock {
+	bt_addr_le_t peer;
+	bool bonded;
+} conn_mock_data;
+
 static void bt_gatt_discover_work(struct k_work *work);
+static void bt_gatt_read_work(struct k_work *work);
 
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len)
 {
 	k_work_init_delayable(&discover_mock_data.work, bt_gatt_discover_work);
 	discover_mock_data.attr = attr;
 	discover_mock_data.len  = len;
+	discover_mock_data.count = 0;
+}
+
+size_t bt_gatt_discover_mock_count(void)
+{
+	return discover_mock_data.count;
+}
+
+void bt_gatt_read_mock_setup(const uint8_t *db_hash)
+{
+	k_work_init_delayable(&read_mock_data.work, bt_gatt_read_work);
+	read_mock_data.db_hash = db_hash;
+	read_mock_data.err = 0;
+}
+
+void bt_gatt_read_mock_error_set(int err)
+{
+	read_mock_data.err = err;
+}
+
+void bt_conn_mock_setup(const bt_addr_le_t *peer, bool bonded)
+{
+	bt_addr_le_copy(&conn_mock_data.peer, peer);
+	conn_mock_data.bonded = bonded;
+}
+
+/* Mocked version of the bt_conn_get_info, for a connected LE peer */
+/* Call the bt_conn_mock_setup function first */
+int __wrap_bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->type = BT_CONN_TYPE_LE;
+	info->le.dst = &conn_mock_data.peer;
+
+	return 0;
+}
+
+bool __wrap_bt_addr_le_is_bonded(uint8_t id, const bt_addr_le_t *addr)
+{
+	return conn_mock_data.bonded && !bt_addr_le_cmp(addr, &conn_mock_data.peer);
 }
 
 static bool bt_gatt_primary_check(const struct bt_gatt_attr *attr_cur,
@@ -128,7 +187,50 @@ int bt_gatt_discover(struct bt_conn *conn,
 	printk("Running %s mock\n", __func__);
 	discover_mock_data.conn = conn;
 	discover_mock_data.params = params;
+	discover_mock_data.count++;
 
 	k_work_schedule(&discover_mock_data.work, K_MSEC(5));
 	return 0;
 }
+
+static void bt_gatt_read_work(struct k_work *work)
+{
+	struct bt_gatt_read_params *params = read_mock_data.params;
+
+	if (!read_mock_data.db_hash) {
+		(void)params->func(read_mock_data.conn,
+				   BT_ATT_ERR_ATTRIBUTE_NOT_FOUND,
+				   params, NULL, 0);
+		return;
+	}
+
+	if (BT_GATT_ITER_STOP ==
+		params->func(read_mock_data.conn, 0, params,
+			     read_mock_data.db_hash, 16)) {
+		return;
+	}
+
+	/* Send NULL to mark processing end */
+	(void)params->func(read_mock_data.conn, 0, params, NULL, 0);
+}
+
+/* Mocked version of the bt_gatt_read, reading by UUID only */
+/* Call the bt_gatt_read_mock_setup function first */
+int bt_gatt_read(struct bt_conn *conn, struct bt_gatt_read_params *params)
+{
+	printk("Running %s mock\n", __func__);
+
+	zassert_equal(0, params->handle_count, "Only reads by UUID are mocked");
+	zassert_true(!bt_uuid_cmp(BT_UUID_GATT_DB_HASH, params->by_uuid.uuid),
+		     "Unexpected UUID read");
+
+	if (read_mock_data.err) {
+		return read_mock_data.err;
+	}
+
+	read_mock_data.conn = conn;
+	read_mock_data.params = params;
+
+	k_work_schedule(&read_mock_data.work, K_MSEC(5));
+	return 0;
+}
@@ -9,6 +9,7 @@
 
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/conn.h>
 
 
 /**
@@ -90,5 +91,44 @@
  */
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len);
 
+/**
+ * @brief Number of discoveries run since the mock setup
+ *
+ * @return The number of @ref bt_gatt_discover calls
+ */
+size_t bt_gatt_discover_mock_count(void);
+
+/**
+ * @brief GATT read mock setup
+ *
+ * This function setups the mock for @ref bt_gatt_read function, which
+ * is only used to read the Database Hash.
+ *
+ * @param db_hash The 16 bytes of the Database Hash,
+ *                or NULL if the peer has none
+ */
+void bt_gatt_read_mock_setup(const uint8_t *db_hash);
+
+/**
+ * @brief GATT read mock error
+ *
+ * Makes the @ref bt_gatt_read function fail until the next
+ * @ref bt_gatt_read_mock_setup call.
+ *
+ * @param err The error returned by @ref bt_gatt_read
+ */
+void bt_gatt_read_mock_error_set(int err);
+
+/**
+ * @brief Connection mock setup
+ *
+ * This function setups the mock for @ref bt_conn_get_info and
+ * @ref bt_addr_le_is_bonded functions.
+ *
+ * @param peer   The identity address of the connected peer
+ * @param bonded True if the peer is bonded
+ */
+void bt_conn_mock_setup(const bt_addr_le_t *peer, bool bonded);
+
 /** @} */
 #endif /* #define BT_GATT_DISCOVERY_MOCK_H_ */
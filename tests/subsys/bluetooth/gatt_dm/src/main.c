@@ -20,6 +20,38 @@
 static char dummy_conn;
 K_SEM_DEFINE(discovery_finished, 0, 1);
 
+static const uint8_t db_hash[16] = {
+	0xf1, 0x3e, 0x81, 0x6a, 0x20, 0x5c, 0x94, 0x07,
+	0xbd, 0x12, 0x3a, 0xe6, 0x58, 0x77, 0xc0, 0x29
+};
+static const uint8_t db_hash_changed[16] = {
+	0x0c, 0x9a, 0x44, 0xd2, 0x6b, 0x18, 0xef, 0x53,
+	0x71, 0xa5, 0x08, 0x3c, 0x96, 0xe4, 0x2f, 0xb0
+};
+
+static const bt_addr_le_t peer = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = { 0x01, 0x42, 0x13, 0x37, 0x00, 0xc0 }
+};
+static const bt_addr_le_t peer_other = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = { 0x02, 0x42, 0x13, 0x37, 0x00, 0xc0 }
+};
+
+/* Discovered attributes, to compare discoveries of the same service */
+struct attr_snapshot {
+	uint16_t handle;
+	uint16_t value_handle;
+	uint8_t properties;
+	char uuid[BT_UUID_STR_LEN];
+	char value_uuid[BT_UUID_STR_LEN];
+};
+
+struct dm_snapshot {
+	size_t cnt;
+	struct attr_snapshot attrs[CONFIG_BT_GATT_DM_MAX_ATTRS];
+};
+
 
 const struct bt_gatt_attr discover_sim[] = {
 	/* HIDS */
@@ -87,12 +119,65 @@ struct bt_gatt_dm_cb test_hids_cb = {
 	.error_found       = test_cb_error_found
 };
 
+static int discovery_err;
+
+void test_cb_error_expected(struct bt_conn *conn, int err, void *context)
+{
+	printk("%s\n", __func__);
+	discovery_err = err;
+	k_sem_give(&discovery_finished);
+}
+struct bt_gatt_dm_cb test_error_cb = {
+	.completed         = test_cb_completed,
+	.service_not_found = test_cb_service_not_found,
+	.error_found       = test_cb_error_expected
+};
+
 void test_before(void *fixture)
 {
 	ARG_UNUSED(fixture);
 
 	k_sem_reset(&discovery_finished);
 	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	bt_gatt_read_mock_setup(NULL);
+	bt_conn_mock_setup(&peer, true);
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	bt_gatt_dm_cache_clear();
+#endif
+}
+
+void test_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)bt_gatt_dm_arena_set(NULL, 0);
+}
+
+static void snapshot_take(const struct bt_gatt_dm *dm, struct dm_snapshot *snap)
+{
+	memset(snap, 0, sizeof(*snap));
+	snap->cnt = bt_gatt_dm_attr_cnt(dm);
+
+	for (size_t i = 0; i < snap->cnt; i++) {
+		const struct bt_gatt_dm_attr *attr = &bt_gatt_dm_service_get(dm)[i];
+		const struct bt_gatt_service_val *serv_val = bt_gatt_dm_attr_service_val(attr);
+		const struct bt_gatt_chrc *chrc_val = bt_gatt_dm_attr_chrc_val(attr);
+		struct attr_snapshot *attr_snap = &snap->attrs[i];
+
+		attr_snap->handle = attr->handle;
+		bt_uuid_to_str(attr->uuid, attr_snap->uuid, sizeof(attr_snap->uuid));
+
+		if (serv_val) {
+			attr_snap->value_handle = serv_val->end_handle;
+			bt_uuid_to_str(serv_val->uuid, attr_snap->value_uuid,
+				       sizeof(attr_snap->value_uuid));
+		} else if (chrc_val) {
+			attr_snap->value_handle = chrc_val->value_handle;
+			attr_snap->properties = chrc_val->properties;
+			bt_uuid_to_str(chrc_val->uuid, attr_snap->value_uuid,
+				       sizeof(attr_snap->value_uuid));
+		}
+	}
 }
 
 struct bt_gatt_dm *run_dm(const struct bt_uuid *svc_uuid)
@@ -126,7 +211,7 @@ struct bt_gatt_dm *run_dm_next(struct bt_gatt_dm *dm)
 	return dm_next;
 }
 
-ZTEST_SUITE(gatt_tests, NULL, NULL, test_before, NULL, NULL);
+ZTEST_SUITE(gatt_tests, NULL, NULL, test_before, test_after, NULL);
 
 /* The service that is not present */
 ZTEST(gatt_tests, test_gatt_none_serv)
@@ -476,3 +561,303 @@ ZTEST(gatt_tests, test_gatt_many_serv_by_uuid)
 	zassert_equal(0, bt_gatt_dm_attr_cnt(dm), "Parameter count after clearing: %d",
 		      bt_gatt_dm_attr_cnt(dm));
 }
+
+ZTEST(gatt_tests, test_gatt_arena)
+{
+	static uint32_t arena[BT_GATT_DM_ARENA_SIZE(CONFIG_BT_GATT_DM_MAX_ATTRS) /
+			      sizeof(uint32_t)];
+	const uint8_t *arena_end = (const uint8_t *)arena + sizeof(arena);
+	const struct bt_gatt_dm_attr *attr;
+	struct bt_gatt_dm *dm;
+
+	zassert_equal(-EINVAL, bt_gatt_dm_arena_set((uint8_t *)arena + 1, 16),
+		      "Unaligned arena accepted");
+	zassert_ok(bt_gatt_dm_arena_set(arena, sizeof(arena)));
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(11,
+		      bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	zassert_equal(-EBUSY, bt_gatt_dm_arena_set(NULL, 0),
+		      "Arena changed before the data was released");
+
+	/* All the data is placed in the arena */
+	for (size_t i = 0; i < bt_gatt_dm_attr_cnt(dm); i++) {
+		attr = &bt_gatt_dm_service_get(dm)[i];
+		zassert_true((const uint8_t *)attr->uuid >= (const uint8_t *)arena &&
+			     (const uint8_t *)attr->uuid < arena_end,
+			     "UUID of attribute %u outside of the arena", attr->handle);
+	}
+
+	attr = bt_gatt_dm_char_by_uuid(dm, BT_UUID_HIDS_REPORT);
+	zassert_not_null(attr, "Unexpected NULL");
+	zassert_equal(6, attr->handle, "Unexpected handle: %d", attr->handle);
+	attr = bt_gatt_dm_desc_by_uuid(dm, attr, BT_UUID_GATT_CCC);
+	zassert_not_null(attr, "Unexpected NULL");
+	zassert_equal(8, attr->handle, "Unexpected handle: %d", attr->handle);
+
+	bt_gatt_dm_data_release(dm);
+	zassert_ok(bt_gatt_dm_arena_set(NULL, 0));
+}
+
+ZTEST(gatt_tests, test_gatt_arena_too_small)
+{
+	static uint32_t arena[8];
+	struct bt_gatt_dm *dm;
+	int err;
+
+	zassert_ok(bt_gatt_dm_arena_set(arena, sizeof(arena)));
+
+	discovery_err = 0;
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_HIDS,
+			       &test_error_cb, &dm);
+	zassert_ok(err, "bt_gatt_dm_start finished with error: %d", err);
+	err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+	zassert_equal(0, err, "It seems that no callback function was called: %d", err);
+	zassert_equal(-ENOMEM, discovery_err, "Unexpected error: %d", discovery_err);
+
+	/* Nothing is left locked after the error */
+	zassert_ok(bt_gatt_dm_arena_set(NULL, 0));
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(11,
+		      bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_tests, test_gatt_cache_hit)
+{
+	static struct dm_snapshot discovered;
+	static struct dm_snapshot cached;
+	struct bt_gatt_dm *dm;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	bt_gatt_read_mock_setup(db_hash);
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+	snapshot_take(dm, &discovered);
+	bt_gatt_dm_data_release(dm);
+
+	/* The same database again, as after a reconnection */
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(0, bt_gatt_discover_mock_count(), "Cached service discovered");
+	snapshot_take(dm, &cached);
+	bt_gatt_dm_data_release(dm);
+
+	zassert_equal(11, cached.cnt, "Unexpected number of attributes: %zu", cached.cnt);
+	zassert_mem_equal(&discovered, &cached, sizeof(cached), "Cached service differs");
+
+	/* Services that are not there are cached as well */
+	zassert_is_null(run_dm(BT_UUID_BAS), "Detected service that should be inviable");
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	zassert_is_null(run_dm(BT_UUID_BAS), "Detected service that should be inviable");
+	zassert_equal(0, bt_gatt_discover_mock_count(), "Missing service discovered");
+}
+
+ZTEST(gatt_tests, test_gatt_cache_continue)
+{
+	static struct dm_snapshot discovered[6];
+	static struct dm_snapshot cached;
+	struct bt_gatt_dm *dm;
+	size_t cnt;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	bt_gatt_read_mock_setup(db_hash);
+
+	cnt = 0;
+	for (dm = run_dm(NULL); dm; dm = run_dm_next(dm)) {
+		zassert_true(cnt < ARRAY_SIZE(discovered), "Too many services");
+		snapshot_take(dm, &discovered[cnt++]);
+	}
+	zassert_equal(ARRAY_SIZE(discovered), cnt, "Unexpected number of services: %zu", cnt);
+
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+
+	cnt = 0;
+	for (dm = run_dm(NULL); dm; dm = run_dm_next(dm)) {
+		zassert_true(cnt < ARRAY_SIZE(discovered), "Too many services");
+		snapshot_take(dm, &cached);
+		zassert_mem_equal(&discovered[cnt], &cached, sizeof(cached),
+				  "Cached service %zu differs", cnt);
+		cnt++;
+	}
+	zassert_equal(ARRAY_SIZE(discovered), cnt, "Unexpected number of services: %zu", cnt);
+	zassert_equal(0, bt_gatt_discover_mock_count(), "Cached services discovered");
+}
+
+ZTEST(gatt_tests, test_gatt_cache_db_hash)
+{
+	struct bt_gatt_dm *dm;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	/* Without the Database Hash, the services are always discovered */
+	for (int i = 0; i < 2; i++) {
+		bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+		dm = run_dm(BT_UUID_DIS);
+		zassert_not_null(dm, "Device Manager pointer not set");
+		zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+		bt_gatt_dm_data_release(dm);
+	}
+
+	bt_gatt_read_mock_setup(db_hash);
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	bt_gatt_dm_data_release(dm);
+
+	/* The database changed */
+	bt_gatt_read_mock_setup(db_hash_changed);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+	bt_gatt_dm_data_release(dm);
+
+	/* Both databases are cached until the cache is cleared */
+	bt_gatt_read_mock_setup(db_hash);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(0, bt_gatt_discover_mock_count(), "Cached service discovered");
+	bt_gatt_dm_data_release(dm);
+
+	bt_gatt_dm_cache_clear();
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+	zassert_equal(5,
+		      bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_tests, test_gatt_cache_not_bonded)
+{
+	struct bt_gatt_dm *dm;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	/* The services of a peer that is not bonded are always discovered */
+	bt_conn_mock_setup(&peer, false);
+	bt_gatt_read_mock_setup(db_hash);
+
+	for (int i = 0; i < 2; i++) {
+		bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+		dm = run_dm(BT_UUID_DIS);
+		zassert_not_null(dm, "Device Manager pointer not set");
+		zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+		bt_gatt_dm_data_release(dm);
+	}
+
+	/* Nor are they taken from the cache once it is bonded */
+	bt_conn_mock_setup(&peer, true);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_tests, test_gatt_cache_peer)
+{
+	struct bt_gatt_dm *dm;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	bt_gatt_read_mock_setup(db_hash);
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	bt_gatt_dm_data_release(dm);
+
+	/* Another peer with the same Database Hash */
+	bt_conn_mock_setup(&peer_other, true);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_count() > 0, "Service of another peer taken");
+	bt_gatt_dm_data_release(dm);
+
+	bt_conn_mock_setup(&peer, true);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(0, bt_gatt_discover_mock_count(), "Cached service discovered");
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_tests, test_gatt_cache_eviction)
+{
+	/* A record holds at least the key, so this many records overflow the cache. */
+	const size_t peer_cnt = CONFIG_BT_GATT_DM_CACHE_SIZE / 32 + 1;
+	bt_addr_le_t addr = peer;
+	struct bt_gatt_dm *dm;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	bt_gatt_read_mock_setup(db_hash);
+
+	/* The same service of other peers, until the cache is full */
+	for (size_t i = 0; i < peer_cnt; i++) {
+		addr.a.val[5] = i;
+		bt_conn_mock_setup(&addr, true);
+		bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+		dm = run_dm(BT_UUID_DIS);
+		zassert_not_null(dm, "Device Manager pointer not set");
+		zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+		bt_gatt_dm_data_release(dm);
+	}
+
+	/* The most recent service is still cached */
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(0, bt_gatt_discover_mock_count(), "Cached service discovered");
+	bt_gatt_dm_data_release(dm);
+
+	/* The oldest one was removed to make room */
+	addr.a.val[5] = 0;
+	bt_conn_mock_setup(&addr, true);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_count() > 0, "Removed service not discovered");
+	zassert_equal(5,
+		      bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_tests, test_gatt_cache_read_error)
+{
+	struct bt_gatt_dm *dm;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_GATT_DM_CACHE);
+
+	/* The discovery runs without the cache if the hash cannot be read */
+	bt_gatt_read_mock_setup(db_hash);
+	bt_gatt_read_mock_error_set(-ENOMEM);
+
+	for (int i = 0; i < 2; i++) {
+		bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+		dm = run_dm(BT_UUID_DIS);
+		zassert_not_null(dm, "Device Manager pointer not set");
+		zassert_true(bt_gatt_discover_mock_count() > 0, "Service not discovered");
+		zassert_equal(5,
+			      bt_gatt_dm_attr_cnt(dm),
+			      "Unexpected number of attributes detected: %d",
+			      bt_gatt_dm_attr_cnt(dm));
+		bt_gatt_dm_data_release(dm);
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+#include <emds/emds.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* Simulated time does not advance while the CPU is busy, use host time instead. */
+#include <native_rtc.h>
+#define TIME_NOW_US() native_rtc_gettime_us(RTC_CLOCK_REALTIME)
+#else
+#define TIME_NOW_US() k_cyc_to_us_floor64(k_cycle_get_32())
+#endif
+
+#define CRPL CONFIG_BT_MESH_CRPL
+#define ROUNDS 20
+/* First address, so that the addresses are not aligned to the hash size. */
+#define ADDR_BASE 0x0123
+
+static struct bt_mesh_rpl stored[CRPL];
+
+static struct bt_mesh_net_rx rx_msg(uint16_t src, uint32_t seq)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.local_match = 1,
+		.net_if = BT_MESH_NET_IF_ADV,
+	};
+
+	return rx;
+}
+
+static struct emds_entry *rpl_entry_get(void)
+{
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		if (entry->id == CONFIG_BT_MESH_RPL_INDEX) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* The lookup used before the list was indexed, on a copy of the list. */
+static bool linear_check(struct bt_mesh_rpl *list, struct bt_mesh_net_rx *rx)
+{
+	for (int i = 0; i < CRPL; i++) {
+		if (!list[i].src) {
+			return false;
+		}
+		if (list[i].src == rx->ctx.addr) {
+			return list[i].seq >= rx->seq;
+		}
+	}
+
+	return true;
+}
+
+static void test_before(void *fixture)
+{
+	bt_mesh_rpl_clear();
+}
+
+ZTEST_SUITE(bt_mesh_rpl_benchmark, NULL, NULL, test_before, NULL, NULL);
+
+/* Replays from every source of a full list, so that neither list changes. */
+ZTEST(bt_mesh_rpl_benchmark, test_lookup)
+{
+	struct emds_entry *entry = rpl_entry_get();
+	uint32_t lookups = ROUNDS * CRPL;
+	uint64_t hashed_us, linear_us;
+	struct bt_mesh_net_rx rx;
+	uint64_t start;
+
+	for (uint16_t i = 0; i < CRPL; i++) {
+		rx = rx_msg(ADDR_BASE + i, 1);
+		zassert_false(bt_mesh_rpl_check(&rx, NULL));
+	}
+	memcpy(stored, entry->data, sizeof(stored));
+
+	start = TIME_NOW_US();
+	for (int round = 0; round < ROUNDS; round++) {
+		for (uint16_t i = 0; i < CRPL; i++) {
+			rx = rx_msg(ADDR_BASE + (i * 7) % CRPL, 1);
+			zassert_true(bt_mesh_rpl_check(&rx, NULL));
+		}
+	}
+	hashed_us = TIME_NOW_US() - start;
+
+	start = TIME_NOW_US();
+	for (int round = 0; round < ROUNDS; round++) {
+		for (uint16_t i = 0; i < CRPL; i++) {
+			rx = rx_msg(ADDR_BASE + (i * 7) % CRPL, 1);
+			zassert_true(linear_check(stored, &rx));
+		}
+	}
+	linear_us = TIME_NOW_US() - start;
+
+	printk("CRPL %d, average lookup [ns]: hashed %llu, linear %llu\n", CRPL,
+	       (unsigned long long)(hashed_us * 1000 / lookups),
+	       (unsigned long long)(linear_us * 1000 / lookups));
+}
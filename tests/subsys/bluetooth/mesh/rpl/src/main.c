@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+#include <emds/emds.h>
+
+#define CRPL CONFIG_BT_MESH_CRPL
+#define MSGS (8 * CRPL)
+/* First address, so that the addresses are not aligned to the hash size. */
+#define ADDR_BASE 0x0123
+
+static struct bt_mesh_rpl stored[CRPL];
+static uint32_t rand_state;
+
+/* Deterministic pseudo-random numbers, so that failures are reproducible. */
+static uint32_t rand_next(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static struct bt_mesh_net_rx rx_msg(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.local_match = 1,
+		.net_if = BT_MESH_NET_IF_ADV,
+	};
+
+	return rx;
+}
+
+static bool replayed(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = rx_msg(src, seq, old_iv);
+
+	return bt_mesh_rpl_check(&rx, NULL);
+}
+
+static struct emds_entry *rpl_entry_get(void)
+{
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		if (entry->id == CONFIG_BT_MESH_RPL_INDEX) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	bt_mesh_rpl_clear();
+}
+
+ZTEST_SUITE(bt_mesh_rpl, NULL, NULL, test_before, NULL, NULL);
+
+ZTEST(bt_mesh_rpl, test_replay)
+{
+	struct bt_mesh_net_rx local = rx_msg(ADDR_BASE, 1, false);
+
+	zassert_false(replayed(ADDR_BASE, 10, false));
+	zassert_true(replayed(ADDR_BASE, 10, false));
+	zassert_true(replayed(ADDR_BASE, 9, false));
+	zassert_false(replayed(ADDR_BASE, 11, false));
+	zassert_false(replayed(ADDR_BASE + 1, 10, false));
+	zassert_true(replayed(ADDR_BASE + 1, 10, false));
+
+	local.net_if = BT_MESH_NET_IF_LOCAL;
+	zassert_false(bt_mesh_rpl_check(&local, NULL));
+	zassert_false(bt_mesh_rpl_check(&local, NULL));
+}
+
+ZTEST(bt_mesh_rpl, test_segmented_match)
+{
+	struct bt_mesh_net_rx rx = rx_msg(ADDR_BASE, 5, false);
+	struct bt_mesh_rpl *rpl = NULL;
+
+	/* Not updated, nor reserved, until the segmented message is complete. */
+	zassert_false(bt_mesh_rpl_check(&rx, &rpl));
+	zassert_not_null(rpl);
+	zassert_not_equal(rpl->src, ADDR_BASE);
+	zassert_false(replayed(ADDR_BASE + 1, 3, false));
+	zassert_false(replayed(ADDR_BASE, 3, false));
+
+	bt_mesh_rpl_update(rpl, &rx);
+	zassert_true(replayed(ADDR_BASE, 5, false));
+	zassert_true(replayed(ADDR_BASE, 4, false));
+	zassert_true(replayed(ADDR_BASE + 1, 3, false));
+	zassert_false(replayed(ADDR_BASE + 1, 4, false));
+}
+
+ZTEST(bt_mesh_rpl, test_segmented_match_full)
+{
+	struct bt_mesh_net_rx rx = rx_msg(ADDR_BASE + CRPL, 5, false);
+	struct bt_mesh_rpl *rpl = NULL;
+
+	for (uint16_t i = 0; i < CRPL - 1; i++) {
+		zassert_false(replayed(ADDR_BASE + i, 100, false));
+	}
+
+	zassert_false(bt_mesh_rpl_check(&rx, &rpl));
+
+	/* The last entry is taken before the segmented message is complete. */
+	zassert_false(replayed(ADDR_BASE + CRPL - 1, 100, false));
+	bt_mesh_rpl_update(rpl, &rx);
+
+	/* The entry is not overwritten, and the list is full for the new source. */
+	zassert_true(replayed(ADDR_BASE + CRPL, 6, false));
+	for (uint16_t i = 0; i < CRPL; i++) {
+		zassert_true(replayed(ADDR_BASE + i, 100, false), "0x%04x", ADDR_BASE + i);
+	}
+}
+
+ZTEST(bt_mesh_rpl, test_full)
+{
+	for (uint16_t i = 0; i < CRPL; i++) {
+		zassert_false(replayed(ADDR_BASE + i, 100, false));
+	}
+
+	/* No entry is replaced, so new sources are rejected and all others are still
+	 * protected.
+	 */
+	zassert_true(replayed(ADDR_BASE + CRPL, 100, false));
+	zassert_true(replayed(ADDR_BASE + CRPL, 101, false));
+	for (uint16_t i = 0; i < CRPL; i++) {
+		zassert_true(replayed(ADDR_BASE + i, 100, false), "0x%04x", ADDR_BASE + i);
+		zassert_false(replayed(ADDR_BASE + i, 101, false), "0x%04x", ADDR_BASE + i);
+	}
+}
+
+ZTEST(bt_mesh_rpl, test_full_replaces_old_iv)
+{
+	for (uint16_t i = 0; i < CRPL; i++) {
+		zassert_false(replayed(ADDR_BASE + i, 100, false));
+	}
+
+	bt_mesh_rpl_reset();
+
+	/* All sources but the first one send with the new IV index. */
+	for (uint16_t i = 1; i < CRPL; i++) {
+		zassert_false(replayed(ADDR_BASE + i, 1, false));
+	}
+
+	/* Replaces the entry of the previous IV index. */
+	zassert_false(replayed(ADDR_BASE + CRPL, 1, false));
+	zassert_true(replayed(ADDR_BASE + CRPL, 1, false));
+
+	/* The replaced source is unknown now, but its old messages are still rejected. */
+	zassert_true(replayed(ADDR_BASE, 100, true));
+	zassert_true(replayed(ADDR_BASE, 101, true));
+	zassert_true(replayed(ADDR_BASE + CRPL + 1, 1, true));
+
+	/* No entry of the previous IV index left. */
+	zassert_true(replayed(ADDR_BASE, 1, false));
+	for (uint16_t i = 1; i < CRPL; i++) {
+		zassert_true(replayed(ADDR_BASE + i, 1, false), "0x%04x", ADDR_BASE + i);
+	}
+
+	/* Another IV update drops the replaced source. */
+	bt_mesh_rpl_reset();
+	zassert_true(replayed(ADDR_BASE + 1, 1, true));
+	zassert_false(replayed(ADDR_BASE, 1, false));
+}
+
+ZTEST(bt_mesh_rpl, test_iv_update)
+{
+	zassert_false(replayed(ADDR_BASE, 10, false));
+	zassert_false(replayed(ADDR_BASE + 1, 10, false));
+
+	bt_mesh_rpl_reset();
+
+	/* Entries from the previous IV index are old now. */
+	zassert_true(replayed(ADDR_BASE, 10, true));
+	zassert_false(replayed(ADDR_BASE, 1, false));
+	zassert_false(replayed(ADDR_BASE + 2, 1, false));
+
+	bt_mesh_rpl_reset();
+
+	/* Old entries are dropped, and the list is compacted. */
+	zassert_false(replayed(ADDR_BASE + 1, 1, false));
+	zassert_true(replayed(ADDR_BASE, 1, true));
+	zassert_true(replayed(ADDR_BASE + 2, 1, true));
+	zassert_false(replayed(ADDR_BASE + 2, 1, false));
+}
+
+/* The list is restored by EMDS, in any order, before the first check. */
+ZTEST(bt_mesh_rpl, test_restore)
+{
+	struct emds_entry *entry = rpl_entry_get();
+	size_t count = MIN(CRPL, 16);
+
+	zassert_not_null(entry);
+	zassert_equal(entry->len, sizeof(stored));
+
+	for (uint16_t i = 0; i < count; i++) {
+		zassert_false(replayed(ADDR_BASE + i, 1000 + i, false));
+	}
+
+	memcpy(stored, entry->data, sizeof(stored));
+	bt_mesh_rpl_clear();
+
+	/* Spread out, as an older list could be. */
+	memset(entry->data, 0, entry->len);
+	for (uint16_t i = 0; i < count; i++) {
+		((struct bt_mesh_rpl *)entry->data)[CRPL - 1 - i * (CRPL / count)] = stored[i];
+	}
+
+	for (uint16_t i = 0; i < count; i++) {
+		zassert_true(replayed(ADDR_BASE + i, 1000 + i, false));
+		zassert_false(replayed(ADDR_BASE + i, 1001 + i, false));
+	}
+	zassert_false(replayed(ADDR_BASE + count, 1, false));
+}
+
+/* The check as it was before the list was indexed, on a copy of the list. */
+static bool linear_check(struct bt_mesh_rpl *list, struct bt_mesh_net_rx *rx)
+{
+	for (int i = 0; i < CRPL; i++) {
+		if (!list[i].src) {
+			list[i].src = rx->ctx.addr;
+			list[i].seq = rx->seq;
+			return false;
+		}
+
+		if (list[i].src == rx->ctx.addr) {
+			if (list[i].seq >= rx->seq) {
+				return true;
+			}
+
+			list[i].seq = rx->seq;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Random messages are accepted and rejected as by the linear check, also once the list
+ * is full.
+ */
+ZTEST(bt_mesh_rpl, test_matches_linear)
+{
+	struct bt_mesh_net_rx rx;
+	bool expected;
+
+	memset(stored, 0, sizeof(stored));
+	rand_state = 0x2545F491;
+
+	for (int i = 0; i < MSGS; i++) {
+		rx = rx_msg(ADDR_BASE + (rand_next() % (CRPL + CRPL / 4)),
+			    rand_next() % 16, false);
+
+		expected = linear_check(stored, &rx);
+		zassert_equal(bt_mesh_rpl_check(&rx, NULL), expected, "0x%04x seq %u",
+			      rx.ctx.addr, rx.seq);
+	}
+}
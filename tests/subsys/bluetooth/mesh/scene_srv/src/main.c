@@ -0,0 +1,674 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/mesh.h>
+#include <bluetooth/mesh/models.h>
+
+#include "mesh/access.h"
+
+#define ONOFF_ID BT_MESH_MODEL_ID_GEN_ONOFF_SRV
+#define LVL_ID BT_MESH_MODEL_ID_GEN_LEVEL_SRV
+#define VND_COMPANY 0x0059
+#define VND_ID 0x000a
+
+#define STORED_MAX 16
+#define DATA_PATH "bt/mesh/s/0/data/"
+
+/* Scene data layout, see scene_srv.c. */
+#define ITEM_VND BIT(0)
+#define ITEM_ABSENT BIT(1)
+
+struct __packed item {
+	uint8_t len;
+	uint8_t elem_idx;
+	uint8_t mod_idx;
+	uint8_t flags;
+	uint16_t id;
+	uint16_t company;
+	uint8_t data[];
+};
+
+/* Scene data stored by earlier versions. */
+struct __packed legacy_item {
+	uint8_t len;
+	uint8_t elem_idx;
+	uint16_t id;
+	uint8_t data[];
+};
+
+/* Length of a page with the given items. */
+#define PAGE_LEN(_items, _data_len) (1 + (_items) * sizeof(struct item) + (_data_len))
+
+/** Mocks ******************************************/
+
+struct mod_state {
+	uint8_t data[4];
+	size_t len;
+	uint8_t recalled[4];
+	size_t recalled_len;
+	int recall_count;
+};
+
+static struct mod_state onoff;
+static struct mod_state lvl;
+static struct mod_state vnd;
+
+static struct bt_mesh_scene_srv scene_srv;
+
+static struct bt_mesh_model models[] = {
+	BT_MESH_MODEL_SCENE_SRV(&scene_srv),
+	BT_MESH_MODEL(ONOFF_ID, NULL, NULL, &onoff),
+	BT_MESH_MODEL(LVL_ID, NULL, NULL, &lvl),
+};
+
+static struct bt_mesh_model vnd_models[] = {
+	BT_MESH_MODEL_VND(VND_COMPANY, VND_ID, NULL, NULL, &vnd),
+};
+
+static struct bt_mesh_elem elems[] = {
+	BT_MESH_ELEM(0, models, vnd_models),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elems,
+	.elem_count = ARRAY_SIZE(elems),
+};
+
+/* The same models, with the SIG models in the opposite order. */
+static struct bt_mesh_model swapped_models[] = {
+	BT_MESH_MODEL_SCENE_SRV(&scene_srv),
+	BT_MESH_MODEL(LVL_ID, NULL, NULL, &lvl),
+	BT_MESH_MODEL(ONOFF_ID, NULL, NULL, &onoff),
+};
+
+static struct bt_mesh_elem swapped_elems[] = {
+	BT_MESH_ELEM(0, swapped_models, vnd_models),
+};
+
+static const struct bt_mesh_comp swapped_comp = {
+	.elem = swapped_elems,
+	.elem_count = ARRAY_SIZE(swapped_elems),
+};
+
+static const struct bt_mesh_comp *current_comp = &comp;
+
+static struct {
+	char path[32];
+	uint8_t data[SETTINGS_MAX_VAL_LEN];
+	size_t len;
+} stored[STORED_MAX];
+
+static ssize_t state_store(struct bt_mesh_model *model, uint8_t data[])
+{
+	struct mod_state *state = model->user_data;
+
+	memcpy(data, state->data, state->len);
+	return state->len;
+}
+
+static void state_recall(struct bt_mesh_model *model, const uint8_t data[],
+			 size_t len, struct bt_mesh_model_transition *transition)
+{
+	struct mod_state *state = model->user_data;
+
+	zassert_true(len <= sizeof(state->recalled), "Recalled %u bytes", len);
+
+	memcpy(state->recalled, data, len);
+	state->recalled_len = len;
+	state->recall_count++;
+}
+
+BT_MESH_SCENE_ENTRY_SIG(onoff) = {
+	.id.sig = ONOFF_ID,
+	.maxlen = 1,
+	.store = state_store,
+	.recall = state_recall,
+};
+
+BT_MESH_SCENE_ENTRY_SIG(lvl) = {
+	.id.sig = LVL_ID,
+	.maxlen = 2,
+	.store = state_store,
+	.recall = state_recall,
+};
+
+BT_MESH_SCENE_ENTRY_VND(test) = {
+	.id.vnd = {
+		.company = VND_COMPANY,
+		.id = VND_ID,
+	},
+	.maxlen = 4,
+	.store = state_store,
+	.recall = state_recall,
+};
+
+const struct bt_mesh_comp *bt_mesh_comp_get(void)
+{
+	return current_comp;
+}
+
+uint16_t bt_mesh_elem_count(void)
+{
+	return current_comp->elem_count;
+}
+
+struct bt_mesh_elem *bt_mesh_model_elem(struct bt_mesh_model *mod)
+{
+	return &current_comp->elem[mod->elem_idx];
+}
+
+struct bt_mesh_model *bt_mesh_model_find(const struct bt_mesh_elem *elem,
+					 uint16_t id)
+{
+	for (int i = 0; i < elem->model_count; i++) {
+		if (elem->models[i].id == id) {
+			return &elem->models[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct bt_mesh_model *bt_mesh_model_find_vnd(const struct bt_mesh_elem *elem,
+					     uint16_t company, uint16_t id)
+{
+	for (int i = 0; i < elem->vnd_model_count; i++) {
+		if (elem->vnd_models[i].vnd.company == company &&
+		    elem->vnd_models[i].vnd.id == id) {
+			return &elem->vnd_models[i];
+		}
+	}
+
+	return NULL;
+}
+
+bool bt_mesh_model_is_extended(struct bt_mesh_model *model)
+{
+	return false;
+}
+
+int bt_mesh_model_extend(struct bt_mesh_model *extending_mod,
+			 struct bt_mesh_model *base_mod)
+{
+	return 0;
+}
+
+struct bt_mesh_dtt_srv *bt_mesh_dtt_srv_get(const struct bt_mesh_elem *elem)
+{
+	return NULL;
+}
+
+int tid_check_and_update(struct bt_mesh_tid_ctx *prev_transaction, uint8_t tid,
+			 const struct bt_mesh_msg_ctx *ctx)
+{
+	return 0;
+}
+
+uint8_t model_transition_encode(int32_t transition_time)
+{
+	return 0;
+}
+
+int32_t model_transition_decode(uint8_t encoded_transition)
+{
+	return 0;
+}
+
+int32_t model_delay_decode(uint8_t encoded_delay)
+{
+	return 0;
+}
+
+void bt_mesh_model_msg_init(struct net_buf_simple *msg, uint32_t opcode)
+{
+	net_buf_simple_init(msg, 0);
+}
+
+int bt_mesh_msg_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		     struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+const char *bt_hex(const void *buf, size_t len)
+{
+	return "";
+}
+
+static int stored_find(const char *path)
+{
+	for (int i = 0; i < ARRAY_SIZE(stored); i++) {
+		if (stored[i].len && !strcmp(stored[i].path, path)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void stored_set(const char *path, const void *data, size_t len)
+{
+	int i = stored_find(path);
+
+	if (!len) {
+		if (i >= 0) {
+			stored[i].len = 0;
+		}
+
+		return;
+	}
+
+	if (i < 0) {
+		for (i = 0; stored[i].len; i++) {
+			zassert_true(i + 1 < ARRAY_SIZE(stored), "Out of storage");
+		}
+	}
+
+	zassert_true(len <= sizeof(stored[i].data), "Too large: %u", len);
+
+	strcpy(stored[i].path, path);
+	memcpy(stored[i].data, data, len);
+	stored[i].len = len;
+}
+
+static const uint8_t *scene_page_get(const char *name, size_t *len)
+{
+	char path[32];
+	int i;
+
+	snprintf(path, sizeof(path), DATA_PATH "%s", name);
+	i = stored_find(path);
+	if (i < 0) {
+		return NULL;
+	}
+
+	*len = stored[i].len;
+	return stored[i].data;
+}
+
+static ssize_t stored_read(void *cb_arg, void *data, size_t len)
+{
+	int i = (intptr_t)cb_arg;
+
+	len = MIN(len, stored[i].len);
+	memcpy(data, stored[i].data, len);
+	return len;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	char path[32];
+
+	zassert_equal(mod, &models[0], "Stored by another model");
+	zassert_false(vnd, "Stored as vendor model data");
+
+	snprintf(path, sizeof(path), "bt/mesh/s/%x/data/%s",
+		 (mod->elem_idx << 8) | mod->mod_idx, name);
+	stored_set(path, data, data ? data_len : 0);
+	return 0;
+}
+
+int settings_name_next(const char *name, const char **next)
+{
+	int len = 0;
+
+	*next = NULL;
+
+	while (name[len] != '\0' && name[len] != '/') {
+		len++;
+	}
+
+	if (name[len] == '/') {
+		*next = &name[len + 1];
+	}
+
+	return len;
+}
+
+int settings_load_subtree_direct(const char *subtree,
+				 settings_load_direct_cb cb, void *param)
+{
+	size_t len = strlen(subtree);
+
+	for (int i = 0; i < ARRAY_SIZE(stored); i++) {
+		if (stored[i].len && !strncmp(stored[i].path, subtree, len) &&
+		    stored[i].path[len] == '/') {
+			cb(&stored[i].path[len + 1], stored[i].len, stored_read,
+			   (void *)(intptr_t)i, param);
+		}
+	}
+
+	return 0;
+}
+
+/** Helpers ******************************************/
+
+static void state_set(struct mod_state *state, const uint8_t *data, size_t len)
+{
+	memcpy(state->data, data, len);
+	state->len = len;
+}
+
+static void recalled_check(struct mod_state *state, const uint8_t *data,
+			   size_t len)
+{
+	zassert_equal(state->recall_count, 1, "Recalled %d times",
+		      state->recall_count);
+	zassert_equal(state->recalled_len, len);
+	zassert_mem_equal(state->recalled, data, len);
+}
+
+static void recall(uint16_t scene)
+{
+	onoff.recall_count = 0;
+	lvl.recall_count = 0;
+	vnd.recall_count = 0;
+
+	/* Recalling the current scene does nothing. */
+	bt_mesh_scene_invalidate(&models[2]);
+
+	zassert_ok(bt_mesh_scene_srv_set(&scene_srv, scene, NULL));
+	zassert_equal(bt_mesh_scene_srv_current_scene_get(&scene_srv), scene);
+}
+
+static void setup_msg_send(uint32_t opcode, uint16_t scene)
+{
+	const struct bt_mesh_model_op *op;
+	struct bt_mesh_msg_ctx ctx = { 0 };
+
+	NET_BUF_SIMPLE_DEFINE(buf, BT_MESH_SCENE_MSG_LEN_STORE);
+
+	net_buf_simple_add_le16(&buf, scene);
+
+	for (op = _bt_mesh_scene_setup_srv_op; op->func; op++) {
+		if (op->opcode == opcode) {
+			zassert_ok(op->func(&models[1], &ctx, &buf));
+			return;
+		}
+	}
+
+	zassert_unreachable("No handler for 0x%x", opcode);
+}
+
+static void store(uint16_t scene)
+{
+	setup_msg_send(BT_MESH_SCENE_OP_STORE_UNACK, scene);
+}
+
+static void delete(uint16_t scene)
+{
+	setup_msg_send(BT_MESH_SCENE_OP_DELETE_UNACK, scene);
+}
+
+/* Load the stored data, as on boot. */
+static void reboot(void)
+{
+	scene_srv.count = 0;
+	scene_srv.pages = 0;
+	scene_srv.sigpages = 0;
+	scene_srv.vndpages = 0;
+	scene_srv.base_len = 0;
+	memset(scene_srv.base, 0, sizeof(scene_srv.base));
+
+	for (int i = 0; i < ARRAY_SIZE(stored); i++) {
+		if (stored[i].len &&
+		    !strncmp(stored[i].path, DATA_PATH, strlen(DATA_PATH))) {
+			zassert_ok(_bt_mesh_scene_srv_cb.settings_set(
+				&models[0], &stored[i].path[strlen(DATA_PATH)],
+				stored[i].len, stored_read, (void *)(intptr_t)i));
+		}
+	}
+}
+
+static void *setup(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(models); i++) {
+		models[i].mod_idx = i;
+		swapped_models[i].mod_idx = i;
+	}
+
+	vnd_models[0].mod_idx = 0;
+
+	zassert_ok(_bt_mesh_scene_srv_cb.init(&models[0]));
+
+	return NULL;
+}
+
+static void before(void *f)
+{
+	current_comp = &comp;
+	_bt_mesh_scene_srv_cb.reset(&models[0]);
+	memset(stored, 0, sizeof(stored));
+	memset(&scene_srv.stats, 0, sizeof(scene_srv.stats));
+
+	state_set(&onoff, (uint8_t[]){ 0x01 }, 1);
+	state_set(&lvl, (uint8_t[]){ 0x10, 0x20 }, 2);
+	state_set(&vnd, (uint8_t[]){ 0x01, 0x02, 0x03, 0x04 }, 4);
+}
+
+ZTEST_SUITE(scene_srv, NULL, setup, before, NULL, NULL);
+
+/** Test cases ******************************************/
+
+ZTEST(scene_srv, test_diff_encoding)
+{
+	const struct item *item;
+	const uint8_t *page;
+	size_t len;
+
+	/* The first scene is the base state, and has no differences. */
+	store(1);
+
+	zassert_not_null(scene_page_get("0/d0", &len), "No base state");
+	zassert_equal(len, PAGE_LEN(3, 1 + 2 + 4));
+	zassert_not_null(scene_page_get("1/d0", &len));
+	zassert_equal(len, PAGE_LEN(0, 0));
+
+	state_set(&lvl, (uint8_t[]){ 0x30, 0x40 }, 2);
+	store(2);
+
+	page = scene_page_get("2/d0", &len);
+	zassert_not_null(page);
+	zassert_equal(len, PAGE_LEN(1, 2));
+
+	item = (const struct item *)&page[1];
+	zassert_equal(item->len, 2);
+	zassert_equal(item->elem_idx, 0);
+	zassert_equal(item->mod_idx, 3);
+	zassert_equal(item->flags, 0);
+	zassert_equal(item->id, LVL_ID);
+	zassert_equal(item->company, 0);
+	zassert_mem_equal(item->data, ((uint8_t[]){ 0x30, 0x40 }), 2);
+
+	/* A model without scene data overrides the base state. */
+	vnd.len = 0;
+	store(3);
+
+	page = scene_page_get("3/d0", &len);
+	zassert_not_null(page);
+	zassert_equal(len, PAGE_LEN(2, 2));
+
+	item = (const struct item *)&page[1 + sizeof(*item) + 2];
+	zassert_equal(item->len, 0);
+	zassert_equal(item->mod_idx, 0);
+	zassert_equal(item->flags, ITEM_VND | ITEM_ABSENT);
+	zassert_equal(item->id, VND_ID);
+	zassert_equal(item->company, VND_COMPANY);
+
+	recall(1);
+	recalled_check(&onoff, (uint8_t[]){ 0x01 }, 1);
+	recalled_check(&lvl, (uint8_t[]){ 0x10, 0x20 }, 2);
+	recalled_check(&vnd, (uint8_t[]){ 0x01, 0x02, 0x03, 0x04 }, 4);
+
+	recall(2);
+	recalled_check(&onoff, (uint8_t[]){ 0x01 }, 1);
+	recalled_check(&lvl, (uint8_t[]){ 0x30, 0x40 }, 2);
+	recalled_check(&vnd, (uint8_t[]){ 0x01, 0x02, 0x03, 0x04 }, 4);
+
+	recall(3);
+	recalled_check(&onoff, (uint8_t[]){ 0x01 }, 1);
+	recalled_check(&lvl, (uint8_t[]){ 0x30, 0x40 }, 2);
+	zassert_equal(vnd.recall_count, 0, "Recalled from the base state");
+
+	/* Only the base state is read on boot. */
+	reboot();
+
+	zassert_equal(scene_srv.count, 3);
+	zassert_equal(scene_srv.base_len, PAGE_LEN(3, 1 + 2 + 4));
+
+	recall(2);
+	recalled_check(&onoff, (uint8_t[]){ 0x01 }, 1);
+	recalled_check(&lvl, (uint8_t[]){ 0x30, 0x40 }, 2);
+	recalled_check(&vnd, (uint8_t[]){ 0x01, 0x02, 0x03, 0x04 }, 4);
+}
+
+ZTEST(scene_srv, test_model_changed)
+{
+	struct bt_mesh_scene_srv_stats stats;
+	size_t len;
+
+	store(1);
+
+	/* The scene data isn't recalled to the models now at the stored
+	 * indexes.
+	 */
+	current_comp = &swapped_comp;
+
+	recall(1);
+	zassert_equal(onoff.recall_count, 0, "Recalled to another model");
+	zassert_equal(lvl.recall_count, 0, "Recalled to another model");
+	recalled_check(&vnd, (uint8_t[]){ 0x01, 0x02, 0x03, 0x04 }, 4);
+
+	bt_mesh_scene_srv_stats_get(&scene_srv, &stats);
+	zassert_equal(stats.recall_entries, 1);
+
+	/* The base state of the changed models isn't used. */
+	store(2);
+
+	zassert_not_null(scene_page_get("2/d0", &len));
+	zassert_equal(len, PAGE_LEN(2, 2 + 1));
+
+	recall(2);
+	recalled_check(&onoff, (uint8_t[]){ 0x01 }, 1);
+	recalled_check(&lvl, (uint8_t[]){ 0x10, 0x20 }, 2);
+	recalled_check(&vnd, (uint8_t[]){ 0x01, 0x02, 0x03, 0x04 }, 4);
+}
+
+ZTEST(scene_srv, test_legacy_recovery)
+{
+	uint8_t sig[2 * sizeof(struct legacy_item) + 1 + 2];
+	uint8_t vnd_page[sizeof(struct legacy_item) + 2 + 4];
+	struct legacy_item *item;
+	size_t len;
+
+	item = (struct legacy_item *)sig;
+	item->len = 1;
+	item->elem_idx = 0;
+	item->id = ONOFF_ID;
+	item->data[0] = 0x00;
+
+	item = (struct legacy_item *)&item->data[item->len];
+	item->len = 2;
+	item->elem_idx = 0;
+	item->id = LVL_ID;
+	item->data[0] = 0x50;
+	item->data[1] = 0x60;
+
+	/* Vendor model data starts with the company ID. */
+	item = (struct legacy_item *)vnd_page;
+	item->len = 2 + 4;
+	item->elem_idx = 0;
+	item->id = VND_ID;
+	sys_put_le16(VND_COMPANY, item->data);
+	memcpy(&item->data[2], ((uint8_t[]){ 0x05, 0x06, 0x07, 0x08 }), 4);
+
+	stored_set(DATA_PATH "5/s0", sig, sizeof(sig));
+	stored_set(DATA_PATH "5/v0", vnd_page, sizeof(vnd_page));
+
+	reboot();
+
+	zassert_equal(scene_srv.count, 1);
+	zassert_equal(scene_srv.all[0], 5);
+	zassert_equal(scene_srv.sigpages, 1);
+	zassert_equal(scene_srv.vndpages, 1);
+
+	recall(5);
+	recalled_check(&onoff, (uint8_t[]){ 0x00 }, 1);
+	recalled_check(&lvl, (uint8_t[]){ 0x50, 0x60 }, 2);
+	recalled_check(&vnd, (uint8_t[]){ 0x05, 0x06, 0x07, 0x08 }, 4);
+
+	/* Storing the scene again replaces the old pages. */
+	store(5);
+
+	zassert_is_null(scene_page_get("5/s0", &len), "SIG page not deleted");
+	zassert_is_null(scene_page_get("5/v0", &len), "Vendor page not deleted");
+	zassert_not_null(scene_page_get("5/d0", &len));
+	zassert_not_null(scene_page_get("0/d0", &len));
+}
+
+ZTEST(scene_srv, test_base_delete)
+{
+	size_t len;
+
+	store(1);
+	store(2);
+
+	delete(1);
+	zassert_is_null(scene_page_get("1/d0", &len));
+	zassert_not_null(scene_page_get("0/d0", &len), "Base deleted with scenes left");
+	zassert_not_equal(scene_srv.base_len, 0);
+
+	delete(2);
+	zassert_is_null(scene_page_get("2/d0", &len));
+	zassert_is_null(scene_page_get("0/d0", &len), "Base not deleted");
+	zassert_equal(scene_srv.base_len, 0);
+
+	/* The next stored scene makes a new base state. */
+	state_set(&lvl, (uint8_t[]){ 0x30, 0x40 }, 2);
+	store(3);
+
+	zassert_not_null(scene_page_get("0/d0", &len));
+	zassert_not_null(scene_page_get("3/d0", &len));
+	zassert_equal(len, PAGE_LEN(0, 0));
+
+	recall(3);
+	recalled_check(&lvl, (uint8_t[]){ 0x30, 0x40 }, 2);
+}
+
+ZTEST(scene_srv, test_stats)
+{
+	struct bt_mesh_scene_srv_stats stats;
+
+	/* The base state and the scene. */
+	store(1);
+
+	bt_mesh_scene_srv_stats_get(&scene_srv, &stats);
+	zassert_equal(stats.records_written, 2);
+	zassert_equal(stats.bytes_written,
+		      PAGE_LEN(3, 1 + 2 + 4) + PAGE_LEN(0, 0));
+
+	state_set(&onoff, (uint8_t[]){ 0x00 }, 1);
+	store(2);
+
+	bt_mesh_scene_srv_stats_get(&scene_srv, &stats);
+	zassert_equal(stats.records_written, 3);
+	zassert_equal(stats.bytes_written,
+		      PAGE_LEN(3, 1 + 2 + 4) + PAGE_LEN(0, 0) + PAGE_LEN(1, 1));
+
+	recall(1);
+
+	bt_mesh_scene_srv_stats_get(&scene_srv, &stats);
+	zassert_equal(stats.recall_entries, 3);
+
+	/* Recalling doesn't write. */
+	zassert_equal(stats.records_written, 3);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <bluetooth/mesh/sensor_types.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* Simulated time does not advance while the CPU is busy, use host time instead. */
+#include <native_rtc.h>
+#define TIME_NOW_US() native_rtc_gettime_us(RTC_CLOCK_REALTIME)
+#else
+#define TIME_NOW_US() k_cyc_to_us_floor64(k_cycle_get_32())
+#endif
+
+#define ROUNDS 10000
+
+ZTEST_SUITE(sensor_types_benchmark, NULL, NULL, NULL, NULL, NULL);
+
+/* Encoding and decoding time of every channel format that is used by a sensor type. */
+ZTEST(sensor_types_benchmark, test_format_encode_decode)
+{
+	const struct bt_mesh_sensor_format *formats[64];
+	size_t format_count = 0;
+
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		for (int i = 0; i < type->channel_count; i++) {
+			const struct bt_mesh_sensor_format *format = type->channels[i].format;
+			struct sensor_value value;
+			uint64_t encode_us, decode_us;
+			uint64_t start;
+			size_t j;
+			int err;
+
+			for (j = 0; j < format_count && formats[j] != format; j++) {
+			}
+
+			if (j < format_count || format_count == ARRAY_SIZE(formats)) {
+				continue;
+			}
+
+			formats[format_count++] = format;
+
+			NET_BUF_SIMPLE_DEFINE(buf, CONFIG_BT_MESH_SENSOR_CHANNEL_ENCODED_SIZE_MAX);
+
+			/* Any valid value of the format. */
+			net_buf_simple_add(&buf, format->size);
+			memset(buf.data, 0, format->size);
+			if (format->decode(format, &buf, &value)) {
+				continue;
+			}
+
+			start = TIME_NOW_US();
+			for (int round = 0; round < ROUNDS; round++) {
+				net_buf_simple_reset(&buf);
+				err = format->encode(format, &value, &buf);
+				zassert_ok(err, "Encoding failed with error code: %i", err);
+			}
+			encode_us = TIME_NOW_US() - start;
+
+			start = TIME_NOW_US();
+			for (int round = 0; round < ROUNDS; round++) {
+				/* The encoded value is still in the buffer, only its length is reset. */
+				net_buf_simple_reset(&buf);
+				net_buf_simple_add(&buf, format->size);
+				err = format->decode(format, &buf, &value);
+				zassert_ok(err, "Decoding failed with error code: %i", err);
+			}
+			decode_us = TIME_NOW_US() - start;
+
+			printk("0x%04x channel %d (%u bytes): encode %llu ns, decode %llu ns\n",
+			       type->id, i, (unsigned int)format->size,
+			       (unsigned long long)(encode_us * 1000 / ROUNDS),
+			       (unsigned long long)(decode_us * 1000 / ROUNDS));
+		}
+	}
+}
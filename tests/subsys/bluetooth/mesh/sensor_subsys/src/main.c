@@ -9,6 +9,7 @@
 #include <float.h>
 
 #include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
 #include <bluetooth/mesh/properties.h>
 #include <bluetooth/mesh/sensor_types.h>
 #include <model_utils.h>
@@ -2437,4 +2438,122 @@ ZTEST(sensor_types_test, test_present_rel_output_ripple_voltage)
 	percentage8_check(sensor_type);
 }
 
+/* The conversion that the float32 format used before it was done with integers. */
+static uint32_t float32_reference_encode(const struct sensor_value *val)
+{
+	float fvalue = (float)val->val1 + (float)val->val2 / 1000000L;
+	uint32_t bits;
+
+	memcpy(&bits, &fvalue, sizeof(bits));
+	return bits;
+}
+
+static bool float32_reference_decode(uint32_t bits, struct sensor_value *val)
+{
+	float fvalue;
+
+	memcpy(&fvalue, &bits, sizeof(fvalue));
+	/* The float conversion is undefined out of range, where the decoder saturates. */
+	if (!(fabsf(fvalue) < 2147483648.0f)) {
+		return false;
+	}
+
+	val->val1 = (int32_t)fvalue;
+	val->val2 = ((int64_t)(fvalue * 1000000.0f)) % 1000000L;
+	return true;
+}
+
+ZTEST(sensor_types_test, test_sensor_gain)
+{
+	const struct bt_mesh_sensor_type *sensor_type;
+	const struct sensor_value values[] = {
+		{ 0, 0 }, { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 0, 500000 },
+		{ 1, 999999 }, { -1, -999999 }, { 3, 141593 }, { -273, -150000 },
+		{ 16777216, 0 }, { 16777217, 0 }, { 16777219, 500000 },
+		{ INT32_MAX, 999999 }, { INT32_MIN, -999999 }, { 1, -1000000 },
+		{ 0, INT32_MAX }, { -7, INT32_MIN }, { 12345, 678901 },
+	};
+	uint32_t seed = 0x12345678;
+
+	sensor_type = bt_mesh_sensor_type_get(BT_MESH_PROP_ID_SENSOR_GAIN);
+	sensor_type_sanitize(sensor_type);
+
+	for (int i = 0; i < ARRAY_SIZE(values) + 1000; i++) {
+		struct sensor_value in_value;
+		struct sensor_value expected;
+		uint32_t bits;
+
+		if (i < ARRAY_SIZE(values)) {
+			in_value = values[i];
+		} else {
+			seed = seed * 1103515245 + 12345;
+			in_value.val1 = (int32_t)seed >> (i % 31);
+			seed = seed * 1103515245 + 12345;
+			in_value.val2 = (int32_t)(seed % 2000000) - 1000000;
+		}
+
+		bits = sys_cpu_to_le32(float32_reference_encode(&in_value));
+		encoding_checking_proceed(sensor_type, &in_value, &bits, sizeof(bits));
+
+		if (float32_reference_decode(sys_le32_to_cpu(bits), &expected)) {
+			decoding_checking_proceed(sensor_type, &bits, sizeof(bits), &expected);
+		}
+	}
+}
+
+/* Every channel format that is used by a sensor type encodes the values it decodes. */
+ZTEST(sensor_types_test, test_format_roundtrip)
+{
+	const struct bt_mesh_sensor_format *formats[64];
+	size_t format_count = 0;
+
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		for (int i = 0; i < type->channel_count; i++) {
+			const struct bt_mesh_sensor_format *format = type->channels[i].format;
+			size_t j;
+
+			for (j = 0; j < format_count && formats[j] != format; j++) {
+			}
+
+			if (j < format_count) {
+				continue;
+			}
+
+			zassert_true(format_count < ARRAY_SIZE(formats), "Too many formats");
+			formats[format_count++] = format;
+
+			for (int byte = 0; byte <= UINT8_MAX; byte++) {
+				uint8_t raw[CONFIG_BT_MESH_SENSOR_CHANNEL_ENCODED_SIZE_MAX];
+				struct sensor_value value;
+				int err;
+
+				NET_BUF_SIMPLE_DEFINE(buf, CONFIG_BT_MESH_SENSOR_CHANNEL_ENCODED_SIZE_MAX);
+
+				memset(raw, byte, format->size);
+				net_buf_simple_add_mem(&buf, raw, format->size);
+
+				/* Not every raw value is valid. */
+				if (format->decode(format, &buf, &value)) {
+					continue;
+				}
+
+				net_buf_simple_reset(&buf);
+				err = format->encode(format, &value, &buf);
+				zassert_ok(err, "0x%04x channel %d: encoding 0x%02x failed: %i",
+					   type->id, i, byte, err);
+				zassert_equal(buf.len, format->size,
+					      "0x%04x channel %d: encoded %u bytes", type->id, i,
+					      buf.len);
+
+				/* Scaling may round other values, but never zero. */
+				if (byte == 0) {
+					zassert_mem_equal(buf.data, raw, format->size,
+							  "0x%04x channel %d: zero not encoded as zero",
+							  type->id, i);
+				}
+			}
+		}
+	}
+}
+
 ZTEST_SUITE(sensor_types_test, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include <bt_rpc.h>
+
+#include "bt_rpc_common.h"
+#include "bt_rpc_batch_client.h"
+#include "serialize.h"
+
+#define MSGS_MAX 4
+#define ITEMS_MAX 32
+#define ERRORS_MAX 4
+#define THREAD_STACK_SIZE 1024
+
+/* Batched calls used by the tests, the argument takes one byte. */
+#define ITEM_SIZE 1
+/* With the call ID and the null ending the batch, this many fit in the buffer. */
+#define ITEMS_PER_MSG ((CONFIG_BT_RPC_BATCH_SIZE - 1) / (ITEM_SIZE + 1))
+
+const struct nrf_rpc_group bt_rpc_grp;
+
+static uint8_t tx_buf[CONFIG_BT_RPC_BATCH_SIZE];
+
+/* Decoded messages sent to the host. */
+static struct {
+	size_t count;
+	uint8_t cmd;
+	uint32_t items[ITEMS_MAX];
+	bool values[ITEMS_MAX];
+} msgs[MSGS_MAX];
+static size_t msg_count;
+
+/* Response of the host to the next message: failed calls counted from the message start. */
+static struct {
+	uint32_t failed;
+	uint32_t index[ERRORS_MAX];
+	int err[ERRORS_MAX];
+} rsp;
+static int send_err;
+
+/* Reported failures. */
+static struct {
+	uint32_t index;
+	int err;
+} errors[ITEMS_MAX];
+static size_t error_count;
+
+static K_THREAD_STACK_DEFINE(thread_stack, THREAD_STACK_SIZE);
+static struct k_thread thread;
+
+void ser_encode_null(struct nrf_rpc_cbor_ctx *ctx)
+{
+	zcbor_nil_put(ctx->zs, NULL);
+}
+
+void ser_encode_bool(struct nrf_rpc_cbor_ctx *ctx, bool value)
+{
+	zcbor_bool_put(ctx->zs, value);
+}
+
+void ser_encode_uint(struct nrf_rpc_cbor_ctx *ctx, uint32_t value)
+{
+	zcbor_uint32_put(ctx->zs, value);
+}
+
+uint32_t ser_decode_uint(struct nrf_rpc_cbor_ctx *ctx)
+{
+	uint32_t result;
+
+	return zcbor_uint32_decode(ctx->zs, &result) ? result : 0;
+}
+
+int32_t ser_decode_int(struct nrf_rpc_cbor_ctx *ctx)
+{
+	int32_t result;
+
+	return zcbor_int32_decode(ctx->zs, &result) ? result : 0;
+}
+
+bool ser_decoding_done_and_check(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx)
+{
+	return ctx->zs->payload == ctx->zs->payload_end;
+}
+
+void test_cbor_alloc(struct nrf_rpc_cbor_ctx *ctx, size_t len)
+{
+	zassert_true(len <= sizeof(tx_buf));
+
+	ctx->out_packet = tx_buf;
+	zcbor_new_state(ctx->zs, ARRAY_SIZE(ctx->zs), tx_buf, len, 0);
+}
+
+static void msg_decode(const uint8_t *data, size_t len)
+{
+	zcbor_state_t zs[2];
+
+	zassert_true(msg_count < MSGS_MAX);
+
+	zcbor_new_state(zs, ARRAY_SIZE(zs), data, len, ITEMS_MAX * 2 + 1);
+
+	while (!zcbor_nil_expect(zs, NULL)) {
+		size_t i = msgs[msg_count].count++;
+
+		zassert_true(i < ITEMS_MAX);
+		zassert_true(zcbor_uint32_decode(zs, &msgs[msg_count].items[i]));
+		zassert_true(zcbor_bool_decode(zs, &msgs[msg_count].values[i]));
+	}
+
+	zassert_equal(zs->payload, zs->payload_end, "Data after the end of the batch");
+	msg_count++;
+}
+
+int nrf_rpc_cbor_cmd(const struct nrf_rpc_group *group, uint8_t cmd,
+		     struct nrf_rpc_cbor_ctx *ctx, nrf_rpc_cbor_handler_t handler,
+		     void *handler_data)
+{
+	static uint8_t rsp_buf[8 + ERRORS_MAX * 10];
+	struct nrf_rpc_cbor_ctx rsp_ctx;
+	size_t len;
+
+	zassert_equal(group, &bt_rpc_grp);
+
+	msgs[msg_count].cmd = cmd;
+	msg_decode(ctx->out_packet, ctx->zs->payload - ctx->out_packet);
+
+	if (send_err) {
+		return send_err;
+	}
+
+	zcbor_new_state(rsp_ctx.zs, ARRAY_SIZE(rsp_ctx.zs), rsp_buf, sizeof(rsp_buf), 0);
+	zcbor_uint32_put(rsp_ctx.zs, rsp.failed);
+	for (uint32_t i = 0; i < MIN(rsp.failed, ERRORS_MAX); i++) {
+		zcbor_uint32_put(rsp_ctx.zs, rsp.index[i]);
+		zcbor_int32_put(rsp_ctx.zs, rsp.err[i]);
+	}
+	len = rsp_ctx.zs->payload - rsp_buf;
+
+	zcbor_new_state(rsp_ctx.zs, ARRAY_SIZE(rsp_ctx.zs), rsp_buf, len, 2 * ERRORS_MAX + 1);
+	handler(group, &rsp_ctx, handler_data);
+
+	/* Only the first message fails. */
+	rsp.failed = 0;
+
+	return 0;
+}
+
+static void error_cb(uint32_t index, int err)
+{
+	zassert_true(error_count < ITEMS_MAX);
+
+	errors[error_count].index = index;
+	errors[error_count].err = err;
+	error_count++;
+}
+
+/* Returns true if the call was batched. */
+static bool item_call(bool value)
+{
+	struct nrf_rpc_cbor_ctx *ctx;
+
+	if (!bt_rpc_batch_item_begin(BT_RPC_BATCH_SET_BONDABLE, ITEM_SIZE, &ctx)) {
+		return false;
+	}
+
+	ser_encode_bool(ctx, value);
+	bt_rpc_batch_item_end();
+
+	return true;
+}
+
+static void test_before(void *fixture)
+{
+	memset(msgs, 0, sizeof(msgs));
+	msg_count = 0;
+	memset(&rsp, 0, sizeof(rsp));
+	send_err = 0;
+	error_count = 0;
+
+	bt_rpc_batch_error_cb_set(error_cb);
+}
+
+static void test_after(void *fixture)
+{
+	(void)bt_rpc_batch_end();
+	bt_rpc_batch_error_cb_set(NULL);
+}
+
+ZTEST_SUITE(bt_rpc_batch, NULL, NULL, test_before, test_after, NULL);
+
+ZTEST(bt_rpc_batch, test_no_batch)
+{
+	zassert_false(item_call(true));
+	zassert_equal(bt_rpc_batch_end(), -EALREADY);
+	zassert_equal(msg_count, 0);
+}
+
+ZTEST(bt_rpc_batch, test_batch)
+{
+	zassert_ok(bt_rpc_batch_begin());
+	zassert_equal(bt_rpc_batch_begin(), -EALREADY);
+
+	zassert_true(item_call(true));
+	zassert_true(item_call(false));
+	zassert_true(item_call(true));
+	zassert_equal(msg_count, 0, "Sent before the batch ended");
+
+	zassert_ok(bt_rpc_batch_end());
+	zassert_equal(bt_rpc_batch_end(), -EALREADY);
+
+	zassert_equal(msg_count, 1);
+	zassert_equal(msgs[0].cmd, BT_RPC_BATCH_RPC_CMD);
+	zassert_equal(msgs[0].count, 3);
+	for (size_t i = 0; i < 3; i++) {
+		zassert_equal(msgs[0].items[i], BT_RPC_BATCH_SET_BONDABLE);
+		zassert_equal(msgs[0].values[i], (i != 1));
+	}
+
+	/* Not batched anymore. */
+	zassert_false(item_call(true));
+}
+
+ZTEST(bt_rpc_batch, test_empty_batch)
+{
+	zassert_ok(bt_rpc_batch_begin());
+	zassert_ok(bt_rpc_batch_end());
+	zassert_equal(msg_count, 0);
+}
+
+ZTEST(bt_rpc_batch, test_flush_when_full)
+{
+	zassert_ok(bt_rpc_batch_begin());
+
+	for (size_t i = 0; i < ITEMS_PER_MSG + 1; i++) {
+		zassert_true(item_call(true));
+	}
+
+	zassert_equal(msg_count, 1);
+	zassert_equal(msgs[0].count, ITEMS_PER_MSG);
+
+	zassert_ok(bt_rpc_batch_end());
+	zassert_equal(msg_count, 2);
+	zassert_equal(msgs[1].count, 1);
+}
+
+ZTEST(bt_rpc_batch, test_call_too_large)
+{
+	struct nrf_rpc_cbor_ctx *ctx;
+
+	zassert_ok(bt_rpc_batch_begin());
+	zassert_true(item_call(true));
+
+	/* Sent on its own, after the calls batched before it. */
+	zassert_false(bt_rpc_batch_item_begin(BT_RPC_BATCH_GATT_NOTIFY_CB,
+					      CONFIG_BT_RPC_BATCH_SIZE, &ctx));
+	zassert_equal(msg_count, 1);
+	zassert_equal(msgs[0].count, 1);
+
+	zassert_ok(bt_rpc_batch_end());
+	zassert_equal(msg_count, 1);
+}
+
+static void other_thread_fn(void *p1, void *p2, void *p3)
+{
+	bool *batched = p1;
+	int *err = p2;
+
+	*batched = item_call(true);
+	*err = bt_rpc_batch_begin();
+	if (*err == 0) {
+		(void)bt_rpc_batch_end();
+	}
+}
+
+ZTEST(bt_rpc_batch, test_other_thread)
+{
+	bool batched = true;
+	int err = 0;
+
+	zassert_ok(bt_rpc_batch_begin());
+	zassert_true(item_call(true));
+
+	k_thread_create(&thread, thread_stack, K_THREAD_STACK_SIZEOF(thread_stack),
+			other_thread_fn, &batched, &err, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	zassert_ok(k_thread_join(&thread, K_SECONDS(1)));
+
+	zassert_false(batched, "Call of another thread was batched");
+	zassert_equal(err, -EBUSY);
+
+	zassert_ok(bt_rpc_batch_end());
+	zassert_equal(msg_count, 1);
+	zassert_equal(msgs[0].count, 1);
+}
+
+ZTEST(bt_rpc_batch, test_errors)
+{
+	zassert_ok(bt_rpc_batch_begin());
+
+	rsp.failed = 2;
+	rsp.index[0] = 1;
+	rsp.err[0] = -EINVAL;
+	rsp.index[1] = 4;
+	rsp.err[1] = -ENOMEM;
+
+	for (size_t i = 0; i < ITEMS_PER_MSG + 1; i++) {
+		zassert_true(item_call(true));
+	}
+
+	/* Reported as soon as the message is sent. */
+	zassert_equal(error_count, 2);
+	zassert_equal(errors[0].index, 1);
+	zassert_equal(errors[0].err, -EINVAL);
+	zassert_equal(errors[1].index, 4);
+	zassert_equal(errors[1].err, -ENOMEM);
+
+	/* Indexes in the following messages count from the start of the batch. */
+	rsp.failed = 1;
+	rsp.index[0] = 0;
+	rsp.err[0] = -EIO;
+
+	zassert_ok(bt_rpc_batch_end());
+	zassert_equal(error_count, 3);
+	zassert_equal(errors[2].index, ITEMS_PER_MSG);
+	zassert_equal(errors[2].err, -EIO);
+}
+
+ZTEST(bt_rpc_batch, test_send_error)
+{
+	zassert_ok(bt_rpc_batch_begin());
+	zassert_true(item_call(true));
+
+	send_err = -ENOMEM;
+	zassert_equal(bt_rpc_batch_end(), -ENOMEM);
+	zassert_equal(error_count, 0);
+
+	/* The next batch starts without the error. */
+	send_err = 0;
+	zassert_ok(bt_rpc_batch_begin());
+	zassert_true(item_call(true));
+	zassert_ok(bt_rpc_batch_end());
+}
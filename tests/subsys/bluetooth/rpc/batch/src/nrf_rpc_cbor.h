@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* The part of the nRF RPC CBOR API used by the batched calls, implemented by the test. */
+
+#ifndef NRF_RPC_CBOR_H_
+#define NRF_RPC_CBOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zcbor_common.h>
+#include <zcbor_encode.h>
+#include <zcbor_decode.h>
+
+struct nrf_rpc_group {
+	const char *name;
+};
+
+struct nrf_rpc_cbor_ctx {
+	zcbor_state_t zs[2];
+	uint8_t *out_packet;
+};
+
+typedef void (*nrf_rpc_cbor_handler_t)(const struct nrf_rpc_group *group,
+				       struct nrf_rpc_cbor_ctx *ctx, void *handler_data);
+
+#define NRF_RPC_GROUP_DECLARE(_name) extern const struct nrf_rpc_group _name
+
+#define NRF_RPC_CBOR_ALLOC(_group, _ctx, _len) test_cbor_alloc(&(_ctx), (_len))
+
+void test_cbor_alloc(struct nrf_rpc_cbor_ctx *ctx, size_t len);
+
+int nrf_rpc_cbor_cmd(const struct nrf_rpc_group *group, uint8_t cmd,
+		     struct nrf_rpc_cbor_ctx *ctx, nrf_rpc_cbor_handler_t handler,
+		     void *handler_data);
+
+#endif /* NRF_RPC_CBOR_H_ */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include "bt_rpc_gatt_common.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* Simulated time does not advance while the CPU is busy, use host time instead. */
+#include <native_rtc.h>
+#define TIME_NOW_US() native_rtc_gettime_us(RTC_CLOCK_REALTIME)
+#else
+#define TIME_NOW_US() k_cyc_to_us_floor64(k_cycle_get_32())
+#endif
+
+#define SERVICES CONFIG_BT_RPC_GATT_SRV_MAX
+#define ATTRS 12
+#define ROUNDS 1000
+
+static struct bt_gatt_attr attrs[SERVICES][ATTRS];
+static struct bt_gatt_service services[SERVICES];
+static const struct bt_gatt_service *order[SERVICES];
+
+uint16_t bt_gatt_attr_get_handle(const struct bt_gatt_attr *attr)
+{
+	return 0;
+}
+
+/* The lookup used before the index, registration order is the service index. */
+static int linear_attr_to_index(const struct bt_gatt_service **order, size_t count,
+				const struct bt_gatt_attr *attr, uint32_t *index)
+{
+	for (size_t i = 0; i < count; i++) {
+		if ((attr >= order[i]->attrs) && (attr < &order[i]->attrs[order[i]->attr_count])) {
+			*index = (i << 16) | (attr - order[i]->attrs);
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+/* Services are registered out of address order, as static and dynamic services are. */
+static size_t service_register_order(size_t i, size_t count)
+{
+	return (i * 7) % count;
+}
+
+static void services_register(size_t count)
+{
+	uint32_t index;
+
+	for (size_t i = 0; i < count; i++) {
+		size_t svc = service_register_order(i, count);
+
+		services[svc].attrs = attrs[svc];
+		services[svc].attr_count = ATTRS;
+		zassert_ok(bt_rpc_gatt_add_service(&services[svc], &index));
+		order[i] = &services[svc];
+	}
+}
+
+static void services_remove(size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		zassert_ok(bt_rpc_gatt_remove_service(&services[i]));
+	}
+}
+
+/* Looks up every attribute of the registered services, with both lookups. */
+static void lookup_measure(size_t count)
+{
+	uint64_t start, linear_us, index_us;
+	uint32_t lookups = count * ATTRS * ROUNDS;
+	uint32_t index;
+
+	services_register(count);
+
+	start = TIME_NOW_US();
+	for (int round = 0; round < ROUNDS; round++) {
+		for (size_t i = 0; i < count; i++) {
+			for (size_t j = 0; j < ATTRS; j++) {
+				zassert_ok(linear_attr_to_index(order, count, &attrs[i][j], &index));
+			}
+		}
+	}
+	linear_us = TIME_NOW_US() - start;
+
+	start = TIME_NOW_US();
+	for (int round = 0; round < ROUNDS; round++) {
+		for (size_t i = 0; i < count; i++) {
+			for (size_t j = 0; j < ATTRS; j++) {
+				zassert_ok(bt_rpc_gatt_attr_to_index(&attrs[i][j], &index));
+			}
+		}
+	}
+	index_us = TIME_NOW_US() - start;
+
+	services_remove(count);
+
+	printk("Services: %2zu, average lookup [ns]: linear %llu, indexed %llu\n", count,
+	       (unsigned long long)(linear_us * 1000 / lookups),
+	       (unsigned long long)(index_us * 1000 / lookups));
+}
+
+ZTEST_SUITE(bt_rpc_gatt_index_benchmark, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(bt_rpc_gatt_index_benchmark, test_attr_to_index_lookup)
+{
+	for (size_t count = 1; count <= SERVICES; count *= 2) {
+		lookup_measure(count);
+	}
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include "bt_rpc_gatt_common.h"
+
+#define SERVICES CONFIG_BT_RPC_GATT_SRV_MAX
+#define ATTRS 12
+
+static struct bt_gatt_attr attrs[SERVICES][ATTRS];
+static struct bt_gatt_service services[SERVICES];
+static bool registered[SERVICES];
+
+uint16_t bt_gatt_attr_get_handle(const struct bt_gatt_attr *attr)
+{
+	return 0;
+}
+
+/* The lookup used before the index, registration order is the service index. */
+static int linear_attr_to_index(const struct bt_gatt_service **order, size_t count,
+				const struct bt_gatt_attr *attr, uint32_t *index)
+{
+	for (size_t i = 0; i < count; i++) {
+		if ((attr >= order[i]->attrs) && (attr < &order[i]->attrs[order[i]->attr_count])) {
+			*index = (i << 16) | (attr - order[i]->attrs);
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+/* Services are registered out of address order, as static and dynamic services are. */
+static size_t service_register_order(size_t i)
+{
+	return (i * 7) % SERVICES;
+}
+
+static void services_register(size_t count, const struct bt_gatt_service **order)
+{
+	uint32_t index;
+
+	for (size_t i = 0; i < count; i++) {
+		size_t svc = service_register_order(i);
+
+		zassert_ok(bt_rpc_gatt_add_service(&services[svc], &index));
+		zassert_equal(index, i);
+		registered[svc] = true;
+		if (order) {
+			order[i] = &services[svc];
+		}
+	}
+}
+
+static void test_before(void *fixture)
+{
+	for (size_t i = 0; i < SERVICES; i++) {
+		services[i].attrs = attrs[i];
+		services[i].attr_count = ATTRS - (i % 3);
+	}
+}
+
+static void test_after(void *fixture)
+{
+	for (size_t i = 0; i < SERVICES; i++) {
+		if (registered[i]) {
+			zassert_ok(bt_rpc_gatt_remove_service(&services[i]));
+			registered[i] = false;
+		}
+	}
+}
+
+ZTEST_SUITE(bt_rpc_gatt_index, NULL, NULL, test_before, test_after, NULL);
+
+ZTEST(bt_rpc_gatt_index, test_attr_index_round_trip)
+{
+	uint32_t index;
+	uint16_t svc_index;
+
+	services_register(SERVICES, NULL);
+
+	for (size_t i = 0; i < SERVICES; i++) {
+		size_t svc = service_register_order(i);
+
+		zassert_ok(bt_rpc_gatt_service_to_index(&services[svc], &svc_index));
+		zassert_equal(svc_index, i);
+		zassert_equal_ptr(bt_rpc_gatt_get_service_by_index(i), &services[svc]);
+
+		for (size_t j = 0; j < services[svc].attr_count; j++) {
+			zassert_ok(bt_rpc_gatt_attr_to_index(&attrs[svc][j], &index));
+			zassert_equal(index, (i << 16) | j);
+			zassert_equal_ptr(bt_rpc_gatt_index_to_attr(index), &attrs[svc][j]);
+		}
+	}
+}
+
+ZTEST(bt_rpc_gatt_index, test_attr_not_registered)
+{
+	uint32_t index;
+	uint16_t svc_index;
+
+	zassert_equal(bt_rpc_gatt_attr_to_index(&attrs[0][0], &index), -EINVAL);
+
+	services_register(SERVICES / 2, NULL);
+
+	zassert_equal(bt_rpc_gatt_attr_to_index(NULL, &index), -EINVAL);
+
+	for (size_t i = SERVICES / 2; i < SERVICES; i++) {
+		size_t svc = service_register_order(i);
+
+		zassert_equal(bt_rpc_gatt_attr_to_index(&attrs[svc][0], &index), -EINVAL);
+		zassert_equal(bt_rpc_gatt_service_to_index(&services[svc], &svc_index), -EFAULT);
+	}
+
+	/* Past the attributes of a registered service. */
+	for (size_t i = 0; i < SERVICES / 2; i++) {
+		size_t svc = service_register_order(i);
+
+		if (services[svc].attr_count < ATTRS) {
+			zassert_equal(bt_rpc_gatt_attr_to_index(
+					&attrs[svc][services[svc].attr_count], &index), -EINVAL);
+		}
+	}
+}
+
+ZTEST(bt_rpc_gatt_index, test_remove_service)
+{
+	const struct bt_gatt_service *order[SERVICES];
+	const struct bt_gatt_service *svc;
+	uint32_t expected;
+	uint32_t index;
+	uint16_t svc_index;
+	size_t count = SERVICES;
+	size_t removed[] = { SERVICES / 2, 0, SERVICES - 3 };
+
+	services_register(SERVICES, order);
+
+	for (size_t r = 0; r < ARRAY_SIZE(removed); r++) {
+		svc = order[removed[r]];
+
+		zassert_ok(bt_rpc_gatt_remove_service(svc));
+		registered[svc - services] = false;
+
+		/* The indexes of the next services shift down. */
+		memmove(&order[removed[r]], &order[removed[r] + 1],
+			sizeof(order[0]) * (count - removed[r] - 1));
+		count--;
+
+		zassert_equal(bt_rpc_gatt_attr_to_index(svc->attrs, &index), -EINVAL);
+		zassert_equal(bt_rpc_gatt_service_to_index(svc, &svc_index), -EFAULT);
+
+		for (size_t i = 0; i < count; i++) {
+			zassert_ok(bt_rpc_gatt_service_to_index(order[i], &svc_index));
+			zassert_equal(svc_index, i);
+
+			for (size_t j = 0; j < order[i]->attr_count; j++) {
+				zassert_ok(linear_attr_to_index(order, count, &order[i]->attrs[j],
+								&expected));
+				zassert_ok(bt_rpc_gatt_attr_to_index(&order[i]->attrs[j], &index));
+				zassert_equal(index, expected);
+			}
+		}
+	}
+
+	/* Registered again, at the end. */
+	zassert_ok(bt_rpc_gatt_add_service(svc, &index));
+	zassert_equal(index, count);
+	registered[svc - services] = true;
+
+	zassert_ok(bt_rpc_gatt_attr_to_index(&svc->attrs[1], &index));
+	zassert_equal(index, (count << 16) | 1);
+}
+
+/* The lookup gives the same result as the linear scan it replaces, for every attribute
+ * slot, registered or not.
+ */
+ZTEST(bt_rpc_gatt_index, test_attr_to_index_matches_linear)
+{
+	const struct bt_gatt_service *order[SERVICES];
+	uint32_t expected;
+	uint32_t index;
+	size_t count = SERVICES - 5;
+	int expected_err;
+
+	services_register(count, order);
+
+	for (size_t i = 0; i < SERVICES; i++) {
+		for (size_t j = 0; j < ATTRS; j++) {
+			expected_err = linear_attr_to_index(order, count, &attrs[i][j], &expected);
+
+			zassert_equal(bt_rpc_gatt_attr_to_index(&attrs[i][j], &index), expected_err,
+				      "service %zu attribute %zu", i, j);
+			if (expected_err == 0) {
+				zassert_equal(index, expected, "service %zu attribute %zu", i, j);
+			}
+		}
+	}
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#include "captured_reports.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* Simulated time does not advance while the CPU is busy, use host time instead. */
+#include <native_rtc.h>
+#define TIME_NOW_US() native_rtc_gettime_us(RTC_CLOCK_REALTIME)
+#else
+#define TIME_NOW_US() k_cyc_to_us_floor64(k_cycle_get_32())
+#endif
+
+#define REPLAY_ROUNDS 1000
+
+static struct bt_le_scan_cb *scan_cb;
+
+NET_BUF_SIMPLE_DEFINE_STATIC(adv_data, BT_GAP_ADV_MAX_EXT_ADV_DATA_LEN);
+
+static uint32_t match_cnt;
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void filter_match(struct bt_scan_device_info *device_info,
+			 struct bt_scan_filter_match *filter_match,
+			 bool connectable)
+{
+	match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_callbacks, filter_match, NULL, NULL, NULL);
+
+static void replay(void)
+{
+	struct bt_le_scan_recv_info info = {
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(captured); i++) {
+		net_buf_simple_add_mem(&adv_data, captured[i].data, captured[i].len);
+		info.addr = &captured[i].addr;
+		scan_cb->recv(&info, &adv_data);
+		net_buf_simple_reset(&adv_data);
+	}
+}
+
+static void filter_add(enum bt_scan_filter_type type, const void *data)
+{
+	zassert_ok(bt_scan_filter_add(type, data));
+}
+
+static void *suite_setup(void)
+{
+	bt_scan_cb_register(&scan_callbacks);
+	bt_scan_init(NULL);
+	zassert_not_null(scan_cb);
+
+	return NULL;
+}
+
+ZTEST_SUITE(bt_scan_benchmark, NULL, suite_setup, NULL, NULL, NULL);
+
+/* Time to check the captured reports with a filter setup of a dongle that looks for keyboards
+ * and mice, by name, address, service and manufacturer.
+ */
+ZTEST(bt_scan_benchmark, test_replay)
+{
+	const char *names[] = { "Nordic_Keys", "Nordic_Mouse", "Desktop Kit", "Gaming Mouse" };
+	const bt_addr_le_t addrs[] = {
+		ADDR(BT_ADDR_LE_RANDOM, 0x80), ADDR(BT_ADDR_LE_RANDOM, 0x81),
+		ADDR(BT_ADDR_LE_PUBLIC, 0x82), ADDR(BT_ADDR_LE_PUBLIC, 0x83),
+	};
+	const uint8_t swift_pair[] = { 0x06, 0x00, 0x03, 0x00 };
+	const uint8_t nordic[] = { 0x59, 0x00 };
+	const struct bt_scan_manufacturer_data manufacturer_data[] = {
+		{ .data = (uint8_t *)swift_pair, .data_len = sizeof(swift_pair) },
+		{ .data = (uint8_t *)nordic, .data_len = sizeof(nordic) },
+	};
+	uint32_t reports = REPLAY_ROUNDS * ARRAY_SIZE(captured);
+	uint64_t start, elapsed;
+
+	for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_NAME, names[i]);
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(addrs); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addrs[i]);
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(manufacturer_data); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &manufacturer_data[i]);
+	}
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HIDS);
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x8e7f1a23, 0x4b2c, 0x11ee, 0xbe56, 0x0242ac120002)));
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_ADDR_FILTER |
+					 BT_SCAN_UUID_FILTER |
+					 BT_SCAN_MANUFACTURER_DATA_FILTER, false));
+
+	start = TIME_NOW_US();
+	for (int round = 0; round < REPLAY_ROUNDS; round++) {
+		replay();
+	}
+	elapsed = TIME_NOW_US() - start;
+
+	/* The mouse and the keyboard match, unless the duplicate filter suppresses them. */
+	zassert_not_equal(match_cnt, 0);
+
+	printk("%u reports in %llu us, %llu ns per report, %u matched\n", reports,
+	       (unsigned long long)elapsed, (unsigned long long)(elapsed * 1000 / reports),
+	       match_cnt);
+
+#if defined(CONFIG_BT_SCAN_DUPLICATE_FILTER)
+	struct bt_scan_duplicate_filter_stats stats;
+
+	zassert_ok(bt_scan_duplicate_filter_stats_get(&stats));
+	printk("Duplicate filter: %u reports suppressed, %u passed on\n", stats.hits,
+	       stats.misses);
+#endif
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef CAPTURED_REPORTS_H_
+#define CAPTURED_REPORTS_H_
+
+#include <zephyr/bluetooth/bluetooth.h>
+
+#define ADDR(_type, _last) { .type = (_type), .a.val = { (_last), 0x42, 0x13, 0x37, 0x00, 0xc0 } }
+
+/* Advertising reports as captured in an office, with the same payloads as the devices sent. */
+static const struct captured_report {
+	bt_addr_le_t addr;
+	uint8_t len;
+	uint8_t data[BT_GAP_ADV_MAX_ADV_DATA_LEN];
+} captured[] = {
+	/* iBeacon */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x10), 30,
+	  { 0x02, 0x01, 0x06, 0x1a, 0xff, 0x4c, 0x00, 0x02, 0x15, 0xe2, 0xc5, 0x6d, 0xb5, 0xdf,
+	    0xfb, 0x48, 0xd2, 0xb0, 0x60, 0xd0, 0xf5, 0xa7, 0x10, 0x96, 0xe0, 0x00, 0x01, 0x00,
+	    0x02, 0xc5 } },
+	/* Eddystone URL */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x11), 26,
+	  { 0x02, 0x01, 0x06, 0x03, 0x03, 0xaa, 0xfe, 0x12, 0x16, 0xaa, 0xfe, 0x10, 0xeb, 0x03,
+	    'n', 'o', 'r', 'd', 'i', 'c', 's', 'e', 'm', 'i', 0x07, 0x00 } },
+	/* Phone, continuity */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x12), 17,
+	  { 0x02, 0x01, 0x1a, 0x0d, 0xff, 0x4c, 0x00, 0x10, 0x08, 0x1b, 0x1c, 0x5f, 0x2e, 0x71,
+	    0x3a, 0x98, 0x00 } },
+	/* Swift Pair mouse */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x13), 29,
+	  { 0x02, 0x01, 0x05, 0x03, 0x19, 0xc2, 0x03, 0x03, 0x03, 0x12, 0x18, 0x06, 0xff, 0x06,
+	    0x00, 0x03, 0x00, 0x80, 0x0a, 0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'M', 'o' } },
+	/* Keyboard */
+	{ ADDR(BT_ADDR_LE_PUBLIC, 0x14), 26,
+	  { 0x02, 0x01, 0x06, 0x03, 0x19, 0xc1, 0x03, 0x05, 0x03, 0x12, 0x18, 0x0f, 0x18, 0x0c,
+	    0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'K', 'e', 'y', 's' } },
+	/* Heart rate sensor */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x15), 24,
+	  { 0x02, 0x01, 0x06, 0x05, 0x03, 0x0d, 0x18, 0x0f, 0x18, 0x0b, 0x09, 'H', 'R', 'M', ' ',
+	    'S', 'e', 'n', 's', 'o', 'r', 0x02, 0x0a, 0x00 } },
+	/* Thingy */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x16), 27,
+	  { 0x02, 0x01, 0x06, 0x11, 0x07, 0x42, 0x00, 0x74, 0xa9, 0xff, 0x52, 0x10, 0x9b, 0x33,
+	    0x49, 0x35, 0x9b, 0x00, 0x01, 0x68, 0xef, 0x05, 0x08, 'T', 'h', 'i', 'n' } },
+	/* Tracker */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x17), 20,
+	  { 0x02, 0x01, 0x06, 0x03, 0x03, 0xed, 0xfe, 0x0c, 0x16, 0xed, 0xfe, 0x02, 0x00, 0x5a,
+	    0x7b, 0x13, 0x9c, 0x44, 0x21, 0x01 } },
+	/* Earbuds */
+	{ ADDR(BT_ADDR_LE_RANDOM, 0x18), 31,
+	  { 0x1b, 0xff, 0x75, 0x00, 0x42, 0x09, 0x81, 0x02, 0x14, 0x15, 0x03, 0x21, 0x01, 0x09,
+	    0x6b, 0x2a, 0x8c, 0x44, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	    0x02, 0x0a, 0xf8 } },
+	/* TV */
+	{ ADDR(BT_ADDR_LE_PUBLIC, 0x19), 20,
+	  { 0x02, 0x01, 0x1a, 0x0f, 0x09, 'L', 'i', 'v', 'i', 'n', 'g', ' ', 'R', 'o', 'o', 'm',
+	    ' ', 'T', 'V', 0x00 } },
+};
+
+#endif /* CAPTURED_REPORTS_H_ */
@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#include "captured_reports.h"
+
+static struct bt_le_scan_cb *scan_cb;
+
+NET_BUF_SIMPLE_DEFINE_STATIC(adv_data, BT_GAP_ADV_MAX_EXT_ADV_DATA_LEN);
+
+static struct bt_scan_filter_match match_status;
+static uint32_t match_cnt;
+static uint32_t no_match_cnt;
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void filter_match(struct bt_scan_device_info *device_info,
+			 struct bt_scan_filter_match *filter_match,
+			 bool connectable)
+{
+	match_status = *filter_match;
+	match_cnt++;
+}
+
+static void filter_no_match(struct bt_scan_device_info *device_info,
+			    bool connectable)
+{
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_callbacks, filter_match, filter_no_match, NULL, NULL);
+
+static void ad_add(uint8_t type, const void *data, uint8_t len)
+{
+	net_buf_simple_add_u8(&adv_data, len + 1);
+	net_buf_simple_add_u8(&adv_data, type);
+	net_buf_simple_add_mem(&adv_data, data, len);
+}
+
+static void ad_add_str(uint8_t type, const char *str)
+{
+	ad_add(type, str, strlen(str));
+}
+
+/* Passes the advertising data to the scanning module, returns whether a filter matched. */
+static bool report(const bt_addr_le_t *addr)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = addr,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+	uint32_t matched = match_cnt;
+
+	scan_cb->recv(&info, &adv_data);
+	net_buf_simple_reset(&adv_data);
+
+	return match_cnt != matched;
+}
+
+static void filter_add(enum bt_scan_filter_type type, const void *data)
+{
+	zassert_ok(bt_scan_filter_add(type, data));
+}
+
+static void *suite_setup(void)
+{
+	bt_scan_cb_register(&scan_callbacks);
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	bt_scan_init(NULL);
+	zassert_not_null(scan_cb);
+	net_buf_simple_reset(&adv_data);
+	match_cnt = 0;
+	no_match_cnt = 0;
+}
+
+static void test_after(void *fixture)
+{
+	bt_scan_filter_remove_all();
+	bt_scan_filter_disable();
+	bt_scan_blocklist_clear();
+}
+
+ZTEST_SUITE(bt_scan, NULL, suite_setup, test_before, test_after, NULL);
+
+ZTEST(bt_scan, test_name)
+{
+	const char *names[] = { "Keyboard", "Mouse", "Key", "Headset", "Mic" };
+	bt_addr_le_t addr = ADDR(BT_ADDR_LE_RANDOM, 1);
+
+	for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_NAME, names[i]);
+	}
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false));
+
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	zassert_true(report(&addr));
+	zassert_true(match_status.name.match);
+	zassert_mem_equal(match_status.name.name, "Mouse", sizeof("Mouse"));
+
+	/* The advertised name is compared up to its length, so it matches the
+	 * names that start with it. The first name added is reported.
+	 */
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Key");
+	zassert_true(report(&addr));
+	zassert_mem_equal(match_status.name.name, "Keyboard", sizeof("Keyboard"));
+	zassert_equal(match_status.name.len, 3);
+
+	/* Unless it ends with a null character. */
+	ad_add(BT_DATA_NAME_COMPLETE, "Key", sizeof("Key"));
+	zassert_true(report(&addr));
+	zassert_mem_equal(match_status.name.name, "Key", sizeof("Key"));
+
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Keyboards");
+	zassert_false(report(&addr));
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Kex");
+	zassert_false(report(&addr));
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Speaker");
+	zassert_false(report(&addr));
+
+	/* Only the complete name is checked. */
+	ad_add_str(BT_DATA_NAME_SHORTENED, "Headset");
+	zassert_false(report(&addr));
+
+	zassert_equal(match_cnt, 3);
+	zassert_equal(no_match_cnt, 4);
+}
+
+ZTEST(bt_scan, test_short_name)
+{
+	const struct bt_scan_short_name short_names[] = {
+		{ .name = "Thingy", .min_len = 5 },
+		{ .name = "Thermometer", .min_len = 3 },
+	};
+	bt_addr_le_t addr = ADDR(BT_ADDR_LE_RANDOM, 1);
+
+	for (size_t i = 0; i < ARRAY_SIZE(short_names); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_names[i]);
+	}
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_SHORT_NAME_FILTER, false));
+
+	ad_add_str(BT_DATA_NAME_SHORTENED, "Thing");
+	zassert_true(report(&addr));
+	zassert_mem_equal(match_status.short_name.name, "Thingy", sizeof("Thingy"));
+
+	/* Too short for the first name, long enough for the second one. */
+	ad_add_str(BT_DATA_NAME_SHORTENED, "Th");
+	zassert_false(report(&addr));
+	ad_add_str(BT_DATA_NAME_SHORTENED, "The");
+	zassert_true(report(&addr));
+	zassert_mem_equal(match_status.short_name.name, "Thermometer", sizeof("Thermometer"));
+
+	ad_add_str(BT_DATA_NAME_SHORTENED, "Thin");
+	zassert_false(report(&addr));
+}
+
+ZTEST(bt_scan, test_addr)
+{
+	bt_addr_le_t addrs[CONFIG_BT_SCAN_ADDRESS_CNT];
+	bt_addr_le_t other;
+
+	for (size_t i = 0; i < ARRAY_SIZE(addrs); i++) {
+		addrs[i] = (bt_addr_le_t)ADDR(BT_ADDR_LE_RANDOM, i * 3);
+		filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addrs[i]);
+
+		/* Duplicates are not added again. */
+		filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addrs[0]);
+	}
+
+	other = (bt_addr_le_t)ADDR(BT_ADDR_LE_RANDOM, 1);
+	zassert_equal(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &other), -ENOMEM);
+
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false));
+
+	for (size_t i = 0; i < ARRAY_SIZE(addrs); i++) {
+		zassert_true(report(&addrs[i]));
+		zassert_true(match_status.addr.match);
+		zassert_equal(bt_addr_le_cmp(match_status.addr.addr, &addrs[i]), 0);
+
+		/* The address type is part of the address. */
+		other = addrs[i];
+		other.type = BT_ADDR_LE_PUBLIC;
+		zassert_false(report(&other));
+
+		other = addrs[i];
+		other.a.val[0]++;
+		zassert_false(report(&other));
+	}
+
+	/* No events for blocked devices. */
+	zassert_ok(bt_scan_blocklist_device_add(&addrs[1]));
+	zassert_false(report(&addrs[1]));
+	zassert_equal(no_match_cnt, 2 * ARRAY_SIZE(addrs));
+}
+
+ZTEST(bt_scan, test_uuid)
+{
+	uint8_t hrs_128[] = { BT_UUID_128_ENCODE(BT_UUID_HRS_VAL, 0x0000, 0x1000, 0x8000,
+						 0x00805F9B34FB) };
+	uint8_t custom_128[] = { BT_UUID_128_ENCODE(0x8e7f1a23, 0x4b2c, 0x11ee, 0xbe56,
+						    0x0242ac120002) };
+	uint16_t uuids_16[] = { sys_cpu_to_le16(BT_UUID_BAS_VAL),
+				sys_cpu_to_le16(BT_UUID_DIS_VAL) };
+	bt_addr_le_t addr = ADDR(BT_ADDR_LE_RANDOM, 1);
+
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS);
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x8e7f1a23, 0x4b2c, 0x11ee, 0xbe56, 0x0242ac120002)));
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_DIS);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER, false));
+
+	/* Compared as bt_uuid_cmp does, a 16-bit UUID matches its 128-bit form. */
+	ad_add(BT_DATA_UUID128_ALL, hrs_128, sizeof(hrs_128));
+	zassert_true(report(&addr));
+	zassert_equal(match_status.uuid.count, 1);
+	zassert_equal(bt_uuid_cmp(match_status.uuid.uuid[0], BT_UUID_HRS), 0);
+
+	/* The first UUID added is reported. */
+	ad_add(BT_DATA_UUID16_SOME, uuids_16, sizeof(uuids_16));
+	ad_add(BT_DATA_UUID128_SOME, custom_128, sizeof(custom_128));
+	zassert_true(report(&addr));
+	zassert_equal(match_status.uuid.count, 1);
+	zassert_equal(match_status.uuid.uuid[0]->type, BT_UUID_TYPE_128);
+
+	ad_add(BT_DATA_UUID16_ALL, uuids_16, 1);
+	zassert_false(report(&addr));
+
+	/* All UUIDs must be found in the multifilter mode, in any AD structure. */
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER, true));
+
+	ad_add(BT_DATA_UUID16_SOME, uuids_16, sizeof(uuids_16));
+	ad_add(BT_DATA_UUID128_SOME, custom_128, sizeof(custom_128));
+	zassert_false(report(&addr));
+
+	ad_add(BT_DATA_UUID16_SOME, uuids_16, sizeof(uuids_16));
+	ad_add(BT_DATA_UUID128_SOME, custom_128, sizeof(custom_128));
+	ad_add(BT_DATA_UUID128_SOME, hrs_128, sizeof(hrs_128));
+	zassert_true(report(&addr));
+	zassert_equal(match_status.uuid.count, 3);
+	zassert_equal(bt_uuid_cmp(match_status.uuid.uuid[2], BT_UUID_DIS), 0);
+}
+
+ZTEST(bt_scan, test_manufacturer_data)
+{
+	const uint8_t apple[] = { 0x4c, 0x00 };
+	const uint8_t ibeacon[] = { 0x4c, 0x00, 0x02, 0x15 };
+	const uint8_t nordic[] = { 0x59, 0x00, 0xaa };
+	const uint8_t adv_ibeacon[] = { 0x4c, 0x00, 0x02, 0x15, 0x01, 0x02 };
+	const uint8_t adv_nordic[] = { 0x59, 0x00, 0xaa, 0xbb };
+	const struct bt_scan_manufacturer_data filters[] = {
+		{ .data = (uint8_t *)ibeacon, .data_len = sizeof(ibeacon) },
+		{ .data = (uint8_t *)nordic, .data_len = sizeof(nordic) },
+		{ .data = (uint8_t *)apple, .data_len = sizeof(apple) },
+	};
+	bt_addr_le_t addr = ADDR(BT_ADDR_LE_RANDOM, 1);
+
+	for (size_t i = 0; i < ARRAY_SIZE(filters); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &filters[i]);
+	}
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_MANUFACTURER_DATA_FILTER, false));
+
+	/* Filters match the start of the data, the first one added is reported. */
+	ad_add(BT_DATA_MANUFACTURER_DATA, adv_ibeacon, sizeof(adv_ibeacon));
+	zassert_true(report(&addr));
+	zassert_equal(match_status.manufacturer_data.len, sizeof(ibeacon));
+
+	ad_add(BT_DATA_MANUFACTURER_DATA, adv_ibeacon, 3);
+	zassert_true(report(&addr));
+	zassert_equal(match_status.manufacturer_data.len, sizeof(apple));
+
+	ad_add(BT_DATA_MANUFACTURER_DATA, adv_nordic, sizeof(adv_nordic));
+	zassert_true(report(&addr));
+	zassert_mem_equal(match_status.manufacturer_data.data, nordic, sizeof(nordic));
+
+	ad_add(BT_DATA_MANUFACTURER_DATA, adv_nordic, 2);
+	zassert_false(report(&addr));
+}
+
+ZTEST(bt_scan, test_all_mode)
+{
+	bt_addr_le_t addr = ADDR(BT_ADDR_LE_RANDOM, 1);
+	bt_addr_le_t other = ADDR(BT_ADDR_LE_RANDOM, 2);
+	uint16_t appearance = 0x03c1;
+	uint8_t appearance_be[] = { 0x03, 0xc1 };
+
+	filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	filter_add(BT_SCAN_FILTER_TYPE_NAME, "Keyboard");
+	filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &appearance);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_ADDR_FILTER | BT_SCAN_NAME_FILTER |
+					 BT_SCAN_APPEARANCE_FILTER, true));
+
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Keyboard");
+	ad_add(BT_DATA_GAP_APPEARANCE, appearance_be, sizeof(appearance_be));
+	zassert_true(report(&addr));
+	zassert_true(match_status.addr.match);
+	zassert_true(match_status.name.match);
+	zassert_true(match_status.appearance.match);
+
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Keyboard");
+	ad_add(BT_DATA_GAP_APPEARANCE, appearance_be, sizeof(appearance_be));
+	zassert_false(report(&other));
+
+	/* A type matching twice does not make up for one that did not match. */
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Keyboard");
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Keyboard");
+	zassert_false(report(&addr));
+
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_ADDR_FILTER | BT_SCAN_NAME_FILTER |
+					 BT_SCAN_APPEARANCE_FILTER, false));
+	zassert_true(report(&addr));
+	zassert_true(match_status.addr.match);
+	zassert_false(match_status.name.match);
+}
+
+#if defined(CONFIG_BT_SCAN_DUPLICATE_FILTER)
+/* Passes the advertising data to the scanning module as scan response data. */
+static void scan_rsp_report(const bt_addr_le_t *addr)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = addr,
+		.adv_type = BT_GAP_ADV_TYPE_SCAN_RSP,
+		.adv_props = BT_GAP_ADV_PROP_SCANNABLE | BT_GAP_ADV_PROP_SCAN_RESPONSE,
+	};
+
+	scan_cb->recv(&info, &adv_data);
+	net_buf_simple_reset(&adv_data);
+}
+#endif
+
+ZTEST(bt_scan, test_duplicate_filter)
+{
+#if defined(CONFIG_BT_SCAN_DUPLICATE_FILTER)
+	struct bt_scan_duplicate_filter_stats stats;
+	bt_addr_le_t addr = ADDR(BT_ADDR_LE_RANDOM, 1);
+	bt_addr_le_t other;
+
+	/* Without filters, every report passed on is a no match event. */
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	report(&addr);
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	report(&addr);
+	zassert_equal(no_match_cnt, 1);
+
+	/* A report that differs from the last one is passed on right away, also when
+	 * the device goes back to a payload it sent before.
+	 */
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse2");
+	report(&addr);
+	zassert_equal(no_match_cnt, 2);
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	report(&addr);
+	zassert_equal(no_match_cnt, 3);
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	report(&addr);
+	zassert_equal(no_match_cnt, 3);
+
+	/* The scan response data is checked apart from the advertising data. */
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	scan_rsp_report(&addr);
+	zassert_equal(no_match_cnt, 4);
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	scan_rsp_report(&addr);
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	report(&addr);
+	zassert_equal(no_match_cnt, 4);
+
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DUPLICATE_FILTER_WINDOW));
+	ad_add_str(BT_DATA_NAME_COMPLETE, "Mouse");
+	report(&addr);
+	zassert_equal(no_match_cnt, 5);
+
+	zassert_ok(bt_scan_duplicate_filter_stats_get(&stats));
+	zassert_equal(stats.hits, 4);
+	zassert_equal(stats.misses, 5);
+
+	/* The least recently received device is forgotten. */
+	bt_scan_duplicate_filter_clear();
+	no_match_cnt = 0;
+	for (int i = 0; i <= CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN; i++) {
+		other = (bt_addr_le_t)ADDR(BT_ADDR_LE_RANDOM, 0x80 + i);
+		report(&other);
+	}
+	zassert_equal(no_match_cnt, CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN + 1);
+
+	other = (bt_addr_le_t)ADDR(BT_ADDR_LE_RANDOM, 0x80 + CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN);
+	report(&other);
+	other = (bt_addr_le_t)ADDR(BT_ADDR_LE_RANDOM, 0x80);
+	report(&other);
+	zassert_equal(no_match_cnt, CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN + 2);
+
+	zassert_ok(bt_scan_duplicate_filter_stats_get(&stats));
+	zassert_equal(stats.hits, 1);
+	zassert_equal(stats.misses, CONFIG_BT_SCAN_DUPLICATE_FILTER_LEN + 2);
+	zassert_equal(bt_scan_duplicate_filter_stats_get(NULL), -EINVAL);
+#else
+	ztest_test_skip();
+#endif
+}
+
+/* Passes the captured reports to the scanning module, returns a mask of the matched ones. */
+static uint32_t replay(void)
+{
+	uint32_t matched = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(captured); i++) {
+		net_buf_simple_add_mem(&adv_data, captured[i].data, captured[i].len);
+		if (report(&captured[i].addr)) {
+			matched |= BIT(i);
+		}
+	}
+
+	return matched;
+}
+
+/* The captured reports with a filter setup of a dongle that looks for keyboards and mice,
+ * by name, address, service and manufacturer.
+ */
+ZTEST(bt_scan, test_replay)
+{
+	const char *names[] = { "Nordic_Keys", "Nordic_Mouse", "Desktop Kit", "Gaming Mouse" };
+	const bt_addr_le_t addrs[] = {
+		ADDR(BT_ADDR_LE_RANDOM, 0x80), ADDR(BT_ADDR_LE_RANDOM, 0x81),
+		ADDR(BT_ADDR_LE_PUBLIC, 0x82), ADDR(BT_ADDR_LE_PUBLIC, 0x83),
+	};
+	const uint8_t swift_pair[] = { 0x06, 0x00, 0x03, 0x00 };
+	const uint8_t nordic[] = { 0x59, 0x00 };
+	const struct bt_scan_manufacturer_data manufacturer_data[] = {
+		{ .data = (uint8_t *)swift_pair, .data_len = sizeof(swift_pair) },
+		{ .data = (uint8_t *)nordic, .data_len = sizeof(nordic) },
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_NAME, names[i]);
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(addrs); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addrs[i]);
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(manufacturer_data); i++) {
+		filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &manufacturer_data[i]);
+	}
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HIDS);
+	filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x8e7f1a23, 0x4b2c, 0x11ee, 0xbe56, 0x0242ac120002)));
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_ADDR_FILTER |
+					 BT_SCAN_UUID_FILTER |
+					 BT_SCAN_MANUFACTURER_DATA_FILTER, false));
+
+	/* The mouse by name, HID service and manufacturer data, the keyboard by name and
+	 * HID service.
+	 */
+	zassert_equal(replay(), BIT(3) | BIT(4));
+	zassert_equal(no_match_cnt, ARRAY_SIZE(captured) - 2);
+	zassert_true(match_status.name.match);
+	zassert_mem_equal(match_status.name.name, "Nordic_Keys", sizeof("Nordic_Keys"));
+	zassert_true(match_status.uuid.match);
+	zassert_equal(match_status.uuid.count, 1);
+	zassert_false(match_status.manufacturer_data.match);
+	zassert_false(match_status.addr.match);
+
+	/* The same reports again are suppressed by the duplicate filter. */
+	match_cnt = 0;
+	no_match_cnt = 0;
+	if (IS_ENABLED(CONFIG_BT_SCAN_DUPLICATE_FILTER)) {
+		zassert_equal(replay(), 0);
+		zassert_equal(no_match_cnt, 0);
+		bt_scan_duplicate_filter_clear();
+	}
+
+	/* Only the mouse matches both the name and the manufacturer data. */
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER |
+					 BT_SCAN_MANUFACTURER_DATA_FILTER, true));
+	zassert_equal(replay(), BIT(3));
+	zassert_equal(no_match_cnt, ARRAY_SIZE(captured) - 1);
+	zassert_true(match_status.name.match);
+	zassert_mem_equal(match_status.name.name, "Nordic_Mouse", sizeof("Nordic_Mouse"));
+	zassert_true(match_status.manufacturer_data.match);
+	zassert_mem_equal(match_status.manufacturer_data.data, swift_pair, sizeof(swift_pair));
+}
@@ -70,6 +70,11 @@ int dfu_target_mcuboot_reset(void)
 	return 0;
 }
 
+int dfu_target_mcuboot_read(size_t offset, void *buf, size_t len)
+{
+	return -ENOTSUP;
+}
+
 void test_setup(void)
 {
 	init_retval = 0;
@@ -9,7 +9,11 @@
 #include <zephyr/drivers/flash.h>
 #include <stdbool.h>
 #include <zephyr/ztest.h>
+#include <dfu/dfu_target.h>
 #include <dfu/dfu_target_stream.h>
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+#include <zephyr/settings/settings.h>
+#endif
 
 #define FLASH_BASE (64*1024)
 #define FLASH_SIZE DT_REG_SIZE(SOC_NV_FLASH_NODE)
@@ -276,6 +280,202 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 
 #endif
 
+#ifdef CONFIG_DFU_TARGET_HASH
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash)
+{
+	int err;
+	uint8_t hash[32];
+	/* SHA-256 of BUF_LEN bytes of 0xaa */
+	static const uint8_t expected[32] = {
+		0xc0, 0xcc, 0x6c, 0x7f, 0x4a, 0xd1, 0x77, 0xab,
+		0xc8, 0xf5, 0x76, 0x5d, 0xd5, 0xb5, 0xfd, 0x41,
+		0x76, 0x42, 0xa9, 0xee, 0xcb, 0xe0, 0xea, 0xc9,
+		0xa1, 0xc4, 0x26, 0x96, 0x86, 0xba, 0xbf, 0x4a,
+	};
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Write in chunks which are not aligned to the stream buffer */
+	err = dfu_target_stream_write(write_buf, 1000);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, 7);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, BUF_LEN - 1007);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Data still buffered is hashed once it is flushed */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_hash_get(hash, sizeof(hash));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_mem_equal(hash, expected, sizeof(hash), "Incorrect hash");
+
+	/* Verify the flash content matches what was hashed */
+	err = flash_read(fdev, FLASH_BASE, read_buf, BUF_LEN);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_mem_equal(read_buf, write_buf, BUF_LEN, "Incorrect value");
+
+	/* Too small buffer */
+	err = dfu_target_hash_get(hash, sizeof(hash) - 1);
+	zassert_equal(err, -EINVAL, "Unexpected result: %d", err);
+}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+/* Interrupts an update half-way, optionally deletes the saved hash state,
+ * and resumes the update. Returns the hash of the complete image.
+ */
+static void hash_resume(bool delete_state, uint8_t *hash)
+{
+	int err;
+	size_t offset;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, BUF_LEN / 2);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Interrupt the update, buffered data is lost */
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	if (delete_state) {
+		err = settings_delete("dfu/" TEST_ID_1 "/sha256");
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_true(offset > 0 && offset < BUF_LEN / 2, "Unexpected offset: %d", offset);
+
+	err = dfu_target_stream_write(&write_buf[offset], BUF_LEN - offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_hash_get(hash, 32);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash_resume)
+{
+	uint8_t hash[32];
+	/* SHA-256 of BUF_LEN bytes of 0xaa */
+	static const uint8_t expected[32] = {
+		0xc0, 0xcc, 0x6c, 0x7f, 0x4a, 0xd1, 0x77, 0xab,
+		0xc8, 0xf5, 0x76, 0x5d, 0xd5, 0xb5, 0xfd, 0x41,
+		0x76, 0x42, 0xa9, 0xee, 0xcb, 0xe0, 0xea, 0xc9,
+		0xa1, 0xc4, 0x26, 0x96, 0x86, 0xba, 0xbf, 0x4a,
+	};
+
+	/* The hash continues from the state saved with the progress */
+	hash_resume(false, hash);
+	zassert_mem_equal(hash, expected, sizeof(hash), "Incorrect hash");
+
+	/* Without the saved state, the prefix in flash is hashed again */
+	hash_resume(true, hash);
+	zassert_mem_equal(hash, expected, sizeof(hash), "Incorrect hash");
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash_resume_no_read_back)
+{
+	int err;
+	size_t offset;
+	uint8_t hash[32];
+	/* SHA-256 of BUF_LEN bytes of 0xaa */
+	static const uint8_t expected[32] = {
+		0xc0, 0xcc, 0x6c, 0x7f, 0x4a, 0xd1, 0x77, 0xab,
+		0xc8, 0xf5, 0x76, 0x5d, 0xd5, 0xb5, 0xfd, 0x41,
+		0x76, 0x42, 0xa9, 0xee, 0xcb, 0xe0, 0xea, 0xc9,
+		0xa1, 0xc4, 0x26, 0x96, 0x86, 0xba, 0xbf, 0x4a,
+	};
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, BUF_LEN / 2);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Change the prefix in flash, the saved state must be used instead */
+	err = flash_erase(fdev, FLASH_BASE, page_size);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(&write_buf[offset], BUF_LEN - offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_hash_get(hash, sizeof(hash));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_mem_equal(hash, expected, sizeof(hash), "Incorrect hash");
+}
+#else
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash_resume)
+{
+	ztest_test_skip();
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash_resume_no_read_back)
+{
+	ztest_test_skip();
+}
+
+#endif
+#else
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash)
+{
+	ztest_test_skip();
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash_resume)
+{
+	ztest_test_skip();
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_hash_resume_no_read_back)
+{
+	ztest_test_skip();
+}
+
+#endif
+
 static void *setup(void)
 {
 	__ASSERT_NO_MSG(device_is_ready(fdev));
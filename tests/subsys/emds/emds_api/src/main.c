@@ -56,6 +56,8 @@ static uint8_t s_data[1024];
 
 EMDS_STATIC_ENTRY_DEFINE(s_entry, 0x100, s_data, sizeof(s_data));
 
+#define ENTRY_COUNT (ARRAY_SIZE(d_entries) + 1)
+
 static char *print_state(enum test_states s)
 {
 	switch (s) {
@@ -163,8 +165,10 @@ static void prepare(void)
 	zassert_true(emds_is_ready(), "EMDS should be ready");
 }
 
-static void store(void)
+static void store(int expect_written)
 {
+	struct emds_store_stats stats;
+
 	zassert_true(emds_is_ready(), "Store should be ready to execute");
 
 	memcpy(d_data, expect_d_data, sizeof(expect_d_data));
@@ -192,6 +196,19 @@ static void store(void)
 	zassert_true((store_time_us < estimate_store_time_us), "Store takes to long time");
 	printf("Store time: Actual %lldus, Worst case:  %dus\n",
 	       store_time_us, estimate_store_time_us);
+
+	emds_store_stats_get(&stats);
+	printf("Store: %u entries written, %u skipped, %u bytes in %uus\n",
+	       stats.entries_written, stats.entries_skipped, stats.bytes_written, stats.time_us);
+
+	zassert_equal(stats.entries_written + stats.entries_skipped, ENTRY_COUNT,
+		      "Wrong entry count");
+	if (expect_written >= 0) {
+		zassert_equal(stats.entries_written, expect_written, "Wrong written entry count");
+	}
+	/* At most all entries and the commit record */
+	zassert_true(stats.bytes_written <= emds_store_size_get() + 8, "Too many bytes written");
+	zassert_true(stats.time_us < estimate_store_time_us, "Store takes to long time");
 }
 
 static void clear(void)
@@ -278,7 +295,8 @@ ZTEST(empty_flash, test_empty_flash)
 {
 	load_empty_flash();
 	prepare();
-	store();
+	/* Nothing is stored yet, so all entries have changed. */
+	store(ENTRY_COUNT);
 	load_flash();
 }
 
@@ -286,7 +304,8 @@ ZTEST(store_data, test_store_data)
 {
 	load_flash();
 	prepare();
-	store();
+	/* Same data as loaded, so the entries kept in flash are stored data again. */
+	store(0);
 	load_flash();
 }
 
@@ -294,7 +313,7 @@ ZTEST(clear_flash, test_clear_flash)
 {
 	load_flash();
 	prepare();
-	store();
+	store(-1);
 	clear();
 	load_empty_flash();
 }
@@ -311,11 +330,11 @@ ZTEST(several_store, test_several_store)
 	load_flash();
 	prepare();
 	load_empty_flash();
-	store();
+	store(0);
 	load_flash();
 	prepare();
 	load_empty_flash();
-	store();
+	store(0);
 	load_flash();
 }
 
@@ -267,7 +267,8 @@ ZTEST(emds_flash_tests, test_rd_wr_simple)
 	device_reset();
 
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
-	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL),
+		      "Prepare failed");
 	zassert_false(emds_flash_write(&ctx, 1, data_in, sizeof(data_in)) < 0, "Error when write");
 	zassert_false(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)) < 0, "Error when read");
 	zassert_false(memcmp(data_out, data_in, sizeof(data_out)), "Retrived wrong value");
@@ -351,14 +352,16 @@ ZTEST(emds_flash_tests, test_flash_recovery)
 	 *     #5: Empty
 	 *     #6: Empty
 	 *     ...
-	 * Expect:  Unexpected behavior
+	 * Expect: Normal behavior. emds_flash_prepare keeps the entries that did not
+	 *         change and invalidates the others, so a valid entry followed by an
+	 *         invalidated one is a layout it writes itself.
 	 */
 	ate_invalidate_write(idx);
 	idx -= sizeof(struct test_ate);
 	entry_write(idx, 3, data_in3, sizeof(data_in3));
 	idx -= sizeof(struct test_ate);
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
-	zassert_true(ctx.force_erase, "Expected true");
+	zassert_false(ctx.force_erase, "Expected false");
 	zassert_equal(idx, ctx.ate_wra, "Addr not equal");
 	zassert_true(emds_flash_read(&ctx, 2, data_out, sizeof(data_in2)) > 0, "Could not read");
 	zassert_false(memcmp(data_in2, data_out, sizeof(data_in2)), "Not same data");
@@ -434,7 +437,7 @@ ZTEST(emds_flash_tests, test_invalidate_on_prepare)
 		memset(data_out, 0, sizeof(data_out));
 	}
 
-	zassert_false(emds_flash_prepare(&ctx, 0), "Error when preparing");
+	zassert_false(emds_flash_prepare(&ctx, 0, NULL, NULL), "Error when preparing");
 
 	device_reset();
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
@@ -447,7 +450,7 @@ ZTEST(emds_flash_tests, test_invalidate_on_prepare)
 		zassert_false(emds_flash_read(&ctx, i, data_out, sizeof(data_in)) > 0,
 			      "Should not be able to read");
 	}
-	zassert_false(emds_flash_prepare(&ctx, 0), "Error when preparing");
+	zassert_false(emds_flash_prepare(&ctx, 0, NULL, NULL), "Error when preparing");
 
 	/* Reset again without writing */
 	device_reset();
@@ -458,6 +461,103 @@ ZTEST(emds_flash_tests, test_invalidate_on_prepare)
 	zassert_false(ctx.force_erase, "Force erase should be false");
 }
 
+struct walk_result {
+	uint16_t ids[8];
+	bool valid[8];
+	int count;
+	bool commit;
+};
+
+static bool walk_cb(const struct emds_flash_ate_info *ate, void *user_data)
+{
+	struct walk_result *result = user_data;
+
+	if (ate->commit) {
+		result->commit = true;
+		return true;
+	}
+
+	result->ids[result->count] = ate->id;
+	result->valid[result->count] = ate->valid;
+	result->count++;
+
+	return result->count < ARRAY_SIZE(result->ids);
+}
+
+static bool keep_odd_cb(const struct emds_flash_ate_info *ate, void *user_data)
+{
+	return ate->id % 2;
+}
+
+ZTEST(emds_flash_tests, test_keep_on_prepare)
+{
+	char data_in[9] = "Deadbeef";
+	char data_out[9] = {0};
+	struct walk_result result = {0};
+	uint32_t ate_addr;
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, 5 * (sizeof(data_in) + ctx.ate_size), NULL, NULL),
+		      "Prepare failed");
+	for (uint16_t i = 0; i < 5; i++) {
+		zassert_equal(emds_flash_write(&ctx, i, data_in, sizeof(data_in)), sizeof(data_in),
+			      "Write failed");
+	}
+	zassert_false(emds_flash_commit(&ctx), "Commit failed");
+
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+
+	/* The most recently written entries are walked first. */
+	zassert_false(emds_flash_ate_walk(&ctx, walk_cb, &result), "Walk failed");
+	zassert_true(result.commit, "Commit record not found");
+	zassert_equal(result.count, 5, "Wrong entry count");
+	for (int i = 0; i < 5; i++) {
+		zassert_equal(result.ids[i], 4 - i, "Wrong order");
+		zassert_true(result.valid[i], "Entry not valid");
+	}
+
+	zassert_false(emds_flash_prepare(&ctx, 5 * (sizeof(data_in) + ctx.ate_size), keep_odd_cb,
+					 NULL), "Prepare failed");
+
+	/* The kept entries can be read, the others and the commit record are invalidated. */
+	memset(&result, 0, sizeof(result));
+	zassert_false(emds_flash_ate_walk(&ctx, walk_cb, &result), "Walk failed");
+	zassert_false(result.commit, "Commit record not invalidated");
+	for (int i = 0; i < result.count; i++) {
+		zassert_true(!result.valid[i] || (result.ids[i] % 2), "Entry not invalidated");
+	}
+	for (uint16_t i = 0; i < 5; i++) {
+		zassert_equal(emds_flash_read(&ctx, i, data_out, sizeof(data_out)) > 0, i % 2,
+			      "Entry %d not kept as expected", i);
+	}
+
+	/* The kept entries do not force an erase on the next boot. */
+	zassert_false(emds_flash_write(&ctx, 2, data_in, sizeof(data_in)) < 0, "Write failed");
+	zassert_false(emds_flash_commit(&ctx), "Commit failed");
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(ctx.force_erase, "Force erase should be false");
+
+	/* Entries are read at their known location. */
+	memset(&result, 0, sizeof(result));
+	zassert_false(emds_flash_ate_walk(&ctx, walk_cb, &result), "Walk failed");
+	zassert_true(result.commit, "Commit record not found");
+	zassert_equal(result.ids[0], 2, "Wrong entry");
+	zassert_true(result.valid[0], "Entry not valid");
+	ate_addr = m_test_fd.ate_idx_start - 6 * sizeof(struct test_ate);
+	zassert_equal(emds_flash_ate_read(&ctx, ate_addr, data_out, sizeof(data_out)),
+		      sizeof(data_in), "Could not read");
+	zassert_false(memcmp(data_in, data_out, sizeof(data_in)), "Not same data");
+	zassert_true(emds_flash_ate_match(&ctx, ate_addr, data_in, sizeof(data_in)), "No match");
+	data_in[0]++;
+	zassert_false(emds_flash_ate_match(&ctx, ate_addr, data_in, sizeof(data_in)), "Match");
+	zassert_false(emds_flash_ate_match(&ctx, ate_addr, data_in, 4), "Match");
+}
+
 ZTEST(emds_flash_tests, test_clear_on_strange_flash)
 {
 	flash_clear();
@@ -473,7 +573,7 @@ ZTEST(emds_flash_tests, test_clear_on_strange_flash)
 	ate_corrupt_write(m_test_fd.ate_idx_start);
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
 	zassert_true(ctx.force_erase, "Force erase should be true");
-	zassert_false(emds_flash_prepare(&ctx, 0), "Error when preparing");
+	zassert_false(emds_flash_prepare(&ctx, 0, NULL, NULL), "Error when preparing");
 	zassert_false(flash_cmp_const(m_test_fd.offset, 0xff, m_test_fd.size), "Flash not cleared");
 }
 
@@ -485,8 +585,8 @@ ZTEST(emds_flash_tests, test_permission)
 	flash_clear();
 	device_reset();
 
-	zassert_true(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size) == -EACCES,
-		     "Prepare did not fail");
+	zassert_true(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL) ==
+		     -EACCES, "Prepare did not fail");
 	zassert_true(emds_flash_read(&ctx, 1, data_out, sizeof(data_in)) == -EACCES,
 		     "Should not be able to read");
 	zassert_true(emds_flash_write(&ctx, 1, data_in, sizeof(data_in)) == -EACCES,
@@ -497,7 +597,8 @@ ZTEST(emds_flash_tests, test_permission)
 	zassert_true(emds_flash_write(&ctx, 1, data_in, sizeof(data_in)) == -EACCES,
 		     "Should not be able to read");
 
-	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL),
+		      "Prepare failed");
 
 	zassert_true(emds_flash_write(&ctx, 1, data_in, sizeof(data_in)) == sizeof(data_in),
 				      "Should be able to write");
@@ -516,7 +617,8 @@ ZTEST(emds_flash_tests, test_overflow)
 	device_reset();
 
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
-	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL),
+		      "Prepare failed");
 
 	uint16_t test_cnt = 0;
 
@@ -542,7 +644,8 @@ ZTEST(emds_flash_tests, test_overflow)
 	}
 
 
-	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL),
+		      "Prepare failed");
 
 	data_in[0] = 'D';
 	emds_flash_write(&ctx, 0, data_in, sizeof(data_in));
@@ -564,9 +667,10 @@ ZTEST(emds_flash_tests, test_prepare_overflow)
 	device_reset();
 
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
-	zassert_true(emds_flash_prepare(&ctx, m_test_fd.size), "Prepare should return error");
-	zassert_false(emds_flash_prepare(&ctx, m_test_fd.size - 16), "Prepare failed");
-	zassert_false(emds_flash_prepare(&ctx, m_test_fd.size - 24), "Prepare failed");
+	zassert_true(emds_flash_prepare(&ctx, m_test_fd.size, NULL, NULL),
+		     "Prepare should return error");
+	zassert_false(emds_flash_prepare(&ctx, m_test_fd.size - 16, NULL, NULL), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, m_test_fd.size - 24, NULL, NULL), "Prepare failed");
 }
 
 ZTEST(emds_flash_tests, test_full_corrupt_recovery)
@@ -580,7 +684,7 @@ ZTEST(emds_flash_tests, test_full_corrupt_recovery)
 	zassert_true(ctx.force_erase, "Force erase should be true");
 	zassert_equal(0, emds_flash_free_space_get(&ctx), "Expected no free space");
 
-	zassert_false(emds_flash_prepare(&ctx, 0), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, 0, NULL, NULL), "Prepare failed");
 	zassert_equal(m_test_fd.size - sizeof(struct test_ate), emds_flash_free_space_get(&ctx),
 		      "Expected no free space");
 
@@ -598,7 +702,8 @@ ZTEST(emds_flash_tests, test_corrupted_data)
 	device_reset();
 
 	zassert_false(emds_flash_init(&ctx), "Error when initializing");
-	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL),
+		      "Prepare failed");
 
 	zassert_true(emds_flash_write(&ctx, 1, data_in, sizeof(data_in)) == sizeof(data_in),
 				      "Should be able to write");
@@ -639,7 +744,7 @@ ZTEST(emds_flash_tests, test_write_speed)
 	mpsl_uninit();
 #endif
 	(void)emds_flash_init(&ctx);
-	(void)emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size);
+	(void)emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size, NULL, NULL);
 
 	tic = k_uptime_ticks();
 	dk_set_led(0, true);
@@ -12,6 +12,7 @@
 
 #include "mock/socket.h"
 #include "mock/dl_coap.h"
+#include "mock/dl_http.h"
 
 static enum download_client_evt_id last_event = -1;
 static struct download_client client;
@@ -68,9 +69,13 @@ static struct download_client_cfg config = {
 	.frag_size_override = 0,
 };
 
-static void dl_coap_start(void)
+static struct download_client_cfg http_config = {
+	.pdn_id = 0,
+	.frag_size_override = 25,
+};
+
+static void dl_start(const char *host, const struct download_client_cfg *cfg)
 {
-	static const char host[] = "coap://10.1.0.10";
 	static bool initialized;
 	int err;
 
@@ -81,13 +86,23 @@ static void dl_coap_start(void)
 		initialized = true;
 	}
 
-	err = download_client_set_host(&client, host, &config);
+	err = download_client_set_host(&client, host, cfg);
 	zassert_ok(err, NULL);
 
 	err = download_client_start(&client, "no.file", 0);
 	zassert_ok(err, NULL);
 }
 
+static void dl_coap_start(void)
+{
+	dl_start("coap://10.1.0.10", &config);
+}
+
+static void dl_http_start(void)
+{
+	dl_start("http://10.1.0.10", &http_config);
+}
+
 static void de_init(struct download_client *client)
 {
 	int err;
@@ -214,6 +229,34 @@ ZTEST(download_client, test_get)
 	zassert_ok(wait_for_event(DOWNLOAD_CLIENT_EVT_CLOSED, 10), "Socket must have closed");
 }
 
+ZTEST(download_client, test_http_parallel_ranges)
+{
+	int32_t recvfrom_params[] = { 25, 25, 25, 25 };
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_DOWNLOAD_CLIENT_PARALLEL);
+
+	dl_http_init(100, 25);
+
+	mock_return_values("mock_socket_offload_recvfrom", recvfrom_params,
+			   ARRAY_SIZE(recvfrom_params));
+
+	dl_http_start();
+
+	zassert_ok(wait_for_event(DOWNLOAD_CLIENT_EVT_DONE, 10), "Download must have finished");
+
+	/* The first fragment is requested alone, to learn the file size */
+	zassert_equal(dl_http_values.range_requests, 3, "Unexpected number of range requests");
+	zassert_equal(dl_http_values.range_request[0].from, 25, NULL);
+	zassert_equal(dl_http_values.range_request[0].progress, 25, NULL);
+	/* The next range is requested before the current one is received */
+	zassert_equal(dl_http_values.range_request[1].from, 50, NULL);
+	zassert_equal(dl_http_values.range_request[1].progress, 25, NULL);
+	zassert_equal(dl_http_values.range_request[2].from, 75, NULL);
+	zassert_equal(dl_http_values.range_request[2].progress, 50, NULL);
+
+	de_init(&client);
+}
+
 #define TEST_SOCKET_PRIO 40
 NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
 		    mock_socket_create);
@@ -9,12 +9,53 @@
 
 #include "mock/dl_http.h"
 
+struct dl_http_values_s dl_http_values;
+
+void dl_http_init(size_t file_size, size_t frag_size)
+{
+	memset(&dl_http_values, 0, sizeof(dl_http_values));
+	dl_http_values.file_size = file_size;
+	dl_http_values.frag_size = frag_size;
+}
+
 int http_parse(struct download_client *client, size_t len)
 {
+	if (!client->http.has_header) {
+		client->http.has_header = true;
+		if (client->file_size == 0) {
+			client->file_size = dl_http_values.file_size;
+		}
+	}
+
+	client->offset += len;
+	client->progress += len;
+
+	if (client->offset < dl_http_values.frag_size &&
+	    client->progress < client->file_size) {
+		return 1;
+	}
+
 	return 0;
 }
 
 int http_get_request_send(struct download_client *client)
 {
+	client->http.has_header = false;
+	client->http.ranged = true;
+
+	return 0;
+}
+
+int http_get_range_request_send(struct download_client *client, int fd, size_t from)
+{
+	size_t i = dl_http_values.range_requests;
+
+	if (i < DL_HTTP_RANGE_REQUESTS_MAX) {
+		dl_http_values.range_request[i].from = from;
+		dl_http_values.range_request[i].progress = client->progress;
+	}
+
+	dl_http_values.range_requests++;
+
 	return 0;
 }
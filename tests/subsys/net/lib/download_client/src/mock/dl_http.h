@@ -8,7 +8,28 @@
 
 #include <zephyr/kernel.h>
 
+#define DL_HTTP_RANGE_REQUESTS_MAX 16
+
+struct dl_http_range_request {
+	/* Start of the requested range */
+	size_t from;
+	/* Download progress when the range was requested */
+	size_t progress;
+};
+
+struct dl_http_values_s {
+	size_t file_size;
+	size_t frag_size;
+	size_t range_requests;
+	struct dl_http_range_request range_request[DL_HTTP_RANGE_REQUESTS_MAX];
+};
+
+extern struct dl_http_values_s dl_http_values;
+
+void dl_http_init(size_t file_size, size_t frag_size);
+
 int http_parse(struct download_client *client, size_t len);
 int http_get_request_send(struct download_client *client);
+int http_get_range_request_send(struct download_client *client, int fd, size_t from);
 
 #endif /* _DL_HTTP_H_ */
@@ -22,6 +22,7 @@ static char buf[1024];
 #define BASE_DOMAIN "something.com"
 #define NO_TLS -1
 #define ARBITRARY_IMAGE_OFFSET 512
+#define FILE_SIZE 1024
 
 /* Stubs and mocks */
 static const char *download_client_start_file;
@@ -34,6 +35,7 @@ static bool fail_on_connect;
 static bool fail_on_start;
 static bool download_with_offset_success;
 static download_client_callback_t download_client_event_handler;
+static int dfu_target_reset_count;
 K_SEM_DEFINE(stop_sem, 0, 1);
 
 int dfu_target_init(int img_type, int img_num, size_t file_size, dfu_target_callback_t cb)
@@ -73,6 +75,7 @@ int dfu_target_done(bool successful)
 
 int dfu_target_reset(void)
 {
+	dfu_target_reset_count++;
 	return 0;
 }
 
@@ -83,6 +86,7 @@ int dfu_target_schedule_update(int img_num)
 
 int download_client_file_size_get(struct download_client *client, size_t *size)
 {
+	*size = FILE_SIZE;
 	return 0;
 }
 
@@ -136,6 +140,61 @@ int z_impl_zsock_inet_pton(sa_family_t family, const char *src, void *dst)
 	return 0;
 }
 
+#ifdef CONFIG_FOTA_DOWNLOAD_JOURNAL
+/* The journal is kept in RAM instead of the settings storage */
+static uint8_t journal_buf[128];
+static size_t journal_len;
+static uint32_t etag;
+static uint8_t image_hash[32];
+
+int settings_subsys_init(void)
+{
+	return 0;
+}
+
+int settings_save_one(const char *name, const void *value, size_t val_len)
+{
+	zassert_true(val_len <= sizeof(journal_buf), "Journal too big");
+	memcpy(journal_buf, value, val_len);
+	journal_len = val_len;
+	return 0;
+}
+
+int settings_delete(const char *name)
+{
+	journal_len = 0;
+	return 0;
+}
+
+static ssize_t journal_read(void *cb_arg, void *data, size_t len)
+{
+	len = MIN(len, journal_len);
+	memcpy(data, journal_buf, len);
+	return len;
+}
+
+int settings_load_subtree_direct(const char *subtree, settings_load_direct_cb cb, void *param)
+{
+	if (journal_len == 0) {
+		return 0;
+	}
+
+	return cb(subtree, journal_len, journal_read, NULL, param);
+}
+
+int download_client_etag_get(struct download_client *client, uint32_t *etag_hash)
+{
+	*etag_hash = etag;
+	return 0;
+}
+
+int dfu_target_hash_get(uint8_t *hash, size_t len)
+{
+	memcpy(hash, image_hash, MIN(len, sizeof(image_hash)));
+	return 0;
+}
+#endif /* CONFIG_FOTA_DOWNLOAD_JOURNAL */
+
 /* END stubs and mocks */
 
 
@@ -264,6 +323,7 @@ static void init(void)
 	fail_on_start = false;
 	download_client_start_file = NULL;
 	spm_s0_active_retval = false;
+	dfu_target_reset_count = 0;
 
 	k_sem_reset(&stop_sem);
 
@@ -335,6 +395,13 @@ ZTEST(fota_download_tests, test_download_with_offset)
 {
 	int err;
 
+	if (IS_ENABLED(CONFIG_FOTA_DOWNLOAD_JOURNAL)) {
+		/* Without a journal entry the partial image is discarded,
+		 * see the journal tests.
+		 */
+		ztest_test_skip();
+	}
+
 	/* Init */
 	init();
 
@@ -424,3 +491,131 @@ ZTEST(fota_download_tests, test_download_with_offset)
 	err = fota_download_cancel();
 	zassert_equal(err, -EAGAIN);
 }
+
+#ifdef CONFIG_FOTA_DOWNLOAD_JOURNAL
+static uint8_t journal_fragment_buf[1];
+static const struct download_client_evt journal_fragment_evt = {
+	.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+	.fragment = {
+		.buf = journal_fragment_buf,
+		.len = sizeof(journal_fragment_buf),
+	}
+};
+
+/* Download the first fragment of S0_A and cancel the download, leaving a
+ * partial image of ARBITRARY_IMAGE_OFFSET bytes in the DFU target.
+ */
+static void journal_download_interrupt(void)
+{
+	int err;
+
+	init();
+	memset(image_hash, 0xaa, sizeof(image_hash));
+	etag = 0x1234;
+
+	strcpy(buf, S0_A);
+	err = fota_download_start(BASE_DOMAIN, buf, NO_TLS, 0, 0);
+	zassert_ok(err, NULL);
+
+	err = download_client_event_handler(&journal_fragment_evt);
+	zassert_ok(err, NULL);
+
+	start_with_offset = true;
+
+	err = fota_download_cancel();
+	zassert_ok(err, NULL);
+	zassert_ok(k_sem_take(&stop_sem, K_SECONDS(1)), NULL);
+	zassert_not_equal(journal_len, 0, "Journal not saved");
+}
+
+/* Start the download of @p file again, with a partial image in the DFU target.
+ * Returns the result of the first fragment.
+ */
+static int journal_download_resume(const char *file)
+{
+	int err;
+
+	strcpy(buf, file);
+	err = fota_download_start(BASE_DOMAIN, buf, NO_TLS, 0, 0);
+	zassert_ok(err, NULL);
+
+	return download_client_event_handler(&journal_fragment_evt);
+}
+
+static void journal_download_cancel(void)
+{
+	int err;
+
+	err = fota_download_cancel();
+	zassert_ok(err, NULL);
+	zassert_ok(k_sem_take(&stop_sem, K_SECONDS(1)), NULL);
+}
+
+ZTEST(fota_download_tests, test_journal_resume)
+{
+	int err;
+
+	journal_download_interrupt();
+
+	/* The fragment is refused, the download continues from the partial image */
+	download_with_offset_success = false;
+	err = journal_download_resume(S0_A);
+	zassert_equal(err, -1, NULL);
+
+	k_sem_take(&download_with_offset_sem, K_SECONDS(2));
+	zassert_true(download_with_offset_success, NULL);
+	zassert_equal(dfu_target_reset_count, 0, NULL);
+
+	journal_download_cancel();
+}
+
+ZTEST(fota_download_tests, test_journal_stale_image)
+{
+	int err;
+
+	/* Another resource locator */
+	journal_download_interrupt();
+
+	err = journal_download_resume(S1_A);
+	zassert_ok(err, NULL);
+	zassert_equal(dfu_target_reset_count, 1, NULL);
+
+	journal_download_cancel();
+
+	/* Another version of the file */
+	journal_download_interrupt();
+	etag++;
+
+	err = journal_download_resume(S0_A);
+	zassert_ok(err, NULL);
+	zassert_equal(dfu_target_reset_count, 1, NULL);
+
+	journal_download_cancel();
+
+	/* No journal */
+	journal_download_interrupt();
+	journal_len = 0;
+
+	err = journal_download_resume(S0_A);
+	zassert_ok(err, NULL);
+	zassert_equal(dfu_target_reset_count, 1, NULL);
+
+	journal_download_cancel();
+}
+
+ZTEST(fota_download_tests, test_journal_image_mismatch)
+{
+	int err;
+
+	journal_download_interrupt();
+
+	/* The DFU target holds another image at the same progress */
+	image_hash[0] ^= 0xff;
+
+	err = journal_download_resume(S0_A);
+	zassert_ok(err, NULL);
+	zassert_equal(dfu_target_reset_count, 1, NULL);
+
+	journal_download_cancel();
+}
+#endif /* CONFIG_FOTA_DOWNLOAD_JOURNAL */
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <lz4.h>
+
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_log_internal.h"
+
+#define WINDOW_MS 1000
+#define LINES_PER_SEC 2
+#define BURST 3
+#define SOURCES 4
+#define BLOCK_SIZE 1024
+
+static struct nrf_cloud_log_dedup dedup;
+static struct nrf_cloud_log_token_bucket buckets[SOURCES];
+static struct nrf_cloud_log_rate_limit limit;
+
+static uint8_t block[BLOCK_SIZE];
+static uint8_t out[BLOCK_SIZE];
+static uint8_t decompressed[BLOCK_SIZE];
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&dedup, 0, sizeof(dedup));
+	dedup.window_ms = WINDOW_MS;
+
+	memset(buckets, 0, sizeof(buckets));
+	limit = (struct nrf_cloud_log_rate_limit) {
+		.lines_per_sec = LINES_PER_SEC,
+		.burst = BURST,
+		.buckets = buckets,
+		.bucket_cnt = ARRAY_SIZE(buckets),
+	};
+}
+
+ZTEST_SUITE(nrf_cloud_log_filter, NULL, NULL, test_before, NULL, NULL);
+
+ZTEST(nrf_cloud_log_filter, test_dedup_repeats)
+{
+	zassert_false(nrf_cloud_log_dedup_check(&dedup, 0x1234, 0), "Nothing to repeat yet");
+	nrf_cloud_log_dedup_set(&dedup, 0x1234, 1, 0, LOG_LEVEL_ERR, 0);
+
+	for (int i = 1; i <= 5; i++) {
+		zassert_true(nrf_cloud_log_dedup_check(&dedup, 0x1234, i * 100));
+		zassert_equal(dedup.repeats, i);
+	}
+
+	/* Another message ends the repetition */
+	zassert_false(nrf_cloud_log_dedup_check(&dedup, 0x5678, 600));
+	zassert_equal(dedup.repeats, 5, "Repeats are kept until the next message is set");
+	nrf_cloud_log_dedup_set(&dedup, 0x5678, 2, 0, LOG_LEVEL_WRN, 600);
+	zassert_equal(dedup.repeats, 0);
+	zassert_equal(dedup.src_id, 2);
+	zassert_equal(dedup.level, LOG_LEVEL_WRN);
+
+	zassert_false(nrf_cloud_log_dedup_check(&dedup, 0x1234, 700));
+}
+
+ZTEST(nrf_cloud_log_filter, test_dedup_window)
+{
+	nrf_cloud_log_dedup_set(&dedup, 0x1234, 1, 0, LOG_LEVEL_INF, 1000);
+
+	zassert_true(nrf_cloud_log_dedup_check(&dedup, 0x1234, 1000 + WINDOW_MS - 1));
+	/* Sent again once the window has passed, so the cloud sees it persists */
+	zassert_false(nrf_cloud_log_dedup_check(&dedup, 0x1234, 1000 + WINDOW_MS));
+	zassert_equal(dedup.repeats, 1);
+}
+
+ZTEST(nrf_cloud_log_filter, test_dedup_flush)
+{
+	zassert_equal(nrf_cloud_log_dedup_flush(&dedup, WINDOW_MS), 0, "Nothing to flush yet");
+	nrf_cloud_log_dedup_set(&dedup, 0x1234, 1, 0, LOG_LEVEL_INF, 1000);
+	zassert_equal(nrf_cloud_log_dedup_flush(&dedup, 1000 + WINDOW_MS), 0, "No repeats");
+
+	zassert_true(nrf_cloud_log_dedup_check(&dedup, 0x1234, 1100));
+	zassert_true(nrf_cloud_log_dedup_check(&dedup, 0x1234, 1200));
+	/* Repeats are kept while the window lasts */
+	zassert_equal(nrf_cloud_log_dedup_flush(&dedup, 1000 + WINDOW_MS - 1), 0);
+	zassert_equal(dedup.repeats, 2);
+
+	zassert_equal(nrf_cloud_log_dedup_flush(&dedup, 1000 + WINDOW_MS), 2);
+	zassert_equal(dedup.repeats, 0, "Repeats reported twice");
+	zassert_equal(nrf_cloud_log_dedup_flush(&dedup, 1000 + WINDOW_MS), 0);
+
+	/* The message is passed on again after the window */
+	zassert_false(nrf_cloud_log_dedup_check(&dedup, 0x1234, 1000 + WINDOW_MS));
+}
+
+ZTEST(nrf_cloud_log_filter, test_rate_limit_burst_and_refill)
+{
+	uint32_t now = 5000;
+
+	for (int i = 0; i < BURST; i++) {
+		zassert_true(nrf_cloud_log_rate_limit_take(&limit, 0, now), "Message %d", i);
+	}
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, 0, now), "Burst exceeded");
+
+	/* One message is refilled every 1000 / LINES_PER_SEC ms */
+	now += 1000 / LINES_PER_SEC - 1;
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, 0, now));
+	now += 1;
+	zassert_true(nrf_cloud_log_rate_limit_take(&limit, 0, now));
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, 0, now));
+
+	/* The bucket does not fill beyond the burst size */
+	now += 60 * MSEC_PER_SEC;
+	for (int i = 0; i < BURST; i++) {
+		zassert_true(nrf_cloud_log_rate_limit_take(&limit, 0, now), "Message %d", i);
+	}
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, 0, now));
+}
+
+ZTEST(nrf_cloud_log_filter, test_rate_limit_sources)
+{
+	for (int i = 0; i < BURST; i++) {
+		zassert_true(nrf_cloud_log_rate_limit_take(&limit, 1, 0));
+	}
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, 1, 0));
+
+	/* Other sources have their own bucket */
+	zassert_true(nrf_cloud_log_rate_limit_take(&limit, 0, 0));
+	zassert_true(nrf_cloud_log_rate_limit_take(&limit, 2, 0));
+
+	/* Sources beyond the table, and unknown ones, share the last bucket */
+	for (int i = 0; i < BURST; i++) {
+		zassert_true(nrf_cloud_log_rate_limit_take(&limit, SOURCES - 1 + i * 7, 0));
+	}
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, UINT32_MAX, 0));
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, SOURCES - 1, 0));
+}
+
+ZTEST(nrf_cloud_log_filter, test_rate_limit_uptime_wrap)
+{
+	uint32_t now = UINT32_MAX - 100;
+
+	for (int i = 0; i < BURST; i++) {
+		zassert_true(nrf_cloud_log_rate_limit_take(&limit, 0, now));
+	}
+	zassert_false(nrf_cloud_log_rate_limit_take(&limit, 0, now));
+
+	now += 1000 / LINES_PER_SEC;
+	zassert_true(nrf_cloud_log_rate_limit_take(&limit, 0, now), "Refill across the wrap");
+}
+
+static size_t dict_block_fill(size_t records)
+{
+	struct nrf_cloud_bin_hdr hdr = {
+		.magic = NRF_CLOUD_BINARY_MAGIC,
+		.format = NRF_CLOUD_DICT_LOG_FMT,
+		.ts = 1690000000000LL,
+		.sequence = 42,
+	};
+	size_t len = sizeof(hdr);
+
+	memcpy(block, &hdr, sizeof(hdr));
+
+	/* Dictionary records repeat their format string addresses and most arguments */
+	for (size_t i = 0; i < records; i++) {
+		uint8_t record[] = { 0x01, 0x00, 0x10, 0x00, 0xa4, 0x3f, 0x02, 0x00,
+				     (uint8_t)i, 0x00, 0x00, 0x00, 0x2c, 0x01, 0x00, 0x00 };
+
+		memcpy(&block[len], record, sizeof(record));
+		len += sizeof(record);
+	}
+
+	return len;
+}
+
+ZTEST(nrf_cloud_log_filter, test_compress_round_trip)
+{
+	const struct nrf_cloud_bin_hdr *hdr = (const struct nrf_cloud_bin_hdr *)out;
+	size_t len = dict_block_fill(60);
+	size_t raw_len = len - sizeof(*hdr);
+	int out_len;
+	int ret;
+
+	out_len = nrf_cloud_log_dict_compress(block, len, out, sizeof(out));
+	zassert_true(out_len > 0, "Compression failed: %d", out_len);
+	zassert_true(out_len < len, "Not smaller: %d of %zu", out_len, len);
+
+	/* The header is kept, with the compressed format */
+	zassert_equal(hdr->format, NRF_CLOUD_DICT_LOG_LZ_FMT);
+	zassert_mem_equal(out, block, offsetof(struct nrf_cloud_bin_hdr, format));
+	zassert_mem_equal(&out[offsetof(struct nrf_cloud_bin_hdr, pad)],
+			  &block[offsetof(struct nrf_cloud_bin_hdr, pad)],
+			  sizeof(*hdr) - offsetof(struct nrf_cloud_bin_hdr, pad));
+	zassert_equal(sys_get_le32(&out[sizeof(*hdr)]), raw_len);
+
+	ret = LZ4_decompress_safe((const char *)&out[NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE],
+				  (char *)decompressed, out_len - NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE,
+				  sizeof(decompressed));
+	zassert_equal(ret, raw_len, "Decompressed %d bytes", ret);
+	zassert_mem_equal(decompressed, &block[sizeof(*hdr)], raw_len);
+}
+
+ZTEST(nrf_cloud_log_filter, test_compress_not_smaller)
+{
+	size_t len = sizeof(struct nrf_cloud_bin_hdr) + 200;
+	uint32_t x = 0x12345678;
+
+	memset(block, 0, sizeof(struct nrf_cloud_bin_hdr));
+	for (size_t i = sizeof(struct nrf_cloud_bin_hdr); i < len; i++) {
+		/* xorshift, data that does not compress */
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		block[i] = (uint8_t)x;
+	}
+
+	zassert_equal(nrf_cloud_log_dict_compress(block, len, out, sizeof(out)), -ENOSPC);
+
+	/* Compressible, but the output buffer is too small */
+	len = dict_block_fill(60);
+	zassert_equal(nrf_cloud_log_dict_compress(block, len, out,
+						  NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE + 8), -ENOSPC);
+
+	zassert_equal(nrf_cloud_log_dict_compress(block, NRF_CLOUD_DICT_LOG_LZ_HDR_SIZE, out,
+						  sizeof(out)), -EINVAL);
+}